@@ -0,0 +1,490 @@
+/*=========================================================================
+
+  Name:        DerivedFields.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Fields derived from the point data fields of a volume.
+
+=========================================================================*/
+
+
+#include "DerivedFields.h"
+
+#include "vtkVolumeDifference.h"
+
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkRectilinearGrid.h>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef USE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+// Work shared by the threads computing planes
+struct DerivedFieldsWork {
+    DerivedFields* fields;
+    DerivedFields::Type type;
+    vtkDataArray* input;
+    vtkDataArray* output;
+    int next;
+    vtkSimpleCriticalSection lock;
+};
+
+
+// Name suffix of each type
+static const char* typeSuffixes[DerivedFields::NumberOfTypes] = {
+    " squared",
+    " gradient magnitude",
+    " Laplacian",
+    " reduced density gradient"
+};
+
+// 2 (3 pi^2)^(1/3), for the reduced density gradient
+static const double pi = 3.14159265358979323846;
+static const double reducedGradientFactor = 2.0 * pow(3.0 * pi * pi, 1.0 / 3.0);
+
+// Reduced density gradients are capped, as they grow without bound where the density vanishes.
+// NCI analysis is interested in values well below this.
+static const double maximumReducedGradient = 2.0;
+
+
+// Fit a quadratic through three consecutive points around each point and take its derivatives
+static void ComputeStencil(const std::vector<double>& c, std::vector<int>& index,
+                           std::vector<double> first[3], std::vector<double> second[3]) {
+    int n = (int)c.size();
+
+    index.resize(n);
+    for (int k = 0; k < 3; k++) {
+        first[k].assign(n, 0.0);
+        second[k].assign(n, 0.0);
+    }
+
+    if (n < 3) {
+        // At most a linear difference.  Unused points repeat the last one.
+        for (int i = 0; i < n; i++) {
+            index[i] = 0;
+
+            if (n == 2) {
+                double h = c[1] - c[0];
+                first[0][i] = -1.0 / h;
+                first[1][i] = 1.0 / h;
+            }
+        }
+
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        int m = std::min(std::max(i - 1, 0), n - 3);
+        index[i] = m;
+
+        double x = c[i];
+        double x0 = c[m];
+        double x1 = c[m + 1];
+        double x2 = c[m + 2];
+
+        double d0 = (x0 - x1) * (x0 - x2);
+        double d1 = (x1 - x0) * (x1 - x2);
+        double d2 = (x2 - x0) * (x2 - x1);
+
+        first[0][i] = ((x - x1) + (x - x2)) / d0;
+        first[1][i] = ((x - x0) + (x - x2)) / d1;
+        first[2][i] = ((x - x0) + (x - x1)) / d2;
+
+        second[0][i] = 2.0 / d0;
+        second[1][i] = 2.0 / d1;
+        second[2][i] = 2.0 / d2;
+    }
+}
+
+
+#ifdef USE_SSE2
+// Load two consecutive values as doubles
+template <class T>
+static inline __m128d LoadTwo(const T* p) {
+    return _mm_set_pd(static_cast<double>(p[1]), static_cast<double>(p[0]));
+}
+
+static inline __m128d LoadTwo(const float* p) {
+    return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+}
+
+static inline __m128d LoadTwo(const double* p) {
+    return _mm_loadu_pd(p);
+}
+
+// Store two consecutive values
+static inline void StoreTwo(float* p, __m128d v) {
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_castps_si128(_mm_cvtpd_ps(v)));
+}
+
+static inline void StoreTwo(double* p, __m128d v) {
+    _mm_storeu_pd(p, v);
+}
+
+// Weighted sum of two consecutive points of three rows
+template <class T>
+static inline __m128d WeightedSum(const __m128d w[3], const T* const rows[3], int x) {
+    __m128d sum = _mm_add_pd(_mm_mul_pd(w[0], LoadTwo(rows[0] + x)), _mm_mul_pd(w[1], LoadTwo(rows[1] + x)));
+    return _mm_add_pd(sum, _mm_mul_pd(w[2], LoadTwo(rows[2] + x)));
+}
+#endif
+
+
+bool DerivedFields::IsSupported(vtkDataObject* volume) {
+    return (vtkImageData::SafeDownCast(volume) || vtkRectilinearGrid::SafeDownCast(volume)) &&
+           vtkDataSet::SafeDownCast(volume)->GetNumberOfPoints() > 0;
+}
+
+
+DerivedFields::DerivedFields(vtkDataObject* volume) {
+    vtkDataSet* data = vtkDataSet::SafeDownCast(volume);
+
+    for (int i = 0; i < 3; i++) {
+        std::vector<double> coordinates;
+        vtkVolumeDifference::GetCoordinates(data, i, coordinates);
+
+        dimensions[i] = (int)coordinates.size();
+
+        ComputeStencil(coordinates, stencils[i].index, stencils[i].first, stencils[i].second);
+    }
+}
+
+DerivedFields::~DerivedFields() {
+}
+
+
+void DerivedFields::Define(const std::string& baseName, std::vector<std::string>& names) {
+    for (int i = 0; i < NumberOfTypes; i++) {
+        Definition definition;
+        definition.baseName = baseName;
+        definition.type = (Type)i;
+
+        std::string name = baseName + typeSuffixes[i];
+        definitions[name] = definition;
+
+        names.push_back(name);
+    }
+}
+
+bool DerivedFields::IsDerived(const std::string& name) {
+    return definitions.find(name) != definitions.end();
+}
+
+std::string DerivedFields::GetBaseName(const std::string& name) {
+    std::map<std::string, Definition>::iterator it = definitions.find(name);
+
+    return it != definitions.end() ? it->second.baseName : "";
+}
+
+
+vtkDataArray* DerivedFields::GetField(const std::string& name, vtkDataArray* base) {
+    std::map<std::string, Definition>::iterator definition = definitions.find(name);
+
+    if (definition == definitions.end() || !base || base->GetNumberOfComponents() != 1) {
+        return NULL;
+    }
+
+    lock.Lock();
+
+    // Move to the front if already computed
+    for (std::list<Entry>::iterator it = entries.begin(); it != entries.end(); it++) {
+        if (it->name == name) {
+            entries.splice(entries.begin(), entries, it);
+
+            vtkDataArray* array = entries.front().array;
+            lock.Unlock();
+
+            return array;
+        }
+    }
+
+    Entry entry;
+    entry.name = name;
+    entry.array = Compute(definition->second.type, base);
+    entry.array->SetName(name.c_str());
+
+    entries.push_front(entry);
+
+    vtkDataArray* array = entry.array;
+    lock.Unlock();
+
+    return array;
+}
+
+void DerivedFields::SetFieldInUse(const std::string& name) {
+    lock.Lock();
+    fieldInUse = name;
+    lock.Unlock();
+}
+
+
+unsigned long DerivedFields::GetMemorySize() {
+    lock.Lock();
+
+    unsigned long size = 0;
+    for (std::list<Entry>::iterator it = entries.begin(); it != entries.end(); it++) {
+        if (it->name != fieldInUse) {
+            size += it->array->GetActualMemorySize();
+        }
+    }
+
+    lock.Unlock();
+
+    return size;
+}
+
+bool DerivedFields::Evict() {
+    lock.Lock();
+
+    bool evicted = false;
+    for (std::list<Entry>::reverse_iterator it = entries.rbegin(); it != entries.rend(); it++) {
+        if (it->name != fieldInUse) {
+            entries.erase(--(it.base()));
+            evicted = true;
+
+            break;
+        }
+    }
+
+    lock.Unlock();
+
+    return evicted;
+}
+
+
+vtkSmartPointer<vtkDataArray> DerivedFields::Compute(Type type, vtkDataArray* base) {
+    // Keep double precision if the base field has it
+    vtkSmartPointer<vtkDataArray> output;
+    if (base->GetDataType() == VTK_DOUBLE) {
+        output = vtkSmartPointer<vtkDoubleArray>::New();
+    }
+    else {
+        output = vtkSmartPointer<vtkFloatArray>::New();
+    }
+
+    output->SetNumberOfTuples(base->GetNumberOfTuples());
+
+    DerivedFieldsWork work;
+    work.fields = this;
+    work.type = type;
+    work.input = base;
+    work.output = output;
+    work.next = 0;
+
+    vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+    threader->SetNumberOfThreads(std::max(1, std::min(vtkMultiThreader::GetGlobalDefaultNumberOfThreads(), dimensions[2])));
+    threader->SetSingleMethod(ComputePlanes, &work);
+    threader->SingleMethodExecute();
+
+    return output;
+}
+
+VTK_THREAD_RETURN_TYPE DerivedFields::ComputePlanes(void* arg) {
+    vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    DerivedFieldsWork* work = static_cast<DerivedFieldsWork*>(info->UserData);
+
+    // Take planes until none are left
+    for (;;) {
+        work->lock.Lock();
+        int z = work->next++;
+        work->lock.Unlock();
+
+        if (z >= work->fields->dimensions[2]) {
+            break;
+        }
+
+        work->fields->ComputePlane(work, z);
+    }
+
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+
+template <class T>
+void DerivedFields::ComputePlaneOutput(DerivedFieldsWork* work, const T* f, int z) {
+    void* out = work->output->GetVoidPointer(0);
+
+    if (work->output->GetDataType() == VTK_DOUBLE) {
+        ComputePlane(work, f, static_cast<double*>(out), z);
+    }
+    else {
+        ComputePlane(work, f, static_cast<float*>(out), z);
+    }
+}
+
+template <class T, class TO>
+void DerivedFields::ComputePlane(DerivedFieldsWork* work, const T* f, TO* out, int z) {
+    int nx = dimensions[0];
+    int ny = dimensions[1];
+    int nz = dimensions[2];
+    vtkIdType planeSize = (vtkIdType)nx * ny;
+    vtkIdType planeStart = z * planeSize;
+
+    if (work->type == Square) {
+        for (vtkIdType i = planeStart; i < planeStart + planeSize; i++) {
+            double v = static_cast<double>(f[i]);
+            out[i] = static_cast<TO>(v * v);
+        }
+
+        return;
+    }
+
+    // The Laplacian needs second derivatives, the others first derivatives
+    bool laplacian = work->type == Laplacian;
+    bool reduced = work->type == ReducedDensityGradient;
+
+    const double* cx[3];
+    double wz[3];
+    vtkIdType zPlanes[3];
+
+    for (int k = 0; k < 3; k++) {
+        cx[k] = laplacian ? &stencils[0].second[k][0] : &stencils[0].first[k][0];
+        wz[k] = laplacian ? stencils[2].second[k][z] : stencils[2].first[k][z];
+
+        // Unused points of flat axes repeat the last one
+        zPlanes[k] = std::min(stencils[2].index[z] + k, nz - 1) * planeSize;
+    }
+
+    std::vector<double> dx(nx);
+    std::vector<double> density(reduced ? nx : 0);
+
+    for (int y = 0; y < ny; y++) {
+        vtkIdType rowStart = planeStart + (vtkIdType)y * nx;
+        const T* row = f + rowStart;
+
+
+        // Derivatives along x.  Interior points use their neighbors, two at a time with SSE2, and 
+        // the ends use one-sided stencils.
+        int interior = 1;
+
+#ifdef USE_SSE2
+        for (; interior + 2 <= nx - 1; interior += 2) {
+            int x = interior;
+            __m128d d = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(cx[0] + x), LoadTwo(row + x - 1)), 
+                                   _mm_mul_pd(_mm_loadu_pd(cx[1] + x), LoadTwo(row + x)));
+            d = _mm_add_pd(d, _mm_mul_pd(_mm_loadu_pd(cx[2] + x), LoadTwo(row + x + 1)));
+
+            _mm_storeu_pd(&dx[x], d);
+        }
+#endif
+
+        for (int x = interior; x < nx - 1; x++) {
+            dx[x] = cx[0][x] * row[x - 1] + cx[1][x] * row[x] + cx[2][x] * row[x + 1];
+        }
+
+        int ends[2] = { 0, nx - 1 };
+        for (int i = 0; i < 2; i++) {
+            int x = ends[i];
+            int m = stencils[0].index[x];
+
+            dx[x] = cx[0][x] * row[m] + 
+                    cx[1][x] * row[std::min(m + 1, nx - 1)] + 
+                    cx[2][x] * row[std::min(m + 2, nx - 1)];
+        }
+
+
+        // Derivatives along y and z have the same weights along the row
+        double wy[3];
+        const T* yRows[3];
+        const T* zRows[3];
+
+        for (int k = 0; k < 3; k++) {
+            wy[k] = laplacian ? stencils[1].second[k][y] : stencils[1].first[k][y];
+            yRows[k] = f + planeStart + (vtkIdType)std::min(stencils[1].index[y] + k, ny - 1) * nx;
+            zRows[k] = f + zPlanes[k] + (vtkIdType)y * nx;
+        }
+
+        // The denominator of the reduced density gradient, 2 (3 pi^2)^(1/3) rho^(4/3), with a cube 
+        // root rather than pow, which costs several times as much
+        if (reduced) {
+            for (int x = 0; x < nx; x++) {
+                double rho = fabs(static_cast<double>(row[x]));
+                density[x] = reducedGradientFactor * rho * cbrt(rho);
+            }
+        }
+
+        TO* outRow = out + rowStart;
+        int first = 0;
+
+#ifdef USE_SSE2
+        // Two points at a time, selecting capped reduced gradients with a mask rather than a branch
+        __m128d wy2[3];
+        __m128d wz2[3];
+
+        for (int k = 0; k < 3; k++) {
+            wy2[k] = _mm_set1_pd(wy[k]);
+            wz2[k] = _mm_set1_pd(wz[k]);
+        }
+
+        __m128d maximum = _mm_set1_pd(maximumReducedGradient);
+
+        for (; first + 2 <= nx; first += 2) {
+            int x = first;
+            __m128d dx2 = _mm_loadu_pd(&dx[x]);
+            __m128d dy = WeightedSum(wy2, yRows, x);
+            __m128d dz = WeightedSum(wz2, zRows, x);
+            __m128d v;
+
+            if (laplacian) {
+                v = _mm_add_pd(_mm_add_pd(dx2, dy), dz);
+            }
+            else {
+                v = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx2, dx2), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz));
+                v = _mm_sqrt_pd(v);
+
+                if (reduced) {
+                    __m128d d = _mm_loadu_pd(&density[x]);
+                    __m128d below = _mm_cmplt_pd(v, _mm_mul_pd(maximum, d));
+
+                    v = _mm_or_pd(_mm_and_pd(below, _mm_div_pd(v, d)), _mm_andnot_pd(below, maximum));
+                }
+            }
+
+            StoreTwo(outRow + x, v);
+        }
+#endif
+
+        if (laplacian) {
+            for (int x = first; x < nx; x++) {
+                double dyy = wy[0] * yRows[0][x] + wy[1] * yRows[1][x] + wy[2] * yRows[2][x];
+                double dzz = wz[0] * zRows[0][x] + wz[1] * zRows[1][x] + wz[2] * zRows[2][x];
+
+                outRow[x] = static_cast<TO>(dx[x] + dyy + dzz);
+            }
+        }
+        else {
+            for (int x = first; x < nx; x++) {
+                double dy = wy[0] * yRows[0][x] + wy[1] * yRows[1][x] + wy[2] * yRows[2][x];
+                double dz = wz[0] * zRows[0][x] + wz[1] * zRows[1][x] + wz[2] * zRows[2][x];
+                double g = sqrt(dx[x] * dx[x] + dy * dy + dz * dz);
+
+                if (reduced) {
+                    // s = |grad rho| / (2 (3 pi^2)^(1/3) rho^(4/3))
+                    double d = density[x];
+                    g = g < maximumReducedGradient * d ? g / d : maximumReducedGradient;
+                }
+
+                outRow[x] = static_cast<TO>(g);
+            }
+        }
+    }
+}
+
+void DerivedFields::ComputePlane(DerivedFieldsWork* work, int z) {
+    void* f = work->input->GetVoidPointer(0);
+
+    switch (work->input->GetDataType()) {
+        vtkTemplateMacro(ComputePlaneOutput(work, static_cast<const VTK_TT*>(f), z));
+    }
+}
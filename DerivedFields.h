@@ -0,0 +1,127 @@
+/*=========================================================================
+
+  Name:        DerivedFields.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Fields derived from the point data fields of a volume: the
+               square (e.g. |psi|^2 of an orbital), the gradient magnitude,
+               the Laplacian, and the reduced density gradient used in
+               non-covalent interaction (NCI) analysis.
+
+               Derived fields are computed when first requested, with
+               finite difference stencils that allow the non-uniform
+               spacing of rectilinear grids.  Planes along z are computed
+               in parallel, with the stencils applied to two points at a
+               time with SSE2 when USE_SSE2 is defined.  Computed fields
+               are kept until evicted by the memory budget.
+
+               Works on uniform and rectilinear grids.
+
+=========================================================================*/
+
+
+#ifndef DERIVEDFIELDS_H
+#define DERIVEDFIELDS_H
+
+#include "MemoryBudget.h"
+
+#include <vtkCriticalSection.h>
+#include <vtkMultiThreader.h>
+#include <vtkSmartPointer.h>
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+class vtkDataArray;
+class vtkDataObject;
+class vtkDataSet;
+
+struct DerivedFieldsWork;
+
+
+class DerivedFields : public MemoryBudget::Consumer {
+public:
+    enum Type {
+        Square,
+        GradientMagnitude,
+        Laplacian,
+        ReducedDensityGradient,
+        NumberOfTypes
+    };
+
+    // Can fields of the volume be derived?
+    static bool IsSupported(vtkDataObject* volume);
+
+    DerivedFields(vtkDataObject* volume);
+    virtual ~DerivedFields();
+
+    // Define the derived fields of a base field, appending their names
+    void Define(const std::string& baseName, std::vector<std::string>& names);
+
+    // Is the name that of a derived field, and if so, of which base field?
+    bool IsDerived(const std::string& name);
+    std::string GetBaseName(const std::string& name);
+
+    // Get a derived field, computing it from the base field's array if not kept.  Thread safe.
+    vtkDataArray* GetField(const std::string& name, vtkDataArray* base);
+
+    // Set the field in use, which is accounted with the volume and not evicted, or "" for none
+    void SetFieldInUse(const std::string& name);
+
+    // MemoryBudget::Consumer interface.  Evicting drops the least recently used field not in use.
+    virtual unsigned long GetMemorySize();
+    virtual bool Evict();
+
+protected:
+    struct Definition {
+        std::string baseName;
+        Type type;
+    };
+
+    struct Entry {
+        std::string name;
+        vtkSmartPointer<vtkDataArray> array;
+    };
+
+    // Finite difference coefficients along an axis.  The first and second derivatives at point i
+    // are weighted sums of the values at points index[i], index[i] + 1, and index[i] + 2.
+    struct Stencil {
+        std::vector<int> index;
+        std::vector<double> first[3];
+        std::vector<double> second[3];
+    };
+
+    int dimensions[3];
+    Stencil stencils[3];
+
+    std::map<std::string, Definition> definitions;
+
+    // Computed fields, most recently used first
+    std::list<Entry> entries;
+    std::string fieldInUse;
+
+    vtkSimpleCriticalSection lock;
+
+    // Compute a field in parallel
+    vtkSmartPointer<vtkDataArray> Compute(Type type, vtkDataArray* base);
+
+    // Compute one plane of a field, for each type of base field and output
+    void ComputePlane(DerivedFieldsWork* work, int z);
+
+    template <class T>
+    void ComputePlaneOutput(DerivedFieldsWork* work, const T* f, int z);
+
+    template <class T, class TO>
+    void ComputePlane(DerivedFieldsWork* work, const T* f, TO* out, int z);
+
+    // Thread entry point
+    static VTK_THREAD_RETURN_TYPE ComputePlanes(void* arg);
+};
+
+
+#endif
@@ -0,0 +1,732 @@
+/*=========================================================================
+
+  Name:        FeatureLabels.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Connected component labeling of a volume at a threshold,
+               in parallel slabs, with incremental updates when the
+               threshold changes.
+
+=========================================================================*/
+
+
+#include "FeatureLabels.h"
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkRectilinearGrid.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+
+// Work shared by the threads running a slab method
+struct FeatureLabelsWork {
+    FeatureLabels* labels;
+    void (FeatureLabels::*method)(int);
+    const std::vector<int>* slabs;
+    int next;
+    vtkSimpleCriticalSection lock;
+};
+
+
+// Serial numbers, as labels can be created on worker threads
+static int nextSerial = 0;
+static vtkSimpleCriticalSection serialLock;
+
+
+// Union-find with path halving.  The smaller label becomes the root.
+static int FindRoot(std::vector<int>& parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+
+    return i;
+}
+
+static void Join(std::vector<int>& parent, int a, int b) {
+    a = FindRoot(parent, a);
+    b = FindRoot(parent, b);
+
+    if (a < b) {
+        parent[b] = a;
+    }
+    else if (b < a) {
+        parent[a] = b;
+    }
+}
+
+
+// Classify voxels as positive (1), negative (-1), or background (0), and find the range of
+// absolute values
+template <class T>
+static void ComputeStates(const T* values, int numberOfComponents, vtkIdType begin, vtkIdType end,
+                          double threshold, signed char* states, double& minMagnitude, double& maxMagnitude) {
+    minMagnitude = VTK_DOUBLE_MAX;
+    maxMagnitude = 0.0;
+
+    const T* v = values + begin * numberOfComponents;
+
+    for (vtkIdType i = begin; i < end; i++, v += numberOfComponents) {
+        double value = (double)*v;
+        double magnitude = fabs(value);
+
+        minMagnitude = std::min(minMagnitude, magnitude);
+        maxMagnitude = std::max(maxMagnitude, magnitude);
+
+        if (value >= threshold) {
+            *states++ = 1;
+        }
+        else if (value <= -threshold) {
+            *states++ = -1;
+        }
+        else {
+            *states++ = 0;
+        }
+    }
+}
+
+
+bool FeatureLabels::IsSupported(vtkDataObject* volume) {
+    vtkDataSet* data = NULL;
+    if (vtkImageData::SafeDownCast(volume)) {
+        data = vtkImageData::SafeDownCast(volume);
+    }
+    else if (vtkRectilinearGrid::SafeDownCast(volume)) {
+        data = vtkRectilinearGrid::SafeDownCast(volume);
+    }
+
+    return data && data->GetPointData()->GetScalars();
+}
+
+
+FeatureLabels::FeatureLabels(vtkDataObject* volume, FeatureTracker* tracker)
+: tracker(tracker) {
+    serialLock.Lock();
+    serial = nextSerial++;
+    serialLock.Unlock();
+
+    this->volume = vtkDataSet::SafeDownCast(volume);
+    scalars = this->volume->GetPointData()->GetScalars();
+
+
+    // Voxel coordinates along each axis, for finding the cell containing a point
+    vtkImageData* image = vtkImageData::SafeDownCast(volume);
+    vtkRectilinearGrid* grid = vtkRectilinearGrid::SafeDownCast(volume);
+
+    if (image) {
+        image->GetDimensions(dimensions);
+
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < dimensions[i]; j++) {
+                coordinates[i].push_back(image->GetOrigin()[i] + j * image->GetSpacing()[i]);
+            }
+        }
+    }
+    else {
+        grid->GetDimensions(dimensions);
+
+        vtkDataArray* axes[3] = { grid->GetXCoordinates(), grid->GetYCoordinates(), grid->GetZCoordinates() };
+
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < dimensions[i]; j++) {
+                coordinates[i].push_back(axes[i]->GetTuple1(j));
+            }
+        }
+    }
+
+
+    // Thin slabs, so a threshold change only relabels where values are near the thresholds
+    slabThickness = 8;
+
+    for (int z = 0; z < dimensions[2]; z += slabThickness) {
+        Slab slab;
+        slab.zStart = z;
+        slab.zEnd = std::min(z + slabThickness, dimensions[2]);
+        slab.rangeKnown = false;
+        slab.minMagnitude = slab.maxMagnitude = 0.0;
+        slab.start = 0;
+        slab.boundaryValid = false;
+
+        slabs.push_back(slab);
+    }
+
+    labels.assign((vtkIdType)dimensions[0] * dimensions[1] * dimensions[2], 0);
+
+    componentSign.assign(1, 0);
+    componentSize.assign(1, 0);
+    componentTrack.assign(1, 0);
+
+    threshold = labeledThreshold = 0.0;
+    labeled = false;
+    generation = 0;
+
+    lastEvents.births = lastEvents.deaths = lastEvents.merges = lastEvents.splits = 0;
+
+    keepPairs = false;
+    otherTracks = NULL;
+    voxelTracks = NULL;
+}
+
+FeatureLabels::~FeatureLabels() {
+}
+
+
+int FeatureLabels::GetSerial() {
+    return serial;
+}
+
+int FeatureLabels::GetGeneration() {
+    return generation;
+}
+
+
+double FeatureLabels::GetThreshold() {
+    return threshold;
+}
+
+void FeatureLabels::SetThreshold(double value) {
+    threshold = fabs(value);
+}
+
+
+void FeatureLabels::Update() {
+    lock.Lock();
+
+    if (labeled && threshold == labeledThreshold) {
+        lock.Unlock();
+        return;
+    }
+
+    bool incremental = labeled;
+    double low = std::min(threshold, labeledThreshold);
+    double high = std::max(threshold, labeledThreshold);
+
+
+    // Keep the old components to carry over their tracks
+    std::vector<int> oldStart;
+    for (int i = 0; i < (int)slabs.size(); i++) {
+        oldStart.push_back(slabs[i].start);
+    }
+
+    std::vector<int> oldComponentOf;
+    std::vector<int> oldComponentTrack;
+    oldComponentOf.swap(componentOf);
+    oldComponentTrack.swap(componentTrack);
+
+    std::set<int> previousTracks;
+    if (incremental) {
+        previousTracks.insert(oldComponentTrack.begin() + 1, oldComponentTrack.end());
+    }
+
+
+    // Only voxels with absolute values between the old and new thresholds change
+    labeledThreshold = threshold;
+
+    std::vector<int> changed;
+    std::vector<bool> isChanged(slabs.size(), false);
+
+    for (int i = 0; i < (int)slabs.size(); i++) {
+        if (!incremental || !slabs[i].rangeKnown ||
+            (slabs[i].maxMagnitude >= low && slabs[i].minMagnitude < high)) {
+            changed.push_back(i);
+            isChanged[i] = true;
+        }
+    }
+
+    keepPairs = incremental;
+    RunSlabs(&FeatureLabels::LabelSlab, changed);
+    keepPairs = false;
+
+
+    // Boundaries next to changed slabs
+    for (int i = 0; i < (int)changed.size(); i++) {
+        slabs[changed[i]].boundaryValid = false;
+
+        if (changed[i] + 1 < (int)slabs.size()) {
+            slabs[changed[i] + 1].boundaryValid = false;
+        }
+    }
+
+    std::vector<int> boundaries;
+    for (int i = 1; i < (int)slabs.size(); i++) {
+        if (!slabs[i].boundaryValid) {
+            boundaries.push_back(i);
+        }
+    }
+
+    RunSlabs(&FeatureLabels::FindBoundary, boundaries);
+
+    JoinSlabs();
+
+
+    // Carry over tracks by overlap.  Labels of unchanged slabs are the same, so their overlap is
+    // their size.
+    FeatureTracker::Overlaps overlaps;
+
+    if (incremental) {
+        for (int i = 0; i < (int)slabs.size(); i++) {
+            Slab& slab = slabs[i];
+
+            if (isChanged[i]) {
+                for (std::map<std::pair<int, int>, int>::iterator it = slab.pairs.begin(); it != slab.pairs.end(); it++) {
+                    int oldComponent = oldComponentOf[oldStart[i] + it->first.first - 1];
+                    int component = componentOf[slab.start + it->first.second - 1];
+
+                    overlaps[std::make_pair(component, oldComponentTrack[oldComponent])] += it->second;
+                }
+
+                slab.pairs.clear();
+            }
+            else {
+                for (int j = 0; j < (int)slab.sizes.size(); j++) {
+                    int oldComponent = oldComponentOf[oldStart[i] + j];
+                    int component = componentOf[slab.start + j];
+
+                    overlaps[std::make_pair(component, oldComponentTrack[oldComponent])] += slab.sizes[j];
+                }
+            }
+        }
+    }
+
+    lastEvents = tracker->AssignTracks(overlaps, GetNumberOfComponents(), previousTracks, componentTrack);
+
+    labeled = true;
+    generation++;
+
+    lock.Unlock();
+}
+
+
+FeatureTracker::Events FeatureLabels::GetLastEvents() {
+    return lastEvents;
+}
+
+
+void FeatureLabels::GetDimensions(int dims[3]) {
+    for (int i = 0; i < 3; i++) {
+        dims[i] = dimensions[i];
+    }
+}
+
+
+int FeatureLabels::GetNumberOfComponents() {
+    return (int)componentSign.size() - 1;
+}
+
+int FeatureLabels::GetComponentSign(int component) {
+    return componentSign[component];
+}
+
+int FeatureLabels::GetComponentTrack(int component) {
+    return componentTrack[component];
+}
+
+
+void FeatureLabels::SetTracks(const std::vector<int>& tracks) {
+    lock.Lock();
+
+    componentTrack = tracks;
+    generation++;
+
+    lock.Unlock();
+}
+
+
+int FeatureLabels::GetTrack(const double point[3], int sign) {
+    // Cell containing the point
+    int cell[3];
+    for (int i = 0; i < 3; i++) {
+        const std::vector<double>& c = coordinates[i];
+
+        cell[i] = (int)(std::upper_bound(c.begin(), c.end(), point[i]) - c.begin()) - 1;
+        cell[i] = std::max(0, std::min(cell[i], dimensions[i] - 2));
+    }
+
+    // A surface point lies on a cell edge with a corner inside the lobe
+    for (int corner = 0; corner < 8; corner++) {
+        int x = std::min(cell[0] + (corner & 1), dimensions[0] - 1);
+        int y = std::min(cell[1] + ((corner >> 1) & 1), dimensions[1] - 1);
+        int z = std::min(cell[2] + ((corner >> 2) & 1), dimensions[2] - 1);
+
+        int component = GetComponent(((vtkIdType)z * dimensions[1] + y) * dimensions[0] + x);
+
+        if (component > 0 && componentSign[component] == sign) {
+            return componentTrack[component];
+        }
+    }
+
+    return 0;
+}
+
+
+void FeatureLabels::GetVoxelTracks(std::vector<int>& tracks) {
+    lock.Lock();
+
+    tracks.resize(labels.size());
+
+    std::vector<int> all;
+    for (int i = 0; i < (int)slabs.size(); i++) {
+        all.push_back(i);
+    }
+
+    voxelTracks = &tracks;
+    RunSlabs(&FeatureLabels::FillVoxelTracks, all);
+    voxelTracks = NULL;
+
+    lock.Unlock();
+}
+
+
+void FeatureLabels::GetOverlaps(const std::vector<int>& tracks, FeatureTracker::Overlaps& overlaps) {
+    lock.Lock();
+
+    std::vector<int> all;
+    for (int i = 0; i < (int)slabs.size(); i++) {
+        all.push_back(i);
+    }
+
+    otherTracks = &tracks;
+    RunSlabs(&FeatureLabels::CountOverlaps, all);
+    otherTracks = NULL;
+
+    for (int i = 0; i < (int)slabs.size(); i++) {
+        for (std::map<std::pair<int, int>, int>::iterator it = slabs[i].pairs.begin(); it != slabs[i].pairs.end(); it++) {
+            overlaps[it->first] += it->second;
+        }
+
+        slabs[i].pairs.clear();
+    }
+
+    lock.Unlock();
+}
+
+
+unsigned long FeatureLabels::GetMemorySize() {
+    unsigned long size = labels.capacity() * sizeof(int) +
+                         (componentOf.capacity() + componentSign.capacity() +
+                          componentSize.capacity() + componentTrack.capacity()) * sizeof(int);
+
+    return size / 1024;
+}
+
+bool FeatureLabels::Evict() {
+    return false;
+}
+
+
+void FeatureLabels::RunSlabs(void (FeatureLabels::*method)(int), const std::vector<int>& slabIndices) {
+    if (slabIndices.empty()) {
+        return;
+    }
+
+    FeatureLabelsWork work;
+    work.labels = this;
+    work.method = method;
+    work.slabs = &slabIndices;
+    work.next = 0;
+
+    vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+    threader->SetNumberOfThreads(std::min(vtkMultiThreader::GetGlobalDefaultNumberOfThreads(), (int)slabIndices.size()));
+    threader->SetSingleMethod(RunSlabsThread, &work);
+    threader->SingleMethodExecute();
+}
+
+VTK_THREAD_RETURN_TYPE FeatureLabels::RunSlabsThread(void* arg) {
+    vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    FeatureLabelsWork* work = static_cast<FeatureLabelsWork*>(info->UserData);
+
+    // Take slabs from the shared list until none are left
+    for (;;) {
+        work->lock.Lock();
+        int i = work->next++;
+        work->lock.Unlock();
+
+        if (i >= (int)work->slabs->size()) {
+            break;
+        }
+
+        (work->labels->*(work->method))((*work->slabs)[i]);
+    }
+
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+
+void FeatureLabels::LabelSlab(int index) {
+    Slab& slab = slabs[index];
+
+    int nx = dimensions[0];
+    int ny = dimensions[1];
+    vtkIdType planeSize = (vtkIdType)nx * ny;
+    vtkIdType begin = slab.zStart * planeSize;
+    vtkIdType end = slab.zEnd * planeSize;
+    vtkIdType count = end - begin;
+
+
+    // Classify voxels
+    std::vector<signed char> states(count);
+    double minMagnitude, maxMagnitude;
+
+    switch (scalars->GetDataType()) {
+        vtkTemplateMacro(ComputeStates(static_cast<VTK_TT*>(scalars->GetVoidPointer(0)),
+                                       scalars->GetNumberOfComponents(), begin, end, labeledThreshold,
+                                       &states[0], minMagnitude, maxMagnitude));
+    }
+
+    slab.minMagnitude = minMagnitude;
+    slab.maxMagnitude = maxMagnitude;
+    slab.rangeKnown = true;
+
+
+    // First pass: provisional labels, joined with earlier neighbors of the same sign
+    std::vector<int> provisional(count, 0);
+    std::vector<int> parent(1, 0);
+    std::vector<int> sign(1, 0);
+
+    vtkIdType i = 0;
+    for (int z = slab.zStart; z < slab.zEnd; z++) {
+        for (int y = 0; y < ny; y++) {
+            for (int x = 0; x < nx; x++, i++) {
+                int state = states[i];
+
+                if (state == 0) {
+                    continue;
+                }
+
+                int label = 0;
+
+                vtkIdType neighbors[3];
+                int numberOfNeighbors = 0;
+
+                if (x > 0) neighbors[numberOfNeighbors++] = i - 1;
+                if (y > 0) neighbors[numberOfNeighbors++] = i - nx;
+                if (z > slab.zStart) neighbors[numberOfNeighbors++] = i - planeSize;
+
+                for (int j = 0; j < numberOfNeighbors; j++) {
+                    if (states[neighbors[j]] == state) {
+                        if (label == 0) {
+                            label = provisional[neighbors[j]];
+                        }
+                        else {
+                            Join(parent, label, provisional[neighbors[j]]);
+                        }
+                    }
+                }
+
+                if (label == 0) {
+                    label = (int)parent.size();
+                    parent.push_back(label);
+                    sign.push_back(state);
+                }
+
+                provisional[i] = label;
+            }
+        }
+    }
+
+
+    // Second pass: compact labels, counting overlaps with the old labels for carrying over tracks
+    std::vector<int> compact(parent.size(), 0);
+
+    slab.signs.clear();
+    slab.sizes.clear();
+    slab.pairs.clear();
+
+    std::pair<int, int> run(0, 0);
+    int runLength = 0;
+
+    for (i = 0; i < count; i++) {
+        int oldLabel = labels[begin + i];
+        int label = 0;
+
+        if (provisional[i] != 0) {
+            int root = FindRoot(parent, provisional[i]);
+
+            if (compact[root] == 0) {
+                slab.signs.push_back(sign[root]);
+                slab.sizes.push_back(0);
+                compact[root] = (int)slab.signs.size();
+            }
+
+            label = compact[root];
+            slab.sizes[label - 1]++;
+        }
+
+        labels[begin + i] = label;
+
+        if (keepPairs && oldLabel != 0 && label != 0) {
+            // Runs of the same pair are common, so avoid a map lookup per voxel
+            std::pair<int, int> pair(oldLabel, label);
+
+            if (pair != run) {
+                if (runLength > 0) {
+                    slab.pairs[run] += runLength;
+                }
+
+                run = pair;
+                runLength = 0;
+            }
+
+            runLength++;
+        }
+    }
+
+    if (runLength > 0) {
+        slab.pairs[run] += runLength;
+    }
+}
+
+
+void FeatureLabels::FindBoundary(int index) {
+    Slab& slab = slabs[index];
+    Slab& previous = slabs[index - 1];
+
+    vtkIdType planeSize = (vtkIdType)dimensions[0] * dimensions[1];
+    vtkIdType plane = slab.zStart * planeSize;
+
+    slab.boundary.clear();
+
+    for (vtkIdType i = 0; i < planeSize; i++) {
+        int a = labels[plane + i];
+        int b = labels[plane - planeSize + i];
+
+        if (a != 0 && b != 0 && slab.signs[a - 1] == previous.signs[b - 1]) {
+            std::pair<int, int> pair(a, b);
+
+            if (slab.boundary.empty() || slab.boundary.back() != pair) {
+                slab.boundary.push_back(pair);
+            }
+        }
+    }
+
+    std::sort(slab.boundary.begin(), slab.boundary.end());
+    slab.boundary.erase(std::unique(slab.boundary.begin(), slab.boundary.end()), slab.boundary.end());
+
+    slab.boundaryValid = true;
+}
+
+
+void FeatureLabels::CountOverlaps(int index) {
+    Slab& slab = slabs[index];
+
+    vtkIdType planeSize = (vtkIdType)dimensions[0] * dimensions[1];
+    vtkIdType begin = slab.zStart * planeSize;
+    vtkIdType end = slab.zEnd * planeSize;
+
+    slab.pairs.clear();
+
+    std::pair<int, int> run(0, 0);
+    int runLength = 0;
+
+    for (vtkIdType i = begin; i < end; i++) {
+        int component = GetComponent(i);
+        int track = (*otherTracks)[i];
+
+        if (component == 0 || track == 0 || (track > 0 ? 1 : -1) != componentSign[component]) {
+            continue;
+        }
+
+        std::pair<int, int> pair(component, abs(track));
+
+        if (pair != run) {
+            if (runLength > 0) {
+                slab.pairs[run] += runLength;
+            }
+
+            run = pair;
+            runLength = 0;
+        }
+
+        runLength++;
+    }
+
+    if (runLength > 0) {
+        slab.pairs[run] += runLength;
+    }
+}
+
+
+void FeatureLabels::FillVoxelTracks(int index) {
+    Slab& slab = slabs[index];
+
+    vtkIdType planeSize = (vtkIdType)dimensions[0] * dimensions[1];
+    vtkIdType begin = slab.zStart * planeSize;
+    vtkIdType end = slab.zEnd * planeSize;
+
+    for (vtkIdType i = begin; i < end; i++) {
+        int component = GetComponent(i);
+
+        (*voxelTracks)[i] = component > 0 ? componentSign[component] * componentTrack[component] : 0;
+    }
+}
+
+
+void FeatureLabels::JoinSlabs() {
+    // Number the labels of all slabs consecutively
+    int total = 0;
+    for (int i = 0; i < (int)slabs.size(); i++) {
+        slabs[i].start = total;
+        total += (int)slabs[i].signs.size();
+    }
+
+
+    // Join labels connected across slab boundaries
+    std::vector<int> parent(total);
+    for (int i = 0; i < total; i++) {
+        parent[i] = i;
+    }
+
+    for (int i = 1; i < (int)slabs.size(); i++) {
+        const std::vector<std::pair<int, int> >& boundary = slabs[i].boundary;
+
+        for (int j = 0; j < (int)boundary.size(); j++) {
+            Join(parent, slabs[i].start + boundary[j].first - 1, slabs[i - 1].start + boundary[j].second - 1);
+        }
+    }
+
+
+    // Number the components
+    std::vector<int> rootComponent(total, 0);
+
+    componentOf.assign(total, 0);
+    componentSign.assign(1, 0);
+    componentSize.assign(1, 0);
+
+    for (int i = 0; i < (int)slabs.size(); i++) {
+        for (int j = 0; j < (int)slabs[i].signs.size(); j++) {
+            int label = slabs[i].start + j;
+            int root = FindRoot(parent, label);
+
+            if (rootComponent[root] == 0) {
+                rootComponent[root] = (int)componentSign.size();
+                componentSign.push_back(slabs[i].signs[j]);
+                componentSize.push_back(0);
+            }
+
+            int component = rootComponent[root];
+
+            componentOf[label] = component;
+            componentSize[component] += slabs[i].sizes[j];
+        }
+    }
+}
+
+
+int FeatureLabels::GetComponent(vtkIdType index) {
+    int label = labels[index];
+
+    if (label == 0) {
+        return 0;
+    }
+
+    int z = (int)(index / ((vtkIdType)dimensions[0] * dimensions[1]));
+
+    return componentOf[slabs[z / slabThickness].start + label - 1];
+}
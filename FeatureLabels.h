@@ -0,0 +1,173 @@
+/*=========================================================================
+
+  Name:        FeatureLabels.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Connected component labeling of a volume at a threshold.
+               Voxels with values at or above the threshold form positive
+               components, and those at or below minus the threshold form
+               negative components, with 6-connectivity.
+
+               The volume is split into slabs along z that are labeled in
+               parallel and then joined across slab boundaries.  When the
+               threshold changes, only slabs with values between the old
+               and new thresholds are labeled again, and components keep
+               the tracks of the old components they overlap.
+
+               Works on uniform and rectilinear grids.
+
+=========================================================================*/
+
+
+#ifndef FEATURELABELS_H
+#define FEATURELABELS_H
+
+#include "FeatureTracker.h"
+#include "MemoryBudget.h"
+
+#include <vtkCriticalSection.h>
+#include <vtkMultiThreader.h>
+#include <vtkSmartPointer.h>
+
+#include <map>
+#include <vector>
+
+class vtkDataArray;
+class vtkDataObject;
+class vtkDataSet;
+
+
+class FeatureLabels : public MemoryBudget::Consumer {
+public:
+    // Can the volume be labeled?
+    static bool IsSupported(vtkDataObject* volume);
+
+    FeatureLabels(vtkDataObject* volume, FeatureTracker* tracker);
+    virtual ~FeatureLabels();
+
+    // Unique for each object, so labels of different volumes can be told apart
+    int GetSerial();
+
+    // Incremented each time the labels change
+    int GetGeneration();
+
+    // Set the threshold to label at.  Labeling is done by Update().
+    double GetThreshold();
+    void SetThreshold(double threshold);
+
+    // Label at the current threshold, if not done already.  Thread safe.
+    void Update();
+
+    // Changes to tracks caused by the last update
+    FeatureTracker::Events GetLastEvents();
+
+    void GetDimensions(int dimensions[3]);
+
+    // Components are numbered from 1, with 0 the background
+    int GetNumberOfComponents();
+    int GetComponentSign(int component);
+    int GetComponentTrack(int component);
+
+    // Set the tracks of all components, indexed by component
+    void SetTracks(const std::vector<int>& tracks);
+
+    // Get the track of a lobe of the given sign at a point on its surface, or 0 if none.  Looks at
+    // the corners of the cell containing the point.
+    int GetTrack(const double point[3], int sign);
+
+    // Get the track of each voxel, negative for negative lobes and 0 for the background
+    void GetVoxelTracks(std::vector<int>& tracks);
+
+    // Get the overlap of each component with the signed tracks of another labeling of the same size
+    void GetOverlaps(const std::vector<int>& tracks, FeatureTracker::Overlaps& overlaps);
+
+    // MemoryBudget::Consumer interface.  Labels can't be evicted, as tracks would be lost.
+    virtual unsigned long GetMemorySize();
+    virtual bool Evict();
+
+protected:
+    struct Slab {
+        // Range of planes along z
+        int zStart;
+        int zEnd;
+
+        // Range of absolute values, to tell if a threshold change affects the slab
+        bool rangeKnown;
+        double minMagnitude;
+        double maxMagnitude;
+
+        // Sign and number of voxels of each label in the slab, indexed by label - 1
+        std::vector<int> signs;
+        std::vector<int> sizes;
+
+        // First global label
+        int start;
+
+        // Pairs of connected labels in this slab and the previous one
+        std::vector<std::pair<int, int> > boundary;
+        bool boundaryValid;
+
+        // Voxel counts of label pairs, used while updating and matching
+        std::map<std::pair<int, int>, int> pairs;
+    };
+
+    vtkSmartPointer<vtkDataSet> volume;
+    vtkDataArray* scalars;
+
+    int dimensions[3];
+    std::vector<double> coordinates[3];
+
+    // Label of each voxel within its slab, or 0 for the background
+    std::vector<int> labels;
+
+    std::vector<Slab> slabs;
+    int slabThickness;
+
+    // Component of each global label, and sign, size, and track of each component
+    std::vector<int> componentOf;
+    std::vector<int> componentSign;
+    std::vector<int> componentSize;
+    std::vector<int> componentTrack;
+
+    double threshold;
+    double labeledThreshold;
+    bool labeled;
+
+    int serial;
+    int generation;
+
+    FeatureTracker::Events lastEvents;
+
+    FeatureTracker* tracker;
+
+    vtkSimpleCriticalSection lock;
+
+    // Temporaries for slab methods run in parallel
+    bool keepPairs;
+    const std::vector<int>* otherTracks;
+    std::vector<int>* voxelTracks;
+
+    // Run a method on the given slabs in parallel
+    void RunSlabs(void (FeatureLabels::*method)(int), const std::vector<int>& slabIndices);
+
+    // Slab methods
+    void LabelSlab(int slab);
+    void FindBoundary(int slab);
+    void CountOverlaps(int slab);
+    void FillVoxelTracks(int slab);
+
+    // Join slabs into components
+    void JoinSlabs();
+
+    // Component of a voxel
+    int GetComponent(vtkIdType index);
+
+    // Thread entry point
+    static VTK_THREAD_RETURN_TYPE RunSlabsThread(void* arg);
+};
+
+
+#endif
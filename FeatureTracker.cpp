@@ -0,0 +1,212 @@
+/*=========================================================================
+
+  Name:        FeatureTracker.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Follows positive and negative lobes through time by voxel
+               overlap.
+
+=========================================================================*/
+
+
+#include "FeatureTracker.h"
+
+#include "FeatureLabels.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+
+
+FeatureTracker::FeatureTracker(MemoryBudget* memoryBudget)
+: memoryBudget(memoryBudget) {
+    nextTrack = 1;
+
+    Reset();
+
+    // Only needed to continue tracks, so drop before anything shown
+    memoryBudget->AddConsumer("Feature track history", this, -1);
+}
+
+FeatureTracker::~FeatureTracker() {
+    memoryBudget->RemoveConsumer(this);
+}
+
+
+int FeatureTracker::NewTrack() {
+    lock.Lock();
+    int track = nextTrack++;
+    lock.Unlock();
+
+    return track;
+}
+
+
+FeatureTracker::Events FeatureTracker::AssignTracks(const Overlaps& overlaps, int numberOfComponents,
+                                                    const std::set<int>& previousTracks, std::vector<int>& tracks) {
+    Events events;
+    events.births = events.deaths = events.merges = events.splits = 0;
+
+    tracks.assign(numberOfComponents + 1, 0);
+
+
+    // Count matches of each component and previous track, and order by overlap
+    std::vector<int> componentMatches(numberOfComponents + 1, 0);
+    std::map<int, int> trackMatches;
+
+    std::vector<std::pair<int, std::pair<int, int> > > order;
+
+    for (Overlaps::const_iterator it = overlaps.begin(); it != overlaps.end(); it++) {
+        componentMatches[it->first.first]++;
+        trackMatches[it->first.second]++;
+
+        order.push_back(std::make_pair(it->second, it->first));
+    }
+
+    std::sort(order.begin(), order.end(), std::greater<std::pair<int, std::pair<int, int> > >());
+
+
+    // Each previous track continues with the component it overlaps most, so merged lobes keep the
+    // largest contributor's track and split lobes keep it for the largest piece
+    std::set<int> used;
+
+    for (int i = 0; i < (int)order.size(); i++) {
+        int component = order[i].second.first;
+        int track = order[i].second.second;
+
+        if (tracks[component] == 0 && used.find(track) == used.end()) {
+            tracks[component] = track;
+            used.insert(track);
+        }
+    }
+
+    for (int i = 1; i <= numberOfComponents; i++) {
+        if (componentMatches[i] == 0) {
+            events.births++;
+        }
+        else if (componentMatches[i] > 1) {
+            events.merges++;
+        }
+
+        if (tracks[i] == 0) {
+            tracks[i] = NewTrack();
+        }
+    }
+
+    for (std::set<int>::const_iterator it = previousTracks.begin(); it != previousTracks.end(); it++) {
+        std::map<int, int>::iterator match = trackMatches.find(*it);
+
+        if (match == trackMatches.end()) {
+            events.deaths++;
+        }
+        else if (match->second > 1) {
+            events.splits++;
+        }
+    }
+
+    return events;
+}
+
+
+bool FeatureTracker::Match(int level, FeatureLabels* labels) {
+    labels->Update();
+
+    Snapshot& snapshot = snapshots[level];
+
+    if (labels->GetSerial() == snapshot.serial && labels->GetGeneration() == snapshot.generation) {
+        // Already matched
+        return false;
+    }
+
+    std::string context = level == 0 ? "Isovalue 1 lobes" : "Isovalue 2 lobes";
+
+    int dimensions[3];
+    labels->GetDimensions(dimensions);
+
+    bool changed = false;
+
+    if (labels->GetSerial() != snapshot.serial) {
+        // A new volume, so continue the tracks of the last one if on the same grid
+        if (!snapshot.tracks.empty() &&
+            dimensions[0] == snapshot.dimensions[0] &&
+            dimensions[1] == snapshot.dimensions[1] &&
+            dimensions[2] == snapshot.dimensions[2]) {
+            Overlaps overlaps;
+            labels->GetOverlaps(snapshot.tracks, overlaps);
+
+            std::vector<int> tracks;
+            Events events = AssignTracks(overlaps, labels->GetNumberOfComponents(), snapshot.trackIds, tracks);
+
+            labels->SetTracks(tracks);
+
+            PrintEvents(context + ", new volume", events);
+
+            changed = true;
+        }
+    }
+    else {
+        // The same volume at a new isovalue, with tracks already carried over
+        PrintEvents(context + ", isovalue change", labels->GetLastEvents());
+    }
+
+
+    // Remember for the next match
+    snapshot.serial = labels->GetSerial();
+    snapshot.generation = labels->GetGeneration();
+
+    for (int i = 0; i < 3; i++) {
+        snapshot.dimensions[i] = dimensions[i];
+    }
+
+    labels->GetVoxelTracks(snapshot.tracks);
+
+    snapshot.trackIds.clear();
+    for (int i = 1; i <= labels->GetNumberOfComponents(); i++) {
+        snapshot.trackIds.insert(labels->GetComponentTrack(i));
+    }
+
+    return changed;
+}
+
+
+void FeatureTracker::Reset() {
+    for (int i = 0; i < 2; i++) {
+        snapshots[i].serial = -1;
+        snapshots[i].generation = -1;
+        snapshots[i].dimensions[0] = snapshots[i].dimensions[1] = snapshots[i].dimensions[2] = 0;
+        std::vector<int>().swap(snapshots[i].tracks);
+        snapshots[i].trackIds.clear();
+    }
+}
+
+
+void FeatureTracker::PrintEvents(const std::string& context, const Events& events) {
+    std::cout << "FeatureTracker: " << context << ": "
+              << events.births << " births, "
+              << events.deaths << " deaths, "
+              << events.merges << " merges, "
+              << events.splits << " splits" << std::endl;
+}
+
+
+unsigned long FeatureTracker::GetMemorySize() {
+    unsigned long size = 0;
+    for (int i = 0; i < 2; i++) {
+        size += snapshots[i].tracks.capacity() * sizeof(int);
+    }
+
+    return size / 1024;
+}
+
+bool FeatureTracker::Evict() {
+    if (snapshots[0].tracks.empty() && snapshots[1].tracks.empty()) {
+        return false;
+    }
+
+    Reset();
+
+    return true;
+}
@@ -0,0 +1,91 @@
+/*=========================================================================
+
+  Name:        FeatureTracker.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Follows positive and negative lobes through time.  Each
+               lobe, a connected region beyond an isovalue, gets a track
+               ID.  Lobes of a newly shown volume are matched to those of
+               the previously shown volume by voxel overlap, so a lobe
+               keeps its track ID from step to step, and births, deaths,
+               merges, and splits are reported.  One tracker is shared by
+               all pipelines so track IDs are unique.
+
+=========================================================================*/
+
+
+#ifndef FEATURETRACKER_H
+#define FEATURETRACKER_H
+
+#include "MemoryBudget.h"
+
+#include <vtkCriticalSection.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class FeatureLabels;
+
+
+class FeatureTracker : public MemoryBudget::Consumer {
+public:
+    // Changes between two labelings
+    struct Events {
+        int births;
+        int deaths;
+        int merges;
+        int splits;
+    };
+
+    // Voxel overlap between each (component, previous track) pair
+    typedef std::map<std::pair<int, int>, int> Overlaps;
+
+    FeatureTracker(MemoryBudget* memoryBudget);
+    virtual ~FeatureTracker();
+
+    // Get a new, unique track ID.  Thread safe.
+    int NewTrack();
+
+    // Assign each component the track it overlaps most, largest overlaps first, and new tracks to
+    // the rest.  Tracks are indexed by component, with component 0 the background.  Thread safe.
+    Events AssignTracks(const Overlaps& overlaps, int numberOfComponents,
+                        const std::set<int>& previousTracks, std::vector<int>& tracks);
+
+    // Match the labels of a newly shown volume at an isovalue level (0 or 1) to the labels last
+    // shown at that level, and remember them for the next match.  Returns true if tracks changed.
+    bool Match(int level, FeatureLabels* labels);
+
+    // Forget the last shown labels, so the next volume starts new tracks
+    void Reset();
+
+    // Print events to the console
+    static void PrintEvents(const std::string& context, const Events& events);
+
+    // MemoryBudget::Consumer interface.  Evicting forgets the last shown labels.
+    virtual unsigned long GetMemorySize();
+    virtual bool Evict();
+
+protected:
+    // Signed track of each voxel of the last shown labels, positive for positive lobes
+    struct Snapshot {
+        int serial;
+        int generation;
+        int dimensions[3];
+        std::vector<int> tracks;
+        std::set<int> trackIds;
+    };
+    Snapshot snapshots[2];
+
+    int nextTrack;
+    vtkSimpleCriticalSection lock;
+
+    MemoryBudget* memoryBudget;
+};
+
+
+#endif
@@ -1,119 +1,212 @@
-/*=========================================================================
-
-  Name:        Isosurface.cpp
-
-  Author:      David Borland, The Renaissance Computing Institute (RENCI)
-
-  Copyright:   The Renaissance Computing Institute (RENCI)
-
-  Description: Container class for an isosurface.
-
-=========================================================================*/
-
-
-#include "Isosurface.h"
-
-
-#include <vtkActor.h>
-#include <vtkAlgorithmOutput.h>
-#include <vtkContourFilter.h>
-#include <vtkPolyDataMapper.h>
-#include <vtkProperty.h>
-#include <vtkReverseSense.h>
-#include <vtkXMLMaterial.h>
-
-
-Isosurface::Isosurface(vtkAlgorithmOutput* volume, double value, bool translucent,
-                       const std::string& opaqueMaterial, const std::string& translucentMaterial) 
-	: translucent(translucent), opaqueMaterial(opaqueMaterial), translucentMaterial(translucentMaterial) {
-    // Create the isosurface
-    isosurface = vtkSmartPointer<vtkContourFilter>::New();
-    isosurface->SetInputConnection(volume);
-    isosurface->SetNumberOfContours(1);
-    isosurface->SetValue(0, value);
-    isosurface->ComputeScalarsOff();
-    isosurface->ComputeNormalsOn();
-    isosurface->ComputeGradientsOff();
-
-
-    // Mapper for the surface
-    vtkSmartPointer<vtkPolyDataMapper> mapper =  vtkSmartPointer<vtkPolyDataMapper>::New();
-
-    if (value < 0.0) {
-        // Negative value, so flip the normals
-        vtkSmartPointer<vtkReverseSense> reverse =  vtkSmartPointer<vtkReverseSense>::New();
-        reverse->SetInputConnection(isosurface->GetOutputPort());
-        reverse->ReverseCellsOff();
-        reverse->ReverseNormalsOn();
-
-        mapper->SetInputConnection(reverse->GetOutputPort());
-    }
-    else {
-        // Positive value, don't flip the normals 
-        mapper->SetInputConnection(isosurface->GetOutputPort());
-    }
-
-
-    // Actor for the surface
-    actor = vtkSmartPointer<vtkActor>::New();
-    actor->SetMapper(mapper);
-
-
-    // Appearance
-    vtkProperty* p = actor->GetProperty();
-
-    p->SetAmbient(0.1);
-
-    p->SetDiffuse(1.0);
-
-    p->SetSpecular(1.0);
-    p->SetSpecularColor(1.0, 1.0, 1.0);
-    p->SetSpecularPower(50.0);
-
-	SetTranslucent(translucent);
-    
-    p->ShadingOn();
-}
-
-Isosurface::~Isosurface() {
-}
-
-
-void Isosurface::SetInput(vtkAlgorithmOutput* volume) {
-    isosurface->SetInputConnection(volume);
-}
-
-
-vtkActor* Isosurface::GetActor() {
-    return actor;
-}
-
-vtkContourFilter* Isosurface::GetIsosurface() {
-    return isosurface;
-}
-
-
-bool Isosurface::GetTranslucent() {
-    return translucent;
-}
-
-void Isosurface::SetTranslucent(bool translucent) {
-    this->translucent = translucent;
-
-	vtkProperty* p = actor->GetProperty();
-
-	if (translucent) {
-        // Use shader for translucent surface
-        p->LoadMaterialFromString(translucentMaterial.c_str());
-		
-		// XXX: This needs to be < 1.0 (and > 0.0) to work without depth sorting for silhouetteFalloff.xml.
-		// Exactly why, I'm not sure.
-        p->SetOpacity(0.1);
-    }
-    else {
-        // Per-pixel lighting
-        p->LoadMaterialFromString(opaqueMaterial.c_str());
-
-		p->SetOpacity(1.0);
-    }
+/*=========================================================================
+
+  Name:        Isosurface.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Container class for an isosurface.
+
+=========================================================================*/
+
+
+#include "Isosurface.h"
+
+#include "vtkFeatureTrackColors.h"
+#include "vtkNestedGridContourFilter.h"
+#include "vtkPropertyColors.h"
+#include "vtkTriangleDepthSort.h"
+
+#include <vtkActor.h>
+#include <vtkAlgorithm.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkCamera.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkContourFilter.h>
+#include <vtkDataSet.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkProperty.h>
+#include <vtkReverseSense.h>
+#include <vtkScalarsToColors.h>
+#include <vtkXMLMaterial.h>
+
+
+Isosurface::Isosurface(vtkAlgorithmOutput* volume, double value, bool translucent,
+                       const std::string& opaqueMaterial, const std::string& translucentMaterial) 
+	: translucent(translucent), opaqueMaterial(opaqueMaterial), translucentMaterial(translucentMaterial) {
+    // Create the isosurface.  Nested multi-block grids are contoured per block and stitched together.
+    if (vtkCompositeDataSet::SafeDownCast(volume->GetProducer()->GetOutputDataObject(volume->GetIndex()))) {
+        isosurface = vtkSmartPointer<vtkNestedGridContourFilter>::New();
+    }
+    else {
+        isosurface = vtkSmartPointer<vtkContourFilter>::New();
+    }
+    isosurface->SetInputConnection(volume);
+    isosurface->SetNumberOfContours(1);
+    isosurface->SetValue(0, value);
+    isosurface->ComputeScalarsOff();
+    isosurface->ComputeNormalsOn();
+    isosurface->ComputeGradientsOff();
+
+
+    // Colors by lobe track, passed through unless tracking
+    trackColors = vtkSmartPointer<vtkFeatureTrackColors>::New();
+    trackColors->SetSign(value < 0.0 ? -1 : 1);
+
+    if (value < 0.0) {
+        // Negative value, so flip the normals
+        reverse =  vtkSmartPointer<vtkReverseSense>::New();
+        reverse->SetInputConnection(isosurface->GetOutputPort());
+        reverse->ReverseCellsOff();
+        reverse->ReverseNormalsOn();
+
+        trackColors->SetInputConnection(reverse->GetOutputPort());
+    }
+    else {
+        // Positive value, don't flip the normals 
+        trackColors->SetInputConnection(isosurface->GetOutputPort());
+    }
+
+
+    // Colors by property, passed through unless there is one
+    propertyColors = vtkSmartPointer<vtkPropertyColors>::New();
+    propertyColors->SetInputConnection(trackColors->GetOutputPort());
+
+
+    // Back to front order for translucency, used once given a camera
+    depthSort = vtkSmartPointer<vtkTriangleDepthSort>::New();
+    depthSort->SetInputConnection(propertyColors->GetOutputPort());
+
+
+    // Mapper for the surface
+    vtkSmartPointer<vtkPolyDataMapper> mapper =  vtkSmartPointer<vtkPolyDataMapper>::New();
+    mapper->SetInputConnection(propertyColors->GetOutputPort());
+
+
+    // Actor for the surface
+    actor = vtkSmartPointer<vtkActor>::New();
+    actor->SetMapper(mapper);
+
+
+    // Appearance
+    vtkProperty* p = actor->GetProperty();
+
+    p->SetAmbient(0.1);
+
+    p->SetDiffuse(1.0);
+
+    p->SetSpecular(1.0);
+    p->SetSpecularColor(1.0, 1.0, 1.0);
+    p->SetSpecularPower(50.0);
+
+	SetTranslucent(translucent);
+    
+    p->ShadingOn();
+}
+
+Isosurface::~Isosurface() {
+}
+
+
+void Isosurface::SetInput(vtkAlgorithmOutput* volume) {
+    isosurface->SetInputConnection(volume);
+}
+
+
+void Isosurface::SetLeanMemory(bool lean) {
+    // The contour is only needed by the normal flipper when there is one
+    isosurface->SetReleaseDataFlag(lean && reverse);
+}
+
+
+vtkActor* Isosurface::GetActor() {
+    return actor;
+}
+
+vtkContourFilter* Isosurface::GetIsosurface() {
+    return isosurface;
+}
+
+vtkReverseSense* Isosurface::GetNormalFlipper() {
+    return reverse;
+}
+
+
+void Isosurface::SetFeatureLabels(FeatureLabels* labels) {
+    trackColors->SetLabels(labels);
+
+    SetShaderColors();
+}
+
+void Isosurface::UpdateFeatureColors() {
+    trackColors->Modified();
+}
+
+
+void Isosurface::SetProperty(vtkDataSet* property, vtkScalarsToColors* colors) {
+    propertyColors->SetProperty(property);
+    propertyColors->SetLookupTable(property ? colors : NULL);
+
+    SetShaderColors();
+}
+
+
+bool Isosurface::GetTranslucent() {
+    return translucent;
+}
+
+void Isosurface::SetTranslucent(bool translucent) {
+    this->translucent = translucent;
+
+	vtkProperty* p = actor->GetProperty();
+
+	if (translucent) {
+        // Use shader for translucent surface
+        p->LoadMaterialFromString(translucentMaterial.c_str());
+		
+		// The shader computes its own alpha, but VTK only draws actors with opacity < 1.0 in the 
+		// translucent pass, which leaves the depth buffer alone and is depth peeled if enabled
+        p->SetOpacity(0.1);
+    }
+    else {
+        // Per-pixel lighting
+        p->LoadMaterialFromString(opaqueMaterial.c_str());
+
+		p->SetOpacity(1.0);
+    }
+
+    SetShaderColors();
+    UpdateMapperInput();
+}
+
+
+void Isosurface::SetDepthSortCamera(vtkCamera* camera) {
+    depthSort->SetCamera(camera);
+
+    UpdateMapperInput();
+}
+
+vtkTriangleDepthSort* Isosurface::GetDepthSort() {
+    return depthSort;
+}
+
+void Isosurface::UpdateMapperInput() {
+    // Only translucent surfaces need sorting
+    if (translucent && depthSort->GetCamera()) {
+        actor->GetMapper()->SetInputConnection(depthSort->GetOutputPort());
+    }
+    else {
+        depthSort->CancelSort();
+
+        actor->GetMapper()->SetInputConnection(propertyColors->GetOutputPort());
+    }
+}
+
+
+void Isosurface::SetShaderColors() {
+    // Loading a material resets its variables, so set after each load
+    int useVertexColors = trackColors->GetLabels() != NULL || propertyColors->GetProperty() != NULL;
+
+    actor->GetProperty()->AddShaderVariable("useVertexColors", 1, &useVertexColors);
 }
\ No newline at end of file
@@ -17,12 +17,20 @@
 
 class vtkActor;
 class vtkAlgorithmOutput;
+class vtkCamera;
 class vtkContourFilter;
+class vtkDataSet;
+class vtkFeatureTrackColors;
 class vtkPolyDataMapper;
 class vtkProperty;
+class vtkPropertyColors;
 class vtkReverseSense;
+class vtkScalarsToColors;
+class vtkTriangleDepthSort;
 class vtkXMLMaterial;
 
+class FeatureLabels;
+
 
 class Isosurface {
 public:
@@ -32,20 +40,51 @@ public:
 
     void SetInput(vtkAlgorithmOutput* volume);
 
+    // Release intermediate data not needed for rendering
+    void SetLeanMemory(bool lean);
+
     vtkActor* GetActor();
     vtkContourFilter* GetIsosurface();
 
+    // NULL for positive isovalues
+    vtkReverseSense* GetNormalFlipper();
+
+    // Color lobes by track, or use the surface color if NULL
+    void SetFeatureLabels(FeatureLabels* labels);
+
+    // Recolor after tracks change
+    void UpdateFeatureColors();
+
+    // Color by a property sampled from a second volume, or clear it if NULL.  Takes precedence
+    // over track colors.
+    void SetProperty(vtkDataSet* property, vtkScalarsToColors* colors);
+
 	bool GetTranslucent();
 	void SetTranslucent(bool translucent);
 
+    // Sort the triangles back to front from the camera while translucent, or NULL to draw them
+    // unsorted.  The order follows the camera in the background; see vtkTriangleDepthSort.
+    void SetDepthSortCamera(vtkCamera* camera);
+    vtkTriangleDepthSort* GetDepthSort();
+
 protected:
     vtkSmartPointer<vtkContourFilter> isosurface;
+    vtkSmartPointer<vtkReverseSense> reverse;
+    vtkSmartPointer<vtkFeatureTrackColors> trackColors;
+    vtkSmartPointer<vtkPropertyColors> propertyColors;
+    vtkSmartPointer<vtkTriangleDepthSort> depthSort;
     vtkSmartPointer<vtkActor> actor;
 
     std::string opaqueMaterial;
     std::string translucentMaterial;
 
 	bool translucent;
+
+    // Tell the shaders whether to use the track or property colors
+    void SetShaderColors();
+
+    // Feed the mapper sorted triangles if translucent and sorting
+    void UpdateMapperInput();
 };
 
 
@@ -1,581 +1,1636 @@
-/*=========================================================================
-
-  Name:        MainWindow.cpp
-
-  Author:      David Borland
-
-  Copyright:   The Renaissance Computing Institute (RENCI)
-
-  Description: The main window for the Voluminous visualization program
-
-=========================================================================*/
-
-
-#include "MainWindow.h"
-
-#include <QApplication>
-#include <QtConcurrentRun>
-#include <QColorDialog>
-#include <QFileDialog>
-#include <QMessageBox>
-#include <QProgressDialog>
-#include <QResource>
-#include <QTimer>
-
-#include <vtkQImageToImageSource.h>
-#include <vtkRenderWindow.h>
-
-#include <QDoubleSlider.h>
-
-#include "AboutDialog.h"
-#include "VTKPipeline.h"
-
-#include <vrpn_Tracker.h>
-
-
-static void VRPN_CALLBACK HandlePosition(void* userData, const vrpn_TRACKERCB t) {
-//    printf("%f %f %f\n", t.pos[0], t.pos[1], t.pos[2]);
-
-    VTKPipeline* pipeline = static_cast<MainWindow*>(userData)->GetVTKPipeline();
-    
-    if (!pipeline) {
-        return;
-    }
-
-    if (t.sensor == 0) {
-        pipeline->SetHeadPosition(t.pos[0], t.pos[1], t.pos[2]);
-    }
-}
-
-
-MainWindow::MainWindow(int argc, char** argv) : QMainWindow(NULL) {
-    // Create the GUI from the Qt Designer file
-    setupUi(this);
-
-
-    // Make stereo options unavailable, unless a stereo window is requested
-    menuStereo->setEnabled(false);
-
-    // No tracker by default
-    tracker = NULL;
-
-
-    // Disable the GUI until we have data
-    tabWidget->setEnabled(false);
-
-
-    // Hide the advanced controls for now
-    tabWidget->removeTab(2);
-
-    
-    // Set up double sliders
-    isovalue1DoubleSlider = new QDoubleSlider(isovalue1Slider, isovalue1SpinBox, this);
-    connect(isovalue1DoubleSlider, SIGNAL(valueChanged(double)), this, SLOT(isovalue1DoubleSlider_valueChanged(double)));
-    connect(isovalue1DoubleSlider, SIGNAL(sliderReleased()), this, SLOT(isovalue1DoubleSlider_sliderReleased()));
-
-    isovalue2DoubleSlider = new QDoubleSlider(isovalue2Slider, isovalue2SpinBox, this);
-    connect(isovalue2DoubleSlider, SIGNAL(valueChanged(double)), this, SLOT(isovalue2DoubleSlider_valueChanged(double)));
-    connect(isovalue2DoubleSlider, SIGNAL(sliderReleased()), this, SLOT(isovalue2DoubleSlider_sliderReleased()));
-
-    isovalueExponentDoubleSlider = new QDoubleSlider(isovalueExponentSlider, isovalueExponentSpinBox, this);
-    connect(isovalueExponentDoubleSlider, SIGNAL(valueChanged(double)), isovalue1DoubleSlider, SLOT(setExponent(double)));
-    connect(isovalueExponentDoubleSlider, SIGNAL(valueChanged(double)), isovalue2DoubleSlider, SLOT(setExponent(double)));
-
-
-    isovalue1DualValue->setUpdateSeparately(true);
-
-
-    connect(isovalue1ExploratorySlider, SIGNAL(valueChanged(double)), testIsovalue1SpinBox, SLOT(setValue(double)));
-    connect(testIsovalue1SpinBox, SIGNAL(valueChanged(double)), isovalue1ExploratorySlider, SLOT(setValue(double)));
-    
-
-    // Create the visualization pipeline
-    pipeline = NULL;
-    CreatePipeline();
-
-
-    // Parse command-line options
-    for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "-ActiveStereo") == 0) {
-            // Try to create a stereo-capable window
-            vtkRenderWindow* win = qvtkWidget->GetRenderWindow();
-            win->StereoCapableWindowOn();
-            win->StereoRenderOn();
-        }
-        else if (strcmp(argv[i], "-zSpace") == 0) {
-            // Try to create a stereo-capable window
-            vtkRenderWindow* win = qvtkWidget->GetRenderWindow();
-            win->StereoCapableWindowOn();
-            win->StereoRenderOn();
-
-            // Create the tracker
-            tracker = new vrpn_Tracker_Remote("Tracker0@localhost");
-            if (tracker->register_change_handler(this, HandlePosition) == -1) {
-                printf("Error: Can't register tracker callback.");
-            }
-            else {
-                // Create a timer for updating tracking
-                QTimer* timer = new QTimer(this);
-                connect(timer, SIGNAL(timeout()), this, SLOT(trackingTimer()));
-                timer->start(0);
-            }
-        }
-    }
-
-    // See if stereo is available    
-    if (qvtkWidget->GetRenderWindow()->GetStereoCapableWindow()) {
-        menuStereo->setEnabled(true);
-        actionUseStereo->setChecked(true);
-    }
-}
-
-MainWindow::~MainWindow() {
-    // Clean up
-    if (tracker) {
-        delete tracker;
-        tracker = NULL;
-    }
-
-    delete pipeline;
-    pipeline = NULL;
-}
-
-
-VTKPipeline* MainWindow::GetVTKPipeline() {
-    return pipeline;
-}
-
-
-///////////////////////////////////////////////////////////////////////////
-// Respond to menu events
-
-void MainWindow::on_actionOpenVolume_triggered() {
-    // Open a file dialog to read the VTK file
-    QString fileName = QFileDialog::getOpenFileName(this,
-                                                    "Open Volume",
-                                                    "",
-                                                    "All Files (*);;Legacy VTK Files (*.vtk);;VTK XML ImageData Files (.vti)");
-
-    // Check for file name
-    if (fileName == "") {
-        return;
-    }
-
-        
-    // Disable the GUI until we have data
-    tabWidget->setEnabled(false);
-    
-
-    // Create a new pipeline
-    CreatePipeline();
-
-
-    // Clear the screen
-    pipeline->Render();
-    
-
-    // ProgressBar.   
-    // Doing things this way because vtkStructuredPointsReader would only give one update at 50% and then 
-    // no updates until the volume was loaded, making it look frozen.  By loading the data in a thread 
-    // with a continually animated progress bar, it doesn't look like application is frozen.
-    // This code was adapted from:  http://qt-project.org/wiki/Progress-bar
-    QFutureWatcher<bool> futureWatcher;
-    QProgressDialog progressDialog("Opening " + fileName.right(fileName.length() - fileName.lastIndexOf("/") - 1), "Cancel", 0, 0, this);
-
-    connect(&futureWatcher, SIGNAL(finished()), this, SLOT(openVolumeFinished()));
-    connect(&futureWatcher, SIGNAL(finished()), &progressDialog , SLOT(cancel()));
-
-    future = QtConcurrent::run(pipeline, &VTKPipeline::OpenVolume, fileName.toStdString(), &errorMessage);
-    futureWatcher.setFuture(future);
-    
-    progressDialog.setWindowModality(Qt::WindowModal);
-    progressDialog.exec();
-}
-
-
-void MainWindow::openVolumeFinished() {
-    if (!future.result()) {
-        // Show error message
-        QMessageBox::critical(this, "Error", errorMessage.c_str());
-
-        return;
-    }
-
-    if (!pipeline->CreateVisualization(errorMessage)) {
-        QMessageBox::critical(this, "Error", errorMessage.c_str());
-
-        return;
-    }
-    
-    RefreshGUI();
-}
-
-
-
-
-void MainWindow::on_actionSaveScreenshot_triggered() {
-    // Open a file dialog to save the PNG image
-    QString fileName = QFileDialog::getSaveFileName(this,
-                                                    "Save Screenshot",
-                                                    "VoluminousScreenshot.png",
-                                                    "PNG Files (*.png)");
-
-    // Check for file name
-    if (fileName == "") {
-        return;
-    }
-
-    // Save a screenshot
-    pipeline->SaveScreenshot(fileName.toStdString());
-}
-
-void MainWindow::on_actionExit_triggered() {
-    qApp->exit();
-}
-
-
-void MainWindow::on_actionUseStereo_triggered() {
-    pipeline->SetUseStereo(actionUseStereo->isChecked());
-}
-
-void MainWindow::on_actionFlipEyes_triggered() {
-    pipeline->FlipEyes();
-}
-
-
-void MainWindow::on_actionAbout_triggered() {
-    AboutDialog about(this);
-    about.exec();
-}
-
-void MainWindow::on_actionControls_triggered() {
-    const char* message = 
-        "--Mouse--\n"
-        "Left button + drag: Rotate\n"
-        "Middle button + drag: Pan\n"
-        "Right button + drag: Zoom\n"
-        "Wheel: Zoom\n"
-        "\n"
-        "--IsovalueControls--\n"
-        "Change the two isosurface values and visibility with the associated sliders and check boxes.\n"
-        "\n"
-        "The Isovalue Exponent slider changes the output of the isovalue sliders to be based on a curve with the given exponent.\n"
-        "An exponent of 1 results in a standard linear slider.\n"
-        "\n"
-        "--Settings--\n"
-        "Set the background color and turn visualization elements on and off with the associated button and check boxes.\n"
-        "\n"
-        "The Grayscale radio button changes the color map such that it will be more suitable for printing in black and white.\n"
-        "\n"
-        "The Interactive Data Resolution slider changes the amount of downsampling applied to the volume when moving the isovalue sliders.\n"
-        "Sliding to the left provides faster rendering but with a less-accurate volume.\n"
-        "Sliding to the right provides slower rendering but with a more-accurate volume.";
-
-    QMessageBox::about(this, "Controls", message);
-}
-
-
-///////////////////////////////////////////////////////////////////////////
-// Timer events
-
-void MainWindow::trackingTimer() {
-    if (tracker) {
-        tracker->mainloop();
-    }
-}
-
-
-///////////////////////////////////////////////////////////////////////////
-// Respond to widget events
-
-void MainWindow::isovalue1DoubleSlider_valueChanged(double value) {
-    pipeline->SetIsovalue1(value, true);   
-    pipeline->Render();
-}
-
-void MainWindow::isovalue1DoubleSlider_sliderReleased() {
-    pipeline->SetIsovalue1(isovalue1DoubleSlider->value());   
-    pipeline->Render();
-}
-
-
-void MainWindow::isovalue2DoubleSlider_valueChanged(double value) {
-    pipeline->SetIsovalue2(value, true);
-    pipeline->Render();
-}
-
-void MainWindow::isovalue2DoubleSlider_sliderReleased() {
-    pipeline->SetIsovalue2(isovalue2DoubleSlider->value());   
-    pipeline->Render();
-}
-
-
-void MainWindow::on_isovalue1VisibleCheckBox_toggled(bool checked) {
-	pipeline->SetIsovalue1Visible(checked);
-    pipeline->Render();
-}
-
-void MainWindow::on_isovalue1TranslucentCheckBox_toggled(bool checked) {
-	pipeline->SetIsovalue1Translucent(checked);
-
-    pipeline->Render();
-}
-	
-void MainWindow::on_isovalue2VisibleCheckBox_toggled(bool checked) {
-	pipeline->SetIsovalue2Visible(checked);
-    pipeline->Render();
-}
-
-void MainWindow::on_isovalue2TranslucentCheckBox_toggled(bool checked) {
-	pipeline->SetIsovalue2Translucent(checked);
-    pipeline->Render();
-}
-
-
-void MainWindow::on_isovalue1DualValue_value1Changed(double value) {
-    double v1 = isovalue1DualValue->getValue1();
-    double v2 = isovalue1DualValue->getValue2();
-
-    double v = v1 * pow(10.0, v2);
-
-    pipeline->SetIsovalue1(v, true);
-
-    pipeline->Render();
-}
-
-void MainWindow::on_isovalue1DualValue_bar1Released() {
-    double v1 = isovalue1DualValue->getValue1();
-    double v2 = isovalue1DualValue->getValue2();
-
-    double v = v1 * pow(10.0, v2);
-
-    pipeline->SetIsovalue1(v);
-
-    pipeline->Render();   
-}
-
-void MainWindow::on_isovalue1DualValue_value2Changed(double value) {
-    double v1 = isovalue1DualValue->getValue1();
-    double v2 = isovalue1DualValue->getValue2();
-
-    double v = v1 * pow(10.0, v2);
-
-    pipeline->SetIsovalue1(v, true);
-
-    pipeline->Render();
-}
-
-void MainWindow::on_isovalue1DualValue_bar2Released() {
-    double v1 = isovalue1DualValue->getValue1();
-    double v2 = isovalue1DualValue->getValue2();
-
-    double v = v1 * pow(10.0, v2);
-
-    pipeline->SetIsovalue1(v);
-
-    pipeline->Render();   
-}
-
-void MainWindow::on_isovalue1DualValue_valuesChanged(QPointF values) {
-    double v1 = isovalue1DualValue->getValue1();
-    double v2 = isovalue1DualValue->getValue2();
-
-    double v = v1 * pow(10.0, v2);
-
-    pipeline->SetIsovalue1(v, true);
-
-    pipeline->Render();
-
-/*
-    if (values.y() > values.x() * 0.8) {
-        isovalue1DualValue->setValues(values.x(), values.x() * 0.8);
-    }
-    else {
-        pipeline->SetIsovalue1(values.x());
-        pipeline->SetIsovalue2(values.y());
-
-        printf("%f %f\n", values.x(), values.y());
-
-        pipeline->Render();
-    }
-*/
-}
-
-void MainWindow::on_isovalue1DualValue_handleReleased() {
-    double v1 = isovalue1DualValue->getValue1();
-    double v2 = isovalue1DualValue->getValue2();
-
-    double v = v1 * pow(10.0, v2);
-
-    pipeline->SetIsovalue1(v);
-
-    pipeline->Render();   
-}
-
-void MainWindow::on_isovalue1ExploratorySlider_valueChanged(double value) {
-    pipeline->SetIsovalue1(value, true);
-
-    pipeline->Render();
-}
-
-void MainWindow::on_isovalue1ExploratorySlider_sliderReleased() {
-    pipeline->SetIsovalue1(isovalue1ExploratorySlider->getValue());
-
-    pipeline->Render();
-}
-
-
-void MainWindow::on_setBackgroundColorButton_clicked() {
-    // Open a file dialog to read the VTK XML file
-    double rgb[3];
-    pipeline->GetBackgroundColor(rgb);
-    QColor color;
-    color.setRgbF(rgb[0], rgb[1], rgb[2]);
-    color = QColorDialog::getColor(color, this, "Choose Background Color");
-
-    if (color.isValid()) {
-        pipeline->SetBackgroundColor(color.redF(), color.greenF(), color.blueF());
-        pipeline->Render();
-    }
-}
-
-
-void MainWindow::on_colorRadioButton_toggled(bool checked) {
-    if (checked) {
-        pipeline->SetColorMapType(VTKPipeline::Color);
-        pipeline->Render();
-    }
-}
-
-void MainWindow::on_grayscaleRadioButton_toggled(bool checked) {
-    if (checked) {
-        pipeline->SetColorMapType(VTKPipeline::Grayscale);
-        pipeline->Render();
-    }
-}
-
-
-void MainWindow::on_showAxesCheckBox_toggled(bool checked) {
-    pipeline->SetShowAxes(checked);
-    pipeline->Render();
-}
-
-void MainWindow::on_showColorLegendCheckBox_toggled(bool checked) {
-    pipeline->SetShowColorLegend(checked);
-    pipeline->Render();
-}
-
-void MainWindow::on_showDataLabelCheckBox_toggled(bool checked) {
-    pipeline->SetShowDataLabel(checked);
-    pipeline->Render();
-}
-
-
-void MainWindow::on_interactiveDataResolutionSlider_valueChanged(int value)
-{
-    pipeline->SetInteractiveDataMagnification((double)value / 10);
-}
-
-
-void MainWindow::CreatePipeline() {
-    // Load the RENCI logos
-    QImage logoImage(":/logo");
-    vtkSmartPointer<vtkQImageToImageSource> logo = vtkSmartPointer<vtkQImageToImageSource>::New();
-    logo->SetQImage(&logoImage);
-    logo->Update();
-
-    QImage bwLogoImage(":/logo_bw");
-    vtkSmartPointer<vtkQImageToImageSource> bwLogo = vtkSmartPointer<vtkQImageToImageSource>::New();
-    bwLogo->SetQImage(&bwLogoImage);
-    bwLogo->Update();
-    
-
-    // Clean up the old visualization pipeline and create a new one
-    if (pipeline) {
-        delete pipeline;
-    }
-
-    pipeline = new VTKPipeline(qvtkWidget->GetInteractor(), 
-                               logo->GetOutput(), bwLogo->GetOutput(),
-                               reinterpret_cast<const char*>(QResource(":/opaqueShader").data()), 
-                               reinterpret_cast<const char*>(QResource(":/translucentShader").data()));
-}
-
-
-void MainWindow::RefreshGUI() {
-    // Find the maximum absolute value of the data
-    double maxValue = pipeline->GetMaximumAbsoluteValue();
-
-
-    isovalue1DualValue->blockSignals(true);
-    isovalue1DualValue->setValue1Range(1.0, 10.0);
-    isovalue1DualValue->setValue2Range(-10.0, 1.0);
-
-    isovalue1DualValue->setValue1(pipeline->GetIsovalue1() * 10.0);
-    isovalue1DualValue->setValue2(-2.0);
-    isovalue1DualValue->blockSignals(false);
-
-
-
-    isovalue1ExploratorySlider->blockSignals(true);
-    isovalue1ExploratorySlider->setRange(0.0, maxValue);
-    isovalue1ExploratorySlider->setValue(pipeline->GetIsovalue1());
-    isovalue1ExploratorySlider->blockSignals(false);
-
-/*
-    isovalue1DualValue->blockSignals(true);
-    isovalue1DualValue->setValue1Range(0.0, maxValue);
-    isovalue1DualValue->setValue2Range(0.0, maxValue);
-
-    isovalue1DualValue->setValue1(pipeline->GetIsovalue1());
-    isovalue1DualValue->setValue2(pipeline->GetIsovalue2());
-    isovalue1DualValue->blockSignals(false);
-*/
-
-
-    // Set the spin boxes based on the maximum absolute value.
-    // Have to block signals here when changing the range because otherwise, if the maxValue is greater than the 
-    // current range of the spin box, the spin box value will get set to maxValue, causing 
-    // the pipeline isovalue to also be set to maxValue.
-    isovalue1SpinBox->blockSignals(true);
-    isovalue2SpinBox->blockSignals(true);
-
-    isovalue1SpinBox->setRange(0.0, maxValue);
-    isovalue1SpinBox->setValue(pipeline->GetIsovalue1());
-    
-    isovalue2SpinBox->setRange(0.0, maxValue);
-    isovalue2SpinBox->setValue(pipeline->GetIsovalue2());    
-
-    isovalue1SpinBox->blockSignals(false); 
-    isovalue2SpinBox->blockSignals(false);
-
-    
-    isovalue1DoubleSlider->blockSignals(true);
-    isovalue2DoubleSlider->blockSignals(true);
-
-    isovalueExponentSpinBox->setValue(10); 
-
-    isovalue1DoubleSlider->blockSignals(false);
-    isovalue2DoubleSlider->blockSignals(false);
-
-
-    // Set the isovalue visibility checkboxes
-    isovalue1VisibleCheckBox->setChecked(pipeline->GetIsovalue1Visible());
-    isovalue1TranslucentCheckBox->setChecked(pipeline->GetIsovalue1Translucent());
-    isovalue2VisibleCheckBox->setChecked(pipeline->GetIsovalue2Visible());
-    isovalue2TranslucentCheckBox->setChecked(pipeline->GetIsovalue2Translucent());
-
-
-    // Set other widgets
-    colorRadioButton->setChecked(pipeline->GetColorMapType() == VTKPipeline::Color);
-    grayscaleRadioButton->setChecked(pipeline->GetColorMapType() == VTKPipeline::Grayscale);
-
-    showAxesCheckBox->setChecked(pipeline->GetShowAxes());
-    showColorLegendCheckBox->setChecked(pipeline->GetShowColorLegend());
-    showDataLabelCheckBox->setChecked(pipeline->GetShowDataLabel());
-
-    interactiveDataResolutionSlider->setValue(pipeline->GetInteractiveDataMagnification() * 10);
-
-    // Enable the GUI
-    tabWidget->setEnabled(true);
+/*=========================================================================
+
+  Name:        MainWindow.cpp
+
+  Author:      David Borland
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: The main window for the Voluminous visualization program
+
+=========================================================================*/
+
+
+#include "MainWindow.h"
+
+#include <QApplication>
+#include <QtConcurrentRun>
+#include <QColorDialog>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QInputDialog>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QProgressBar>
+#include <QRegExp>
+#include <QResource>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <algorithm>
+#include <climits>
+#include <iostream>
+
+#include <vtkQImageToImageSource.h>
+#include <vtkRenderWindow.h>
+
+#include <QDoubleSlider.h>
+
+#include "AboutDialog.h"
+#include "FeatureTracker.h"
+#include "SliceCine.h"
+#include "TimeSeries.h"
+#include "VTKPipeline.h"
+#include "Wavefunction.h"
+
+#include <vrpn_Tracker.h>
+
+
+static void VRPN_CALLBACK HandlePosition(void* userData, const vrpn_TRACKERCB t) {
+//    printf("%f %f %f\n", t.pos[0], t.pos[1], t.pos[2]);
+
+    VTKPipeline* pipeline = static_cast<MainWindow*>(userData)->GetVTKPipeline();
+    
+    if (!pipeline) {
+        return;
+    }
+
+    if (t.sensor == 0) {
+        pipeline->SetHeadPosition(t.pos[0], t.pos[1], t.pos[2]);
+    }
+}
+
+
+MainWindow::MainWindow(int argc, char** argv) : QMainWindow(NULL) {
+    // Create the GUI from the Qt Designer file
+    setupUi(this);
+
+
+    // Make stereo options unavailable, unless a stereo window is requested
+    menuStereo->setEnabled(false);
+
+    // No tracker by default
+    tracker = NULL;
+
+
+    // Disable the GUI until we have data
+    tabWidget->setEnabled(false);
+
+
+    // Hide the advanced controls for now
+    tabWidget->removeTab(2);
+
+    
+    // Set up double sliders
+    isovalue1DoubleSlider = new QDoubleSlider(isovalue1Slider, isovalue1SpinBox, this);
+    connect(isovalue1DoubleSlider, SIGNAL(valueChanged(double)), this, SLOT(isovalue1DoubleSlider_valueChanged(double)));
+    connect(isovalue1DoubleSlider, SIGNAL(sliderReleased()), this, SLOT(isovalue1DoubleSlider_sliderReleased()));
+
+    isovalue2DoubleSlider = new QDoubleSlider(isovalue2Slider, isovalue2SpinBox, this);
+    connect(isovalue2DoubleSlider, SIGNAL(valueChanged(double)), this, SLOT(isovalue2DoubleSlider_valueChanged(double)));
+    connect(isovalue2DoubleSlider, SIGNAL(sliderReleased()), this, SLOT(isovalue2DoubleSlider_sliderReleased()));
+
+    isovalueExponentDoubleSlider = new QDoubleSlider(isovalueExponentSlider, isovalueExponentSpinBox, this);
+    connect(isovalueExponentDoubleSlider, SIGNAL(valueChanged(double)), isovalue1DoubleSlider, SLOT(setExponent(double)));
+    connect(isovalueExponentDoubleSlider, SIGNAL(valueChanged(double)), isovalue2DoubleSlider, SLOT(setExponent(double)));
+
+
+    isovalue1DualValue->setUpdateSeparately(true);
+
+
+    connect(isovalue1ExploratorySlider, SIGNAL(valueChanged(double)), testIsovalue1SpinBox, SLOT(setValue(double)));
+    connect(testIsovalue1SpinBox, SIGNAL(valueChanged(double)), isovalue1ExploratorySlider, SLOT(setValue(double)));
+    
+
+    // Create the memory budget and its display
+    memoryBudget = new MemoryBudget();
+
+    memoryLabel = new QLabel(this);
+    statusbar->addPermanentWidget(memoryLabel);
+
+    QTimer* memoryUpdateTimer = new QTimer(this);
+    connect(memoryUpdateTimer, SIGNAL(timeout()), this, SLOT(memoryTimer()));
+    memoryUpdateTimer->start(1000);
+
+
+    // Create the volume cache
+    volumeCache = new VolumeCache(memoryBudget);
+
+
+    // Create the lobe tracker, used when coloring lobes by track
+    featureTracker = new FeatureTracker(memoryBudget);
+
+
+    // Slice sweeps, computed ahead on the thread pool
+    sliceCine = new SliceCine(memoryBudget);
+
+
+    // No time series until one is opened
+    timeSeries = NULL;
+    pipelineStep = -1;
+    requestedStep = -1;
+
+    timeGroupBox->hide();
+
+    // Only shown for volumes with several fields
+    fieldGroupBox->hide();
+
+    smoothingPreviewed = false;
+
+    playbackTimer = new QTimer(this);
+    connect(playbackTimer, SIGNAL(timeout()), this, SLOT(playTimer()));
+
+    // Enough layers for the nested translucent isosurfaces from most views
+    maxPeels = 8;
+
+
+    // Create the visualization pipeline
+    pipeline = CreatePipeline();
+    pipeline->SetActive(true);
+
+    nextPipeline = NULL;
+    nextPipelineStep = -1;
+
+    progressBar = new QProgressBar(this);
+    progressBar->setRange(0, 0);
+    progressBar->setMaximumWidth(150);
+    progressBar->hide();
+    statusbar->addPermanentWidget(progressBar);
+
+    connect(&futureWatcher, SIGNAL(finished()), this, SLOT(openVolumeFinished()));
+
+
+    // Parse command-line options
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-ActiveStereo") == 0) {
+            // Try to create a stereo-capable window
+            vtkRenderWindow* win = qvtkWidget->GetRenderWindow();
+            win->StereoCapableWindowOn();
+            win->StereoRenderOn();
+        }
+        else if (strcmp(argv[i], "-zSpace") == 0) {
+            // Try to create a stereo-capable window
+            vtkRenderWindow* win = qvtkWidget->GetRenderWindow();
+            win->StereoCapableWindowOn();
+            win->StereoRenderOn();
+
+            // Create the tracker
+            tracker = new vrpn_Tracker_Remote("Tracker0@localhost");
+            if (tracker->register_change_handler(this, HandlePosition) == -1) {
+                printf("Error: Can't register tracker callback.");
+            }
+            else {
+                // Create a timer for updating tracking
+                QTimer* timer = new QTimer(this);
+                connect(timer, SIGNAL(timeout()), this, SLOT(trackingTimer()));
+                timer->start(0);
+            }
+        }
+        else if (strcmp(argv[i], "-RayCast") == 0) {
+            // Start with volume rendering, e.g. on machines without graphics hardware
+            displayComboBox->setCurrentIndex(VTKPipeline::VolumeDisplay);
+            pipeline->SetDisplayType(VTKPipeline::VolumeDisplay);
+        }
+        else if (strcmp(argv[i], "-MemoryLimit") == 0 && i + 1 < argc) {
+            // Memory limit in megabytes
+            memoryBudget->SetLimit(strtoul(argv[++i], NULL, 10) * 1024);
+        }
+    }
+
+    // Depth peeling needs alpha bit planes and no multisampling, set before the window is created
+    qvtkWidget->GetRenderWindow()->SetAlphaBitPlanes(1);
+    qvtkWidget->GetRenderWindow()->SetMultiSamples(0);
+
+    // See if stereo is available    
+    if (qvtkWidget->GetRenderWindow()->GetStereoCapableWindow()) {
+        menuStereo->setEnabled(true);
+        actionUseStereo->setChecked(true);
+    }
+}
+
+MainWindow::~MainWindow() {
+    // Clean up
+    if (tracker) {
+        delete tracker;
+        tracker = NULL;
+    }
+
+    // Wait for any slices and isosurfaces being computed
+    QThreadPool::globalInstance()->waitForDone();
+
+    delete sliceCine;
+    sliceCine = NULL;
+
+    delete timeSeries;
+    timeSeries = NULL;
+
+    if (nextPipeline) {
+        future.waitForFinished();
+
+        delete nextPipeline;
+        nextPipeline = NULL;
+    }
+
+    delete pipeline;
+    pipeline = NULL;
+
+    delete volumeCache;
+    volumeCache = NULL;
+
+    delete featureTracker;
+    featureTracker = NULL;
+
+    delete memoryBudget;
+    memoryBudget = NULL;
+}
+
+
+VTKPipeline* MainWindow::GetVTKPipeline() {
+    return pipeline;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+// Respond to menu events
+
+void MainWindow::on_actionOpenVolume_triggered() {
+    // One volume at a time
+    if (nextPipeline || pipeline->GetProductsPending() > 0) {
+        QMessageBox::information(this, "Open Volume", "Already opening a volume");
+
+        return;
+    }
+
+
+    // Open a file dialog to read the VTK file
+    QString fileName = QFileDialog::getOpenFileName(this,
+                                                    "Open Volume",
+                                                    "",
+                                                    "All Files (*);;Legacy VTK Files (*.vtk);;VTK XML ImageData Files (*.vti);;VTK XML RectilinearGrid Files (*.vtr);;VTK XML MultiBlock Files (*.vtm)");
+
+    // Check for file name
+    if (fileName == "") {
+        return;
+    }
+
+    openTime.start();
+
+    // A single volume replaces any time series
+    CloseTimeSeries();
+
+        
+    // Switch to the cached pipeline if the file was loaded before and hasn't changed since
+    VolumeCache::Key key = VolumeCache::GetKey(fileName.toStdString());
+
+    if (pipeline->HasVisualization() && key == pipelineKey) {
+        // Already showing
+        return;
+    }
+
+    VTKPipeline* cached = volumeCache->Take(key);
+
+    if (cached) {
+        SwapPipeline(cached, key);
+
+        return;
+    }
+
+    LoadPipeline(fileName, key, -1);
+}
+
+
+void MainWindow::on_actionOpenTimeSeries_triggered() {
+    // One volume at a time
+    if (nextPipeline || pipeline->GetProductsPending() > 0) {
+        QMessageBox::information(this, "Open Time Series", "Already opening a volume");
+
+        return;
+    }
+
+
+    // Select all steps, or one step to find the others by its number
+    QStringList fileNames = QFileDialog::getOpenFileNames(this,
+                                                          "Open Time Series",
+                                                          "",
+                                                          "All Files (*);;Legacy VTK Files (*.vtk);;VTK XML ImageData Files (*.vti);;VTK XML RectilinearGrid Files (*.vtr);;VTK XML MultiBlock Files (*.vtm)");
+
+    if (fileNames.size() == 0) {
+        return;
+    }
+    else if (fileNames.size() == 1) {
+        fileNames = TimeSeries::ExpandPattern(fileNames[0]);
+    }
+    else {
+        fileNames.sort();
+    }
+
+    if (fileNames.size() < 2) {
+        QMessageBox::information(this, "Open Time Series", "No other time steps found");
+
+        return;
+    }
+
+    openTime.start();
+
+
+    CloseTimeSeries();
+
+    timeSeries = new TimeSeries(fileNames, memoryBudget, this);
+    connect(timeSeries, SIGNAL(stepReady(int)), this, SLOT(timeStepReady(int)));
+
+    RefreshTimeGUI();
+
+    LoadPipeline(fileNames[0], VolumeCache::GetKey(fileNames[0].toStdString()), 0);
+}
+
+
+void MainWindow::on_actionOpenDifference_triggered() {
+    // One volume at a time
+    if (nextPipeline || pipeline->GetProductsPending() > 0) {
+        QMessageBox::information(this, "Open Difference", "Already opening a volume");
+
+        return;
+    }
+
+
+    // Open file dialogs for the two volumes, and ask for a scale
+    QString filter = "All Files (*);;Legacy VTK Files (*.vtk);;VTK XML ImageData Files (*.vti);;VTK XML RectilinearGrid Files (*.vtr)";
+
+    QString fileNameA = QFileDialog::getOpenFileName(this, "Open Difference: Volume A", "", filter);
+
+    if (fileNameA == "") {
+        return;
+    }
+
+    QString fileNameB = QFileDialog::getOpenFileName(this, "Open Difference: Volume B", 
+                                                     QFileInfo(fileNameA).path(), filter);
+
+    if (fileNameB == "") {
+        return;
+    }
+
+    bool ok;
+    double scale = QInputDialog::getDouble(this, "Open Difference", "Scale for A - B:", 1.0, 
+                                           -1e10, 1e10, 6, &ok);
+
+    if (!ok) {
+        return;
+    }
+
+    openTime.start();
+
+    // A single volume replaces any time series
+    CloseTimeSeries();
+
+
+    // Switch to the cached pipeline if the difference was computed before
+    VolumeCache::Key key = VolumeCache::GetKey(fileNameA.toStdString(), fileNameB.toStdString(), scale);
+
+    if (pipeline->HasVisualization() && key == pipelineKey) {
+        // Already showing
+        return;
+    }
+
+    VTKPipeline* cached = volumeCache->Take(key);
+
+    if (cached) {
+        SwapPipeline(cached, key);
+
+        return;
+    }
+
+    StartPipeline(key, -1, "Computing difference of " + QFileInfo(fileNameA).fileName() + 
+                           " and " + QFileInfo(fileNameB).fileName());
+
+    future = QtConcurrent::run(nextPipeline, &VTKPipeline::LoadDifference, 
+                               fileNameA.toStdString(), fileNameB.toStdString(), scale, &errorMessage);
+    futureWatcher.setFuture(future);
+}
+
+
+void MainWindow::on_actionOpenWavefunction_triggered() {
+    // One volume at a time
+    if (nextPipeline || pipeline->GetProductsPending() > 0) {
+        QMessageBox::information(this, "Open Wavefunction", "Already opening a volume");
+
+        return;
+    }
+
+
+    // Open file dialog
+    QString fileName = QFileDialog::getOpenFileName(this, "Open Wavefunction", "", 
+                                                    "Wavefunction Files (*.molden *.mold *.fchk *.fch);;All Files (*)");
+
+    if (fileName == "") {
+        return;
+    }
+
+
+    // Read the orbitals to choose from.  Reading is quick compared to evaluating the grid, which
+    // is done with the rest of the pipeline.
+    Wavefunction wavefunction;
+    std::string message;
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool read = wavefunction.Read(fileName.toStdString(), &message);
+    QApplication::restoreOverrideCursor();
+
+    if (!read) {
+        QMessageBox::critical(this, "Error", message.c_str());
+
+        return;
+    }
+
+    QStringList items;
+    items << "Electron density";
+
+    for (int i = 0; i < wavefunction.GetNumberOfOrbitals(); i++) {
+        const Wavefunction::Orbital& orbital = wavefunction.GetOrbital(i);
+
+        items << QString("MO %1 %2 %3 (E = %4, occupation %5)").arg(i + 1)
+                                                                .arg(orbital.beta ? "beta" : "")
+                                                                .arg(orbital.symmetry.c_str())
+                                                                .arg(orbital.energy)
+                                                                .arg(orbital.occupation)
+                                                                .simplified();
+    }
+
+    bool ok;
+    QString item = QInputDialog::getItem(this, "Open Wavefunction", "Evaluate:", items, 
+                                         wavefunction.GetHomo() + 1, false, &ok);
+
+    if (!ok) {
+        return;
+    }
+
+    int orbital = items.indexOf(item) - 1;
+
+    double spacing = QInputDialog::getDouble(this, "Open Wavefunction", "Grid spacing (bohr):", 0.2, 
+                                             0.01, 10.0, 3, &ok);
+
+    if (!ok) {
+        return;
+    }
+
+    int refinement = QInputDialog::getInt(this, "Open Wavefunction", 
+                                          "Refinement around the atoms (1 for none):", 1, 1, 8, 1, &ok);
+
+    if (!ok) {
+        return;
+    }
+
+    openTime.start();
+
+    // A single volume replaces any time series
+    CloseTimeSeries();
+
+
+    // Switch to the cached pipeline if the grid was evaluated before
+    VolumeCache::Key key = VolumeCache::GetKey(fileName.toStdString(), orbital, spacing, refinement);
+
+    if (pipeline->HasVisualization() && key == pipelineKey) {
+        // Already showing
+        return;
+    }
+
+    VTKPipeline* cached = volumeCache->Take(key);
+
+    if (cached) {
+        SwapPipeline(cached, key);
+
+        return;
+    }
+
+    StartPipeline(key, -1, "Evaluating " + QFileInfo(fileName).fileName());
+
+    future = QtConcurrent::run(nextPipeline, &VTKPipeline::LoadWavefunction, 
+                               fileName.toStdString(), orbital, spacing, refinement, &errorMessage);
+    futureWatcher.setFuture(future);
+}
+
+
+void MainWindow::on_actionOpenProperty_triggered() {
+    if (!pipeline->HasVisualization() || pipeline->GetProductsPending() > 0) {
+        QMessageBox::information(this, "Open Property Colors", "Open a volume to color first");
+
+        return;
+    }
+
+
+    // Open file dialog
+    QString fileName = QFileDialog::getOpenFileName(this, "Open Property Colors", "", 
+                                                    "Volume Files (*.vtk *.vti *.vtr);;All Files (*)");
+
+    if (fileName == "") {
+        return;
+    }
+
+
+    // Reading the property and sampling it on the isosurfaces can take a moment
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    std::string message;
+    bool success = pipeline->OpenProperty(fileName.toStdString(), &message);
+
+    if (success) {
+        pipeline->Render();
+    }
+
+    QApplication::restoreOverrideCursor();
+
+    if (!success) {
+        QMessageBox::critical(this, "Error", message.c_str());
+
+        return;
+    }
+
+    RefreshGUI();
+
+    PipelineUpdated();
+}
+
+
+void MainWindow::UpdateSmoothing(bool doFast) {
+    VTKPipeline::SmoothingType type = (VTKPipeline::SmoothingType)smoothingComboBox->currentIndex();
+    double width = smoothingSlider->value() / 10.0;
+
+    // Nothing to do if already applied, e.g. on the release after a keyboard change.  A preview 
+    // sets the pipeline's settings, but still needs to be applied at full resolution.
+    if (!doFast && !smoothingPreviewed && 
+        type == pipeline->GetSmoothingType() && width == pipeline->GetSmoothingWidth()) {
+        return;
+    }
+
+    smoothingPreviewed = doFast;
+
+    if (doFast) {
+        pipeline->SetSmoothing(type, width, true);
+        pipeline->Render();
+
+        return;
+    }
+
+    // Smoothing the full resolution volume can take a moment
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    pipeline->SetSmoothing(type, width);
+    pipeline->Render();
+
+    QApplication::restoreOverrideCursor();
+
+    PipelineUpdated();
+}
+
+
+void MainWindow::LoadPipeline(const QString& fileName, const VolumeCache::Key& key, int step) {
+    StartPipeline(key, step, "Opening " + fileName.right(fileName.length() - fileName.lastIndexOf("/") - 1));
+
+    future = QtConcurrent::run(nextPipeline, &VTKPipeline::LoadVolume, fileName.toStdString(), &errorMessage);
+    futureWatcher.setFuture(future);
+}
+
+
+void MainWindow::StartPipeline(const VolumeCache::Key& key, int step, const QString& message) {
+    // Build the new pipeline on worker threads, leaving the current one interactive until it is ready
+    nextPipeline = CreatePipeline();
+    nextPipelineKey = key;
+    nextPipelineStep = step;
+
+    if ((actionKeepIsovalues->isChecked() || pipelineStep >= 0) && pipeline->HasVisualization()) {
+        nextPipeline->SetInitialIsovalues(pipeline->GetIsovalue1(), pipeline->GetIsovalue2());
+    }
+
+    if (step >= 0 && pipelineStep >= 0) {
+        // Time steps show the same field
+        nextPipeline->SetInitialField(pipeline->GetFieldName(pipeline->GetField()));
+    }
+    
+
+    // Progress bar.   
+    // Doing things this way because vtkStructuredPointsReader would only give one update at 50% and then 
+    // no updates until the volume was loaded, making it look frozen.  By loading the data in a thread 
+    // with a continually animated progress bar, it doesn't look like application is frozen.
+    // This code was adapted from:  http://qt-project.org/wiki/Progress-bar
+    statusbar->showMessage(message);
+    progressBar->show();
+}
+
+
+void MainWindow::openVolumeFinished() {
+    statusbar->clearMessage();
+    progressBar->hide();
+
+    if (!future.result()) {
+        // Show error message
+        QMessageBox::critical(this, "Error", errorMessage.c_str());
+
+        delete nextPipeline;
+        nextPipeline = NULL;
+
+        // Stay on the current time step, or give up on the series if none was shown
+        if (timeSeries && pipelineStep < 0) {
+            CloseTimeSeries();
+        }
+        else {
+            requestedStep = -1;
+            playButton->setChecked(false);
+            RefreshTimeGUI();
+        }
+
+        return;
+    }
+
+    VTKPipeline* newPipeline = nextPipeline;
+    nextPipeline = NULL;
+
+    SwapPipeline(newPipeline, nextPipelineKey, nextPipelineStep);
+}
+
+
+void MainWindow::timeStepReady(int step) {
+    if (step == requestedStep) {
+        SetTimeStep(step);
+    }
+}
+
+
+
+
+void MainWindow::on_actionSaveScreenshot_triggered() {
+    // Open a file dialog to save the PNG image
+    QString fileName = QFileDialog::getSaveFileName(this,
+                                                    "Save Screenshot",
+                                                    "VoluminousScreenshot.png",
+                                                    "PNG Files (*.png)");
+
+    // Check for file name
+    if (fileName == "") {
+        return;
+    }
+
+    // Save a screenshot
+    pipeline->SaveScreenshot(fileName.toStdString());
+}
+
+void MainWindow::on_actionExit_triggered() {
+    qApp->exit();
+}
+
+
+void MainWindow::on_actionUseStereo_triggered() {
+    pipeline->SetUseStereo(actionUseStereo->isChecked());
+}
+
+void MainWindow::on_actionFlipEyes_triggered() {
+    pipeline->FlipEyes();
+}
+
+
+void MainWindow::on_actionLeanMemory_triggered() {
+    // Applied when products are done otherwise
+    if (pipeline->GetProductsPending() == 0) {
+        pipeline->SetLeanMemory(actionLeanMemory->isChecked());
+    }
+}
+
+void MainWindow::on_actionTrackFeatures_triggered() {
+    if (!actionTrackFeatures->isChecked()) {
+        // Start new tracks next time
+        featureTracker->Reset();
+    }
+
+    // Applied when products are done otherwise
+    if (pipeline->GetProductsPending() == 0) {
+        pipeline->SetFeatureTracker(actionTrackFeatures->isChecked() ? featureTracker : NULL);
+        pipeline->TrackFeatures();
+        pipeline->Render();
+    }
+}
+
+void MainWindow::on_actionMemoryLimit_triggered() {
+    bool ok;
+    int limit = QInputDialog::getInt(this, "Memory Limit", "Memory limit in MB (0 for no limit):", 
+                                     (int)(memoryBudget->GetLimit() / 1024), 0, INT_MAX, 256, &ok);
+
+    if (ok) {
+        memoryBudget->SetLimit((unsigned long)limit * 1024);
+        memoryBudget->Enforce();
+        memoryTimer();
+    }
+}
+
+void MainWindow::on_actionMemoryUsage_triggered() {
+    std::string report = memoryBudget->GetReport();
+    report += std::string("Lean memory mode: ") + (pipeline->GetLeanMemory() ? "on" : "off") + "\n";
+
+    std::cout << report;
+
+    QMessageBox::information(this, "Memory Usage", report.c_str());
+}
+
+
+void MainWindow::on_actionDepthPeeling_triggered() {
+    pipeline->SetDepthPeeling(actionDepthPeeling->isChecked(), maxPeels);
+    pipeline->Render();
+
+    if (actionDepthPeeling->isChecked() && !pipeline->GetLastRenderUsedDepthPeeling()) {
+        statusbar->showMessage("Depth peeling is not supported by this OpenGL implementation", 10000);
+    }
+}
+
+void MainWindow::on_actionPeelBudget_triggered() {
+    bool ok;
+    int peels = QInputDialog::getInt(this, "Peel Budget", "Maximum number of layers peeled per frame:", 
+                                     maxPeels, 1, 100, 1, &ok);
+
+    if (ok) {
+        maxPeels = peels;
+        pipeline->SetDepthPeeling(actionDepthPeeling->isChecked(), maxPeels);
+        pipeline->Render();
+    }
+}
+
+void MainWindow::on_actionDepthSorting_triggered() {
+    // Applied when products are done otherwise, as workers may be updating the isosurface mappers
+    if (pipeline->GetProductsPending() == 0) {
+        pipeline->SetDepthSorting(actionDepthSorting->isChecked());
+        pipeline->Render();
+    }
+}
+
+void MainWindow::on_actionBenchmarkTransparency_triggered() {
+    if (!pipeline->HasVisualization()) {
+        return;
+    }
+
+    double blendedTime;
+    double peeledTime;
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    pipeline->BenchmarkTransparency(120, &blendedTime, &peeledTime);
+    QApplication::restoreOverrideCursor();
+
+    QString report = QString("Blended: %1 ms per frame\nDepth peeled (%2 peels): %3 ms per frame")
+                     .arg(blendedTime, 0, 'f', 2).arg(maxPeels).arg(peeledTime, 0, 'f', 2);
+
+    QMessageBox::information(this, "Transparency Benchmark", report);
+}
+
+
+void MainWindow::on_actionAbout_triggered() {
+    AboutDialog about(this);
+    about.exec();
+}
+
+void MainWindow::on_actionControls_triggered() {
+    const char* message = 
+        "--Mouse--\n"
+        "Left button + drag: Rotate\n"
+        "Middle button + drag: Pan\n"
+        "Right button + drag: Zoom\n"
+        "Wheel: Zoom\n"
+        "\n"
+        "--IsovalueControls--\n"
+        "Change the two isosurface values and visibility with the associated sliders and check boxes.\n"
+        "\n"
+        "The Isovalue Exponent slider changes the output of the isovalue sliders to be based on a curve with the given exponent.\n"
+        "An exponent of 1 results in a standard linear slider.\n"
+        "\n"
+        "--Settings--\n"
+        "Set the background color and turn visualization elements on and off with the associated button and check boxes.\n"
+        "\n"
+        "The Grayscale radio button changes the color map such that it will be more suitable for printing in black and white.\n"
+        "\n"
+        "The Interactive Data Resolution slider changes the amount of downsampling applied to the volume when moving the isovalue sliders.\n"
+        "Sliding to the left provides faster rendering but with a less-accurate volume.\n"
+        "Sliding to the right provides slower rendering but with a more-accurate volume.";
+
+    QMessageBox::about(this, "Controls", message);
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+// Timer events
+
+void MainWindow::trackingTimer() {
+    if (tracker) {
+        tracker->mainloop();
+    }
+}
+
+void MainWindow::memoryTimer() {
+    memoryBudget->Update();
+
+    QString text = QString("Memory: %1 MB").arg(memoryBudget->GetTotal() / 1024.0, 0, 'f', 1);
+    if (memoryBudget->GetLimit() > 0) {
+        text += QString(" of %1 MB").arg(memoryBudget->GetLimit() / 1024);
+    }
+
+    memoryLabel->setText(text);
+}
+
+void MainWindow::playTimer() {
+    if (!timeSeries || nextPipeline || pipeline->GetProductsPending() > 0 || requestedStep >= 0) {
+        return;
+    }
+
+    int step = (pipelineStep + 1) % timeSeries->GetNumberOfSteps();
+
+    // Wait for a step being prefetched rather than loading it again
+    if (timeSeries->IsStepPending(step)) {
+        return;
+    }
+
+    timeSlider->setValue(step);
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+// Respond to widget events
+
+void MainWindow::isovalue1DoubleSlider_valueChanged(double value) {
+    pipeline->SetIsovalue1(value, true);   
+    pipeline->Render();
+}
+
+void MainWindow::isovalue1DoubleSlider_sliderReleased() {
+    pipeline->SetIsovalue1(isovalue1DoubleSlider->value());   
+    pipeline->Render();
+
+    PipelineUpdated();
+}
+
+
+void MainWindow::isovalue2DoubleSlider_valueChanged(double value) {
+    pipeline->SetIsovalue2(value, true);
+    pipeline->Render();
+}
+
+void MainWindow::isovalue2DoubleSlider_sliderReleased() {
+    pipeline->SetIsovalue2(isovalue2DoubleSlider->value());   
+    pipeline->Render();
+
+    PipelineUpdated();
+}
+
+
+void MainWindow::on_isovalue1VisibleCheckBox_toggled(bool checked) {
+	pipeline->SetIsovalue1Visible(checked);
+    pipeline->Render();
+}
+
+void MainWindow::on_isovalue1TranslucentCheckBox_toggled(bool checked) {
+	pipeline->SetIsovalue1Translucent(checked);
+
+    pipeline->Render();
+}
+	
+void MainWindow::on_isovalue2VisibleCheckBox_toggled(bool checked) {
+	pipeline->SetIsovalue2Visible(checked);
+    pipeline->Render();
+}
+
+void MainWindow::on_isovalue2TranslucentCheckBox_toggled(bool checked) {
+	pipeline->SetIsovalue2Translucent(checked);
+    pipeline->Render();
+}
+
+
+void MainWindow::on_isovalue1DualValue_value1Changed(double value) {
+    double v1 = isovalue1DualValue->getValue1();
+    double v2 = isovalue1DualValue->getValue2();
+
+    double v = v1 * pow(10.0, v2);
+
+    pipeline->SetIsovalue1(v, true);
+
+    pipeline->Render();
+}
+
+void MainWindow::on_isovalue1DualValue_bar1Released() {
+    double v1 = isovalue1DualValue->getValue1();
+    double v2 = isovalue1DualValue->getValue2();
+
+    double v = v1 * pow(10.0, v2);
+
+    pipeline->SetIsovalue1(v);
+
+    pipeline->Render();   
+
+    PipelineUpdated();
+}
+
+void MainWindow::on_isovalue1DualValue_value2Changed(double value) {
+    double v1 = isovalue1DualValue->getValue1();
+    double v2 = isovalue1DualValue->getValue2();
+
+    double v = v1 * pow(10.0, v2);
+
+    pipeline->SetIsovalue1(v, true);
+
+    pipeline->Render();
+}
+
+void MainWindow::on_isovalue1DualValue_bar2Released() {
+    double v1 = isovalue1DualValue->getValue1();
+    double v2 = isovalue1DualValue->getValue2();
+
+    double v = v1 * pow(10.0, v2);
+
+    pipeline->SetIsovalue1(v);
+
+    pipeline->Render();   
+
+    PipelineUpdated();
+}
+
+void MainWindow::on_isovalue1DualValue_valuesChanged(QPointF values) {
+    double v1 = isovalue1DualValue->getValue1();
+    double v2 = isovalue1DualValue->getValue2();
+
+    double v = v1 * pow(10.0, v2);
+
+    pipeline->SetIsovalue1(v, true);
+
+    pipeline->Render();
+
+/*
+    if (values.y() > values.x() * 0.8) {
+        isovalue1DualValue->setValues(values.x(), values.x() * 0.8);
+    }
+    else {
+        pipeline->SetIsovalue1(values.x());
+        pipeline->SetIsovalue2(values.y());
+
+        printf("%f %f\n", values.x(), values.y());
+
+        pipeline->Render();
+    }
+*/
+}
+
+void MainWindow::on_isovalue1DualValue_handleReleased() {
+    double v1 = isovalue1DualValue->getValue1();
+    double v2 = isovalue1DualValue->getValue2();
+
+    double v = v1 * pow(10.0, v2);
+
+    pipeline->SetIsovalue1(v);
+
+    pipeline->Render();   
+
+    PipelineUpdated();
+}
+
+void MainWindow::on_isovalue1ExploratorySlider_valueChanged(double value) {
+    pipeline->SetIsovalue1(value, true);
+
+    pipeline->Render();
+}
+
+void MainWindow::on_isovalue1ExploratorySlider_sliderReleased() {
+    pipeline->SetIsovalue1(isovalue1ExploratorySlider->getValue());
+
+    pipeline->Render();
+
+    PipelineUpdated();
+}
+
+
+void MainWindow::on_setBackgroundColorButton_clicked() {
+    // Open a file dialog to read the VTK XML file
+    double rgb[3];
+    pipeline->GetBackgroundColor(rgb);
+    QColor color;
+    color.setRgbF(rgb[0], rgb[1], rgb[2]);
+    color = QColorDialog::getColor(color, this, "Choose Background Color");
+
+    if (color.isValid()) {
+        pipeline->SetBackgroundColor(color.redF(), color.greenF(), color.blueF());
+        pipeline->Render();
+    }
+}
+
+
+void MainWindow::on_colorRadioButton_toggled(bool checked) {
+    if (checked) {
+        pipeline->SetColorMapType(VTKPipeline::Color);
+        pipeline->Render();
+    }
+}
+
+void MainWindow::on_grayscaleRadioButton_toggled(bool checked) {
+    if (checked) {
+        pipeline->SetColorMapType(VTKPipeline::Grayscale);
+        pipeline->Render();
+    }
+}
+
+
+void MainWindow::on_showAxesCheckBox_toggled(bool checked) {
+    pipeline->SetShowAxes(checked);
+    pipeline->Render();
+}
+
+void MainWindow::on_showColorLegendCheckBox_toggled(bool checked) {
+    pipeline->SetShowColorLegend(checked);
+    pipeline->Render();
+}
+
+void MainWindow::on_showDataLabelCheckBox_toggled(bool checked) {
+    pipeline->SetShowDataLabel(checked);
+    pipeline->Render();
+}
+
+void MainWindow::on_displayComboBox_activated(int index) {
+    pipeline->SetDisplayType((VTKPipeline::DisplayType)index);
+    pipeline->Render();
+}
+
+
+void MainWindow::on_showSlicesInsideCheckBox_toggled(bool checked) {
+    pipeline->SetShowSlicesInside(checked);
+    pipeline->Render();
+}
+
+void MainWindow::on_sliceXSlider_valueChanged(int value) {
+    pipeline->SetSlicePosition(0, value);
+    pipeline->Render();
+}
+
+void MainWindow::on_sliceYSlider_valueChanged(int value) {
+    pipeline->SetSlicePosition(1, value);
+    pipeline->Render();
+}
+
+void MainWindow::on_sliceZSlider_valueChanged(int value) {
+    pipeline->SetSlicePosition(2, value);
+    pipeline->Render();
+}
+
+void MainWindow::on_cineAxisComboBox_activated(int index) {
+    // Restart a sweep along the new axis
+    if (sliceCine->IsPlaying()) {
+        on_cinePlayButton_toggled(true);
+    }
+}
+
+void MainWindow::on_cinePlayButton_toggled(bool checked) {
+    if (!checked) {
+        sliceCine->Stop();
+        pipeline->Render();
+
+        return;
+    }
+
+    if (!sliceCine->Start(pipeline, cineAxisComboBox->currentIndex())) {
+        cinePlayButton->blockSignals(true);
+        cinePlayButton->setChecked(false);
+        cinePlayButton->blockSignals(false);
+    }
+}
+
+void MainWindow::on_wallsComboBox_activated(int index) {
+    // Projections of a new field take a pass over the volume
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    pipeline->SetWallType((VTKPipeline::WallType)index);
+    QApplication::restoreOverrideCursor();
+
+    pipeline->Render();
+}
+
+void MainWindow::on_showObliqueSliceCheckBox_toggled(bool checked) {
+    pipeline->SetShowObliqueSlice(checked);
+    pipeline->Render();
+}
+
+void MainWindow::on_obliqueSliceThroughPointsButton_clicked() {
+    bool ok;
+    QString text = QInputDialog::getText(this, "Oblique Slice Through Points", 
+                                         "Three points (x1 y1 z1 x2 y2 z2 x3 y3 z3):", 
+                                         QLineEdit::Normal, "", &ok);
+
+    if (!ok) {
+        return;
+    }
+
+    QStringList values = text.split(QRegExp("[\\s,]+"), QString::SkipEmptyParts);
+
+    double p[9];
+    bool valid = values.size() == 9;
+
+    for (int i = 0; valid && i < 9; i++) {
+        p[i] = values[i].toDouble(&valid);
+    }
+
+    if (!valid) {
+        QMessageBox::critical(this, "Error", "Expected nine numbers: the x, y, and z coordinates of three points");
+        return;
+    }
+
+    if (!pipeline->SetObliqueSliceThroughPoints(p, p + 3, p + 6)) {
+        QMessageBox::critical(this, "Error", "The points are on a line, so do not define a plane");
+        return;
+    }
+
+    pipeline->SetShowObliqueSlice(true);
+    pipeline->Render();
+
+    showObliqueSliceCheckBox->blockSignals(true);
+    showObliqueSliceCheckBox->setChecked(true);
+    showObliqueSliceCheckBox->blockSignals(false);
+}
+
+
+void MainWindow::on_interactiveDataResolutionSlider_valueChanged(int value)
+{
+    pipeline->SetInteractiveDataMagnification((double)value / 10);
+}
+
+
+void MainWindow::on_fieldComboBox_activated(int index) {
+    // Fields other than the first are decoded when first selected
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    std::string message;
+    bool success = pipeline->SetField(index, &message);
+
+    if (success) {
+        // Recompute the slices and isosurfaces
+        pipeline->Render();
+    }
+
+    QApplication::restoreOverrideCursor();
+
+    if (!success) {
+        QMessageBox::critical(this, "Error", message.c_str());
+
+        fieldComboBox->setCurrentIndex(pipeline->GetField());
+
+        return;
+    }
+
+    RefreshGUI();
+
+    PipelineUpdated();
+}
+
+
+void MainWindow::on_smoothingComboBox_activated(int index) {
+    UpdateSmoothing(false);
+}
+
+void MainWindow::on_smoothingSlider_valueChanged(int value) {
+    // Preview while dragging.  Other changes, e.g. from the keyboard, are applied at once.
+    UpdateSmoothing(smoothingSlider->isSliderDown());
+}
+
+void MainWindow::on_smoothingSlider_sliderReleased() {
+    UpdateSmoothing(false);
+}
+
+
+void MainWindow::on_propertyRangeSpinBox_valueChanged(double value) {
+    pipeline->SetPropertyRange(value);
+    pipeline->Render();
+}
+
+void MainWindow::on_propertyClearButton_clicked() {
+    pipeline->ClearProperty();
+    pipeline->Render();
+
+    RefreshGUI();
+
+    PipelineUpdated();
+}
+
+
+void MainWindow::on_timeSlider_valueChanged(int value) {
+    SetTimeStep(value);
+}
+
+void MainWindow::on_playButton_toggled(bool checked) {
+    if (checked) {
+        playbackTimer->start(100);
+    }
+    else {
+        playbackTimer->stop();
+    }
+}
+
+
+VTKPipeline* MainWindow::CreatePipeline() {
+    // Load the RENCI logos
+    QImage logoImage(":/logo");
+    vtkSmartPointer<vtkQImageToImageSource> logo = vtkSmartPointer<vtkQImageToImageSource>::New();
+    logo->SetQImage(&logoImage);
+    logo->Update();
+
+    QImage bwLogoImage(":/logo_bw");
+    vtkSmartPointer<vtkQImageToImageSource> bwLogo = vtkSmartPointer<vtkQImageToImageSource>::New();
+    bwLogo->SetQImage(&bwLogoImage);
+    bwLogo->Update();
+    
+
+    // Create the pipeline
+    VTKPipeline* newPipeline = new VTKPipeline(qvtkWidget->GetInteractor(), 
+                                               logo->GetOutput(), bwLogo->GetOutput(),
+                                               reinterpret_cast<const char*>(QResource(":/opaqueShader").data()), 
+                                               reinterpret_cast<const char*>(QResource(":/translucentShader").data()),
+                                               memoryBudget);
+
+    newPipeline->SetLeanMemory(actionLeanMemory->isChecked());
+    newPipeline->SetFeatureTracker(actionTrackFeatures->isChecked() ? featureTracker : NULL);
+    newPipeline->SetDepthPeeling(actionDepthPeeling->isChecked(), maxPeels);
+    newPipeline->SetDepthSorting(actionDepthSorting->isChecked());
+    newPipeline->SetDisplayType((VTKPipeline::DisplayType)displayComboBox->currentIndex());
+
+    return newPipeline;
+}
+
+
+void MainWindow::SwapPipeline(VTKPipeline* newPipeline, const VolumeCache::Key& key, int step) {
+    // Carry over settings from the current pipeline.  Time steps always keep them.
+    bool timeStep = step >= 0 && pipelineStep >= 0;
+
+    if (pipeline->HasVisualization()) {
+        if (actionKeepCamera->isChecked() || timeStep) {
+            newPipeline->CopyCamera(pipeline);
+        }
+
+        if ((actionKeepIsovalues->isChecked() || timeStep) && newPipeline->GetProductsPending() == 0) {
+            // New pipelines with products pending had the isovalues set when loading
+            double maxValue = newPipeline->GetMaximumAbsoluteValue();
+
+            if (pipeline->GetIsovalue1() <= maxValue && pipeline->GetIsovalue2() <= maxValue) {
+                newPipeline->SetIsovalue1(pipeline->GetIsovalue1());
+                newPipeline->SetIsovalue2(pipeline->GetIsovalue2());
+            }
+        }
+    }
+
+
+    // Sweeps are of the old pipeline's slices
+    if (sliceCine->IsPlaying()) {
+        sliceCine->Stop();
+
+        cinePlayButton->blockSignals(true);
+        cinePlayButton->setChecked(false);
+        cinePlayButton->blockSignals(false);
+    }
+
+
+    // Put away the old pipeline and show the new one in one step
+    ReleasePipeline();
+
+    pipeline = newPipeline;
+    pipelineKey = key;
+    pipelineStep = step;
+
+    pipeline->SetLeanMemory(actionLeanMemory->isChecked());
+    pipeline->SetDepthPeeling(actionDepthPeeling->isChecked(), maxPeels);
+    pipeline->SetDepthSorting(actionDepthSorting->isChecked());
+    pipeline->SetDisplayType((VTKPipeline::DisplayType)displayComboBox->currentIndex());
+    pipeline->SetActive(true);
+
+    if (pipeline->GetProductsPending() == 0) {
+        // Continue lobe tracks before showing.  Otherwise done when products are finished.
+        pipeline->SetFeatureTracker(actionTrackFeatures->isChecked() ? featureTracker : NULL);
+        pipeline->TrackFeatures();
+    }
+
+    pipeline->Render();
+
+    firstImageTime = openTime.elapsed();
+    std::cout << "Time to first image: " << firstImageTime / 1000.0 << " s" << std::endl;
+
+    RefreshTimeGUI();
+
+    if (pipeline->GetProductsPending() > 0) {
+        // Keep the controls disabled until the slices and isosurfaces are done
+        tabWidget->setEnabled(false);
+
+        BuildProducts();
+    }
+    else {
+        RefreshGUI();
+
+        PipelineUpdated();
+    }
+}
+
+
+void MainWindow::BuildProducts() {
+    slicesTime = -1;
+
+    // Slices are queued first, so they start first
+    for (int i = 0; i < pipeline->GetNumberOfProducts(); i++) {
+        QFutureWatcher<void>* watcher = new QFutureWatcher<void>(this);
+        watcher->setProperty("product", i);
+
+        connect(watcher, SIGNAL(finished()), this, SLOT(productFinished()));
+
+        watcher->setFuture(QtConcurrent::run(pipeline, &VTKPipeline::UpdateProduct, i));
+    }
+}
+
+
+void MainWindow::productFinished() {
+    QFutureWatcher<void>* watcher = static_cast<QFutureWatcher<void>*>(sender());
+    int index = watcher->property("product").toInt();
+    watcher->deleteLater();
+
+    // Show the product, if slices before it are done
+    pipeline->FinishProduct(index);
+    pipeline->Render();
+
+
+    // Report timing
+    int surfaces = pipeline->GetNumberOfProducts() - pipeline->GetNumberOfSliceProducts();
+
+    if (slicesTime < 0 && pipeline->GetProductsPending() <= surfaces) {
+        slicesTime = openTime.elapsed();
+        std::cout << "Time to slices: " << slicesTime / 1000.0 << " s" << std::endl;
+    }
+
+    if (pipeline->GetProductsPending() == 0) {
+        int surfacesTime = openTime.elapsed();
+        std::cout << "Time to isosurfaces: " << surfacesTime / 1000.0 << " s" << std::endl;
+
+        statusbar->showMessage(QString("First image %1 s, slices %2 s, isosurfaces %3 s")
+                               .arg(firstImageTime / 1000.0, 0, 'f', 2)
+                               .arg(slicesTime / 1000.0, 0, 'f', 2)
+                               .arg(surfacesTime / 1000.0, 0, 'f', 2), 10000);
+
+        pipeline->SetLeanMemory(actionLeanMemory->isChecked());
+        pipeline->SetFeatureTracker(actionTrackFeatures->isChecked() ? featureTracker : NULL);
+        pipeline->SetDepthSorting(actionDepthSorting->isChecked());
+
+        RefreshGUI();
+
+        PipelineUpdated();
+    }
+}
+
+
+void MainWindow::ReleasePipeline() {
+    if (!pipeline) {
+        return;
+    }
+
+    if (pipeline->HasVisualization()) {
+        pipeline->SetActive(false);
+
+        if (timeSeries && pipelineStep >= 0) {
+            // Keep it around in case of stepping back
+            timeSeries->ReturnStep(pipelineStep, pipeline);
+        }
+        else {
+            volumeCache->Add(pipelineKey, pipeline);
+        }
+    }
+    else {
+        delete pipeline;
+    }
+
+    pipeline = NULL;
+}
+
+
+void MainWindow::SetTimeStep(int step) {
+    if (!timeSeries || step == pipelineStep) {
+        requestedStep = -1;
+        return;
+    }
+
+    // Wait until the current volume is done
+    if (nextPipeline || pipeline->GetProductsPending() > 0) {
+        requestedStep = step;
+        return;
+    }
+
+    requestedStep = -1;
+    openTime.start();
+
+    QString fileName = timeSeries->GetFileName(step);
+    VolumeCache::Key key = VolumeCache::GetKey(fileName.toStdString());
+
+
+    // Use the prefetched pipeline if ready, or wait for it if being prefetched
+    VTKPipeline* prefetched = timeSeries->TakeStep(step);
+
+    if (prefetched) {
+        SwapPipeline(prefetched, key, step);
+
+        return;
+    }
+
+    if (timeSeries->IsStepPending(step)) {
+        requestedStep = step;
+        return;
+    }
+
+    LoadPipeline(fileName, key, step);
+}
+
+
+void MainWindow::PipelineUpdated() {
+    if (pipeline->GetProductsPending() > 0) {
+        return;
+    }
+
+    if (pipeline->TrackFeatures()) {
+        pipeline->Render();
+    }
+
+    if (!timeSeries || pipelineStep < 0) {
+        return;
+    }
+
+    timeSeries->Prefetch(pipelineStep, pipeline);
+
+    if (requestedStep >= 0) {
+        SetTimeStep(requestedStep);
+    }
+}
+
+
+void MainWindow::CloseTimeSeries() {
+    if (!timeSeries) {
+        return;
+    }
+
+    playButton->setChecked(false);
+
+    delete timeSeries;
+    timeSeries = NULL;
+
+    // The current step is now just a volume
+    pipelineStep = -1;
+    requestedStep = -1;
+
+    RefreshTimeGUI();
+}
+
+
+void MainWindow::RefreshGUI() {
+    // List the fields
+    fieldComboBox->blockSignals(true);
+    fieldComboBox->clear();
+
+    for (int i = 0; i < pipeline->GetNumberOfFields(); i++) {
+        fieldComboBox->addItem(pipeline->GetFieldName(i).c_str());
+    }
+
+    fieldComboBox->setCurrentIndex(pipeline->GetField());
+    fieldComboBox->blockSignals(false);
+
+    fieldGroupBox->setVisible(pipeline->GetNumberOfFields() > 1);
+
+
+    // Smoothing
+    smoothingComboBox->setCurrentIndex(pipeline->GetSmoothingType());
+
+    smoothingSlider->blockSignals(true);
+    smoothingSlider->setValue((int)(pipeline->GetSmoothingWidth() * 10.0 + 0.5));
+    smoothingSlider->blockSignals(false);
+
+    smoothingGroupBox->setVisible(pipeline->IsSmoothingSupported());
+    smoothingPreviewed = false;
+
+
+    // Slices
+    QSlider* sliceSliders[3] = { sliceXSlider, sliceYSlider, sliceZSlider };
+
+    for (int i = 0; i < 3; i++) {
+        sliceSliders[i]->blockSignals(true);
+        sliceSliders[i]->setRange(0, std::max(pipeline->GetNumberOfSlicePositions(i) - 1, 0));
+        sliceSliders[i]->setValue(pipeline->GetSlicePosition(i));
+        sliceSliders[i]->blockSignals(false);
+    }
+
+    showSlicesInsideCheckBox->blockSignals(true);
+    showSlicesInsideCheckBox->setChecked(pipeline->GetShowSlicesInside());
+    showSlicesInsideCheckBox->blockSignals(false);
+
+    showObliqueSliceCheckBox->blockSignals(true);
+    showObliqueSliceCheckBox->setChecked(pipeline->GetShowObliqueSlice());
+    showObliqueSliceCheckBox->blockSignals(false);
+
+    wallsComboBox->setCurrentIndex(pipeline->GetWallType());
+
+
+    // Property colors
+    if (pipeline->HasProperty()) {
+        propertyNameLabel->setText(pipeline->GetPropertyName().c_str());
+
+        propertyRangeSpinBox->blockSignals(true);
+        propertyRangeSpinBox->setSingleStep(pipeline->GetPropertyRange() * 0.1);
+        propertyRangeSpinBox->setValue(pipeline->GetPropertyRange());
+        propertyRangeSpinBox->blockSignals(false);
+    }
+
+    propertyGroupBox->setVisible(pipeline->HasProperty());
+
+
+    // Find the maximum absolute value of the data
+    double maxValue = pipeline->GetMaximumAbsoluteValue();
+
+
+    isovalue1DualValue->blockSignals(true);
+    isovalue1DualValue->setValue1Range(1.0, 10.0);
+    isovalue1DualValue->setValue2Range(-10.0, 1.0);
+
+    isovalue1DualValue->setValue1(pipeline->GetIsovalue1() * 10.0);
+    isovalue1DualValue->setValue2(-2.0);
+    isovalue1DualValue->blockSignals(false);
+
+
+
+    isovalue1ExploratorySlider->blockSignals(true);
+    isovalue1ExploratorySlider->setRange(0.0, maxValue);
+    isovalue1ExploratorySlider->setValue(pipeline->GetIsovalue1());
+    isovalue1ExploratorySlider->blockSignals(false);
+
+/*
+    isovalue1DualValue->blockSignals(true);
+    isovalue1DualValue->setValue1Range(0.0, maxValue);
+    isovalue1DualValue->setValue2Range(0.0, maxValue);
+
+    isovalue1DualValue->setValue1(pipeline->GetIsovalue1());
+    isovalue1DualValue->setValue2(pipeline->GetIsovalue2());
+    isovalue1DualValue->blockSignals(false);
+*/
+
+
+    // Set the spin boxes based on the maximum absolute value.
+    // Have to block signals here when changing the range because otherwise, if the maxValue is greater than the 
+    // current range of the spin box, the spin box value will get set to maxValue, causing 
+    // the pipeline isovalue to also be set to maxValue.
+    isovalue1SpinBox->blockSignals(true);
+    isovalue2SpinBox->blockSignals(true);
+
+    isovalue1SpinBox->setRange(0.0, maxValue);
+    isovalue1SpinBox->setValue(pipeline->GetIsovalue1());
+    
+    isovalue2SpinBox->setRange(0.0, maxValue);
+    isovalue2SpinBox->setValue(pipeline->GetIsovalue2());    
+
+    isovalue1SpinBox->blockSignals(false); 
+    isovalue2SpinBox->blockSignals(false);
+
+    
+    isovalue1DoubleSlider->blockSignals(true);
+    isovalue2DoubleSlider->blockSignals(true);
+
+    isovalueExponentSpinBox->setValue(10); 
+
+    isovalue1DoubleSlider->blockSignals(false);
+    isovalue2DoubleSlider->blockSignals(false);
+
+
+    // Set the isovalue visibility checkboxes
+    isovalue1VisibleCheckBox->setChecked(pipeline->GetIsovalue1Visible());
+    isovalue1TranslucentCheckBox->setChecked(pipeline->GetIsovalue1Translucent());
+    isovalue2VisibleCheckBox->setChecked(pipeline->GetIsovalue2Visible());
+    isovalue2TranslucentCheckBox->setChecked(pipeline->GetIsovalue2Translucent());
+
+
+    // Set other widgets
+    colorRadioButton->setChecked(pipeline->GetColorMapType() == VTKPipeline::Color);
+    grayscaleRadioButton->setChecked(pipeline->GetColorMapType() == VTKPipeline::Grayscale);
+
+    showAxesCheckBox->setChecked(pipeline->GetShowAxes());
+    showColorLegendCheckBox->setChecked(pipeline->GetShowColorLegend());
+    showDataLabelCheckBox->setChecked(pipeline->GetShowDataLabel());
+    displayComboBox->setCurrentIndex(pipeline->GetDisplayType());
+
+    interactiveDataResolutionSlider->setValue(pipeline->GetInteractiveDataMagnification() * 10);
+
+    // Enable the GUI
+    tabWidget->setEnabled(true);
+}
+
+
+void MainWindow::RefreshTimeGUI() {
+    if (!timeSeries) {
+        timeGroupBox->hide();
+        return;
+    }
+
+    int step = pipelineStep >= 0 ? pipelineStep : 0;
+    QString fileName = timeSeries->GetFileName(step);
+
+    timeSlider->blockSignals(true);
+    timeSlider->setRange(0, timeSeries->GetNumberOfSteps() - 1);
+    timeSlider->setValue(step);
+    timeSlider->blockSignals(false);
+
+    timeLabel->setText(QString("Step %1 of %2: %3")
+                       .arg(step + 1)
+                       .arg(timeSeries->GetNumberOfSteps())
+                       .arg(fileName.right(fileName.length() - fileName.lastIndexOf("/") - 1)));
+
+    timeGroupBox->show();
 }
\ No newline at end of file
@@ -19,12 +19,20 @@
 
 #include "ui_MainWindow.h"
 
+#include "VolumeCache.h"
+
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QTime>
 
-class QProgressDialog;
+class QLabel;
+class QProgressBar;
+class QTimer;
 
 class QDoubleSlider;
+class FeatureTracker;
+class SliceCine;
+class TimeSeries;
 class VTKPipeline;
 
 class vrpn_Tracker_Remote;
@@ -52,10 +60,22 @@ public slots:
     // Slot to receive signal when volume has been loaded
     virtual void openVolumeFinished();
 
+    // Slot to receive signal when a slice or isosurface has been computed
+    virtual void productFinished();
+
+    // Slot to receive signal when a time step has been prefetched
+    virtual void timeStepReady(int step);
+
 
     // Timer for tracking
     virtual void trackingTimer();
 
+    // Timer for updating the memory display
+    virtual void memoryTimer();
+
+    // Timer for time series playback
+    virtual void playTimer();
+
 
     // Use Qt's auto-connect magic to tie GUI widgets to slots,
     // removing the need to call connect() explicitly.
@@ -64,12 +84,26 @@ public slots:
 
     // Menu events
     virtual void on_actionOpenVolume_triggered();
+    virtual void on_actionOpenTimeSeries_triggered();
+    virtual void on_actionOpenDifference_triggered();
+    virtual void on_actionOpenWavefunction_triggered();
+    virtual void on_actionOpenProperty_triggered();
     virtual void on_actionSaveScreenshot_triggered();
     virtual void on_actionExit_triggered();
 
     virtual void on_actionUseStereo_triggered();
     virtual void on_actionFlipEyes_triggered();
 
+    virtual void on_actionLeanMemory_triggered();
+    virtual void on_actionTrackFeatures_triggered();
+    virtual void on_actionMemoryLimit_triggered();
+    virtual void on_actionMemoryUsage_triggered();
+
+    virtual void on_actionDepthPeeling_triggered();
+    virtual void on_actionPeelBudget_triggered();
+    virtual void on_actionDepthSorting_triggered();
+    virtual void on_actionBenchmarkTransparency_triggered();
+
     virtual void on_actionAbout_triggered();
     virtual void on_actionControls_triggered();
 
@@ -97,13 +131,59 @@ virtual void on_isovalue1ExploratorySlider_sliderReleased();
     virtual void on_showAxesCheckBox_toggled(bool checked);
     virtual void on_showColorLegendCheckBox_toggled(bool checked);
     virtual void on_showDataLabelCheckBox_toggled(bool checked);
+    virtual void on_displayComboBox_activated(int index);
+
+    virtual void on_showSlicesInsideCheckBox_toggled(bool checked);
+    virtual void on_sliceXSlider_valueChanged(int value);
+    virtual void on_sliceYSlider_valueChanged(int value);
+    virtual void on_sliceZSlider_valueChanged(int value);
+    virtual void on_showObliqueSliceCheckBox_toggled(bool checked);
+    virtual void on_obliqueSliceThroughPointsButton_clicked();
+    virtual void on_cineAxisComboBox_activated(int index);
+    virtual void on_cinePlayButton_toggled(bool checked);
+    virtual void on_wallsComboBox_activated(int index);
 
     virtual void on_interactiveDataResolutionSlider_valueChanged(int value);
 
+    virtual void on_fieldComboBox_activated(int index);
+
+    virtual void on_smoothingComboBox_activated(int index);
+    virtual void on_smoothingSlider_valueChanged(int value);
+    virtual void on_smoothingSlider_sliderReleased();
+
+    virtual void on_propertyRangeSpinBox_valueChanged(double value);
+    virtual void on_propertyClearButton_clicked();
+
+    virtual void on_timeSlider_valueChanged(int value);
+    virtual void on_playButton_toggled(bool checked);
+
 protected:
     // The visualization pipeline object
 	VTKPipeline* pipeline;
 
+    // Memory accounting, shared by all subsystems and kept across pipelines
+    MemoryBudget* memoryBudget;
+
+    // Live memory display in the status bar
+    QLabel* memoryLabel;
+
+    // Lobe tracks, kept across pipelines
+    FeatureTracker* featureTracker;
+
+    // Recently loaded volumes, and the key of the current one
+    VolumeCache* volumeCache;
+    VolumeCache::Key pipelineKey;
+
+    // The open time series, if any, the step of the current pipeline, and a step waiting to be shown
+    TimeSeries* timeSeries;
+    int pipelineStep;
+    int requestedStep;
+
+    QTimer* playbackTimer;
+
+    // Sweeps of a slice through the current pipeline's volume
+    SliceCine* sliceCine;
+
 
     // Double sliders to combine sliders and spin boxes
     QDoubleSlider* isovalue1DoubleSlider;
@@ -115,18 +195,70 @@ protected:
     QDoubleSlider* isovalue2OpacityDoubleSlider; 
 
 
+    // The pipeline being loaded on worker threads while the current one is shown
+    VTKPipeline* nextPipeline;
+    VolumeCache::Key nextPipelineKey;
+    int nextPipelineStep;
+
+    // Most layers of translucent isosurfaces depth peeled per frame
+    int maxPeels;
+
     // Progress bar objects
     QFuture<bool> future;
+    QFutureWatcher<bool> futureWatcher;
+    QProgressBar* progressBar;
 
     std::string errorMessage;
 
+    // Timing of the stages of opening a volume, in milliseconds
+    QTime openTime;
+    int firstImageTime;
+    int slicesTime;
+
+    // Has smoothing been previewed on the downsampled volume but not yet applied?
+    bool smoothingPreviewed;
+
+
+    // Create a VTK pipeline object.  It is not shown until activated.
+    VTKPipeline* CreatePipeline();
+
+    // Start loading a file into a new pipeline on a worker thread.  Step is the time step, or -1.
+    void LoadPipeline(const QString& fileName, const VolumeCache::Key& key, int step);
 
-    // Create the VTK pipeline object
-    void CreatePipeline();
+    // Create the next pipeline and show progress, before starting to load into it
+    void StartPipeline(const VolumeCache::Key& key, int step, const QString& message);
+
+    // Apply the smoothing settings of the GUI, previewing on the downsampled volume if doFast
+    void UpdateSmoothing(bool doFast);
+
+    // Show a new pipeline in place of the current one, carrying over the camera and isovalues if 
+    // requested, or always for time steps
+    void SwapPipeline(VTKPipeline* newPipeline, const VolumeCache::Key& key, int step = -1);
+
+    // Move the current pipeline to the time series or the volume cache if it has data, otherwise delete it
+    void ReleasePipeline();
+
+    // Show a time step, using a prefetched pipeline if ready.  Deferred while another volume is 
+    // loading or being built.
+    void SetTimeStep(int step);
+
+    // Called when the current pipeline's slices and isosurfaces are done, after loading or an
+    // isovalue change.  Continues lobe tracks, prefetches around the current time step, and shows 
+    // any step requested meanwhile.
+    void PipelineUpdated();
+
+    // Close the time series, keeping the current pipeline
+    void CloseTimeSeries();
+
+    // Compute the slices and isosurfaces of the current pipeline on the thread pool
+    void BuildProducts();
 
     // Set GUI widget values from the VTK pipeline
     void RefreshGUI();
 
+    // Set the time widgets from the time series
+    void RefreshTimeGUI();
+
 
     // VRPN
     vrpn_Tracker_Remote* tracker;
@@ -0,0 +1,211 @@
+/*=========================================================================
+
+  Name:        MemoryBudget.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Tracks memory held by each subsystem (volume, downsampled
+               volume, surfaces, slices, caches) and asks subsystems to
+               evict data that can be regenerated when a configurable
+               limit is exceeded.
+
+=========================================================================*/
+
+
+#include "MemoryBudget.h"
+
+#include <vtkAlgorithm.h>
+#include <vtkDataObject.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+
+MemoryBudget::PipelineConsumer::PipelineConsumer(const std::vector<vtkAlgorithm*>& algorithms, bool evictable)
+: algorithms(algorithms), evictable(evictable) {
+}
+
+unsigned long MemoryBudget::PipelineConsumer::GetMemorySize() {
+    unsigned long size = 0;
+    for (int i = 0; i < (int)algorithms.size(); i++) {
+        for (int j = 0; j < algorithms[i]->GetNumberOfOutputPorts(); j++) {
+            vtkDataObject* output = algorithms[i]->GetOutputDataObject(j);
+
+            if (output && !output->GetDataReleased()) {
+                size += output->GetActualMemorySize();
+            }
+        }
+    }
+
+    return size;
+}
+
+bool MemoryBudget::PipelineConsumer::Evict() {
+    if (!evictable) {
+        return false;
+    }
+
+    bool evicted = false;
+    for (int i = 0; i < (int)algorithms.size(); i++) {
+        for (int j = 0; j < algorithms[i]->GetNumberOfOutputPorts(); j++) {
+            vtkDataObject* output = algorithms[i]->GetOutputDataObject(j);
+
+            if (output && !output->GetDataReleased()) {
+                output->ReleaseData();
+                evicted = true;
+            }
+        }
+    }
+
+    return evicted;
+}
+
+
+MemoryBudget::MemoryBudget() {
+    limit = 0;
+    overLimit = false;
+}
+
+MemoryBudget::~MemoryBudget() {
+}
+
+
+void MemoryBudget::AddConsumer(const std::string& name, Consumer* consumer, int priority) {
+    Entry entry;
+    entry.name = name;
+    entry.consumer = consumer;
+    entry.priority = priority;
+    entry.current = entry.peak = consumer->GetMemorySize();
+
+    entries.push_back(entry);
+}
+
+void MemoryBudget::RemoveConsumer(Consumer* consumer) {
+    for (int i = 0; i < (int)entries.size(); i++) {
+        if (entries[i].consumer == consumer) {
+            entries.erase(entries.begin() + i);
+            return;
+        }
+    }
+}
+
+
+unsigned long MemoryBudget::GetLimit() {
+    return limit;
+}
+
+void MemoryBudget::SetLimit(unsigned long kilobytes) {
+    limit = kilobytes;
+    overLimit = false;
+
+    std::cout << "MemoryBudget: limit ";
+    if (limit > 0) {
+        std::cout << limit / 1024 << " MB" << std::endl;
+    }
+    else {
+        std::cout << "off" << std::endl;
+    }
+}
+
+
+void MemoryBudget::Update() {
+    for (int i = 0; i < (int)entries.size(); i++) {
+        entries[i].current = entries[i].consumer->GetMemorySize();
+        entries[i].peak = std::max(entries[i].peak, entries[i].current);
+    }
+}
+
+void MemoryBudget::Enforce() {
+    Update();
+
+    if (limit == 0 || GetTotal() <= limit) {
+        overLimit = false;
+        return;
+    }
+
+    // Evict lowest priority first
+    std::vector<Entry*> order;
+    for (int i = 0; i < (int)entries.size(); i++) {
+        order.push_back(&entries[i]);
+    }
+
+    std::stable_sort(order.begin(), order.end(), ComparePriority);
+
+    std::cout << std::fixed << std::setprecision(1);
+
+    for (int i = 0; i < (int)order.size(); i++) {
+        // Consumers such as caches may evict in several steps
+        while (GetTotal() > limit) {
+            unsigned long before = order[i]->current;
+
+            if (!order[i]->consumer->Evict()) {
+                break;
+            }
+
+            order[i]->current = order[i]->consumer->GetMemorySize();
+
+            std::cout << "MemoryBudget: evicted " << order[i]->name << ", freeing "
+                      << (before - std::min(before, order[i]->current)) / 1024.0 << " MB" << std::endl;
+        }
+    }
+
+    if (GetTotal() <= limit) {
+        overLimit = false;
+    }
+    else if (!overLimit) {
+        overLimit = true;
+
+        std::cout << "MemoryBudget: " << GetTotal() / 1024.0 << " MB in use after eviction, over the "
+                  << limit / 1024 << " MB limit" << std::endl;
+    }
+}
+
+
+bool MemoryBudget::ComparePriority(const Entry* a, const Entry* b) {
+    return a->priority < b->priority;
+}
+
+
+unsigned long MemoryBudget::GetTotal() {
+    unsigned long total = 0;
+    for (int i = 0; i < (int)entries.size(); i++) {
+        total += entries[i].current;
+    }
+
+    return total;
+}
+
+
+std::string MemoryBudget::GetReport() {
+    Update();
+
+    unsigned long totalPeak = 0;
+
+    std::stringstream report;
+    report << std::fixed << std::setprecision(1);
+    report << "Memory (MB): current / peak" << std::endl;
+
+    for (int i = 0; i < (int)entries.size(); i++) {
+        report << entries[i].name << ": "
+               << entries[i].current / 1024.0 << " / "
+               << entries[i].peak / 1024.0 << std::endl;
+
+        totalPeak += entries[i].peak;
+    }
+
+    report << "Total: " << GetTotal() / 1024.0 << " / " << totalPeak / 1024.0 << std::endl;
+
+    report << "Limit: ";
+    if (limit > 0) {
+        report << limit / 1024 << std::endl;
+    }
+    else {
+        report << "none" << std::endl;
+    }
+
+    return report.str();
+}
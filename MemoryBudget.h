@@ -0,0 +1,133 @@
+/*=========================================================================
+
+  Name:        MemoryBudget.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Tracks memory held by each subsystem (volume, downsampled
+               volume, surfaces, slices, caches) and asks subsystems to
+               evict data that can be regenerated when a configurable
+               limit is exceeded.
+
+=========================================================================*/
+
+
+#ifndef MEMORYBUDGET_H
+#define MEMORYBUDGET_H
+
+#include <string>
+#include <vector>
+
+class vtkAlgorithm;
+
+
+class MemoryBudget {
+public:
+    // Interface for anything holding memory
+    class Consumer {
+    public:
+        virtual ~Consumer() {}
+
+        // Memory currently held, in kilobytes
+        virtual unsigned long GetMemorySize() = 0;
+
+        // Free memory that can be regenerated.  May be called repeatedly while over the limit.
+        // Return false if nothing was freed.
+        virtual bool Evict() = 0;
+    };
+
+    // Consumer for the outputs of pipeline filters, on all output ports.  Evicting releases the
+    // output data, which is regenerated on the next update that needs it.
+    class PipelineConsumer : public Consumer {
+    public:
+        PipelineConsumer(const std::vector<vtkAlgorithm*>& algorithms, bool evictable);
+
+        virtual unsigned long GetMemorySize();
+        virtual bool Evict();
+
+    protected:
+        std::vector<vtkAlgorithm*> algorithms;
+        bool evictable;
+    };
+
+    // Consumer for what filters keep besides their outputs, e.g. planes copied ahead of a 
+    // slice.  Filters provide GetCacheSize(), in kilobytes, and ReleaseCache().
+    template <class T>
+    class CacheConsumer : public Consumer {
+    public:
+        CacheConsumer(const std::vector<T*>& filters) : filters(filters) {}
+
+        virtual unsigned long GetMemorySize() {
+            unsigned long size = 0;
+            for (int i = 0; i < (int)filters.size(); i++) {
+                size += filters[i]->GetCacheSize();
+            }
+
+            return size;
+        }
+
+        virtual bool Evict() {
+            bool evicted = false;
+            for (int i = 0; i < (int)filters.size(); i++) {
+                unsigned long before = filters[i]->GetCacheSize();
+
+                if (before > 0) {
+                    filters[i]->ReleaseCache();
+                    evicted = evicted || filters[i]->GetCacheSize() < before;
+                }
+            }
+
+            return evicted;
+        }
+
+    protected:
+        std::vector<T*> filters;
+    };
+
+    MemoryBudget();
+    ~MemoryBudget();
+
+    // Add/remove a consumer.  Consumers are evicted in order of increasing priority.
+    // The budget does not take ownership.
+    void AddConsumer(const std::string& name, Consumer* consumer, int priority);
+    void RemoveConsumer(Consumer* consumer);
+
+    // Get/set the memory limit in kilobytes.  0 for no limit.
+    unsigned long GetLimit();
+    void SetLimit(unsigned long limit);
+
+    // Sample memory use of all consumers, tracking peaks
+    void Update();
+
+    // Sample memory use and evict until under the limit.  Only call when evicted data
+    // is not being used, e.g. after a render.
+    void Enforce();
+
+    // Get the current total, in kilobytes
+    unsigned long GetTotal();
+
+    // Get the current and peak memory use of each consumer
+    std::string GetReport();
+
+protected:
+    struct Entry {
+        std::string name;
+        Consumer* consumer;
+        int priority;
+        unsigned long current;
+        unsigned long peak;
+    };
+    std::vector<Entry> entries;
+
+    static bool ComparePriority(const Entry* a, const Entry* b);
+
+    unsigned long limit;
+
+    // Only log when going over the limit, not on every render
+    bool overLimit;
+};
+
+
+#endif
@@ -0,0 +1,118 @@
+/*=========================================================================
+
+  Name:        ObliqueSlice.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Container class for a slice of the volume at an arbitrary
+               orientation.
+
+=========================================================================*/
+
+
+#include "ObliqueSlice.h"
+
+#include "Slice.h"
+#include "vtkObliqueReslice.h"
+
+#include <vtkActor.h>
+#include <vtkAlgorithm.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkColorTransferFunction.h>
+#include <vtkLookupTable.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkProperty.h>
+#include <vtkTexture.h>
+
+
+// Sampling relative to full resolution while the plane is dragged
+static const double fastMagnification = 0.25;
+
+
+ObliqueSlice::ObliqueSlice(vtkAlgorithmOutput* volume, vtkColorTransferFunction* colorMap,
+                           double clipValue, const double origin[3], const double normal[3]) 
+    : colorMap(colorMap), clipValue(clipValue) {
+    // Sample the volume on the plane, along with a rectangle to texture it on
+    reslice = vtkSmartPointer<vtkObliqueReslice>::New();
+    reslice->SetInputConnection(volume);
+    reslice->SetOrigin(origin[0], origin[1], origin[2]);
+    reslice->SetNormal(normal[0], normal[1], normal[2]);
+
+
+    // Color the slice with a lookup table built from the color map, clipping with its alpha.
+    // Samples outside the volume are 0, so they are clipped too.
+    lookupTable = vtkSmartPointer<vtkLookupTable>::New();
+    UpdateColors();
+
+    vtkSmartPointer<vtkTexture> texture = vtkSmartPointer<vtkTexture>::New();
+    texture->SetInputConnection(reslice->GetOutputPort(0));
+    texture->SetLookupTable(lookupTable);
+    texture->MapColorScalarsThroughLookupTableOn();
+    texture->InterpolateOn();
+    texture->RepeatOff();
+    texture->EdgeClampOn();
+
+    vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+    mapper->SetInputConnection(reslice->GetOutputPort(1));
+    mapper->ScalarVisibilityOff();
+
+
+    // Seen from both sides, and unlit like the other slices
+    actor = vtkSmartPointer<vtkActor>::New();
+    actor->SetMapper(mapper);
+    actor->SetTexture(texture);
+
+    vtkProperty* p = actor->GetProperty();
+    p->SetColor(1.0, 1.0, 1.0);
+    p->SetAmbient(1.0);
+    p->SetDiffuse(0.0);
+    p->SetSpecular(0.0);
+}
+
+ObliqueSlice::~ObliqueSlice() {
+}
+
+
+void ObliqueSlice::SetInput(vtkAlgorithmOutput* volume) {
+    reslice->SetInputConnection(volume);
+}
+
+
+vtkActor* ObliqueSlice::GetActor() {
+    return actor;
+}
+
+
+vtkAlgorithm* ObliqueSlice::GetReslice() {
+    return reslice;
+}
+
+
+void ObliqueSlice::SetPlane(const double origin[3], const double normal[3], bool doFast) {
+    reslice->SetOrigin(origin[0], origin[1], origin[2]);
+    reslice->SetNormal(normal[0], normal[1], normal[2]);
+    reslice->SetMagnification(doFast ? fastMagnification : 1.0);
+}
+
+void ObliqueSlice::GetPlane(double origin[3], double normal[3]) {
+    reslice->GetOrigin(origin);
+    reslice->GetNormal(normal);
+}
+
+
+void ObliqueSlice::SetClipValue(double value) {
+    if (value == clipValue) {
+        return;
+    }
+
+    clipValue = value;
+
+    UpdateColors();
+}
+
+
+void ObliqueSlice::UpdateColors() {
+    Slice::BuildLookupTable(lookupTable, colorMap, clipValue);
+}
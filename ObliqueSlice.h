@@ -0,0 +1,62 @@
+/*=========================================================================
+
+  Name:        ObliqueSlice.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Container class for a slice of the volume at an arbitrary
+               orientation.
+
+=========================================================================*/
+
+
+#ifndef OBLIQUESLICE_H
+
+
+#include "vtkSmartPointer.h"
+
+class vtkActor;
+class vtkAlgorithm;
+class vtkAlgorithmOutput;
+class vtkColorTransferFunction;
+class vtkLookupTable;
+class vtkObliqueReslice;
+
+
+class ObliqueSlice {
+public:
+    ObliqueSlice(vtkAlgorithmOutput* volume, vtkColorTransferFunction* colorMap, 
+                 double clipValue, const double origin[3], const double normal[3]);
+    ~ObliqueSlice();
+
+    void SetInput(vtkAlgorithmOutput* volume);
+
+    vtkActor* GetActor();
+
+    // Move the plane.  Fast updates sample the plane coarsely, to follow a plane widget while it 
+    // is dragged, and a full resolution update should follow when the drag ends.
+    void SetPlane(const double origin[3], const double normal[3], bool doFast = false);
+    void GetPlane(double origin[3], double normal[3]);
+
+    // Values between -value and value are transparent, as for Slice
+    void SetClipValue(double value);
+
+    // Rebuild the lookup table after the color map changes
+    void UpdateColors();
+
+    // Get the filter sampling the plane, for memory accounting
+    vtkAlgorithm* GetReslice();
+
+protected:
+    vtkSmartPointer<vtkObliqueReslice> reslice;
+    vtkSmartPointer<vtkColorTransferFunction> colorMap;
+    vtkSmartPointer<vtkLookupTable> lookupTable;
+    vtkSmartPointer<vtkActor> actor;
+
+    double clipValue;
+};
+
+
+#endif
@@ -0,0 +1,332 @@
+/*=========================================================================
+
+  Name:        SaveSlices.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Command line tool that saves a stack of slices through a
+               volume as numbered TIFF or PNG images, colored with the
+               Voluminous color maps, e.g. for making movies.
+
+               Frames are resliced, resampled, colored, and compressed
+               in parallel by a pool of workers, each with its own
+               pipeline.  Each frame is written to the file for its
+               position in the stack, so the files are numbered in frame
+               order however the work is divided.
+
+=========================================================================*/
+
+
+#include "VTKPipeline.h"
+#include "vtkVolumeSlab.h"
+
+#include <vtkAlgorithm.h>
+#include <vtkColorTransferFunction.h>
+#include <vtkCriticalSection.h>
+#include <vtkImageData.h>
+#include <vtkImageMapToColors.h>
+#include <vtkImageReslice.h>
+#include <vtkImageResample.h>
+#include <vtkImageWriter.h>
+#include <vtkMultiThreader.h>
+#include <vtkPNGWriter.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTIFFWriter.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+// Settings for slicing along one axis, shared by the workers
+struct SliceStack {
+    vtkImageData* volume;
+    vtkColorTransferFunction* colorMap;
+
+    int axis;
+    std::vector<int> planes;
+    double magnification;
+
+    bool png;
+    std::string prefix;
+    int digits;
+
+    // Next frame to save, and frames that failed
+    int nextFrame;
+    int failed;
+    vtkSimpleCriticalSection lock;
+};
+
+
+static void PrintUsage() {
+    std::cout << "Usage: SaveSlices [options] volumeFile" << std::endl
+              << std::endl
+              << "  -axis x|y|z|all         Axis normal to the slices (default all)" << std::endl
+              << "  -range first last       Grid planes to start and end at (default all)" << std::endl
+              << "  -step n                 Grid planes between slices, negative to go" << std::endl
+              << "                          backwards (default 1)" << std::endl
+              << "  -magnification m        Samples per grid point (default 1)" << std::endl
+              << "  -colormap color|gray    Color map (default color)" << std::endl
+              << "  -format tiff|png        Image format (default tiff)" << std::endl
+              << "  -threads n              Number of workers (default number of processors)" << std::endl
+              << "  -output prefix          Prefix of the image files, followed by the axis" << std::endl
+              << "                          and frame number (default the volume file name)" << std::endl;
+}
+
+
+static VTK_THREAD_RETURN_TYPE SaveFrames(void* arg) {
+    vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    SliceStack* stack = static_cast<SliceStack*>(info->UserData);
+
+    // Each worker has its own pipeline, fed by a shallow copy of the volume so no executive is
+    // shared, and its own color map, as color maps build their tables lazily
+    vtkSmartPointer<vtkImageData> volume = vtkSmartPointer<vtkImageData>::New();
+    volume->ShallowCopy(stack->volume);
+
+    vtkSmartPointer<vtkColorTransferFunction> colorMap = vtkSmartPointer<vtkColorTransferFunction>::New();
+    colorMap->DeepCopy(stack->colorMap);
+
+    // Slices are laid out as in Voluminous: y and z for x, x and z for y, and x and y for z
+    static const double directions[3][9] = { { 0, 1, 0,  0, 0, 1,  1, 0, 0 },
+                                             { 1, 0, 0,  0, 0, 1,  0, 1, 0 },
+                                             { 1, 0, 0,  0, 1, 0,  0, 0, 1 } };
+
+    vtkSmartPointer<vtkImageReslice> reslice = vtkSmartPointer<vtkImageReslice>::New();
+    reslice->SetInput(volume);
+    reslice->SetOutputDimensionality(2);
+    reslice->SetResliceAxesDirectionCosines(directions[stack->axis]);
+    reslice->SetNumberOfThreads(1);
+
+    vtkSmartPointer<vtkImageResample> resample = vtkSmartPointer<vtkImageResample>::New();
+    resample->SetInputConnection(reslice->GetOutputPort());
+    resample->SetAxisMagnificationFactor(0, stack->magnification);
+    resample->SetAxisMagnificationFactor(1, stack->magnification);
+    resample->SetAxisMagnificationFactor(2, 1.0);
+    resample->SetInterpolationModeToLinear();
+    resample->SetNumberOfThreads(1);
+
+    vtkSmartPointer<vtkImageMapToColors> colors = vtkSmartPointer<vtkImageMapToColors>::New();
+    colors->SetInputConnection(resample->GetOutputPort());
+    colors->SetLookupTable(colorMap);
+    colors->SetOutputFormatToRGB();
+    colors->SetNumberOfThreads(1);
+
+    vtkSmartPointer<vtkImageWriter> writer;
+    if (stack->png) {
+        writer = vtkSmartPointer<vtkPNGWriter>::New();
+    }
+    else {
+        vtkSmartPointer<vtkTIFFWriter> tiffWriter = vtkSmartPointer<vtkTIFFWriter>::New();
+        tiffWriter->SetCompressionToPackBits();
+        writer = tiffWriter;
+    }
+    writer->SetInputConnection(colors->GetOutputPort());
+
+    double origin[3];
+    double spacing[3];
+    int extent[6];
+    volume->GetOrigin(origin);
+    volume->GetSpacing(spacing);
+    volume->GetExtent(extent);
+
+    const char* axisNames[3] = { "X", "Y", "Z" };
+
+    // Take frames until none are left
+    while (true) {
+        stack->lock.Lock();
+        int frame = stack->nextFrame++;
+        stack->lock.Unlock();
+
+        if (frame >= (int)stack->planes.size()) {
+            break;
+        }
+
+        double position[3];
+        for (int i = 0; i < 3; i++) {
+            position[i] = origin[i] + (extent[2 * i] + extent[2 * i + 1]) * 0.5 * spacing[i];
+        }
+        position[stack->axis] = origin[stack->axis] +
+                                (extent[2 * stack->axis] + stack->planes[frame]) * spacing[stack->axis];
+
+        reslice->SetResliceAxesOrigin(position);
+
+        char number[32];
+        sprintf(number, "%0*d", stack->digits, frame);
+
+        std::string fileName = stack->prefix + "_" + axisNames[stack->axis] + "_" + number +
+                               (stack->png ? ".png" : ".tif");
+
+        writer->SetFileName(fileName.c_str());
+        writer->Write();
+
+        if (writer->GetErrorCode() != 0) {
+            stack->lock.Lock();
+            std::cout << "SaveSlices: Could not write " << fileName << std::endl;
+            stack->failed++;
+            stack->lock.Unlock();
+        }
+    }
+
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+
+int main(int argc, char** argv) {
+    // Parse the options
+    std::string axisOption = "all";
+    int first = 0;
+    int last = -1;
+    int step = 1;
+    double magnification = 1.0;
+    VTKPipeline::ColorMapType colorMapType = VTKPipeline::Color;
+    bool png = false;
+    int numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    std::string prefix;
+    std::string fileName;
+
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (option == "-axis" && hasValue) {
+            axisOption = argv[++i];
+        }
+        else if (option == "-range" && i + 2 < argc) {
+            first = atoi(argv[++i]);
+            last = atoi(argv[++i]);
+        }
+        else if (option == "-step" && hasValue) {
+            step = atoi(argv[++i]);
+        }
+        else if (option == "-magnification" && hasValue) {
+            magnification = atof(argv[++i]);
+        }
+        else if (option == "-colormap" && hasValue) {
+            std::string value = argv[++i];
+            colorMapType = value == "gray" || value == "grayscale" ? VTKPipeline::Grayscale :
+                                                                     VTKPipeline::Color;
+        }
+        else if (option == "-format" && hasValue) {
+            png = std::string(argv[++i]) == "png";
+        }
+        else if (option == "-threads" && hasValue) {
+            numThreads = atoi(argv[++i]);
+        }
+        else if (option == "-output" && hasValue) {
+            prefix = argv[++i];
+        }
+        else if (option[0] != '-' && fileName.empty()) {
+            fileName = option;
+        }
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    std::vector<int> axes;
+    if (axisOption == "x") axes.push_back(0);
+    else if (axisOption == "y") axes.push_back(1);
+    else if (axisOption == "z") axes.push_back(2);
+    else if (axisOption == "all") {
+        axes.push_back(0);
+        axes.push_back(1);
+        axes.push_back(2);
+    }
+
+    if (fileName.empty() || axes.empty() || step == 0 || magnification <= 0.0 || numThreads < 1) {
+        PrintUsage();
+        return 1;
+    }
+
+    if (prefix.empty()) {
+        prefix = fileName.substr(0, fileName.find_last_of('.'));
+    }
+
+
+    // Load the data
+    std::string fileInfo;
+    std::string errorMessage;
+    vtkSmartPointer<vtkAlgorithm> reader = VTKPipeline::ReadVolume(fileName, fileInfo, &errorMessage);
+
+    if (!reader) {
+        std::cout << "SaveSlices: " << errorMessage << std::endl;
+        return 1;
+    }
+
+    // Nested grids are sliced through their first block, which covers the whole volume
+    vtkImageData* volume = vtkImageData::SafeDownCast(vtkVolumeSlab::GetGrid(reader->GetOutputDataObject(0)));
+
+    if (!volume || !volume->GetPointData()->GetScalars()) {
+        std::cout << "SaveSlices: Only uniform grids with point scalars are supported" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SaveSlices: " << fileInfo << std::endl;
+
+
+    // Color as Voluminous does for the range of the data
+    double range[2];
+    volume->GetScalarRange(range);
+
+    vtkSmartPointer<vtkColorTransferFunction> colorMap = vtkSmartPointer<vtkColorTransferFunction>::New();
+    VTKPipeline::BuildColorMap(colorMap, colorMapType, range);
+
+
+    // Save the slices along each axis
+    int dimensions[3];
+    volume->GetDimensions(dimensions);
+
+    int failed = 0;
+
+    for (int i = 0; i < (int)axes.size(); i++) {
+        int axis = axes[i];
+        int n = dimensions[axis];
+
+        // Planes from first to last, clamped to the volume, in the direction of the step
+        int start = std::max(0, std::min(first, n - 1));
+        int end = last < 0 ? n - 1 : std::max(0, std::min(last, n - 1));
+
+        if ((step > 0 && start > end) || (step < 0 && start < end)) {
+            std::swap(start, end);
+        }
+
+        SliceStack stack;
+        stack.volume = volume;
+        stack.colorMap = colorMap;
+        stack.axis = axis;
+        stack.magnification = magnification;
+        stack.png = png;
+        stack.prefix = prefix;
+        stack.nextFrame = 0;
+        stack.failed = 0;
+
+        for (int plane = start; step > 0 ? plane <= end : plane >= end; plane += step) {
+            stack.planes.push_back(plane);
+        }
+
+        // Enough digits for the last frame, and at least 3
+        char number[32];
+        sprintf(number, "%d", (int)stack.planes.size() - 1);
+        stack.digits = std::max(3, (int)strlen(number));
+
+        vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+        threader->SetNumberOfThreads(std::max(1, std::min(numThreads, (int)stack.planes.size())));
+        threader->SetSingleMethod(SaveFrames, &stack);
+        threader->SingleMethodExecute();
+
+        std::cout << "SaveSlices: Saved " << (int)stack.planes.size() - stack.failed << " of "
+                  << (int)stack.planes.size() << " slices along " << "XYZ"[axis] << std::endl;
+
+        failed += stack.failed;
+    }
+
+    return failed > 0 ? 1 : 0;
+}
@@ -1,186 +1,289 @@
-/*=========================================================================
-
-  Name:        Slice.cpp
-
-  Author:      David Borland, The Renaissance Computing Institute (RENCI)
-
-  Copyright:   The Renaissance Computing Institute (RENCI)
-
-  Description: Container class for a slice of the volume.
-
-=========================================================================*/
-
-
-#include "Slice.h"
-
-
-#include <vtkActor.h>
-#include <vtkActorCollection.h>
-#include <vtkAlgorithmOutput.h>
-#include <vtkClipPolyData.h>
-#include <vtkColorTransferFunction.h>
-#include <vtkCutter.h>
-#include <vtkPlane.h>
-#include <vtkPolyDataMapper.h>
-#include <vtkProperty.h>
-
-
-#include <vtkReverseSense.h>
-
-
-Slice::Slice(vtkAlgorithmOutput* volume, vtkColorTransferFunction* colorMap,
-             int direction, double clipValue, const double center[3], const double size[3]) {
-    // Create the plane used for cutting
-    plane = vtkSmartPointer<vtkPlane>::New();
-
-    if (direction == 0) plane->SetNormal(0, 0, 1);         // XY
-    else if (direction == 1) plane->SetNormal(0, 1, 0);    // XZ
-    else if (direction == 2) plane->SetNormal(1, 0, 0);    // YZ
-
-    plane->SetOrigin(center[0], center[1], center[2]);
-
-
-    // Create the cutter
-    cutter = vtkSmartPointer<vtkCutter>::New();
-    cutter->SetInputConnection(volume);
-    cutter->SetCutFunction(plane);
-
-
-    // Create the clipper
-    clipperPos = vtkSmartPointer<vtkClipPolyData>::New();
-    clipperPos->SetInputConnection(cutter->GetOutputPort());
-    clipperPos->SetValue(clipValue);
-
-    clipperNeg = vtkSmartPointer<vtkClipPolyData>::New();
-    clipperNeg->SetInputConnection(cutter->GetOutputPort());
-    clipperNeg->SetValue(-clipValue);
-    clipperNeg->InsideOutOn();
-
-
-    // Create the normal flippers
-    vtkSmartPointer<vtkReverseSense> reversePos = vtkSmartPointer<vtkReverseSense>::New();
-    reversePos->SetInputConnection(clipperPos->GetOutputPort());
-    reversePos->ReverseNormalsOn();
-    reversePos->ReverseCellsOn();
-    
-    vtkSmartPointer<vtkReverseSense> reverseNeg = vtkSmartPointer<vtkReverseSense>::New();
-    reverseNeg->SetInputConnection(clipperNeg->GetOutputPort());
-    reverseNeg->ReverseNormalsOn();
-    reverseNeg->ReverseCellsOn();
-
-    
-    // Mappers for the slices
-    vtkSmartPointer<vtkPolyDataMapper> mapperPos1 = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapperPos1->SetInputConnection(clipperPos->GetOutputPort());
-    mapperPos1->SetLookupTable(colorMap);
-    mapperPos1->InterpolateScalarsBeforeMappingOn();
-    mapperPos1->UseLookupTableScalarRangeOn();
-
-    vtkSmartPointer<vtkPolyDataMapper> mapperPos2 = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapperPos2->SetInputConnection(reversePos->GetOutputPort());
-    mapperPos2->SetLookupTable(colorMap);        
-    mapperPos2->InterpolateScalarsBeforeMappingOn();
-    mapperPos2->UseLookupTableScalarRangeOn();
-
-    vtkSmartPointer<vtkPolyDataMapper> mapperNeg1 = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapperNeg1->SetInputConnection(clipperNeg->GetOutputPort());
-    mapperNeg1->SetLookupTable(colorMap);
-    mapperNeg1->InterpolateScalarsBeforeMappingOn();
-    mapperNeg1->UseLookupTableScalarRangeOn();
-
-    vtkSmartPointer<vtkPolyDataMapper> mapperNeg2 =vtkSmartPointer< vtkPolyDataMapper>::New();
-    mapperNeg2->SetInputConnection(reverseNeg->GetOutputPort());
-    mapperNeg2->SetLookupTable(colorMap);        
-    mapperNeg2->InterpolateScalarsBeforeMappingOn();
-    mapperNeg2->UseLookupTableScalarRangeOn();
-
-
-    // Actors for the slices
-    vtkSmartPointer<vtkActor> actorPos1 = vtkSmartPointer<vtkActor>::New();
-    actorPos1->SetMapper(mapperPos1);
-
-    vtkSmartPointer<vtkActor> actorPos2 = vtkSmartPointer<vtkActor>::New();
-    actorPos2->SetMapper(mapperPos2);
-
-    vtkSmartPointer<vtkActor> actorNeg1 = vtkSmartPointer<vtkActor>::New();
-    actorNeg1->SetMapper(mapperNeg1);
-
-    vtkSmartPointer<vtkActor> actorNeg2 = vtkSmartPointer<vtkActor>::New();
-    actorNeg2->SetMapper(mapperNeg2);
-
-
-    // Move the slices to the appropriate positions
-    if (direction == 0) {
-        // XY
-        actorPos1->SetPosition(0.0, 0.0, size[2] * 0.5);
-        actorPos2->SetPosition(0.0, 0.0, -size[2] * 0.5);
-
-        actorNeg1->SetPosition(0.0, 0.0, size[2] * 0.5);
-        actorNeg2->SetPosition(0.0, 0.0, -size[2] * 0.5);
-    }
-    else if (direction == 1) {
-        // XZ
-        actorPos1->SetPosition(0.0, size[1] * 0.5, 0.0);
-        actorPos2->SetPosition(0.0, -size[1] * 0.5, 0.0);
-
-        actorNeg1->SetPosition(0.0, size[1] * 0.5, 0.0);
-        actorNeg2->SetPosition(0.0, -size[1] * 0.5, 0.0);
-    }
-    else {
-        // ZY
-        actorPos1->SetPosition(size[0] * 0.5, 0.0, 0.0);
-        actorPos2->SetPosition(-size[0] * 0.5, 0.0, 0.0);
-
-        actorNeg1->SetPosition(size[0] * 0.5, 0.0, 0.0);
-        actorNeg2->SetPosition(-size[0] * 0.5, 0.0, 0.0);
-    }
-
-    // Turn on backface culling and turn off lighting
-    actorPos1->GetProperty()->BackfaceCullingOn();
-    actorPos2->GetProperty()->BackfaceCullingOn();
-    actorPos1->GetProperty()->SetAmbient(1.0);
-    actorPos2->GetProperty()->SetAmbient(1.0);
-    actorPos1->GetProperty()->SetDiffuse(0.0);
-    actorPos2->GetProperty()->SetDiffuse(0.0);
-    actorPos1->GetProperty()->SetSpecular(0.0);
-    actorPos2->GetProperty()->SetSpecular(0.0);
-
-    actorNeg1->GetProperty()->BackfaceCullingOn();
-    actorNeg2->GetProperty()->BackfaceCullingOn();
-    actorNeg1->GetProperty()->SetAmbient(1.0);
-    actorNeg2->GetProperty()->SetAmbient(1.0);
-    actorNeg1->GetProperty()->SetDiffuse(0.0);
-    actorNeg2->GetProperty()->SetDiffuse(0.0);
-    actorNeg1->GetProperty()->SetSpecular(0.0);
-    actorNeg2->GetProperty()->SetSpecular(0.0);
-
-
-    // Aggregate the actors
-    actors = vtkSmartPointer<vtkActorCollection>::New();
-    actors->AddItem(actorPos1);
-    actors->AddItem(actorPos2);
-    actors->AddItem(actorNeg1);
-    actors->AddItem(actorNeg2);
-}
-
-Slice::~Slice() {
-}
-
-
-void Slice::SetInput(vtkAlgorithmOutput* volume) {
-    cutter->SetInputConnection(volume);
-}
-
-
-vtkActorCollection* Slice::GetActors() {
-    return actors;
-}
-
-
-void Slice::SetClipValue(double value) {
-    clipperPos->SetValue(value);
-    clipperNeg->SetValue(-value);
-
-    clipperPos->Update();
-    clipperNeg->Update();
+/*=========================================================================
+
+  Name:        Slice.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Container class for a slice of the volume.
+
+=========================================================================*/
+
+
+#include "Slice.h"
+
+#include "vtkVolumeSlab.h"
+
+#include <vtkActor.h>
+#include <vtkActorCollection.h>
+#include <vtkAlgorithm.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkColorTransferFunction.h>
+#include <vtkImageData.h>
+#include <vtkLookupTable.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkProperty.h>
+#include <vtkTexture.h>
+
+
+Slice::Slice(vtkAlgorithmOutput* volume, vtkColorTransferFunction* colorMap,
+             int direction, double clipValue, const double center[3], const double size[3]) 
+    : colorMap(colorMap), clipValue(clipValue), projectionScale(1.0), showInside(false) {
+    // Axis normal to the slice
+    if (direction == 0) axis = 2;         // XY
+    else if (direction == 1) axis = 1;    // XZ
+    else axis = 0;                        // YZ
+
+
+    // Copy a slice of the volume to an image, along with a surface to texture it on.  Starts with
+    // the middle slice.
+    slab = vtkSmartPointer<vtkVolumeSlab>::New();
+    slab->SetInputConnection(volume);
+    slab->SetAxis(axis);
+
+
+    // Color the slice with a lookup table built from the color map, clipping with its alpha
+    lookupTable = vtkSmartPointer<vtkLookupTable>::New();
+    projectionTable = vtkSmartPointer<vtkLookupTable>::New();
+    UpdateColors();
+
+    texture = vtkSmartPointer<vtkTexture>::New();
+    texture->SetInputConnection(slab->GetOutputPort(0));
+    texture->SetLookupTable(lookupTable);
+    texture->MapColorScalarsThroughLookupTableOn();
+    texture->InterpolateOn();
+    texture->RepeatOff();
+    texture->EdgeClampOn();
+
+    // Texture for frames that are already colored
+    frameTexture = vtkSmartPointer<vtkTexture>::New();
+    frameTexture->MapColorScalarsThroughLookupTableOff();
+    frameTexture->InterpolateOn();
+    frameTexture->RepeatOff();
+    frameTexture->EdgeClampOn();
+
+    // Texture for projections on the walls
+    projectionTexture = vtkSmartPointer<vtkTexture>::New();
+    projectionTexture->SetLookupTable(projectionTable);
+    projectionTexture->MapColorScalarsThroughLookupTableOn();
+    projectionTexture->InterpolateOn();
+    projectionTexture->RepeatOff();
+    projectionTexture->EdgeClampOn();
+
+
+    // One mapper for all of the actors showing the slice
+    mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+    mapper->SetInputConnection(slab->GetOutputPort(1));
+    mapper->ScalarVisibilityOff();
+
+    // Frames and projections are laid out on the coarsest grid of nested volumes, so they use 
+    // its surface
+    gridMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+    gridMapper->SetInputConnection(slab->GetOutputPort(2));
+    gridMapper->ScalarVisibilityOff();
+
+
+    // Actors for the walls on either side of the volume.  The surface faces along the positive 
+    // axis, so cull front faces on the positive side and back faces on the negative side to only
+    // show the far wall.  Slices are unlit, so the normals don't matter.
+    vtkSmartPointer<vtkActor> actorPos = vtkSmartPointer<vtkActor>::New();
+    actorPos->SetMapper(mapper);
+    actorPos->SetTexture(texture);
+    actorPos->GetProperty()->FrontfaceCullingOn();
+
+    vtkSmartPointer<vtkActor> actorNeg = vtkSmartPointer<vtkActor>::New();
+    actorNeg->SetMapper(mapper);
+    actorNeg->SetTexture(texture);
+    actorNeg->GetProperty()->BackfaceCullingOn();
+
+    double positionPos[3] = { 0.0, 0.0, 0.0 };
+    double positionNeg[3] = { 0.0, 0.0, 0.0 };
+    positionPos[axis] = center[axis] + size[axis] * 0.5;
+    positionNeg[axis] = center[axis] - size[axis] * 0.5;
+
+    actorPos->SetPosition(positionPos);
+    actorNeg->SetPosition(positionNeg);
+
+    // Actor for the slice inside the volume, seen from both sides.  Hidden until requested.
+    insideActor = vtkSmartPointer<vtkActor>::New();
+    insideActor->SetMapper(mapper);
+    insideActor->SetTexture(texture);
+
+    coordinate = center[axis];
+
+    double positionInside[3] = { 0.0, 0.0, 0.0 };
+    positionInside[axis] = coordinate;
+    insideActor->SetPosition(positionInside);
+    insideActor->VisibilityOff();
+
+    vtkActor* all[3] = { actorPos, actorNeg, insideActor };
+    for (int i = 0; i < 3; i++) {
+        vtkProperty* p = all[i]->GetProperty();
+        p->SetColor(1.0, 1.0, 1.0);
+        p->SetAmbient(1.0);
+        p->SetDiffuse(0.0);
+        p->SetSpecular(0.0);
+    }
+
+
+    // Aggregate the actors
+    actors = vtkSmartPointer<vtkActorCollection>::New();
+    actors->AddItem(actorPos);
+    actors->AddItem(actorNeg);
+    actors->AddItem(insideActor);
+}
+
+Slice::~Slice() {
+}
+
+
+void Slice::SetInput(vtkAlgorithmOutput* volume) {
+    slab->SetInputConnection(volume);
+}
+
+
+vtkVolumeSlab* Slice::GetSlab() {
+    return slab;
+}
+
+
+vtkActorCollection* Slice::GetActors() {
+    return actors;
+}
+
+
+int Slice::GetPosition() {
+    return slab->GetSlice();
+}
+
+void Slice::SetPosition(int index, double newCoordinate) {
+    slab->SetSlice(index);
+
+    coordinate = newCoordinate;
+
+    double position[3] = { 0.0, 0.0, 0.0 };
+    position[axis] = coordinate;
+    insideActor->SetPosition(position);
+}
+
+
+bool Slice::GetShowInside() {
+    return showInside;
+}
+
+void Slice::SetShowInside(bool inside) {
+    showInside = inside;
+
+    actors->InitTraversal();
+    for (vtkIdType i = 0; i < actors->GetNumberOfItems(); i++) {
+        vtkActor* actor = actors->GetNextActor();
+        actor->SetVisibility(actor == insideActor ? inside : !inside);
+    }
+}
+
+
+void Slice::SetFrame(vtkImageData* frame, double frameCoordinate) {
+    double position[3] = { 0.0, 0.0, 0.0 };
+
+    if (!frame) {
+        // Back to the slice
+        frameTexture->SetInput(NULL);
+        insideActor->SetTexture(texture);
+        insideActor->SetMapper(mapper);
+
+        position[axis] = coordinate;
+        insideActor->SetPosition(position);
+
+        SetShowInside(showInside);
+
+        return;
+    }
+
+    frameTexture->SetInput(frame);
+    insideActor->SetTexture(frameTexture);
+    insideActor->SetMapper(gridMapper);
+
+    position[axis] = frameCoordinate;
+    insideActor->SetPosition(position);
+
+    // Only the frame is shown
+    actors->InitTraversal();
+    for (vtkIdType i = 0; i < actors->GetNumberOfItems(); i++) {
+        vtkActor* actor = actors->GetNextActor();
+        actor->SetVisibility(actor == insideActor);
+    }
+}
+
+
+void Slice::SetProjection(vtkAlgorithmOutput* projection, double scale) {
+    if (projection) {
+        projectionTexture->SetInputConnection(projection);
+    }
+    else {
+        projectionTexture->SetInput(NULL);
+    }
+
+    if (scale != projectionScale) {
+        projectionScale = scale;
+
+        UpdateColors();
+    }
+
+    // Only the walls show projections
+    actors->InitTraversal();
+    for (vtkIdType i = 0; i < actors->GetNumberOfItems(); i++) {
+        vtkActor* actor = actors->GetNextActor();
+
+        if (actor != insideActor) {
+            actor->SetTexture(projection ? projectionTexture : texture);
+            actor->SetMapper(projection ? gridMapper : mapper);
+        }
+    }
+}
+
+
+void Slice::SetClipValue(double value) {
+    if (value == clipValue) {
+        return;
+    }
+
+    clipValue = value;
+
+    UpdateColors();
+}
+
+
+void Slice::UpdateColors() {
+    BuildLookupTable(lookupTable, colorMap, clipValue);
+
+    // Same colors and clipping over the range of the projection
+    BuildLookupTable(projectionTable, colorMap, clipValue);
+
+    double* range = colorMap->GetRange();
+    projectionTable->SetTableRange(range[0] * projectionScale, range[1] * projectionScale);
+}
+
+void Slice::BuildLookupTable(vtkLookupTable* table, vtkColorTransferFunction* colorMap, 
+                             double clipValue) {
+    // Sample the color map finely enough that the clip edges are close to the clip value
+    const int numColors = 1024;
+
+    double* range = colorMap->GetRange();
+
+    table->SetNumberOfTableValues(numColors);
+    table->SetTableRange(range[0], range[1]);
+
+    for (int i = 0; i < numColors; i++) {
+        double value = range[0] + (i + 0.5) * (range[1] - range[0]) / numColors;
+
+        double rgb[3];
+        colorMap->GetColor(value, rgb);
+
+        double alpha = value >= clipValue || value <= -clipValue ? 1.0 : 0.0;
+
+        table->SetTableValue(i, rgb[0], rgb[1], rgb[2], alpha);
+    }
+
+    table->Modified();
 }
\ No newline at end of file
@@ -16,12 +16,15 @@
 
 #include "vtkSmartPointer.h"
 
+class vtkActor;
 class vtkActorCollection;
 class vtkAlgorithmOutput;
-class vtkClipPolyData;
 class vtkColorTransferFunction;
-class vtkCutter;
-class vtkPlane;
+class vtkImageData;
+class vtkLookupTable;
+class vtkPolyDataMapper;
+class vtkTexture;
+class vtkVolumeSlab;
 
 
 class Slice {
@@ -34,14 +37,57 @@ public:
 
     vtkActorCollection* GetActors();
 
+    // Values between -value and value are transparent.  Only the lookup table changes, so this
+    // is cheap enough to follow the isovalue while interacting.
     void SetClipValue(double value);
 
+    // Rebuild the lookup table after the color map changes
+    void UpdateColors();
+
+    // Build a lookup table from a color map, with values between -clipValue and clipValue 
+    // transparent
+    static void BuildLookupTable(vtkLookupTable* table, vtkColorTransferFunction* colorMap, 
+                                 double clipValue);
+
+    // Move the slice to an index along its axis, at the given coordinate
+    int GetPosition();
+    void SetPosition(int index, double coordinate);
+
+    // Show the slice at its position inside the volume, rather than on the walls
+    bool GetShowInside();
+    void SetShowInside(bool inside);
+
+    // Show a frame colored elsewhere, e.g. by SliceCine, inside the volume at the given coordinate 
+    // in place of the slice, or NULL to show the slice again.  Frames are RGBA images laid out 
+    // like the slice.
+    void SetFrame(vtkImageData* frame, double coordinate);
+
+    // Show a projection of the volume on the walls in place of the slice, or NULL to show the 
+    // slice again.  The projection is laid out like the slice, and colored with the color map 
+    // stretched by scale, for projections with a different range than the volume.
+    void SetProjection(vtkAlgorithmOutput* projection, double scale);
+
+    // Get the filter copying the slice from the volume, for memory accounting
+    vtkVolumeSlab* GetSlab();
+
 protected:
-    vtkSmartPointer<vtkCutter> cutter;
-    vtkSmartPointer<vtkPlane> plane;
-    vtkSmartPointer<vtkClipPolyData> clipperPos;
-    vtkSmartPointer<vtkClipPolyData> clipperNeg;
+    vtkSmartPointer<vtkVolumeSlab> slab;
+    vtkSmartPointer<vtkColorTransferFunction> colorMap;
+    vtkSmartPointer<vtkLookupTable> lookupTable;
+    vtkSmartPointer<vtkTexture> texture;
+    vtkSmartPointer<vtkTexture> frameTexture;
+    vtkSmartPointer<vtkLookupTable> projectionTable;
+    vtkSmartPointer<vtkTexture> projectionTexture;
+    vtkSmartPointer<vtkPolyDataMapper> mapper;
+    vtkSmartPointer<vtkPolyDataMapper> gridMapper;
     vtkSmartPointer<vtkActorCollection> actors;
+    vtkSmartPointer<vtkActor> insideActor;
+
+    int axis;
+    double coordinate;
+    double clipValue;
+    double projectionScale;
+    bool showInside;
 };
 
 
@@ -0,0 +1,330 @@
+/*=========================================================================
+
+  Name:        SliceCine.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Plays a sweep of a slice through the volume, out to one
+               side and back, at a steady frame rate.
+
+=========================================================================*/
+
+
+#include "SliceCine.h"
+
+#include "VTKPipeline.h"
+#include "vtkVolumeDifference.h"
+
+#include <QTimer>
+#include <QtConcurrentRun>
+
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkImageData.h>
+#include <vtkLookupTable.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <algorithm>
+
+
+SliceCine::SliceCine(MemoryBudget* memoryBudget, QObject* parent)
+: QObject(parent), memoryBudget(memoryBudget) {
+    nextSequence = 0;
+    startIndex = 0;
+
+    bufferSize = 32;
+    depth = bufferSize;
+
+    pipeline = NULL;
+    axis = 2;
+
+    dimensions[0] = dimensions[1] = dimensions[2] = 0;
+
+    timer = new QTimer(this);
+    timer->setInterval(1000 / 25);
+    connect(timer, SIGNAL(timeout()), this, SLOT(showFrame()));
+
+    // Frames ahead are not shown yet, so drop them before data that is
+    memoryBudget->AddConsumer("Slice cine frames", this, -1);
+}
+
+SliceCine::~SliceCine() {
+    ClearBuffer();
+
+    memoryBudget->RemoveConsumer(this);
+}
+
+
+bool SliceCine::Start(VTKPipeline* newPipeline, int newAxis) {
+    Stop();
+
+    vtkDataSet* grid = newPipeline->GetSliceGrid();
+
+    if (!grid) {
+        return false;
+    }
+
+    vtkDataArray* gridScalars = grid->GetPointData()->GetScalars();
+
+    if (!gridScalars || gridScalars->GetNumberOfComponents() != 1) {
+        return false;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        std::vector<double> coordinates;
+        vtkVolumeDifference::GetCoordinates(grid, i, coordinates);
+
+        dimensions[i] = (int)coordinates.size();
+    }
+
+    if (dimensions[newAxis] < 1 || 
+        gridScalars->GetNumberOfTuples() != (vtkIdType)dimensions[0] * dimensions[1] * dimensions[2]) {
+        return false;
+    }
+
+
+    // Keep the field and colors as they are now, so frames match however long the sweep runs
+    scalars = gridScalars;
+
+    lookupTable = vtkSmartPointer<vtkLookupTable>::New();
+    newPipeline->BuildSliceLookupTable(lookupTable);
+
+    pipeline = newPipeline;
+    axis = newAxis;
+
+    startIndex = std::max(pipeline->GetSlicePosition(axis), 0);
+    nextSequence = 0;
+    depth = bufferSize;
+
+    Frame empty;
+    empty.sequence = -1;
+    empty.watcher = NULL;
+    frames.assign(bufferSize, empty);
+
+    FillBuffer();
+
+    timer->start();
+
+    return true;
+}
+
+void SliceCine::Stop() {
+    if (!pipeline) {
+        return;
+    }
+
+    timer->stop();
+
+    ClearBuffer();
+
+    pipeline->SetSliceFrame(axis, NULL, -1);
+
+    pipeline = NULL;
+    scalars = NULL;
+    lookupTable = NULL;
+}
+
+bool SliceCine::IsPlaying() {
+    return pipeline != NULL;
+}
+
+
+int SliceCine::GetFramesPerSecond() {
+    return 1000 / std::max(timer->interval(), 1);
+}
+
+void SliceCine::SetFramesPerSecond(int fps) {
+    timer->setInterval(1000 / std::max(fps, 1));
+}
+
+
+int SliceCine::GetBufferSize() {
+    return bufferSize;
+}
+
+void SliceCine::SetBufferSize(int size) {
+    size = std::max(size, 1);
+
+    if (size == bufferSize) {
+        return;
+    }
+
+    // Frames are placed by sequence number modulo the size, so start over
+    ClearBuffer();
+
+    bufferSize = size;
+    depth = size;
+
+    if (pipeline) {
+        Frame empty;
+        empty.sequence = -1;
+        empty.watcher = NULL;
+        frames.assign(bufferSize, empty);
+
+        FillBuffer();
+    }
+}
+
+
+unsigned long SliceCine::GetMemorySize() {
+    // Frames being computed are being written by worker threads
+    unsigned long size = 0;
+    for (int i = 0; i < (int)frames.size(); i++) {
+        if (frames[i].image) {
+            size += frames[i].image->GetActualMemorySize();
+        }
+    }
+
+    return size;
+}
+
+bool SliceCine::Evict() {
+    int farthest = -1;
+    for (int i = 0; i < (int)frames.size(); i++) {
+        if (frames[i].image && (farthest < 0 || frames[i].sequence > frames[farthest].sequence)) {
+            farthest = i;
+        }
+    }
+
+    if (farthest < 0) {
+        return false;
+    }
+
+    frames[farthest].image = NULL;
+    frames[farthest].sequence = -1;
+
+    // Don't compute it again until frames are shown
+    depth = std::max(depth - 1, 1);
+
+    return true;
+}
+
+
+void SliceCine::showFrame() {
+    Frame& frame = frames[nextSequence % bufferSize];
+
+    if (frame.sequence != nextSequence || !frame.image) {
+        // Not ready yet, so hold the frame shown
+        FillBuffer();
+        return;
+    }
+
+    pipeline->SetSliceFrame(axis, frame.image, GetIndex(nextSequence));
+    pipeline->Render();
+
+    // The texture holds the frame shown, so its slot is free for a frame ahead
+    frame.image = NULL;
+    frame.sequence = -1;
+
+    nextSequence++;
+
+    FillBuffer();
+}
+
+void SliceCine::frameFinished() {
+    QFutureWatcher<vtkImageData*>* watcher = static_cast<QFutureWatcher<vtkImageData*>*>(sender());
+    int sequence = watcher->property("sequence").toInt();
+    watcher->deleteLater();
+
+    Frame& frame = frames[sequence % bufferSize];
+    frame.watcher = NULL;
+    frame.image.TakeReference(watcher->result());
+}
+
+
+int SliceCine::GetIndex(int sequence) {
+    // Out to the last plane, back to the first, and out again, starting at the start index
+    int n = dimensions[axis];
+
+    if (n < 2) {
+        return 0;
+    }
+
+    int period = 2 * (n - 1);
+    int position = (startIndex + sequence) % period;
+
+    return position < n ? position : period - position;
+}
+
+
+void SliceCine::FillBuffer() {
+    for (int s = nextSequence; s < nextSequence + depth; s++) {
+        Frame& frame = frames[s % bufferSize];
+
+        if (frame.sequence == s || frame.watcher) {
+            // Ready or being computed
+            continue;
+        }
+
+        FrameTask task;
+        task.scalars = scalars;
+        task.dimensions[0] = dimensions[0];
+        task.dimensions[1] = dimensions[1];
+        task.dimensions[2] = dimensions[2];
+        task.axis = axis;
+        task.index = GetIndex(s);
+        task.lookupTable = lookupTable;
+
+        frame.sequence = s;
+        frame.image = NULL;
+        frame.watcher = new QFutureWatcher<vtkImageData*>(this);
+        frame.watcher->setProperty("sequence", s);
+
+        connect(frame.watcher, SIGNAL(finished()), this, SLOT(frameFinished()));
+
+        frame.watcher->setFuture(QtConcurrent::run(ComputeFrame, task));
+    }
+}
+
+void SliceCine::ClearBuffer() {
+    for (int i = 0; i < (int)frames.size(); i++) {
+        if (frames[i].watcher) {
+            frames[i].watcher->waitForFinished();
+            frames[i].watcher->result()->Delete();
+
+            delete frames[i].watcher;
+        }
+    }
+
+    frames.clear();
+}
+
+
+vtkImageData* SliceCine::ComputeFrame(FrameTask task) {
+    int u = task.axis == 0 ? 1 : 0;
+    int v = task.axis == 2 ? 1 : 2;
+
+    const int* dims = task.dimensions;
+    vtkIdType stride[3] = { 1, dims[0], (vtkIdType)dims[0] * dims[1] };
+
+    int nu = dims[u];
+    int nv = dims[v];
+
+    vtkSmartPointer<vtkUnsignedCharArray> colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+    colors->SetNumberOfComponents(4);
+    colors->SetNumberOfTuples((vtkIdType)nu * nv);
+
+    // Map a row at a time straight from the volume, in the layout of the slice textures.  Across 
+    // x, rows are strided through the volume, which the lookup table steps through.
+    char* values = static_cast<char*>(task.scalars->GetVoidPointer(0));
+    int typeSize = task.scalars->GetDataTypeSize();
+
+    for (int j = 0; j < nv; j++) {
+        char* row = values + (task.index * stride[task.axis] + j * stride[v]) * typeSize;
+
+        task.lookupTable->MapScalarsThroughTable2(row, colors->GetPointer((vtkIdType)j * nu * 4),
+                                                  task.scalars->GetDataType(), nu, (int)stride[u], 
+                                                  VTK_RGBA);
+    }
+
+    vtkImageData* image = vtkImageData::New();
+    image->SetExtent(0, nu - 1, 0, nv - 1, 0, 0);
+    image->SetScalarTypeToUnsignedChar();
+    image->SetNumberOfScalarComponents(4);
+    image->GetPointData()->SetScalars(colors);
+
+    return image;
+}
@@ -0,0 +1,130 @@
+/*=========================================================================
+
+  Name:        SliceCine.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Plays a sweep of a slice through the volume, out to one
+               side and back, at a steady frame rate.  Frames are colored
+               with the slices' lookup table by tasks on the thread pool,
+               into a ring buffer of frames ahead of the one shown, so
+               showing a frame only swaps a texture.  If the tasks fall
+               behind, the frame shown is held rather than skipped.
+
+               The field and colors are taken when playing starts.  The
+               buffer stays within the memory budget, shrinking when
+               frames are evicted.
+
+=========================================================================*/
+
+
+#ifndef SLICECINE_H
+#define SLICECINE_H
+
+
+#include <QFutureWatcher>
+#include <QObject>
+
+#include <vtkSmartPointer.h>
+
+#include "MemoryBudget.h"
+
+#include <vector>
+
+class QTimer;
+
+class vtkDataArray;
+class vtkImageData;
+class vtkLookupTable;
+
+class VTKPipeline;
+
+
+class SliceCine : public QObject, public MemoryBudget::Consumer {
+    Q_OBJECT
+
+public:
+    SliceCine(MemoryBudget* memoryBudget, QObject* parent = NULL);
+    virtual ~SliceCine();
+
+    // Start sweeping the slice normal to an axis (0 for x, 1 for y, 2 for z) of a pipeline, from 
+    // its current position.  Returns false if the pipeline has no slices.
+    bool Start(VTKPipeline* pipeline, int axis);
+
+    // Stop, showing the slice at its own position again
+    void Stop();
+
+    bool IsPlaying();
+
+    // Get/set the frame rate.  Defaults to 25 frames per second.
+    int GetFramesPerSecond();
+    void SetFramesPerSecond(int fps);
+
+    // Get/set the number of frames computed ahead of the one shown.  Defaults to 32.
+    int GetBufferSize();
+    void SetBufferSize(int size);
+
+    // MemoryBudget::Consumer interface.  Evicting drops the ready frame farthest ahead, and 
+    // shrinks the buffer.
+    virtual unsigned long GetMemorySize();
+    virtual bool Evict();
+
+protected slots:
+    void showFrame();
+    void frameFinished();
+
+protected:
+    // What a frame task needs, copied so tasks don't touch the pipeline
+    struct FrameTask {
+        vtkDataArray* scalars;
+        int dimensions[3];
+        int axis;
+        int index;
+        vtkLookupTable* lookupTable;
+    };
+
+    // Color the slice at an index.  Runs on the thread pool.  The caller takes the reference.
+    static vtkImageData* ComputeFrame(FrameTask task);
+
+    struct Frame {
+        int sequence;
+        vtkSmartPointer<vtkImageData> image;
+        QFutureWatcher<vtkImageData*>* watcher;
+    };
+
+    // Ring buffer of frames, by sequence number modulo its size
+    std::vector<Frame> frames;
+
+    // Sequence number of the next frame to show, and of the frame the sweep started at
+    int nextSequence;
+    int startIndex;
+
+    int bufferSize;
+    int depth;
+
+    VTKPipeline* pipeline;
+    int axis;
+
+    // Snapshot of the field and colors
+    vtkSmartPointer<vtkDataArray> scalars;
+    int dimensions[3];
+    vtkSmartPointer<vtkLookupTable> lookupTable;
+
+    QTimer* timer;
+
+    MemoryBudget* memoryBudget;
+
+    // Slice index shown at a sequence number
+    int GetIndex(int sequence);
+
+    // Start tasks for frames missing from the buffer
+    void FillBuffer();
+
+    // Wait for tasks and drop all frames
+    void ClearBuffer();
+};
+
+
+#endif
@@ -0,0 +1,335 @@
+/*=========================================================================
+
+  Name:        TestTransparency.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Renders nested spheres offscreen with the opaque and
+               translucent isosurface materials, blended and depth
+               peeled, as the application sets them up.  Fails if either
+               material does not compile and link with the main VTK
+               supplies, if depth peeling is not used, or if nothing is
+               drawn.
+
+               The shells are added outermost first, so blending draws
+               them in the wrong order.  Where the order shows, the
+               peeled image must match the back-to-front composite of
+               the core and each shell rendered alone, and differ from
+               the blended image.
+
+               Usage: TestTransparency <source directory>
+
+               Needs a VTK built for offscreen rendering, e.g. with Mesa.
+
+=========================================================================*/
+
+
+#include <vtkActor.h>
+#include <vtkImageData.h>
+#include <vtkObjectFactory.h>
+#include <vtkOutputWindow.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkProperty.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkTimerLog.h>
+#include <vtkWindowToImageFilter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+// Counts errors, such as shaders failing to compile or link, while still showing them
+class ErrorCounter : public vtkOutputWindow {
+public:
+    static ErrorCounter* New();
+    vtkTypeMacro(ErrorCounter, vtkOutputWindow);
+
+    virtual void DisplayErrorText(const char* text) {
+        errors++;
+        std::cout << text << std::endl;
+    }
+
+    virtual void DisplayWarningText(const char* text) {
+        std::cout << text << std::endl;
+    }
+
+    int errors;
+
+protected:
+    ErrorCounter() : errors(0) {}
+};
+
+vtkStandardNewMacro(ErrorCounter);
+
+
+static bool ReadFile(const std::string& fileName, std::string& contents) {
+    std::ifstream file(fileName.c_str());
+
+    if (!file) {
+        return false;
+    }
+
+    std::stringstream ss;
+    ss << file.rdbuf();
+    contents = ss.str();
+
+    return true;
+}
+
+// Capture the window
+static vtkSmartPointer<vtkImageData> Capture(vtkRenderWindow* window) {
+    vtkSmartPointer<vtkWindowToImageFilter> capture = vtkSmartPointer<vtkWindowToImageFilter>::New();
+    capture->SetInput(window);
+    capture->ReadFrontBufferOff();
+    capture->Update();
+
+    vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+    image->DeepCopy(capture->GetOutput());
+
+    return image;
+}
+
+// Render with the given actors visible and background, and capture the result
+static vtkSmartPointer<vtkImageData> Render(vtkRenderWindow* window, vtkRenderer* renderer, 
+                                            const std::vector<vtkSmartPointer<vtkActor> >& actors, 
+                                            const bool visible[3], double background) {
+    for (int i = 0; i < (int)actors.size(); i++) {
+        actors[i]->SetVisibility(visible[i]);
+    }
+
+    renderer->SetBackground(background, background, background);
+    window->Render();
+
+    return Capture(window);
+}
+
+static unsigned char* GetPixel(vtkImageData* image, int i) {
+    return static_cast<unsigned char*>(image->GetScalarPointer()) + i * image->GetNumberOfScalarComponents();
+}
+
+// Count pixels differing from the background
+static int CountDrawnPixels(vtkImageData* image) {
+    int drawn = 0;
+    for (int i = 0; i < image->GetNumberOfPoints(); i++) {
+        unsigned char* p = GetPixel(image, i);
+
+        if (p[0] != 0 || p[1] != 0 || p[2] != 0) {
+            drawn++;
+        }
+    }
+
+    return drawn;
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: TestTransparency <source directory>" << std::endl;
+        return 1;
+    }
+
+    std::string directory = argv[1];
+    std::string opaqueMaterial;
+    std::string translucentMaterial;
+
+    if (!ReadFile(directory + "/perPixelLighting.xml", opaqueMaterial) ||
+        !ReadFile(directory + "/silhouetteFalloff.xml", translucentMaterial)) {
+        std::cout << "Could not read the materials from " << directory << std::endl;
+        return 1;
+    }
+
+    vtkSmartPointer<ErrorCounter> errors = vtkSmartPointer<ErrorCounter>::New();
+    vtkOutputWindow::SetInstance(errors);
+
+
+    // Window set up as in the application: alpha bit planes and no multisampling for peeling
+    vtkSmartPointer<vtkRenderWindow> window = vtkSmartPointer<vtkRenderWindow>::New();
+    window->SetOffScreenRendering(1);
+    window->SetAlphaBitPlanes(1);
+    window->SetMultiSamples(0);
+    window->SetSize(256, 256);
+
+    vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+    renderer->SetBackground(0.0, 0.0, 0.0);
+    renderer->SetMaximumNumberOfPeels(8);
+    renderer->SetOcclusionRatio(0.0);
+    window->AddRenderer(renderer);
+
+
+    // An opaque sphere inside two translucent shells, like nested lobes
+    const double radii[3] = { 0.3, 0.6, 1.0 };
+    std::vector<vtkSmartPointer<vtkActor> > actors;
+
+    for (int i = 0; i < 3; i++) {
+        vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
+        sphere->SetRadius(radii[i]);
+        sphere->SetThetaResolution(32);
+        sphere->SetPhiResolution(32);
+
+        vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+        mapper->SetInputConnection(sphere->GetOutputPort());
+        mapper->ScalarVisibilityOff();
+
+        vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+        actor->SetMapper(mapper);
+
+        vtkProperty* p = actor->GetProperty();
+        p->SetAmbient(0.1);
+        p->SetDiffuse(1.0);
+        p->SetSpecular(1.0);
+        p->SetSpecularPower(50.0);
+        p->SetColor(i == 1 ? 0.0 : 1.0, 0.5, i == 1 ? 1.0 : 0.0);
+
+        bool translucent = i > 0;
+        p->LoadMaterialFromString(translucent ? translucentMaterial.c_str() : opaqueMaterial.c_str());
+        p->SetOpacity(translucent ? 0.1 : 1.0);
+        p->ShadingOn();
+
+        int useVertexColors = 0;
+        p->AddShaderVariable("useVertexColors", 1, &useVertexColors);
+
+        actors.push_back(actor);
+    }
+
+    // Translucent shells outermost first, so blending them unsorted composites in the wrong order
+    renderer->AddActor(actors[0]);
+    renderer->AddActor(actors[2]);
+    renderer->AddActor(actors[1]);
+
+    renderer->ResetCamera();
+
+
+    // Render blended, then depth peeled
+    bool passed = true;
+    vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+    vtkSmartPointer<vtkImageData> images[2];
+
+    for (int i = 0; i < 2; i++) {
+        renderer->SetUseDepthPeeling(i == 1);
+
+        timer->StartTimer();
+        window->Render();
+        timer->StopTimer();
+
+        const char* method = i == 0 ? "Blended" : "Depth peeled";
+        images[i] = Capture(window);
+        int drawn = CountDrawnPixels(images[i]);
+
+        std::cout << method << ": " << drawn << " pixels drawn, first frame "
+                  << timer->GetElapsedTime() * 1000.0 << " ms" << std::endl;
+
+        if (drawn == 0) {
+            std::cout << method << ": nothing drawn" << std::endl;
+            passed = false;
+        }
+
+        if (i == 1 && !renderer->GetLastRenderingUsedDepthPeeling()) {
+            std::cout << "Depth peeling not supported by this OpenGL context" << std::endl;
+            passed = false;
+        }
+    }
+
+
+    // Reference layers, each with at most one translucent surface per pixel, so order doesn't 
+    // matter: the core alone, and each shell alone over black and over white.  A shell over a 
+    // color c gives s + t c, with s its contribution over black and t its transmittance.
+    renderer->SetUseDepthPeeling(0);
+
+    const bool coreOnly[3] = { true, false, false };
+    const bool innerOnly[3] = { false, true, false };
+    const bool outerOnly[3] = { false, false, true };
+
+    vtkSmartPointer<vtkImageData> core = Render(window, renderer, actors, coreOnly, 0.0);
+    vtkSmartPointer<vtkImageData> innerBlack = Render(window, renderer, actors, innerOnly, 0.0);
+    vtkSmartPointer<vtkImageData> innerWhite = Render(window, renderer, actors, innerOnly, 1.0);
+    vtkSmartPointer<vtkImageData> outerBlack = Render(window, renderer, actors, outerOnly, 0.0);
+    vtkSmartPointer<vtkImageData> outerWhite = Render(window, renderer, actors, outerOnly, 1.0);
+
+
+    // Where compositing the shells back to front and front to back differ clearly, the peeled 
+    // image must match back to front and differ from the blended image
+    const int tolerance = 6;
+    const int minimumDifference = 4 * tolerance;
+
+    int ordered = 0;
+    int peeledCorrect = 0;
+    int blendedDiffers = 0;
+
+    for (int i = 0; i < core->GetNumberOfPoints(); i++) {
+        int reversedError = 0;
+        int peeledError = 0;
+        int blendedError = 0;
+
+        for (int c = 0; c < 3; c++) {
+            double k = GetPixel(core, i)[c];
+            double si = GetPixel(innerBlack, i)[c];
+            double ti = (GetPixel(innerWhite, i)[c] - si) / 255.0;
+            double so = GetPixel(outerBlack, i)[c];
+            double to = (GetPixel(outerWhite, i)[c] - so) / 255.0;
+
+            double expected = so + to * (si + ti * k);
+            double reversed = si + ti * (so + to * k);
+
+            int peeled = GetPixel(images[1], i)[c];
+            int blended = GetPixel(images[0], i)[c];
+
+            reversedError = std::max(reversedError, (int)(fabs(reversed - expected) + 0.5));
+            peeledError = std::max(peeledError, (int)(fabs(peeled - expected) + 0.5));
+            blendedError = std::max(blendedError, std::abs(blended - peeled));
+        }
+
+        if (reversedError < minimumDifference) {
+            continue;
+        }
+
+        ordered++;
+
+        if (peeledError <= tolerance) {
+            peeledCorrect++;
+        }
+
+        if (blendedError > tolerance) {
+            blendedDiffers++;
+        }
+    }
+
+    std::cout << ordered << " pixels depend on the order of the shells, " << peeledCorrect 
+              << " peeled back to front, " << blendedDiffers << " blended differently" << std::endl;
+
+    // Allow for a few differences in rasterizing silhouette edges
+    if (ordered == 0) {
+        std::cout << "No pixels depend on the order of the shells" << std::endl;
+        passed = false;
+    }
+    else {
+        if (peeledCorrect < ordered * 0.99) {
+            std::cout << "Depth peeled: shells not composited back to front" << std::endl;
+            passed = false;
+        }
+
+        if (blendedDiffers == 0) {
+            std::cout << "Depth peeled: no different from blending in the wrong order" << std::endl;
+            passed = false;
+        }
+    }
+
+    if (errors->errors > 0) {
+        std::cout << errors->errors << " errors, e.g. from compiling or linking the materials" << std::endl;
+        passed = false;
+    }
+
+    vtkOutputWindow::SetInstance(NULL);
+
+    return passed ? 0 : 1;
+}
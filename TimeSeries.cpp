@@ -0,0 +1,329 @@
+/*=========================================================================
+
+  Name:        TimeSeries.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: A series of volume files, one per time step.  Steps near
+               the current one are prefetched in the background into
+               inactive pipelines, with their slices and isosurfaces
+               computed at the current isovalues, so stepping through
+               time only needs a pipeline swap.  Prefetching stays within
+               the memory budget, and prefetched steps are evicted
+               farthest first.
+
+=========================================================================*/
+
+
+#include "TimeSeries.h"
+
+#include "VTKPipeline.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QRegExp>
+#include <QtConcurrentRun>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+// Task for recomputing products of a prefetched step
+static bool UpdateProducts(VTKPipeline* pipeline) {
+    pipeline->UpdateProducts();
+
+    return true;
+}
+
+
+QStringList TimeSeries::ExpandPattern(const QString& fileName) {
+    QFileInfo info(fileName);
+    QString name = info.fileName();
+
+    // Split around the last run of digits
+    QRegExp digits("(\\d+)(?!.*\\d)");
+    int index = digits.indexIn(name);
+
+    if (index < 0) {
+        return QStringList(fileName);
+    }
+
+    QString prefix = name.left(index);
+    QString suffix = name.mid(index + digits.matchedLength());
+
+    QRegExp pattern("^" + QRegExp::escape(prefix) + "(\\d+)" + QRegExp::escape(suffix) + "$");
+
+
+    // Find matching files, sorted by number rather than name, so padding doesn't matter
+    std::map<long, QString> matches;
+
+    QDir dir = info.absoluteDir();
+    QStringList entries = dir.entryList(QDir::Files);
+
+    for (int i = 0; i < entries.size(); i++) {
+        if (pattern.exactMatch(entries[i])) {
+            matches[pattern.cap(1).toLong()] = dir.absoluteFilePath(entries[i]);
+        }
+    }
+
+    QStringList fileNames;
+    for (std::map<long, QString>::iterator it = matches.begin(); it != matches.end(); it++) {
+        fileNames.append(it->second);
+    }
+
+    return fileNames;
+}
+
+
+TimeSeries::TimeSeries(const QStringList& fileNames, MemoryBudget* memoryBudget, QObject* parent)
+: QObject(parent), fileNames(fileNames), memoryBudget(memoryBudget) {
+    currentStep = 0;
+    prefetchDistance = 2;
+
+    isovalue1 = isovalue2 = 0.0;
+
+    // Prefetched steps are not shown, so drop them before data that is
+    memoryBudget->AddConsumer("Time series prefetch", this, -1);
+}
+
+TimeSeries::~TimeSeries() {
+    memoryBudget->RemoveConsumer(this);
+
+    for (std::map<int, Step>::iterator it = steps.begin(); it != steps.end(); it++) {
+        if (it->second.watcher) {
+            it->second.watcher->waitForFinished();
+            delete it->second.watcher;
+        }
+
+        delete it->second.pipeline;
+    }
+}
+
+
+int TimeSeries::GetNumberOfSteps() {
+    return fileNames.size();
+}
+
+QString TimeSeries::GetFileName(int step) {
+    return fileNames[step];
+}
+
+
+bool TimeSeries::IsStepReady(int step) {
+    std::map<int, Step>::iterator it = steps.find(step);
+
+    return it != steps.end() && !it->second.watcher;
+}
+
+bool TimeSeries::IsStepPending(int step) {
+    std::map<int, Step>::iterator it = steps.find(step);
+
+    return it != steps.end() && it->second.watcher;
+}
+
+
+VTKPipeline* TimeSeries::TakeStep(int step) {
+    if (!IsStepReady(step)) {
+        return NULL;
+    }
+
+    VTKPipeline* pipeline = steps[step].pipeline;
+    steps.erase(step);
+
+    return pipeline;
+}
+
+void TimeSeries::ReturnStep(int step, VTKPipeline* pipeline) {
+    if (steps.find(step) != steps.end()) {
+        // Already have one
+        delete pipeline;
+        return;
+    }
+
+    Step s;
+    s.pipeline = pipeline;
+    s.watcher = NULL;
+
+    steps[step] = s;
+}
+
+
+void TimeSeries::Prefetch(int step, VTKPipeline* currentPipeline) {
+    currentStep = step;
+    isovalue1 = currentPipeline->GetIsovalue1();
+    isovalue2 = currentPipeline->GetIsovalue2();
+    field = currentPipeline->GetFieldName(currentPipeline->GetField());
+
+
+    // Drop steps that are too far away or show another field.  Steps being prepared are dropped 
+    // when finished.
+    std::vector<int> drop;
+    for (std::map<int, Step>::iterator it = steps.begin(); it != steps.end(); it++) {
+        VTKPipeline* pipeline = it->second.pipeline;
+
+        if (!it->second.watcher && 
+            (abs(it->first - currentStep) > prefetchDistance ||
+             pipeline->GetFieldName(pipeline->GetField()) != field)) {
+            drop.push_back(it->first);
+        }
+    }
+
+    for (int i = 0; i < (int)drop.size(); i++) {
+        DeleteStep(drop[i]);
+    }
+
+
+    // Recompute ready steps with other isovalues
+    int pending = 0;
+    for (std::map<int, Step>::iterator it = steps.begin(); it != steps.end(); it++) {
+        VTKPipeline* pipeline = it->second.pipeline;
+
+        if (!it->second.watcher &&
+            (pipeline->GetIsovalue1() != isovalue1 || pipeline->GetIsovalue2() != isovalue2)) {
+            pipeline->SetIsovalue1(isovalue1);
+            pipeline->SetIsovalue2(isovalue2);
+
+            StartStep(it->first, pipeline, false);
+        }
+
+        if (it->second.watcher) {
+            pending++;
+        }
+    }
+
+
+    // Load missing steps, nearest first, while they fit in the budget.  Assume each step needs
+    // about as much memory as the current one.
+    unsigned long stepSize = currentPipeline->GetMemorySize();
+
+    memoryBudget->Update();
+
+    for (int d = 1; d <= prefetchDistance; d++) {
+        for (int sign = 1; sign >= -1; sign -= 2) {
+            int s = currentStep + sign * d;
+
+            if (s < 0 || s >= GetNumberOfSteps() ||
+                steps.find(s) != steps.end() || failedSteps.find(s) != failedSteps.end()) {
+                continue;
+            }
+
+            unsigned long limit = memoryBudget->GetLimit();
+            if (limit > 0 && memoryBudget->GetTotal() + (pending + 1) * stepSize > limit) {
+                return;
+            }
+
+            VTKPipeline* pipeline = currentPipeline->CreateEmptyCopy();
+            pipeline->SetInitialIsovalues(isovalue1, isovalue2);
+
+            StartStep(s, pipeline, true);
+
+            pending++;
+        }
+    }
+}
+
+
+int TimeSeries::GetPrefetchDistance() {
+    return prefetchDistance;
+}
+
+void TimeSeries::SetPrefetchDistance(int distance) {
+    prefetchDistance = distance;
+}
+
+
+unsigned long TimeSeries::GetMemorySize() {
+    // Steps being prepared are being written by worker threads
+    unsigned long size = 0;
+    for (std::map<int, Step>::iterator it = steps.begin(); it != steps.end(); it++) {
+        if (!it->second.watcher) {
+            size += it->second.pipeline->GetMemorySize();
+        }
+    }
+
+    return size;
+}
+
+bool TimeSeries::Evict() {
+    int farthest = -1;
+    for (std::map<int, Step>::iterator it = steps.begin(); it != steps.end(); it++) {
+        if (!it->second.watcher &&
+            (farthest < 0 || abs(it->first - currentStep) > abs(farthest - currentStep))) {
+            farthest = it->first;
+        }
+    }
+
+    if (farthest < 0) {
+        return false;
+    }
+
+    DeleteStep(farthest);
+
+    return true;
+}
+
+
+void TimeSeries::prefetchFinished() {
+    QFutureWatcher<bool>* watcher = static_cast<QFutureWatcher<bool>*>(sender());
+    int step = watcher->property("step").toInt();
+    bool success = watcher->result();
+    watcher->deleteLater();
+
+    Step& s = steps[step];
+    s.watcher = NULL;
+
+    if (!success) {
+        std::cout << "TimeSeries: " << s.errorMessage << std::endl;
+
+        failedSteps.insert(step);
+        DeleteStep(step);
+
+        return;
+    }
+
+    if (abs(step - currentStep) > prefetchDistance ||
+        s.pipeline->GetFieldName(s.pipeline->GetField()) != field) {
+        // No longer needed, or the field was switched while preparing
+        DeleteStep(step);
+
+        return;
+    }
+
+    if (s.pipeline->GetIsovalue1() != isovalue1 || s.pipeline->GetIsovalue2() != isovalue2) {
+        // Isovalues changed while preparing
+        s.pipeline->SetIsovalue1(isovalue1);
+        s.pipeline->SetIsovalue2(isovalue2);
+
+        StartStep(step, s.pipeline, false);
+
+        return;
+    }
+
+    emit stepReady(step);
+}
+
+
+void TimeSeries::StartStep(int step, VTKPipeline* pipeline, bool load) {
+    Step& s = steps[step];
+    s.pipeline = pipeline;
+    s.watcher = new QFutureWatcher<bool>(this);
+    s.watcher->setProperty("step", step);
+
+    connect(s.watcher, SIGNAL(finished()), this, SLOT(prefetchFinished()));
+
+    if (load) {
+        s.watcher->setFuture(QtConcurrent::run(pipeline, &VTKPipeline::PrepareVolume,
+                                               fileNames[step].toStdString(), &s.errorMessage));
+    }
+    else {
+        s.watcher->setFuture(QtConcurrent::run(UpdateProducts, pipeline));
+    }
+}
+
+void TimeSeries::DeleteStep(int step) {
+    delete steps[step].pipeline;
+    steps.erase(step);
+}
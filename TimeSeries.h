@@ -0,0 +1,115 @@
+/*=========================================================================
+
+  Name:        TimeSeries.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: A series of volume files, one per time step.  Steps near
+               the current one are prefetched in the background into
+               inactive pipelines, with their slices and isosurfaces
+               computed at the current isovalues, so stepping through
+               time only needs a pipeline swap.  Prefetching stays within
+               the memory budget, and prefetched steps are evicted
+               farthest first.
+
+=========================================================================*/
+
+
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QStringList>
+
+#include "MemoryBudget.h"
+
+#include <map>
+#include <set>
+#include <string>
+
+class VTKPipeline;
+
+
+class TimeSeries : public QObject, public MemoryBudget::Consumer {
+    Q_OBJECT
+
+public:
+    // Expand a file name such as density_0001.vti to all files in the same directory that only
+    // differ in the last run of digits, sorted by number
+    static QStringList ExpandPattern(const QString& fileName);
+
+    TimeSeries(const QStringList& fileNames, MemoryBudget* memoryBudget, QObject* parent = NULL);
+    virtual ~TimeSeries();
+
+    int GetNumberOfSteps();
+    QString GetFileName(int step);
+
+    // Is a prefetched pipeline ready, or being prepared, for the step?
+    bool IsStepReady(int step);
+    bool IsStepPending(int step);
+
+    // Remove and return the prefetched pipeline for a step if ready, otherwise NULL.  The caller
+    // takes ownership.
+    VTKPipeline* TakeStep(int step);
+
+    // Give back an inactive pipeline for a step, e.g. when another step is shown.  The series
+    // takes ownership.
+    void ReturnStep(int step, VTKPipeline* pipeline);
+
+    // Prefetch the steps around the current one, using the current pipeline's isovalues and field,
+    // and drop those farther away.  Prefetched steps with other isovalues are recomputed, and those
+    // with another field dropped.
+    void Prefetch(int currentStep, VTKPipeline* currentPipeline);
+
+    // Number of steps on each side of the current one to prefetch
+    int GetPrefetchDistance();
+    void SetPrefetchDistance(int distance);
+
+    // MemoryBudget::Consumer interface.  Evicting drops the ready step farthest from the current one.
+    virtual unsigned long GetMemorySize();
+    virtual bool Evict();
+
+signals:
+    // A prefetched step is ready
+    void stepReady(int step);
+
+protected slots:
+    void prefetchFinished();
+
+protected:
+    struct Step {
+        VTKPipeline* pipeline;
+        QFutureWatcher<bool>* watcher;
+        std::string errorMessage;
+    };
+
+    // Steps that are ready or being prepared.  Steps being prepared have a watcher.
+    std::map<int, Step> steps;
+
+    // Steps that could not be loaded, so are not tried again
+    std::set<int> failedSteps;
+
+    QStringList fileNames;
+
+    int currentStep;
+    int prefetchDistance;
+
+    double isovalue1;
+    double isovalue2;
+    std::string field;
+
+    MemoryBudget* memoryBudget;
+
+    // Start preparing a step in the background
+    void StartStep(int step, VTKPipeline* pipeline, bool load);
+
+    // Delete a step that is not being prepared
+    void DeleteStep(int step);
+};
+
+
+#endif
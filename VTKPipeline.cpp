@@ -1,724 +1,2613 @@
-/*=========================================================================
-
-  Name:        VTKPipeline.cpp
-
-  Author:      David Borland, The Renaissance Computing Institute (RENCI)
-
-  Copyright:   The Renaissance Computing Institute (RENCI)
-
-  Description: Container class for all Voluminous VTK code.
-
-=========================================================================*/
-
-
-#include "VTKPipeline.h"
-
-#include "Isosurface.h"
-#include "Slice.h"
-
-#include <vtkActor.h>
-#include <vtkCamera.h>
-#include <vtkColorTransferFunction.h>
-#include <vtkContourFilter.h>
-#include <vtkCubeAxesActor.h>
-#include <vtkImageActor.h>
-#include <vtkImageData.h>
-#include <vtkImageMapper.h>
-#include <vtkImageResize.h>
-#include <vtkOutlineFilter.h>
-#include <vtkPNGReader.h>
-#include <vtkPNGWriter.h>
-#include <vtkPointData.h>
-#include <vtkPolyDataMapper.h>
-#include <vtkProperty.h>
-#include <vtkRenderer.h>
-#include <vtkRendererCollection.h>
-#include <vtkRenderWindow.h>
-#include <vtkRenderWindowInteractor.h>
-#include <vtkScalarBarActor.h>
-#include <vtkStructuredPointsReader.h>
-#include <vtkTextActor.h>
-#include <vtkTextProperty.h>
-#include <vtkTubeFilter.h>
-#include <vtkWindowToImageFilter.h>
-#include <vtkXMLImageDataReader.h>
-
-#include <algorithm>
-
-
-#include <vtkInteractorStyleTrackballActor.h>
-
-
-VTKPipeline::VTKPipeline(vtkRenderWindowInteractor* rwi,
-                         vtkImageData* logoImage, vtkImageData* bwLogoImage,
-                         const std::string& opaqueMaterial, const std::string& translucentMaterial)
-: interactor(rwi), opaqueMaterial(opaqueMaterial), translucentMaterial(translucentMaterial) {
-    // Renderer
-    renderer = vtkSmartPointer<vtkRenderer>::New();
-
-    renderer->SetBackground(0.95, 0.95, 0.9);
-//    renderer->SetBackground(1.0, 1.0, 1.0);
-
-    interactor->GetRenderWindow()->AddRenderer(renderer);
-
-
-    // No reader or volume yet
-    reader = NULL;
-    volume = NULL;
-
-
-    // No slices yet
-    slices[0] = slices[1] = slices[2] = NULL;
-
-    // Create all member visualization objects
-    shrinker = vtkSmartPointer<vtkImageResize>::New();
-
-    axes = vtkSmartPointer<vtkCubeAxesActor>::New();
-    colorLegend = vtkSmartPointer<vtkScalarBarActor>::New();
-    dataLabel = vtkSmartPointer<vtkTextActor>::New();
-
-
-    // Create the logos
-    logo = vtkSmartPointer<vtkImageActor>::New();
-    logo->SetInput(logoImage); 
-    logo->InterpolateOn();
-    logo->SetOrigin((double)logoImage->GetDimensions()[0] / 2.0, (double)(double)logoImage->GetDimensions()[0] / 2.0, 0.0);
-    logo->SetOpacity(0.5);
-
-    bwLogo = vtkSmartPointer<vtkImageActor>::New();
-    bwLogo->SetInput(bwLogoImage); 
-    bwLogo->InterpolateOn();
-    bwLogo->SetOrigin((double)bwLogoImage->GetDimensions()[0] / 2.0, (double)(double)bwLogoImage->GetDimensions()[0] / 2.0, 0.0);
-    bwLogo->SetOpacity(0.5);
-    bwLogo->VisibilityOff();
-
-
-    // Use a separate renderer for the logo, to make placement easier
-    logoRenderer = vtkSmartPointer<vtkRenderer>::New();
-    double scale = 0.1;
-    logoRenderer->SetViewport(0.0, 0.0, scale, scale);
-    logoRenderer->InteractiveOff();
-    logoRenderer->AddViewProp(logo);
-    logoRenderer->AddViewProp(bwLogo);
-
-    interactor->GetRenderWindow()->AddRenderer(logoRenderer);
-    interactor->GetRenderWindow()->SetNumberOfLayers(2);
-
-    renderer->SetLayer(0);
-    logoRenderer->SetLayer(1);
-
-
-    // No data range yet
-    dataRange[0] = dataRange[1] = 0.0;
-
-
-    // Color map type
-    colorMapType = Color;
-}
-
-VTKPipeline::~VTKPipeline() {
-    interactor->GetRenderWindow()->RemoveRenderer(renderer);
-    interactor->GetRenderWindow()->RemoveRenderer(logoRenderer);
-
-    // Clean up
-    for (int i = 0; i < (int)isosurfaces.size(); i++) {
-        delete isosurfaces[i];
-    }
-
-    for (int i = 0; i < 3; i++) {
-        if (slices[i]) {
-            delete slices[i];
-        }
-    }
-}
-
-
-bool VTKPipeline::OpenVolume(const std::string& fileName, std::string* errorMessage) {
-    // Should only call this once per pipeline
-    if (reader) {
-//        std::cout << "VTKPipeline::OpenVolume() : Volume already loaded." << std::endl;
-        *errorMessage = "Volume already loaded";
-
-        return false;
-    }
-
-
-    // File information string
-    size_t p = fileName.find_last_of("/\\") + 1;
-    std::string fileInfo = fileName.substr(p, fileName.find_last_of(".") - p);
-
-    if (fileName.rfind(".vtk") == fileName.length() - 4) {
-        // Load legacy VTK structured point data
-        vtkSmartPointer<vtkStructuredPointsReader> spReader = vtkSmartPointer<vtkStructuredPointsReader>::New();
-        spReader->SetFileName(fileName.c_str());
-        
-        if (spReader->IsFileStructuredPoints()) {
-            reader = spReader;
-
-            reader->Update();
-            
-            std::string header = spReader->GetHeader();
-            if (header.size() > 0) {
-                fileInfo = header;
-            }
-        }
-    }
-    else if (fileName.rfind(".vti") == fileName.length() - 4) {
-        // Load VTK XML image data file
-        vtkSmartPointer<vtkXMLImageDataReader> iReader = vtkSmartPointer<vtkXMLImageDataReader>::New();
-        iReader->SetFileName(fileName.c_str());
-        
-        reader = iReader;
-
-        reader->Update();
-    }  
-
-    
-    if (reader == NULL) {
-//        std::cout << "VTKPipeline::OpenVolume() : Volume must be in .vtk structured points or .vti format." << std::endl;
-        *errorMessage = "Volume must be in .vtk structured points or .vti format";
-
-        return false;
-    }
-            
-
-    if (reader->GetOutputDataObject(0) == NULL) {
-//       std::cout << "VTKPipeline::OpenVolume() : Could not open " << fileName << std::endl;     
-        *errorMessage = "Could not open " + fileName;
-
-       return false;
-    }
-
-
-    // Go ahead and set the data label string
-    dataLabel->SetInput(fileInfo.c_str());
-
-
-    return true;
-}
-
-
-bool VTKPipeline::CreateVisualization(std::string& errorMessage) {
-    // Should only call this once per pipeline
-    if (volume) {
-//        std::cout << "VTKPipeline::CreateVisualization() : Visualization already created." << std::endl;
-        errorMessage = "Visualization already created";
-
-        return false;
-    }
-
-       
-    // Get the volume information
-    volume = (vtkImageData*) reader->GetOutputDataObject(0);
-
-    volume->GetScalarRange(dataRange);
-
-    double bounds[6];
-    volume->GetBounds(bounds);
-
-    double origin[3];
-    volume->GetOrigin(origin);
-
-    double size[3];
-    for (int i = 0; i < 3; i++) {
-        size[i] = (bounds[2 * i + 1] - bounds[2 * i]);
-    }
-
-    double center[3];
-    for (int i = 0; i < 3; i++) {
-        center[i] = origin[i] + size[i] * 0.5;
-    }
-
-
-    // Set up the volume shrinker
-    shrinker->SetInputConnection(reader->GetOutputPort());
-    shrinker->SetMagnificationFactors(0.5, 0.5, 0.5);
-    shrinker->SetResizeMethodToMagnificationFactors();
-    shrinker->InterpolateOn();
-
-
-    // Set up axes
-    double axesBounds[6];
-    for (int i = 0; i < 3; i++) {
-        // Do some rounding if close enough
-        double fraction = 0.01;
-        double d;
-
-        int i1 = 2 * i;
-        int i2 = 2 * i + 1;
-        
-        d = bounds[i1] - floor(bounds[i1]);
-        if (d < size[i] * fraction) axesBounds[i1] = floor(bounds[i1]);
-        else axesBounds[i1] = bounds[i1];
-
-        d = ceil(bounds[i2]) - bounds[i2];
-        if (d < size[i] * fraction) axesBounds[i2] = ceil(bounds[i2]);
-        else axesBounds[i2] = bounds[i2];
-    }
-
-    axes->SetBounds(axesBounds);
-
-    axes->GetXAxesLinesProperty()->SetColor(0.75, 0.75, 0.75);
-    axes->GetXAxesLinesProperty()->SetAmbient(1.0);
-    axes->GetXAxesLinesProperty()->SetDiffuse(0.25);
-    axes->GetXAxesLinesProperty()->SetSpecular(0.0);
-
-    axes->GetYAxesLinesProperty()->SetColor(0.75, 0.75, 0.75);
-    axes->GetYAxesLinesProperty()->SetAmbient(1.0);
-    axes->GetYAxesLinesProperty()->SetDiffuse(0.25);
-    axes->GetYAxesLinesProperty()->SetSpecular(0.0);
-
-    axes->GetZAxesLinesProperty()->SetColor(0.75, 0.75, 0.75);
-    axes->GetZAxesLinesProperty()->SetAmbient(1.0);
-    axes->GetZAxesLinesProperty()->SetDiffuse(0.25);
-    axes->GetZAxesLinesProperty()->SetSpecular(0.0);
-
-    axes->GetLabelTextProperty(0)->SetColor(0.75, 0.75, 0.75);
-    axes->GetLabelTextProperty(1)->SetColor(0.75, 0.75, 0.75);
-    axes->GetLabelTextProperty(2)->SetColor(0.75, 0.75, 0.75);
-
-    axes->GetTitleTextProperty(0)->SetColor(0.75, 0.75, 0.75);
-    axes->GetTitleTextProperty(1)->SetColor(0.75, 0.75, 0.75);
-    axes->GetTitleTextProperty(2)->SetColor(0.75, 0.75, 0.75);
-
-    axes->SetFlyModeToOuterEdges();
-
-    axes->SetCamera(renderer->GetActiveCamera());
-
-    renderer->AddViewProp(axes);
-
-
-    // Create the outline    
-    vtkSmartPointer<vtkOutlineFilter> outline = vtkSmartPointer<vtkOutlineFilter>::New();
-    outline->SetInputConnection(reader->GetOutputPort());
-
-    vtkSmartPointer<vtkTubeFilter> tubeOutline = vtkSmartPointer<vtkTubeFilter>::New();
-    tubeOutline->SetInputConnection(outline->GetOutputPort());
-    tubeOutline->SetRadius(size[0] * 0.002);
-    
-    vtkSmartPointer<vtkPolyDataMapper> outlineMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    outlineMapper->SetInputConnection(tubeOutline->GetOutputPort());
-
-    vtkSmartPointer<vtkActor> outlineActor = vtkSmartPointer<vtkActor>::New();
-    outlineActor->SetMapper(outlineMapper);
-//    outlineActor->GetProperty()->SetColor(background[0] * 0.75, background[1] * 0.75, background[2] * 0.75);
-    outlineActor->GetProperty()->SetColor(0.75, 0.75, 0.75);
-    outlineActor->GetProperty()->SetAmbient(1.0);
-    outlineActor->GetProperty()->SetDiffuse(0.25);
-    outlineActor->GetProperty()->SetSpecular(0.0);
-
-    renderer->AddViewProp(outlineActor);
-
-
-    // Create the data label
-//    dataLabel->SetInput(fileInfo.c_str());
-    dataLabel->GetTextProperty()->SetColor(0.75, 0.75, 0.75);
-    dataLabel->GetTextProperty()->SetJustificationToRight();
-    dataLabel->SetTextScaleModeToProp();
-    dataLabel->GetPositionCoordinate()->SetCoordinateSystemToNormalizedViewport();
-    dataLabel->SetPosition(1.0, 0.0);
-    dataLabel->SetPosition2(1.0, 0.025);
-
-    renderer->AddViewProp(dataLabel);
-
-
-    // Create the isosurfaces
-    double maxValue = GetMaximumAbsoluteValue();
-    double val1 = maxValue * 0.1;
-    double val2 = maxValue * 0.01;
-
-    isosurfaces.push_back(new Isosurface(reader->GetOutputPort(), -val1, false, opaqueMaterial, translucentMaterial));
-    isosurfaces.push_back(new Isosurface(reader->GetOutputPort(), val1, false, opaqueMaterial, translucentMaterial));
-    isosurfaces.push_back(new Isosurface(reader->GetOutputPort(), -val2, true, opaqueMaterial, translucentMaterial));
-    isosurfaces.push_back(new Isosurface(reader->GetOutputPort(), val2, true, opaqueMaterial, translucentMaterial));
-
-    for (int i = 0; i < (int)isosurfaces.size(); i++) {
-        renderer->AddViewProp(isosurfaces[i]->GetActor());
-    }
-
-
-    // Create the slices
-	colorMap = vtkSmartPointer<vtkColorTransferFunction>::New();
-    SetColorMap();
-   
-    for (int i = 0; i < 3; i++) {
-        slices[i] = new Slice(reader->GetOutputPort(), colorMap, i, val2, center, size);
-
-        vtkActorCollection* a = slices[i]->GetActors();
-        a->InitTraversal();
-        for (vtkIdType i = 0; i < a->GetNumberOfItems(); i++) {
-            renderer->AddViewProp(a->GetNextActor());
-        }
-    }
-
-
-    // Create a color legend
-    double width = 0.5;
-    double height = 0.1;
-    colorLegend->SetLookupTable(colorMap);
-    colorLegend->SetOrientationToHorizontal();
-    colorLegend->SetPosition((1.0 - width) * 0.5, 0.9);
-    colorLegend->SetWidth(width);
-    colorLegend->SetHeight(height);
-    colorLegend->SetMaximumNumberOfColors(1024);
-    colorLegend->SetLabelTextProperty(axes->GetLabelTextProperty(0));
-
-    renderer->AddViewProp(colorLegend);
-
-
-    // Show the data
-    renderer->ResetCamera();
-    Render();
-
-
-    return true;
-}
-
-
-void VTKPipeline::SaveScreenshot(const std::string& fileName) {
-    Render();
-    interactor->GetRenderWindow()->Modified();
-
-    vtkSmartPointer<vtkWindowToImageFilter> image = vtkSmartPointer<vtkWindowToImageFilter>::New();
-    image->SetInput(interactor->GetRenderWindow());
-
-    vtkSmartPointer<vtkPNGWriter> writer = vtkSmartPointer<vtkPNGWriter>::New();
-    writer->SetInputConnection(image->GetOutputPort());
-    writer->SetFileName(fileName.c_str());
-    writer->Write();
-}
-
-
-double VTKPipeline::GetIsovalue1() {
-    return isosurfaces[1]->GetIsosurface()->GetValue(0);
-}
-
-double VTKPipeline::GetIsovalue2() {
-    return isosurfaces[3]->GetIsosurface()->GetValue(0);
-}
-
-
-void VTKPipeline::SetIsovalue1(double value, bool doFast) {
-    SetIsovalues(0, 1, value, doFast);
-}
-
-void VTKPipeline::SetIsovalue2(double value, bool doFast) {
-    SetIsovalues(2, 3, value, doFast);
-}
-
-void VTKPipeline::SetIsovalues(int index1, int index2, double value, bool doFast) {
-    if (doFast) {
-        isosurfaces[index1]->SetInput(shrinker->GetOutputPort());
-        isosurfaces[index2]->SetInput(shrinker->GetOutputPort());
-
-/*
-        for (int i = 0; i < 3; i++) {
-            slices[i]->SetInput(shrinker->GetOutputPort());
-        }
-*/
-    }
-    else {       
-        isosurfaces[index1]->SetInput(reader->GetOutputPort());
-        isosurfaces[index2]->SetInput(reader->GetOutputPort());
-
-/*
-        for (int i = 0; i < 3; i++) {
-            slices[i]->SetInput(reader->GetOutputPort());
-        }
-*/
-    }
-
-    isosurfaces[index1]->GetIsosurface()->SetValue(0, -value);
-    isosurfaces[index2]->GetIsosurface()->SetValue(0, value);    
-    
-    if (!doFast) {
-        // Only update clipping of slices when interaction is finished
-        double v1 = GetIsovalue1();
-        double v2 = GetIsovalue2();
-        double clipValue = std::min(v1, v2);
-
-        for (int i = 0; i < 3; i++) {
-            slices[i]->SetClipValue(clipValue);
-        }
-    }
-}
-
-
-bool VTKPipeline::GetIsovalue1Visible() {
-	return isosurfaces[0]->GetActor()->GetVisibility() == 1;
-}
-
-bool VTKPipeline::GetIsovalue1Translucent() {
-	return (bool)isosurfaces[0]->GetTranslucent();
-}
-
-bool VTKPipeline::GetIsovalue2Visible() {
-	return isosurfaces[2]->GetActor()->GetVisibility() == 1;
-}
-
-bool VTKPipeline::GetIsovalue2Translucent() {
-	return isosurfaces[2]->GetTranslucent();
-}
-
-
-
-void VTKPipeline::SetIsovalue1Visible(bool visible) {
-	isosurfaces[0]->GetActor()->SetVisibility(visible);
-	isosurfaces[1]->GetActor()->SetVisibility(visible);
-}
-
-void VTKPipeline::SetIsovalue1Translucent(bool translucent) {
-	isosurfaces[0]->SetTranslucent(translucent);
-	isosurfaces[1]->SetTranslucent(translucent);
-}
-
-void VTKPipeline::SetIsovalue2Visible(bool visible) {
-	isosurfaces[2]->GetActor()->SetVisibility(visible);
-	isosurfaces[3]->GetActor()->SetVisibility(visible);
-}
-
-void VTKPipeline::SetIsovalue2Translucent(bool translucent) {
-	isosurfaces[2]->SetTranslucent(translucent);
-	isosurfaces[3]->SetTranslucent(translucent);
-}
-
-
-void VTKPipeline::GetBackgroundColor(double rgb[3]) {
-    renderer->GetBackground(rgb);
-}
-
-void VTKPipeline::SetBackgroundColor(double red, double green, double blue) {
-    renderer->SetBackground(red, green, blue);
-}
-
-
-VTKPipeline::ColorMapType VTKPipeline::GetColorMapType() {
-    return colorMapType;
-}
-
-void VTKPipeline::SetColorMapType(ColorMapType type) {
-    colorMapType = type;
-
-    SetColorMap();
-}
-
-
-bool VTKPipeline::GetShowAxes() {
-    return axes->GetVisibility() == 1;
-}
-
-void VTKPipeline::SetShowAxes(bool show) {
-    axes->SetVisibility(show);
-}
-
-
-bool VTKPipeline::GetShowColorLegend() {
-    return colorLegend->GetVisibility() == 1;
-}
-
-void VTKPipeline::SetShowColorLegend(bool show) {
-    colorLegend->SetVisibility(show);
-}
-
-
-bool VTKPipeline::GetShowDataLabel() {
-    return dataLabel->GetVisibility() == 1;
-}
-
-void VTKPipeline::SetShowDataLabel(bool show) {
-    dataLabel->SetVisibility(show);
-}
-
-
-double VTKPipeline::GetInteractiveDataMagnification() {
-    return shrinker->GetMagnificationFactors()[0];
-}
-
-void VTKPipeline::SetInteractiveDataMagnification(double magnification) {
-    shrinker->SetMagnificationFactors(magnification, magnification, magnification);
-}
-
-
-void VTKPipeline::GetDataRange(double range[2]) {
-    range[0] = dataRange[0];
-    range[1] = dataRange[1];
-}
-
-double VTKPipeline::GetMaximumAbsoluteValue() {
-    return std::max(fabs(dataRange[0]), dataRange[1]);
-}
-
-
-void VTKPipeline::Render() {
-    interactor->Render();
-}
-
-
-void VTKPipeline::SetUseStereo(bool useStereo) {
-    interactor->GetRenderWindow()->SetStereoRender(useStereo);
-}
-
-
-void VTKPipeline::SetHeadPosition(double x, double y, double z) {
-    renderer->GetActiveCamera()->GetPosition(cameraPosition);
-
-    double scale = 50;
-
-    renderer->GetActiveCamera()->SetPosition(cameraPosition[0] + x * scale,
-                                             cameraPosition[1] + y * scale,
-                                             cameraPosition[2] + z * scale);
-
-    renderer->ResetCameraClippingRange();
-    
-    Render();
-    
-    renderer->GetActiveCamera()->SetPosition(cameraPosition);
-}
-
-void VTKPipeline::FlipEyes() {
-    renderer->GetActiveCamera()->SetEyeAngle(-renderer->GetActiveCamera()->GetEyeAngle());
-}
-
-
-void VTKPipeline::SetColorMap() {
-    switch (colorMapType) {
-        case Color:
-            SetColorMapToColor();
-            SetIsosurfacesToColor();
-    
-            // Set logo
-            logo->VisibilityOn();
-            bwLogo->VisibilityOff();
-
-            break;
-
-        case Grayscale:
-            SetColorMapToGrayscale();
-            SetIsosurfacesToGrayscale();
-
-            // Set logo
-            logo->VisibilityOff();
-            bwLogo->VisibilityOn();
-
-            break;
-
-        default:
-            std::cout << "VTKPipeline::SetColorMap() : Unknown color map type, defaulting to Color" << std::endl;
-            colorMapType = Color;
-
-            SetColorMap();
-    }
-}
-
-void VTKPipeline::SetColorMapToColor() {
-    colorMap->RemoveAllPoints();
-
-    if (dataRange[0] < 0.0 && dataRange[1] > 0.0) {
-        // Positive and negative values
-        double small = std::min(fabs(dataRange[0]), dataRange[1]);
-        double big = std::max(fabs(dataRange[0]), dataRange[1]);
-
-        if (fabs(dataRange[0]) > fabs(dataRange[1])) {
-            // Larger negative values
-            colorMap->AddRGBPoint(-big, 1.0, 1.0, 1.0);
-            colorMap->AddRGBPoint(-small - (big - small) * 0.5, 0.0, 1.0, 1.0);
-            colorMap->AddRGBPoint(-small, 0.0, 0.0, 1.0);
-            colorMap->AddRGBPoint(0.0, 0.75, 0.75, 0.75);
-            colorMap->AddRGBPoint(small, 1.0, 0.0, 0.0);
-        }
-        else {
-            // Larger positive values
-            colorMap->AddRGBPoint(-small, 0.0, 0.0, 1.0);
-            colorMap->AddRGBPoint(0.0, 0.75, 0.75, 0.75);
-            colorMap->AddRGBPoint(small, 1.0, 0.0, 0.0);
-            colorMap->AddRGBPoint(small + (big - small) * 0.5, 1.0, 1.0, 0.0);
-            colorMap->AddRGBPoint(big, 1.0, 1.0, 1.0);
-        }
-    }
-    else {
-        if (dataRange[1] < 0.0) {
-            // Only negative values
-            double big = dataRange[0];
-            colorMap->AddRGBPoint(0.0, 0.75, 0.75, 0.75);
-            colorMap->AddRGBPoint(big / 3.0, 0.0, 0.0, 1.0);
-            colorMap->AddRGBPoint(big * 2.0 / 3.0, 0.0, 1.0, 1.0);
-            colorMap->AddRGBPoint(big, 1.0, 1.0, 1.0);
-        }
-        else {
-            // Only positive values
-            double big = dataRange[1];           
-            colorMap->AddRGBPoint(0.0, 0.75, 0.75, 0.75);
-            colorMap->AddRGBPoint(big / 3.0, 1.0, 0.0, 0.0);
-            colorMap->AddRGBPoint(big * 2.0 / 3.0, 1.0, 1.0, 0.0);
-            colorMap->AddRGBPoint(big, 1.0, 1.0, 1.0);
-        }
-    }
-}
-
-void VTKPipeline::SetColorMapToGrayscale() {
-    colorMap->RemoveAllPoints();
-
-    if (dataRange[0] < 0.0 && dataRange[1] > 0.0) {
-        // Positive and negative values
-        double small = std::min(fabs(dataRange[0]), dataRange[1]);
-        double big = std::max(fabs(dataRange[0]), dataRange[1]);
-
-        if (fabs(dataRange[0]) > fabs(dataRange[1])) {
-            // Larger negative values
-            double smallValue = 0.5 + 0.5 * small / big;
-            colorMap->AddRGBPoint(-big, 0.0, 0.0, 0.0);
-            colorMap->AddRGBPoint(0.0, 0.5, 0.5, 0.5);
-            colorMap->AddRGBPoint(small, smallValue, smallValue, smallValue);
-        }
-        else {
-            // Larger positive values
-            double smallValue = 0.5 - 0.5 * small / big;
-            colorMap->AddRGBPoint(-small, smallValue, smallValue, smallValue);
-            colorMap->AddRGBPoint(0.0, 0.5, 0.5, 0.5);
-            colorMap->AddRGBPoint(big, 1.0, 1.0, 1.0);
-        }
-    }
-    else {
-        if (dataRange[1] < 0.0) {
-            // Only negative values
-            double big = dataRange[0];
-            colorMap->AddRGBPoint(0.0, 0.5, 0.5, 0.5);
-            colorMap->AddRGBPoint(big, 0.0, 0.0, 0.0);
-        }
-        else {
-            // Only positive values
-            double big = dataRange[1];           
-            colorMap->AddRGBPoint(0.0, 0.5, 0.5, 0.5);
-            colorMap->AddRGBPoint(big, 1.0, 1.0, 1.0);
-        }
-    }
-}
-
-
-void VTKPipeline::SetIsosurfacesToColor() {
-    for (int i = 0; i < (int)isosurfaces.size(); i++) {
-        vtkProperty* p = isosurfaces[i]->GetActor()->GetProperty();
-        if (isosurfaces[i]->GetIsosurface()->GetValue(0) < 0.0) { 
-            p->SetAmbientColor(0.0, 0.0, 1.0);
-            p->SetDiffuseColor(0.0, 0.0, 1.0);
-        }
-        else {            
-            p->SetAmbientColor(1.0, 0.0, 0.0);
-            p->SetDiffuseColor(1.0, 0.0, 0.0);
-        }
-    }
-}
-
-void VTKPipeline::SetIsosurfacesToGrayscale() {
-    for (int i = 0; i < (int)isosurfaces.size(); i++) {
-        vtkProperty* p = isosurfaces[i]->GetActor()->GetProperty();
-        if (isosurfaces[i]->GetIsosurface()->GetValue(0) < 0.0) { 
-            p->SetAmbientColor(0.25, 0.25, 0.25);
-            p->SetDiffuseColor(0.25, 0.25, 0.25);
-        }
-        else {            
-            p->SetAmbientColor(0.75, 0.75, 0.75);
-            p->SetDiffuseColor(0.75, 0.75, 0.75);
-        }
-    }
+/*=========================================================================
+
+  Name:        VTKPipeline.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Container class for all Voluminous VTK code.
+
+=========================================================================*/
+
+
+#include "VTKPipeline.h"
+
+#include "DerivedFields.h"
+#include "FeatureLabels.h"
+#include "FeatureTracker.h"
+#include "Isosurface.h"
+#include "ObliqueSlice.h"
+#include "Slice.h"
+#include "Wavefunction.h"
+#include "vtkBrickRayCastMapper.h"
+#include "vtkNestedGridBlanking.h"
+#include "vtkTriangleDepthSort.h"
+#include "vtkVolumeDifference.h"
+#include "vtkVolumeProjection.h"
+#include "vtkVolumeSlab.h"
+#include "vtkVolumeSmoothing.h"
+
+#include <vtkActor.h>
+#include <vtkCallbackCommand.h>
+#include <vtkCamera.h>
+#include <vtkColorTransferFunction.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkContourFilter.h>
+#include <vtkCubeAxesActor.h>
+#include <vtkDataArray.h>
+#include <vtkDataArraySelection.h>
+#include <vtkDataSet.h>
+#include <vtkExtractRectilinearGrid.h>
+#include <vtkImageActor.h>
+#include <vtkImageData.h>
+#include <vtkImageMapper.h>
+#include <vtkImageResize.h>
+#include <vtkImplicitPlaneWidget.h>
+#include <vtkMath.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkMultiThreader.h>
+#include <vtkOutlineSource.h>
+#include <vtkPiecewiseFunction.h>
+#include <vtkPNGReader.h>
+#include <vtkPNGWriter.h>
+#include <vtkPointData.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkProperty.h>
+#include <vtkRectilinearGrid.h>
+#include <vtkRectilinearGridReader.h>
+#include <vtkReverseSense.h>
+#include <vtkRenderer.h>
+#include <vtkRendererCollection.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkScalarBarActor.h>
+#include <vtkStructuredPointsReader.h>
+#include <vtkTextActor.h>
+#include <vtkTextProperty.h>
+#include <vtkTimerLog.h>
+#include <vtkTrivialProducer.h>
+#include <vtkTubeFilter.h>
+#include <vtkUniformGrid.h>
+#include <vtkVolume.h>
+#include <vtkVolumeProperty.h>
+#include <vtkWindowToImageFilter.h>
+#include <vtkXMLImageDataReader.h>
+#include <vtkXMLDataReader.h>
+#include <vtkXMLMultiBlockDataReader.h>
+#include <vtkXMLRectilinearGridReader.h>
+
+#include <algorithm>
+#include <sstream>
+
+
+#include <vtkInteractorStyleTrackballActor.h>
+
+
+VTKPipeline::VTKPipeline(vtkRenderWindowInteractor* rwi,
+                         vtkImageData* logoImage, vtkImageData* bwLogoImage,
+                         const std::string& opaqueMaterial, const std::string& translucentMaterial,
+                         MemoryBudget* memoryBudget)
+: interactor(rwi), opaqueMaterial(opaqueMaterial), translucentMaterial(translucentMaterial), 
+  memoryBudget(memoryBudget) {
+    // Renderer
+    renderer = vtkSmartPointer<vtkRenderer>::New();
+
+    renderer->SetBackground(0.95, 0.95, 0.9);
+//    renderer->SetBackground(1.0, 1.0, 1.0);
+
+
+    // No reader or volume yet
+    reader = NULL;
+    volume = NULL;
+
+
+    // No slices yet
+    slices[0] = slices[1] = slices[2] = NULL;
+    obliqueSlice = NULL;
+
+    // Widget for placing the oblique slice, resampling it as it moves
+    planeWidget = vtkSmartPointer<vtkImplicitPlaneWidget>::New();
+    planeWidget->SetInteractor(interactor);
+    planeWidget->SetDefaultRenderer(renderer);
+    planeWidget->SetPlaceFactor(1.0);
+    planeWidget->DrawPlaneOff();
+    planeWidget->OutlineTranslationOff();
+    planeWidget->ScaleEnabledOff();
+
+    planeCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+    planeCallback->SetCallback(PlaneWidgetCallback);
+    planeCallback->SetClientData(this);
+
+    planeWidget->AddObserver(vtkCommand::InteractionEvent, planeCallback);
+    planeWidget->AddObserver(vtkCommand::EndInteractionEvent, planeCallback);
+
+    // Sort translucent triangles before each render when requested
+    depthSorting = false;
+    depthSortTimer = -1;
+    depthSortTimerObserver = 0;
+
+    depthSortCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+    depthSortCallback->SetCallback(DepthSortCallback);
+    depthSortCallback->SetClientData(this);
+
+    renderer->AddObserver(vtkCommand::StartEvent, depthSortCallback);
+
+    // Walls show slices until projections are requested
+    projection = vtkSmartPointer<vtkVolumeProjection>::New();
+    wallType = SliceWalls;
+
+    // Isosurfaces are shown until volume rendering is requested
+    rayCastMapper = vtkSmartPointer<vtkBrickRayCastMapper>::New();
+    rayCastOpacity = vtkSmartPointer<vtkPiecewiseFunction>::New();
+
+    rayCastVolume = vtkSmartPointer<vtkVolume>::New();
+    rayCastVolume->SetMapper(rayCastMapper);
+    rayCastVolume->GetProperty()->SetScalarOpacity(rayCastOpacity);
+    rayCastVolume->GetProperty()->SetInterpolationTypeToLinear();
+
+    displayType = SurfaceDisplay;
+
+    // Create all member visualization objects
+    shrinker = vtkSmartPointer<vtkImageResize>::New();
+    rectilinearShrinker = vtkSmartPointer<vtkExtractRectilinearGrid>::New();
+
+    smoother = vtkSmartPointer<vtkVolumeSmoothing>::New();
+    previewSmoother = vtkSmartPointer<vtkVolumeSmoothing>::New();
+    smoothingType = NoSmoothing;
+    smoothingWidth = 1.0;
+
+    property = NULL;
+    propertyProducer = vtkSmartPointer<vtkTrivialProducer>::New();
+    propertyColorMap = vtkSmartPointer<vtkColorTransferFunction>::New();
+    propertyRange = 1.0;
+
+    axes = vtkSmartPointer<vtkCubeAxesActor>::New();
+    colorLegend = vtkSmartPointer<vtkScalarBarActor>::New();
+    dataLabel = vtkSmartPointer<vtkTextActor>::New();
+
+
+    // Create the logos
+    logo = vtkSmartPointer<vtkImageActor>::New();
+    logo->SetInput(logoImage); 
+    logo->InterpolateOn();
+    logo->SetOrigin((double)logoImage->GetDimensions()[0] / 2.0, (double)(double)logoImage->GetDimensions()[0] / 2.0, 0.0);
+    logo->SetOpacity(0.5);
+
+    bwLogo = vtkSmartPointer<vtkImageActor>::New();
+    bwLogo->SetInput(bwLogoImage); 
+    bwLogo->InterpolateOn();
+    bwLogo->SetOrigin((double)bwLogoImage->GetDimensions()[0] / 2.0, (double)(double)bwLogoImage->GetDimensions()[0] / 2.0, 0.0);
+    bwLogo->SetOpacity(0.5);
+    bwLogo->VisibilityOff();
+
+
+    // Use a separate renderer for the logo, to make placement easier
+    logoRenderer = vtkSmartPointer<vtkRenderer>::New();
+    double scale = 0.1;
+    logoRenderer->SetViewport(0.0, 0.0, scale, scale);
+    logoRenderer->InteractiveOff();
+    logoRenderer->AddViewProp(logo);
+    logoRenderer->AddViewProp(bwLogo);
+
+    renderer->SetLayer(0);
+    logoRenderer->SetLayer(1);
+
+
+    // No data range yet
+    dataRange[0] = dataRange[1] = 0.0;
+
+
+    // Color map type
+    colorMapType = Color;
+
+
+    // Default isovalues
+    initialIsovalue1 = initialIsovalue2 = -1.0;
+
+    field = 0;
+    derivedFields = NULL;
+
+
+    // Keep all intermediate data by default
+    leanMemory = false;
+
+
+    // No lobe tracking by default
+    featureTracker = NULL;
+    featureLabels[0] = featureLabels[1] = NULL;
+
+
+    // Enforce the memory limit after each render
+    renderCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+    renderCallback->SetCallback(RenderCallback);
+    renderCallback->SetClientData(this);
+
+
+    // Not shown in the render window until activated
+    active = false;
+    memoryRegistered = false;
+
+
+    // No products being computed
+    productsPending = 0;
+}
+
+VTKPipeline::~VTKPipeline() {
+    SetActive(false);
+
+    // Clean up
+    for (int i = 0; i < (int)memoryConsumers.size(); i++) {
+        delete memoryConsumers[i].consumer;
+    }
+
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        delete isosurfaces[i];
+    }
+
+    for (int i = 0; i < 3; i++) {
+        if (slices[i]) {
+            delete slices[i];
+        }
+    }
+
+    if (obliqueSlice) {
+        delete obliqueSlice;
+    }
+}
+
+
+bool VTKPipeline::OpenVolume(const std::string& fileName, std::string* errorMessage) {
+    // Should only call this once per pipeline
+    if (reader) {
+//        std::cout << "VTKPipeline::OpenVolume() : Volume already loaded." << std::endl;
+        *errorMessage = "Volume already loaded";
+
+        return false;
+    }
+
+    std::string fileInfo;
+    reader = ReadVolume(fileName, fileInfo, errorMessage);
+
+    if (!reader) {
+        return false;
+    }
+
+
+    // Go ahead and set the data label string
+    dataLabel->SetInput(fileInfo.c_str());
+
+
+    return true;
+}
+
+
+// Only decode the first point data array of an XML file when loading.  Others are decoded when
+// selected.
+static void SelectFirstField(vtkXMLDataReader* reader) {
+    reader->UpdateInformation();
+
+    vtkDataArraySelection* selection = reader->GetPointDataArraySelection();
+
+    if (selection->GetNumberOfArrays() > 1) {
+        selection->DisableAllArrays();
+        selection->EnableArray(selection->GetArrayName(0));
+    }
+}
+
+
+// Shared state for reading both volumes of a difference at once
+struct VTKPipelineReadWork {
+    std::string fileNames[2];
+    vtkSmartPointer<vtkAlgorithm> readers[2];
+    std::string fileInfo[2];
+    std::string errorMessages[2];
+};
+
+static VTK_THREAD_RETURN_TYPE ReadVolumeThread(void* arg) {
+    vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    VTKPipelineReadWork* work = static_cast<VTKPipelineReadWork*>(info->UserData);
+
+    int i = info->ThreadID;
+    work->readers[i] = VTKPipeline::ReadVolume(work->fileNames[i], work->fileInfo[i], &work->errorMessages[i]);
+
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+bool VTKPipeline::OpenVolume(const std::string& fileNameA, const std::string& fileNameB, double scale, 
+                             std::string* errorMessage) {
+    // Should only call this once per pipeline
+    if (reader) {
+        *errorMessage = "Volume already loaded";
+
+        return false;
+    }
+
+
+    // Read both volumes at the same time
+    VTKPipelineReadWork work;
+    work.fileNames[0] = fileNameA;
+    work.fileNames[1] = fileNameB;
+
+    vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+    threader->SetNumberOfThreads(2);
+    threader->SetSingleMethod(ReadVolumeThread, &work);
+    threader->SingleMethodExecute();
+
+    for (int i = 0; i < 2; i++) {
+        if (!work.readers[i]) {
+            *errorMessage = work.errorMessages[i];
+
+            return false;
+        }
+
+        if (!vtkDataSet::SafeDownCast(work.readers[i]->GetOutputDataObject(0))) {
+            *errorMessage = "Differences of nested grids are not supported";
+
+            return false;
+        }
+    }
+
+
+    // Compute the difference
+    vtkSmartPointer<vtkVolumeDifference> difference = vtkSmartPointer<vtkVolumeDifference>::New();
+    difference->SetInputConnection(0, work.readers[0]->GetOutputPort());
+    difference->SetInputConnection(1, work.readers[1]->GetOutputPort());
+    difference->SetScale(scale);
+    difference->Update();
+
+    vtkDataSet* output = vtkDataSet::SafeDownCast(difference->GetOutputDataObject(0));
+
+    if (!output || !output->GetPointData()->GetScalars()) {
+        *errorMessage = "Could not compute the difference of " + fileNameA + " and " + fileNameB + 
+                        ".  Both volumes must be uniform or rectilinear grids with one scalar component";
+
+        return false;
+    }
+
+
+    // Keep only the difference, so the memory for both volumes is freed
+    vtkSmartPointer<vtkDataObject> data;
+    data.TakeReference(output->NewInstance());
+    data->ShallowCopy(output);
+
+    vtkSmartPointer<vtkTrivialProducer> producer = vtkSmartPointer<vtkTrivialProducer>::New();
+    producer->SetOutput(data);
+
+    reader = producer;
+
+
+    // Data label
+    std::string fileInfo = work.fileInfo[0] + " - " + work.fileInfo[1];
+    if (scale != 1.0) {
+        std::ostringstream label;
+        label << "(" << fileInfo << ") x " << scale;
+        fileInfo = label.str();
+    }
+
+    dataLabel->SetInput(fileInfo.c_str());
+
+
+    return true;
+}
+
+
+bool VTKPipeline::OpenWavefunction(const std::string& fileName, int orbital, double spacing, int refinement,
+                                   std::string* errorMessage) {
+    // Should only call this once per pipeline
+    if (reader) {
+        *errorMessage = "Volume already loaded";
+
+        return false;
+    }
+
+    Wavefunction wavefunction;
+
+    if (!wavefunction.Read(fileName, errorMessage)) {
+        return false;
+    }
+
+    if (orbital >= wavefunction.GetNumberOfOrbitals() || spacing <= 0.0) {
+        *errorMessage = "Invalid orbital or grid spacing for " + fileName;
+
+        return false;
+    }
+
+
+    // Cover the tails of the density around the atoms, and refine the region around the nuclei
+    const double margin = 5.0;
+    const double regionMargin = 2.0;
+
+    double region[6];
+    wavefunction.GetAtomBounds(region);
+
+    for (int i = 0; i < 3; i++) {
+        region[i * 2] -= regionMargin;
+        region[i * 2 + 1] += regionMargin;
+    }
+
+    vtkSmartPointer<vtkDataObject> data = wavefunction.Evaluate(orbital, spacing, margin, refinement, region);
+
+    vtkSmartPointer<vtkTrivialProducer> producer = vtkSmartPointer<vtkTrivialProducer>::New();
+    producer->SetOutput(data);
+
+    if (vtkMultiBlockDataSet::SafeDownCast(data)) {
+        // Prepare the nested blocks as for .vtm files
+        vtkSmartPointer<vtkNestedGridBlanking> blanking = vtkSmartPointer<vtkNestedGridBlanking>::New();
+        blanking->SetInputConnection(producer->GetOutputPort());
+        blanking->Update();
+
+        reader = blanking;
+    }
+    else {
+        reader = producer;
+    }
+
+
+    // Data label
+    size_t p = fileName.find_last_of("/\\") + 1;
+
+    std::ostringstream label;
+    label << fileName.substr(p, fileName.find_last_of(".") - p);
+
+    if (orbital < 0) {
+        label << " density";
+    }
+    else {
+        label << " MO " << orbital + 1;
+    }
+
+    dataLabel->SetInput(label.str().c_str());
+
+
+    return true;
+}
+
+
+vtkSmartPointer<vtkAlgorithm> VTKPipeline::ReadVolume(const std::string& fileName, std::string& fileInfo, 
+                                                      std::string* errorMessage) {
+    vtkSmartPointer<vtkAlgorithm> reader;
+
+    // File information string
+    size_t p = fileName.find_last_of("/\\") + 1;
+    fileInfo = fileName.substr(p, fileName.find_last_of(".") - p);
+
+    if (fileName.rfind(".vtk") == fileName.length() - 4) {
+        // Load legacy VTK structured point data
+        vtkSmartPointer<vtkStructuredPointsReader> spReader = vtkSmartPointer<vtkStructuredPointsReader>::New();
+        spReader->SetFileName(fileName.c_str());
+        
+        if (spReader->IsFileStructuredPoints()) {
+            reader = spReader;
+
+            reader->Update();
+            
+            std::string header = spReader->GetHeader();
+            if (header.size() > 0) {
+                fileInfo = header;
+            }
+        }
+        else {
+            // Load legacy VTK rectilinear grid data
+            vtkSmartPointer<vtkRectilinearGridReader> rgReader = vtkSmartPointer<vtkRectilinearGridReader>::New();
+            rgReader->SetFileName(fileName.c_str());
+
+            if (rgReader->IsFileRectilinearGrid()) {
+                reader = rgReader;
+
+                reader->Update();
+
+                std::string header = rgReader->GetHeader();
+                if (header.size() > 0) {
+                    fileInfo = header;
+                }
+            }
+        }
+    }
+    else if (fileName.rfind(".vti") == fileName.length() - 4) {
+        // Load VTK XML image data file
+        vtkSmartPointer<vtkXMLImageDataReader> iReader = vtkSmartPointer<vtkXMLImageDataReader>::New();
+        iReader->SetFileName(fileName.c_str());
+        SelectFirstField(iReader);
+        
+        reader = iReader;
+
+        reader->Update();
+    }  
+    else if (fileName.rfind(".vtr") == fileName.length() - 4) {
+        // Load VTK XML rectilinear grid file
+        vtkSmartPointer<vtkXMLRectilinearGridReader> rReader = vtkSmartPointer<vtkXMLRectilinearGridReader>::New();
+        rReader->SetFileName(fileName.c_str());
+        SelectFirstField(rReader);
+
+        reader = rReader;
+
+        reader->Update();
+    }
+    else if (fileName.rfind(".vtm") == fileName.length() - 4) {
+        // Load VTK XML multi-block file of nested image data blocks, and prepare the blocks for
+        // contouring by blanking regions covered by finer blocks
+        vtkSmartPointer<vtkXMLMultiBlockDataReader> mReader = vtkSmartPointer<vtkXMLMultiBlockDataReader>::New();
+        mReader->SetFileName(fileName.c_str());
+
+        vtkSmartPointer<vtkNestedGridBlanking> blanking = vtkSmartPointer<vtkNestedGridBlanking>::New();
+        blanking->SetInputConnection(mReader->GetOutputPort());
+
+        reader = blanking;
+
+        reader->Update();
+    }
+
+    
+    if (reader == NULL) {
+//        std::cout << "VTKPipeline::ReadVolume() : Volume must be in .vtk structured points, .vtk rectilinear grid, .vti, .vtr, or .vtm format." << std::endl;
+        *errorMessage = "Volume must be in .vtk structured points, .vtk rectilinear grid, .vti, .vtr, or .vtm format";
+
+        return NULL;
+    }
+            
+
+    if (reader->GetOutputDataObject(0) == NULL) {
+//       std::cout << "VTKPipeline::ReadVolume() : Could not open " << fileName << std::endl;     
+        *errorMessage = "Could not open " + fileName;
+
+       return NULL;
+    }
+
+
+    // Show the first field if the scalars named in the file weren't read
+    vtkDataSet* data = vtkDataSet::SafeDownCast(reader->GetOutputDataObject(0));
+
+    if (data && !data->GetPointData()->GetScalars() && data->GetPointData()->GetNumberOfArrays() > 0) {
+        data->GetPointData()->SetActiveScalars(data->GetPointData()->GetArrayName(0));
+    }
+
+
+    return reader;
+}
+
+
+bool VTKPipeline::LoadVolume(const std::string& fileName, std::string* errorMessage) {
+    return OpenVolume(fileName, errorMessage) && CreateVisualization(*errorMessage);
+}
+
+
+bool VTKPipeline::LoadDifference(const std::string& fileNameA, const std::string& fileNameB, double scale,
+                                 std::string* errorMessage) {
+    return OpenVolume(fileNameA, fileNameB, scale, errorMessage) && CreateVisualization(*errorMessage);
+}
+
+
+bool VTKPipeline::LoadWavefunction(const std::string& fileName, int orbital, double spacing, int refinement,
+                                   std::string* errorMessage) {
+    return OpenWavefunction(fileName, orbital, spacing, refinement, errorMessage) && 
+           CreateVisualization(*errorMessage);
+}
+
+
+bool VTKPipeline::PrepareVolume(const std::string& fileName, std::string* errorMessage) {
+    if (!LoadVolume(fileName, errorMessage)) {
+        return false;
+    }
+
+    UpdateProducts();
+
+    return true;
+}
+
+
+void VTKPipeline::UpdateProducts() {
+    for (int i = 0; i < GetNumberOfProducts(); i++) {
+        UpdateProduct(i);
+    }
+
+    for (int i = 0; i < GetNumberOfProducts(); i++) {
+        if (!productFinished[i]) {
+            FinishProduct(i);
+        }
+    }
+}
+
+
+VTKPipeline* VTKPipeline::CreateEmptyCopy() {
+    VTKPipeline* copy = new VTKPipeline(interactor, logo->GetInput(), bwLogo->GetInput(), 
+                                        opaqueMaterial, translucentMaterial, memoryBudget);
+
+    copy->SetLeanMemory(leanMemory);
+    copy->SetFeatureTracker(featureTracker);
+    copy->SetWallType(wallType);
+    copy->SetDisplayType(displayType);
+    copy->SetDepthPeeling(GetDepthPeeling(), GetMaximumNumberOfPeels());
+    copy->SetDepthSorting(depthSorting);
+
+    if (HasVisualization()) {
+        copy->SetInitialField(GetFieldName(field));
+    }
+
+    return copy;
+}
+
+
+bool VTKPipeline::HasVisualization() {
+    return volume != NULL;
+}
+
+
+bool VTKPipeline::GetActive() {
+    return active;
+}
+
+void VTKPipeline::SetActive(bool isActive) {
+    if (isActive == active) {
+        return;
+    }
+
+    active = isActive;
+
+    vtkRenderWindow* window = interactor->GetRenderWindow();
+
+    if (active) {
+        window->AddRenderer(renderer);
+        window->AddRenderer(logoRenderer);
+        window->SetNumberOfLayers(2);
+
+        renderObserver = window->AddObserver(vtkCommand::EndEvent, renderCallback);
+    }
+    else {
+        window->RemoveRenderer(renderer);
+        window->RemoveRenderer(logoRenderer);
+
+        window->RemoveObserver(renderObserver);
+    }
+
+    UpdatePlaneWidget();
+    UpdateDepthSortTimer();
+
+    UpdateMemoryRegistration();
+}
+
+
+int VTKPipeline::GetNumberOfProducts() {
+    return (int)productShown.size();
+}
+
+int VTKPipeline::GetNumberOfSliceProducts() {
+    return 3;
+}
+
+void VTKPipeline::UpdateProduct(int index) {
+    if (index < 3) {
+        vtkActorCollection* a = slices[index]->GetActors();
+        a->InitTraversal();
+        for (vtkIdType i = 0; i < a->GetNumberOfItems(); i++) {
+            a->GetNextActor()->GetMapper()->Update();
+        }
+    }
+    else if (displayType == SurfaceDisplay) {
+        // Meshes are only built when shown as meshes
+        isosurfaces[index - 3]->GetActor()->GetMapper()->Update();
+    }
+}
+
+void VTKPipeline::FinishProduct(int index) {
+    productFinished[index] = true;
+
+    // Show slices as they finish
+    bool slicesShown = true;
+    for (int i = 0; i < 3; i++) {
+        if (productFinished[i] && !productShown[i]) {
+            ShowProduct(i);
+        }
+
+        slicesShown = slicesShown && productShown[i];
+    }
+
+    // Then surfaces
+    if (slicesShown) {
+        for (int i = 3; i < (int)productShown.size(); i++) {
+            if (productFinished[i] && !productShown[i]) {
+                ShowProduct(i);
+            }
+        }
+    }
+
+    if (productsPending == 0) {
+        // Now safe to account for and evict data
+        UpdateMemoryRegistration();
+    }
+}
+
+int VTKPipeline::GetProductsPending() {
+    return productsPending;
+}
+
+void VTKPipeline::ShowProduct(int index) {
+    if (index < 3) {
+        vtkActorCollection* a = slices[index]->GetActors();
+        a->InitTraversal();
+        for (vtkIdType i = 0; i < a->GetNumberOfItems(); i++) {
+            renderer->AddViewProp(a->GetNextActor());
+        }
+    }
+    else if (displayType == SurfaceDisplay) {
+        renderer->AddViewProp(isosurfaces[index - 3]->GetActor());
+    }
+
+    productShown[index] = true;
+    productsPending--;
+}
+
+
+vtkAlgorithmOutput* VTKPipeline::CreateVolumeCopy() {
+    // Shallow copy, so only the data object is duplicated, not the arrays
+    vtkSmartPointer<vtkDataObject> copy;
+    copy.TakeReference(volume->NewInstance());
+    copy->ShallowCopy(volume);
+
+    vtkSmartPointer<vtkTrivialProducer> producer = vtkSmartPointer<vtkTrivialProducer>::New();
+    producer->SetOutput(copy);
+
+    volumeCopies.push_back(producer.GetPointer());
+
+    return producer->GetOutputPort();
+}
+
+
+void VTKPipeline::UpdateMemoryRegistration() {
+    // Only account for data when shown, and not while products are being computed on other threads
+    bool registered = active && productsPending == 0;
+
+    if (registered == memoryRegistered) {
+        return;
+    }
+
+    memoryRegistered = registered;
+
+    for (int i = 0; i < (int)memoryConsumers.size(); i++) {
+        if (memoryRegistered) {
+            memoryBudget->AddConsumer(memoryConsumers[i].name, memoryConsumers[i].consumer, memoryConsumers[i].priority);
+        }
+        else {
+            memoryBudget->RemoveConsumer(memoryConsumers[i].consumer);
+        }
+    }
+}
+
+
+unsigned long VTKPipeline::GetMemorySize() {
+    unsigned long size = 0;
+    for (int i = 0; i < (int)memoryConsumers.size(); i++) {
+        size += memoryConsumers[i].consumer->GetMemorySize();
+    }
+
+    return size;
+}
+
+
+bool VTKPipeline::CreateVisualization(std::string& errorMessage) {
+    // Should only call this once per pipeline
+    if (volume) {
+//        std::cout << "VTKPipeline::CreateVisualization() : Visualization already created." << std::endl;
+        errorMessage = "Visualization already created";
+
+        return false;
+    }
+
+       
+    // Get the volume information
+    volume = reader->GetOutputDataObject(0);
+
+    // Use the bounds rather than the origin, as rectilinear grids have no origin, and nested grids 
+    // have one per block
+    double bounds[6];
+    if (!GetVolumeBounds(bounds)) {
+        errorMessage = "Volume contains no data";
+
+        return false;
+    }
+
+    // Find the fields, and switch to the initial field if there is one
+    FindFields();
+
+    for (int i = 0; i < (int)fieldNames.size(); i++) {
+        if (i != field && fieldNames[i] == initialField) {
+            std::string fieldMessage;
+            if (LoadField(fieldNames[i], &fieldMessage)) {
+                ActivateField(fieldNames[i]);
+                field = i;
+            }
+            else {
+                std::cout << "VTKPipeline::CreateVisualization() : " << fieldMessage << std::endl;
+            }
+
+            break;
+        }
+    }
+
+    ComputeDataRange();
+
+    double size[3];
+    for (int i = 0; i < 3; i++) {
+        size[i] = (bounds[2 * i + 1] - bounds[2 * i]);
+    }
+
+    double center[3];
+    for (int i = 0; i < 3; i++) {
+        center[i] = bounds[2 * i] + size[i] * 0.5;
+    }
+
+
+    // Set up the volume shrinker.  Nested grids are already compact, so are not downsampled.
+    if (IsRectilinear()) {
+        // vtkImageResize assumes uniform spacing, so subsample rectilinear grids along each axis, 
+        // keeping the original coordinates of the retained samples
+        rectilinearShrinker->SetInputConnection(reader->GetOutputPort());
+        rectilinearShrinker->IncludeBoundaryOn();
+    }
+    else if (!IsNested()) {
+        shrinker->SetInputConnection(reader->GetOutputPort());
+    }
+    shrinker->SetResizeMethodToMagnificationFactors();
+    shrinker->InterpolateOn();
+    SetInteractiveDataMagnification(0.5);
+
+    // Set up smoothing, which is off until requested
+    if (!IsNested()) {
+        smoother->SetInputConnection(reader->GetOutputPort());
+        previewSmoother->SetInputConnection(GetInteractiveVolumePort());
+    }
+
+
+    // Set up axes
+    double axesBounds[6];
+    for (int i = 0; i < 3; i++) {
+        // Do some rounding if close enough
+        double fraction = 0.01;
+        double d;
+
+        int i1 = 2 * i;
+        int i2 = 2 * i + 1;
+        
+        d = bounds[i1] - floor(bounds[i1]);
+        if (d < size[i] * fraction) axesBounds[i1] = floor(bounds[i1]);
+        else axesBounds[i1] = bounds[i1];
+
+        d = ceil(bounds[i2]) - bounds[i2];
+        if (d < size[i] * fraction) axesBounds[i2] = ceil(bounds[i2]);
+        else axesBounds[i2] = bounds[i2];
+    }
+
+    axes->SetBounds(axesBounds);
+
+    axes->GetXAxesLinesProperty()->SetColor(0.75, 0.75, 0.75);
+    axes->GetXAxesLinesProperty()->SetAmbient(1.0);
+    axes->GetXAxesLinesProperty()->SetDiffuse(0.25);
+    axes->GetXAxesLinesProperty()->SetSpecular(0.0);
+
+    axes->GetYAxesLinesProperty()->SetColor(0.75, 0.75, 0.75);
+    axes->GetYAxesLinesProperty()->SetAmbient(1.0);
+    axes->GetYAxesLinesProperty()->SetDiffuse(0.25);
+    axes->GetYAxesLinesProperty()->SetSpecular(0.0);
+
+    axes->GetZAxesLinesProperty()->SetColor(0.75, 0.75, 0.75);
+    axes->GetZAxesLinesProperty()->SetAmbient(1.0);
+    axes->GetZAxesLinesProperty()->SetDiffuse(0.25);
+    axes->GetZAxesLinesProperty()->SetSpecular(0.0);
+
+    axes->GetLabelTextProperty(0)->SetColor(0.75, 0.75, 0.75);
+    axes->GetLabelTextProperty(1)->SetColor(0.75, 0.75, 0.75);
+    axes->GetLabelTextProperty(2)->SetColor(0.75, 0.75, 0.75);
+
+    axes->GetTitleTextProperty(0)->SetColor(0.75, 0.75, 0.75);
+    axes->GetTitleTextProperty(1)->SetColor(0.75, 0.75, 0.75);
+    axes->GetTitleTextProperty(2)->SetColor(0.75, 0.75, 0.75);
+
+    axes->SetFlyModeToOuterEdges();
+
+    axes->SetCamera(renderer->GetActiveCamera());
+
+    renderer->AddViewProp(axes);
+
+
+    // Create the outline    
+    vtkSmartPointer<vtkOutlineSource> outline = vtkSmartPointer<vtkOutlineSource>::New();
+    outline->SetBounds(bounds);
+
+    vtkSmartPointer<vtkTubeFilter> tubeOutline = vtkSmartPointer<vtkTubeFilter>::New();
+    tubeOutline->SetInputConnection(outline->GetOutputPort());
+    tubeOutline->SetRadius(size[0] * 0.002);
+    
+    vtkSmartPointer<vtkPolyDataMapper> outlineMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+    outlineMapper->SetInputConnection(tubeOutline->GetOutputPort());
+
+    vtkSmartPointer<vtkActor> outlineActor = vtkSmartPointer<vtkActor>::New();
+    outlineActor->SetMapper(outlineMapper);
+//    outlineActor->GetProperty()->SetColor(background[0] * 0.75, background[1] * 0.75, background[2] * 0.75);
+    outlineActor->GetProperty()->SetColor(0.75, 0.75, 0.75);
+    outlineActor->GetProperty()->SetAmbient(1.0);
+    outlineActor->GetProperty()->SetDiffuse(0.25);
+    outlineActor->GetProperty()->SetSpecular(0.0);
+
+    renderer->AddViewProp(outlineActor);
+
+
+    // Create the data label
+//    dataLabel->SetInput(fileInfo.c_str());
+    dataLabel->GetTextProperty()->SetColor(0.75, 0.75, 0.75);
+    dataLabel->GetTextProperty()->SetJustificationToRight();
+    dataLabel->SetTextScaleModeToProp();
+    dataLabel->GetPositionCoordinate()->SetCoordinateSystemToNormalizedViewport();
+    dataLabel->SetPosition(1.0, 0.0);
+    dataLabel->SetPosition2(1.0, 0.025);
+
+    renderer->AddViewProp(dataLabel);
+
+
+    // Create the isosurfaces
+    double maxValue = GetMaximumAbsoluteValue();
+    double val1 = maxValue * 0.1;
+    double val2 = maxValue * 0.01;
+
+    if (initialIsovalue1 >= 0.0 && initialIsovalue1 <= maxValue &&
+        initialIsovalue2 >= 0.0 && initialIsovalue2 <= maxValue) {
+        val1 = initialIsovalue1;
+        val2 = initialIsovalue2;
+    }
+
+    // Each product gets its own copy of the volume, so products can be computed concurrently 
+    // without sharing the reader's executive
+    isosurfaces.push_back(new Isosurface(CreateVolumeCopy(), -val1, false, opaqueMaterial, translucentMaterial));
+    isosurfaces.push_back(new Isosurface(CreateVolumeCopy(), val1, false, opaqueMaterial, translucentMaterial));
+    isosurfaces.push_back(new Isosurface(CreateVolumeCopy(), -val2, true, opaqueMaterial, translucentMaterial));
+    isosurfaces.push_back(new Isosurface(CreateVolumeCopy(), val2, true, opaqueMaterial, translucentMaterial));
+
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        isosurfaces[i]->SetDepthSortCamera(depthSorting ? renderer->GetActiveCamera() : NULL);
+    }
+
+
+    // Create the slices
+	colorMap = vtkSmartPointer<vtkColorTransferFunction>::New();
+    SetColorMap();
+   
+    for (int i = 0; i < 3; i++) {
+        slices[i] = new Slice(CreateVolumeCopy(), colorMap, i, val2, center, size);
+    }
+
+    // Start the slices at the grid planes nearest the middle
+    for (int i = 0; i < 3; i++) {
+        vtkVolumeDifference::GetCoordinates(vtkVolumeSlab::GetGrid(volume), i, sliceCoordinates[i]);
+
+        if (!sliceCoordinates[i].empty()) {
+            const std::vector<double>& c = sliceCoordinates[i];
+
+            int index = 0;
+            for (int j = 1; j < (int)c.size(); j++) {
+                if (fabs(c[j] - center[i]) < fabs(c[index] - center[i])) {
+                    index = j;
+                }
+            }
+
+            SetSlicePosition(i, index);
+        }
+    }
+
+    // Projections for the walls are not products, and are only computed when shown
+    projection->SetInputConnection(CreateVolumeCopy());
+    UpdateWallProjection();
+
+    // Volume rendering is ray cast from its own copy of the volume when shown.  Opacity is for a 
+    // mean grid spacing, so volumes of different sizes look alike.
+    double spacing = 0.0;
+    for (int i = 0; i < 3; i++) {
+        const std::vector<double>& c = sliceCoordinates[i];
+        spacing += c.size() > 1 ? (c.back() - c.front()) / (c.size() - 1) / 3.0 : 0.0;
+    }
+
+    rayCastMapper->SetInputConnection(CreateVolumeCopy());
+    rayCastVolume->GetProperty()->SetColor(colorMap);
+    rayCastVolume->GetProperty()->SetScalarOpacityUnitDistance(spacing > 0.0 ? spacing : 1.0);
+    UpdateRayCastOpacity();
+    UpdateRayCastIsosurfaces();
+
+    renderer->AddViewProp(rayCastVolume);
+
+    // The oblique slice is not a product.  It is hidden, and only sampled once shown.
+    double normal[3] = { 0.0, 0.0, 1.0 };
+
+    obliqueSlice = new ObliqueSlice(CreateVolumeCopy(), colorMap, val2, center, normal);
+    obliqueSlice->GetActor()->VisibilityOff();
+
+    renderer->AddViewProp(obliqueSlice->GetActor());
+
+    planeWidget->PlaceWidget(bounds);
+    planeWidget->SetOrigin(center);
+    planeWidget->SetNormal(normal);
+
+
+    // Label lobes for tracking.  Labeling is done when the isosurfaces are computed.
+    if (featureTracker) {
+        CreateFeatureLabels();
+    }
+
+
+    // Slices and isosurfaces are computed and added to the renderer after the first image, 
+    // via UpdateProduct() and FinishProduct()
+    productsPending = 3 + (int)isosurfaces.size();
+    productFinished.assign(productsPending, false);
+    productShown.assign(productsPending, false);
+
+    UpdateDisplay();
+
+
+    // Create a color legend
+    double width = 0.5;
+    double height = 0.1;
+    colorLegend->SetLookupTable(colorMap);
+    colorLegend->SetOrientationToHorizontal();
+    colorLegend->SetPosition((1.0 - width) * 0.5, 0.9);
+    colorLegend->SetWidth(width);
+    colorLegend->SetHeight(height);
+    colorLegend->SetMaximumNumberOfColors(1024);
+    colorLegend->SetLabelTextProperty(axes->GetLabelTextProperty(0));
+
+    renderer->AddViewProp(colorLegend);
+
+
+    // Register memory use of each stage.  Data that is rendered can't be evicted.  Of the rest,
+    // evict what is cheapest to regenerate first.
+    std::vector<vtkAlgorithm*> stage;
+
+    stage.push_back(reader);
+    AddMemoryConsumer("Volume", stage, false, 0);
+
+    stage.clear();
+    if (!IsNested()) {
+        stage.push_back(GetInteractiveVolumePort()->GetProducer());
+    }
+    AddMemoryConsumer("Interactive volume", stage, true, 2);
+
+    stage.clear();
+    stage.push_back(smoother);
+    AddMemoryConsumer("Smoothed volume", stage, false, 0);
+
+    stage.clear();
+    stage.push_back(previewSmoother);
+    AddMemoryConsumer("Interactive smoothed volume", stage, true, 2);
+
+    stage.clear();
+    stage.push_back(propertyProducer);
+    AddMemoryConsumer("Property volume", stage, false, 0);
+
+    stage.clear();
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        if (isosurfaces[i]->GetNormalFlipper()) {
+            stage.push_back(isosurfaces[i]->GetNormalFlipper());
+        }
+        else {
+            stage.push_back(isosurfaces[i]->GetIsosurface());
+        }
+    }
+    AddMemoryConsumer("Isosurfaces", stage, false, 0);
+
+    stage.clear();
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        if (isosurfaces[i]->GetNormalFlipper()) {
+            stage.push_back(isosurfaces[i]->GetIsosurface());
+        }
+    }
+    AddMemoryConsumer("Isosurface contours before normal flips", stage, true, 1);
+
+    stage.clear();
+    for (int i = 0; i < 3; i++) {
+        stage.push_back(slices[i]->GetSlab());
+    }
+    AddMemoryConsumer("Slice walls", stage, false, 0);
+
+    // Planes copied ahead of the slices are cheap to copy again, so go before the caches that take 
+    // a pass over the volume
+    std::vector<vtkVolumeSlab*> slabs;
+    for (int i = 0; i < 3; i++) {
+        slabs.push_back(slices[i]->GetSlab());
+    }
+    AddMemoryConsumer("Slice prefetch planes", new MemoryBudget::CacheConsumer<vtkVolumeSlab>(slabs), 0);
+
+    stage.clear();
+    stage.push_back(obliqueSlice->GetReslice());
+    AddMemoryConsumer("Oblique slice", stage, false, 0);
+
+    stage.clear();
+    stage.push_back(projection);
+    AddMemoryConsumer("Projection walls", stage, false, 0);
+
+    // Projections kept for other fields and modes take a pass over the volume to compute again
+    std::vector<vtkVolumeProjection*> projections(1, projection.GetPointer());
+    AddMemoryConsumer("Projection cache", new MemoryBudget::CacheConsumer<vtkVolumeProjection>(projections), 1);
+
+    SetLeanMemory(leanMemory);
+
+
+    // Compute the outline now, so that the first image can be shown as soon as the pipeline is
+    // activated.  Rendering is left to the caller, as this can be called from a worker thread.
+    outlineMapper->Update();
+
+    renderer->ResetCamera();
+
+
+    return true;
+}
+
+
+int VTKPipeline::GetNumberOfFields() {
+    return (int)fieldNames.size();
+}
+
+std::string VTKPipeline::GetFieldName(int index) {
+    if (index < 0 || index >= (int)fieldNames.size()) {
+        return "";
+    }
+
+    return fieldNames[index];
+}
+
+int VTKPipeline::GetField() {
+    return field;
+}
+
+bool VTKPipeline::SetField(int index, std::string* errorMessage) {
+    if (index < 0 || index >= (int)fieldNames.size()) {
+        *errorMessage = "No such field";
+
+        return false;
+    }
+
+    if (index == field) {
+        return true;
+    }
+
+    if (!LoadField(fieldNames[index], errorMessage)) {
+        return false;
+    }
+
+    ActivateField(fieldNames[index]);
+    field = index;
+
+
+    // Reset the color map, smoothing, and isovalues for the range of the new field
+    ComputeDataRange();
+    SetColorMap();
+    ConfigureSmoothing();
+
+    double maxValue = GetMaximumAbsoluteValue();
+    SetIsovalue1(maxValue * 0.1);
+    SetIsovalue2(maxValue * 0.01);
+
+
+    // Label lobes of the new field
+    if (featureLabels[0]) {
+        DeleteFeatureLabels();
+        CreateFeatureLabels();
+    }
+
+    UpdateWallProjection();
+
+    return true;
+}
+
+void VTKPipeline::SetInitialField(const std::string& name) {
+    initialField = name;
+}
+
+
+void VTKPipeline::FindFields() {
+    fieldNames.clear();
+    field = 0;
+
+    vtkDataSet* data = vtkDataSet::SafeDownCast(volume);
+
+    if (data) {
+        // Single component arrays already read
+        vtkPointData* pointData = data->GetPointData();
+
+        for (int i = 0; i < pointData->GetNumberOfArrays(); i++) {
+            vtkDataArray* array = pointData->GetArray(i);
+
+            if (!array || !array->GetName() || array->GetNumberOfComponents() != 1) {
+                continue;
+            }
+
+            if (array == pointData->GetScalars()) {
+                field = (int)fieldNames.size();
+            }
+
+            fieldNames.push_back(array->GetName());
+        }
+
+        // Arrays that can be decoded from the file later
+        vtkXMLDataReader* xmlReader = vtkXMLDataReader::SafeDownCast(reader);
+
+        if (xmlReader) {
+            vtkDataArraySelection* selection = xmlReader->GetPointDataArraySelection();
+
+            for (int i = 0; i < selection->GetNumberOfArrays(); i++) {
+                std::string name = selection->GetArrayName(i);
+
+                if (std::find(fieldNames.begin(), fieldNames.end(), name) == fieldNames.end()) {
+                    fieldNames.push_back(name);
+                }
+            }
+        }
+    }
+
+    // Nested grids and unnamed scalars have a single field
+    if (fieldNames.empty()) {
+        fieldNames.push_back("");
+
+        return;
+    }
+
+
+    // Fields derived from each field
+    if (DerivedFields::IsSupported(volume)) {
+        if (!derivedFields) {
+            derivedFields = new DerivedFields(volume);
+            AddMemoryConsumer("Derived fields", derivedFields, 1);
+        }
+
+        std::vector<std::string> derivedNames;
+        for (int i = 0; i < (int)fieldNames.size(); i++) {
+            derivedFields->Define(fieldNames[i], derivedNames);
+        }
+
+        fieldNames.insert(fieldNames.end(), derivedNames.begin(), derivedNames.end());
+    }
+}
+
+bool VTKPipeline::LoadField(const std::string& name, std::string* errorMessage) {
+    vtkDataSet* data = vtkDataSet::SafeDownCast(volume);
+
+    if (!data) {
+        *errorMessage = "Fields can't be switched for nested grids";
+
+        return false;
+    }
+
+    if (data->GetPointData()->GetArray(name.c_str())) {
+        // Already read
+        return true;
+    }
+
+    if (derivedFields && derivedFields->IsDerived(name)) {
+        // Compute from the base field, if not kept from before
+        std::string baseName = derivedFields->GetBaseName(name);
+
+        if (!LoadField(baseName, errorMessage)) {
+            return false;
+        }
+
+        vtkDataArray* array = derivedFields->GetField(name, data->GetPointData()->GetArray(baseName.c_str()));
+
+        if (!array) {
+            *errorMessage = "Could not compute field " + name;
+
+            return false;
+        }
+
+        data->GetPointData()->AddArray(array);
+
+        return true;
+    }
+
+    vtkXMLDataReader* xmlReader = vtkXMLDataReader::SafeDownCast(reader);
+
+    if (!xmlReader) {
+        *errorMessage = "Field " + name + " not found";
+
+        return false;
+    }
+
+
+    // Read just this array with another reader of the same type, rather than enabling it in the 
+    // volume's reader, which would read everything again
+    vtkSmartPointer<vtkXMLDataReader> fieldReader;
+    fieldReader.TakeReference(vtkXMLDataReader::SafeDownCast(xmlReader->NewInstance()));
+    fieldReader->SetFileName(xmlReader->GetFileName());
+    fieldReader->UpdateInformation();
+    fieldReader->GetPointDataArraySelection()->DisableAllArrays();
+    fieldReader->GetPointDataArraySelection()->EnableArray(name.c_str());
+    fieldReader->GetCellDataArraySelection()->DisableAllArrays();
+    fieldReader->Update();
+
+    vtkDataSet* fieldData = fieldReader->GetOutputAsDataSet();
+    vtkDataArray* array = fieldData ? fieldData->GetPointData()->GetArray(name.c_str()) : NULL;
+
+    if (!array || array->GetNumberOfComponents() != 1 || array->GetNumberOfTuples() != data->GetNumberOfPoints()) {
+        *errorMessage = "Could not read field " + name + ".  Fields must have one component per point.";
+
+        return false;
+    }
+
+    data->GetPointData()->AddArray(array);
+
+    return true;
+}
+
+void VTKPipeline::ActivateField(const std::string& name) {
+    vtkDataSet* data = vtkDataSet::SafeDownCast(volume);
+    vtkDataArray* array = data->GetPointData()->GetArray(name.c_str());
+
+    // Derived fields not shown are only kept by the derived field cache, so they can be evicted
+    std::string previousName;
+    if (data->GetPointData()->GetScalars() && data->GetPointData()->GetScalars()->GetName()) {
+        previousName = data->GetPointData()->GetScalars()->GetName();
+    }
+
+    bool removePrevious = derivedFields && derivedFields->IsDerived(previousName) && previousName != name;
+
+    if (derivedFields) {
+        derivedFields->SetFieldInUse(derivedFields->IsDerived(name) ? name : "");
+    }
+
+    data->GetPointData()->SetActiveScalars(name.c_str());
+
+    if (removePrevious) {
+        data->GetPointData()->RemoveArray(previousName.c_str());
+    }
+
+    // Copies share the arrays of the volume
+    for (int i = 0; i < (int)volumeCopies.size(); i++) {
+        vtkDataSet* copy = vtkDataSet::SafeDownCast(volumeCopies[i]->GetOutputDataObject(0));
+
+        if (!copy->GetPointData()->GetArray(name.c_str())) {
+            copy->GetPointData()->AddArray(array);
+        }
+
+        copy->GetPointData()->SetActiveScalars(name.c_str());
+
+        if (removePrevious) {
+            copy->GetPointData()->RemoveArray(previousName.c_str());
+        }
+
+        volumeCopies[i]->Modified();
+    }
+
+
+    // The reader doesn't run again, so have everything fed directly by the volume update
+    shrinker->Modified();
+    rectilinearShrinker->Modified();
+    smoother->Modified();
+
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        isosurfaces[i]->GetIsosurface()->Modified();
+    }
+
+    for (int i = 0; i < 3; i++) {
+        if (slices[i]) {
+            slices[i]->GetSlab()->Modified();
+        }
+    }
+
+    if (obliqueSlice) {
+        obliqueSlice->GetReslice()->Modified();
+    }
+
+    projection->Modified();
+}
+
+
+void VTKPipeline::SetInitialIsovalues(double value1, double value2) {
+    initialIsovalue1 = value1;
+    initialIsovalue2 = value2;
+}
+
+
+void VTKPipeline::CopyCamera(VTKPipeline* other) {
+    vtkCamera* camera = renderer->GetActiveCamera();
+    vtkCamera* otherCamera = other->renderer->GetActiveCamera();
+
+    camera->SetPosition(otherCamera->GetPosition());
+    camera->SetFocalPoint(otherCamera->GetFocalPoint());
+    camera->SetViewUp(otherCamera->GetViewUp());
+    camera->SetViewAngle(otherCamera->GetViewAngle());
+    camera->SetParallelScale(otherCamera->GetParallelScale());
+    camera->SetParallelProjection(otherCamera->GetParallelProjection());
+
+    renderer->ResetCameraClippingRange();
+}
+
+
+void VTKPipeline::SaveScreenshot(const std::string& fileName) {
+    Render();
+    interactor->GetRenderWindow()->Modified();
+
+    vtkSmartPointer<vtkWindowToImageFilter> image = vtkSmartPointer<vtkWindowToImageFilter>::New();
+    image->SetInput(interactor->GetRenderWindow());
+
+    vtkSmartPointer<vtkPNGWriter> writer = vtkSmartPointer<vtkPNGWriter>::New();
+    writer->SetInputConnection(image->GetOutputPort());
+    writer->SetFileName(fileName.c_str());
+    writer->Write();
+}
+
+
+double VTKPipeline::GetIsovalue1() {
+    return isosurfaces[1]->GetIsosurface()->GetValue(0);
+}
+
+double VTKPipeline::GetIsovalue2() {
+    return isosurfaces[3]->GetIsosurface()->GetValue(0);
+}
+
+
+void VTKPipeline::SetIsovalue1(double value, bool doFast) {
+    SetIsovalues(0, 1, value, doFast);
+}
+
+void VTKPipeline::SetIsovalue2(double value, bool doFast) {
+    SetIsovalues(2, 3, value, doFast);
+}
+
+void VTKPipeline::SetIsovalues(int index1, int index2, double value, bool doFast) {
+    if (doFast) {
+        isosurfaces[index1]->SetInput(GetInteractiveVolumePort());
+        isosurfaces[index2]->SetInput(GetInteractiveVolumePort());
+
+/*
+        for (int i = 0; i < 3; i++) {
+            slices[i]->SetInput(GetInteractiveVolumePort());
+        }
+*/
+    }
+    else {       
+        isosurfaces[index1]->SetInput(GetVolumePort());
+        isosurfaces[index2]->SetInput(GetVolumePort());
+
+/*
+        for (int i = 0; i < 3; i++) {
+            slices[i]->SetInput(reader->GetOutputPort());
+        }
+*/
+    }
+
+    isosurfaces[index1]->GetIsosurface()->SetValue(0, -value);
+    isosurfaces[index2]->GetIsosurface()->SetValue(0, value);    
+
+    FeatureLabels* labels = featureLabels[index1 / 2];
+    if (labels) {
+        // Only relabel when interaction is finished, using the surface colors meanwhile
+        if (!doFast) {
+            labels->SetThreshold(value);
+        }
+
+        isosurfaces[index1]->SetFeatureLabels(doFast ? NULL : labels);
+        isosurfaces[index2]->SetFeatureLabels(doFast ? NULL : labels);
+    }
+    
+    if (!doFast) {
+        if (leanMemory) {
+            // The downsampled volume is only used while interacting
+            shrinker->GetOutput()->ReleaseData();
+            rectilinearShrinker->GetOutput()->ReleaseData();
+            previewSmoother->GetOutputDataObject(0)->ReleaseData();
+        }
+    }
+
+    // Clipping only changes the slices' lookup tables, so follow the isovalue while interacting
+    double v1 = GetIsovalue1();
+    double v2 = GetIsovalue2();
+    double clipValue = std::min(v1, v2);
+
+    for (int i = 0; i < 3; i++) {
+        slices[i]->SetClipValue(clipValue);
+    }
+
+    obliqueSlice->SetClipValue(clipValue);
+
+    UpdateRayCastOpacity();
+    UpdateRayCastIsosurfaces();
+}
+
+
+bool VTKPipeline::GetIsovalue1Visible() {
+	return isosurfaces[0]->GetActor()->GetVisibility() == 1;
+}
+
+bool VTKPipeline::GetIsovalue1Translucent() {
+	return (bool)isosurfaces[0]->GetTranslucent();
+}
+
+bool VTKPipeline::GetIsovalue2Visible() {
+	return isosurfaces[2]->GetActor()->GetVisibility() == 1;
+}
+
+bool VTKPipeline::GetIsovalue2Translucent() {
+	return isosurfaces[2]->GetTranslucent();
+}
+
+
+
+void VTKPipeline::SetIsovalue1Visible(bool visible) {
+	isosurfaces[0]->GetActor()->SetVisibility(visible);
+	isosurfaces[1]->GetActor()->SetVisibility(visible);
+
+    UpdateRayCastIsosurfaces();
+}
+
+void VTKPipeline::SetIsovalue1Translucent(bool translucent) {
+	isosurfaces[0]->SetTranslucent(translucent);
+	isosurfaces[1]->SetTranslucent(translucent);
+
+    UpdateRayCastIsosurfaces();
+}
+
+void VTKPipeline::SetIsovalue2Visible(bool visible) {
+	isosurfaces[2]->GetActor()->SetVisibility(visible);
+	isosurfaces[3]->GetActor()->SetVisibility(visible);
+
+    UpdateRayCastIsosurfaces();
+}
+
+void VTKPipeline::SetIsovalue2Translucent(bool translucent) {
+	isosurfaces[2]->SetTranslucent(translucent);
+	isosurfaces[3]->SetTranslucent(translucent);
+
+    UpdateRayCastIsosurfaces();
+}
+
+
+void VTKPipeline::GetBackgroundColor(double rgb[3]) {
+    renderer->GetBackground(rgb);
+}
+
+void VTKPipeline::SetBackgroundColor(double red, double green, double blue) {
+    renderer->SetBackground(red, green, blue);
+}
+
+
+VTKPipeline::ColorMapType VTKPipeline::GetColorMapType() {
+    return colorMapType;
+}
+
+void VTKPipeline::SetColorMapType(ColorMapType type) {
+    colorMapType = type;
+
+    SetColorMap();
+}
+
+
+bool VTKPipeline::GetShowAxes() {
+    return axes->GetVisibility() == 1;
+}
+
+void VTKPipeline::SetShowAxes(bool show) {
+    axes->SetVisibility(show);
+}
+
+
+bool VTKPipeline::GetShowColorLegend() {
+    return colorLegend->GetVisibility() == 1;
+}
+
+void VTKPipeline::SetShowColorLegend(bool show) {
+    colorLegend->SetVisibility(show);
+}
+
+
+bool VTKPipeline::GetShowDataLabel() {
+    return dataLabel->GetVisibility() == 1;
+}
+
+void VTKPipeline::SetShowDataLabel(bool show) {
+    dataLabel->SetVisibility(show);
+}
+
+
+int VTKPipeline::GetNumberOfSlicePositions(int axis) {
+    return (int)sliceCoordinates[axis].size();
+}
+
+int VTKPipeline::GetSlicePosition(int axis) {
+    return GetSlice(axis) ? GetSlice(axis)->GetPosition() : -1;
+}
+
+void VTKPipeline::SetSlicePosition(int axis, int index) {
+    if (!GetSlice(axis) || index < 0 || index >= GetNumberOfSlicePositions(axis)) {
+        return;
+    }
+
+    GetSlice(axis)->SetPosition(index, sliceCoordinates[axis][index]);
+}
+
+
+bool VTKPipeline::GetShowSlicesInside() {
+    return slices[0] && slices[0]->GetShowInside();
+}
+
+void VTKPipeline::SetShowSlicesInside(bool show) {
+    for (int i = 0; i < 3; i++) {
+        if (slices[i]) {
+            slices[i]->SetShowInside(show);
+        }
+    }
+}
+
+
+vtkDataSet* VTKPipeline::GetSliceGrid() {
+    if (!HasVisualization()) {
+        return NULL;
+    }
+
+    vtkAlgorithm* producer = GetVolumePort()->GetProducer();
+    producer->Update();
+
+    return vtkVolumeSlab::GetGrid(producer->GetOutputDataObject(0));
+}
+
+void VTKPipeline::BuildSliceLookupTable(vtkLookupTable* table) {
+    Slice::BuildLookupTable(table, colorMap, std::min(GetIsovalue1(), GetIsovalue2()));
+}
+
+void VTKPipeline::SetSliceFrame(int axis, vtkImageData* frame, int index) {
+    if (!GetSlice(axis)) {
+        return;
+    }
+
+    double coordinate = 0.0;
+    if (index >= 0 && index < GetNumberOfSlicePositions(axis)) {
+        coordinate = sliceCoordinates[axis][index];
+    }
+
+    GetSlice(axis)->SetFrame(frame, coordinate);
+}
+
+
+Slice* VTKPipeline::GetSlice(int axis) {
+    // Slices are ordered XY, XZ, YZ
+    return slices[2 - axis];
+}
+
+
+bool VTKPipeline::GetShowObliqueSlice() {
+    return obliqueSlice && obliqueSlice->GetActor()->GetVisibility();
+}
+
+void VTKPipeline::SetShowObliqueSlice(bool show) {
+    if (!obliqueSlice) {
+        return;
+    }
+
+    obliqueSlice->GetActor()->SetVisibility(show);
+
+    UpdatePlaneWidget();
+}
+
+bool VTKPipeline::SetObliqueSliceThroughPoints(const double p1[3], const double p2[3], const double p3[3]) {
+    if (!obliqueSlice) {
+        return false;
+    }
+
+    double a[3];
+    double b[3];
+    double origin[3];
+    for (int i = 0; i < 3; i++) {
+        a[i] = p2[i] - p1[i];
+        b[i] = p3[i] - p1[i];
+        origin[i] = (p1[i] + p2[i] + p3[i]) / 3.0;
+    }
+
+    double normal[3];
+    vtkMath::Cross(a, b, normal);
+
+    // Relative to the triangle's sides, so the test doesn't depend on units
+    double scale = vtkMath::Norm(a) * vtkMath::Norm(b);
+    if (scale == 0.0 || vtkMath::Norm(normal) < scale * 1e-6) {
+        return false;
+    }
+
+    vtkMath::Normalize(normal);
+
+    planeWidget->SetOrigin(origin);
+    planeWidget->SetNormal(normal);
+
+    obliqueSlice->SetPlane(origin, normal);
+
+    return true;
+}
+
+void VTKPipeline::UpdatePlaneWidget() {
+    // Only one pipeline's widget can be enabled on the shared interactor
+    planeWidget->SetEnabled(active && GetShowObliqueSlice());
+}
+
+
+VTKPipeline::WallType VTKPipeline::GetWallType() {
+    return wallType;
+}
+
+void VTKPipeline::SetWallType(WallType type) {
+    wallType = type;
+
+    // Applied when the visualization is created otherwise
+    if (slices[0]) {
+        UpdateWallProjection();
+    }
+}
+
+void VTKPipeline::UpdateWallProjection() {
+    if (wallType == SliceWalls) {
+        for (int i = 0; i < 3; i++) {
+            slices[i]->SetProjection(NULL, 1.0);
+        }
+
+        return;
+    }
+
+    if (wallType == MaximumProjectionWalls) projection->SetModeToMaximumMagnitude();
+    else if (wallType == MinimumProjectionWalls) projection->SetModeToMinimum();
+    else projection->SetModeToIntegrated();
+
+    projection->Update();
+
+    // Stretch the color map to the range of integrals, which are in different units than the field
+    double scale = 1.0;
+
+    if (wallType == IntegratedProjectionWalls) {
+        double maxIntegral = 0.0;
+
+        for (int axis = 0; axis < 3; axis++) {
+            vtkDataArray* scalars = projection->GetProjectionOutput(axis)->GetPointData()->GetScalars();
+
+            if (scalars) {
+                double* range = scalars->GetRange();
+                maxIntegral = std::max(maxIntegral, std::max(fabs(range[0]), fabs(range[1])));
+            }
+        }
+
+        double maxValue = GetMaximumAbsoluteValue();
+
+        if (maxIntegral > 0.0 && maxValue > 0.0) {
+            scale = maxIntegral / maxValue;
+        }
+    }
+
+    for (int axis = 0; axis < 3; axis++) {
+        GetSlice(axis)->SetProjection(projection->GetOutputPort(axis), scale);
+    }
+}
+
+
+VTKPipeline::DisplayType VTKPipeline::GetDisplayType() {
+    return displayType;
+}
+
+void VTKPipeline::SetDisplayType(DisplayType type) {
+    displayType = type;
+
+    if (displayType == RayCastSurfaceDisplay) {
+        rayCastMapper->SetRenderModeToIsosurfaces();
+    }
+    else {
+        rayCastMapper->SetRenderModeToComposite();
+    }
+
+    UpdateDisplay();
+}
+
+void VTKPipeline::UpdateDisplay() {
+    rayCastVolume->SetVisibility(displayType != SurfaceDisplay);
+
+    // Isosurfaces are only in the renderer once shown as products
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        if (i + 3 < (int)productShown.size() && productShown[i + 3]) {
+            if (displayType == SurfaceDisplay) {
+                renderer->AddViewProp(isosurfaces[i]->GetActor());
+            }
+            else {
+                renderer->RemoveViewProp(isosurfaces[i]->GetActor());
+            }
+        }
+    }
+}
+
+void VTKPipeline::UpdateRayCastOpacity() {
+    if (isosurfaces.empty()) {
+        return;
+    }
+
+    // Transparent between the negative and positive of the smaller isovalue, like the slices, then 
+    // increasingly opaque toward both ends of the range
+    double clipValue = std::min(GetIsovalue1(), GetIsovalue2());
+    double maxValue = GetMaximumAbsoluteValue();
+    double maxOpacity = 0.5;
+
+    rayCastOpacity->RemoveAllPoints();
+
+    if (clipValue >= maxValue) {
+        rayCastOpacity->AddPoint(-maxValue, 0.0);
+        rayCastOpacity->AddPoint(maxValue, 0.0);
+
+        return;
+    }
+
+    rayCastOpacity->AddPoint(-maxValue, maxOpacity);
+    rayCastOpacity->AddPoint(-clipValue, 0.0);
+    rayCastOpacity->AddPoint(clipValue, 0.0);
+    rayCastOpacity->AddPoint(maxValue, maxOpacity);
+}
+
+void VTKPipeline::UpdateRayCastIsosurfaces() {
+    rayCastMapper->RemoveAllIsosurfaces();
+
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        vtkActor* actor = isosurfaces[i]->GetActor();
+
+        if (!actor->GetVisibility()) {
+            continue;
+        }
+
+        double* color = actor->GetProperty()->GetDiffuseColor();
+
+        rayCastMapper->AddIsosurface(isosurfaces[i]->GetIsosurface()->GetValue(0), 
+                                     color[0], color[1], color[2], 
+                                     isosurfaces[i]->GetTranslucent());
+    }
+}
+
+
+double VTKPipeline::GetInteractiveDataMagnification() {
+    return shrinker->GetMagnificationFactors()[0];
+}
+
+void VTKPipeline::SetInteractiveDataMagnification(double magnification) {
+    shrinker->SetMagnificationFactors(magnification, magnification, magnification);
+
+    // Keep every nth sample for rectilinear grids
+    int rate = std::max(1, (int)floor(1.0 / magnification + 0.5));
+    rectilinearShrinker->SetSampleRate(rate, rate, rate);
+
+    ConfigureSmoothing();
+}
+
+
+VTKPipeline::SmoothingType VTKPipeline::GetSmoothingType() {
+    return smoothingType;
+}
+
+double VTKPipeline::GetSmoothingWidth() {
+    return smoothingWidth;
+}
+
+bool VTKPipeline::IsSmoothingSupported() {
+    return volume && !IsNested();
+}
+
+void VTKPipeline::SetSmoothing(SmoothingType type, double width, bool doFast) {
+    if (!IsSmoothingSupported()) {
+        return;
+    }
+
+    smoothingType = type;
+    smoothingWidth = width;
+
+    ConfigureSmoothing();
+
+    if (doFast && type != NoSmoothing) {
+        // Preview on the downsampled volume, using the surface colors meanwhile
+        for (int i = 0; i < (int)isosurfaces.size(); i++) {
+            isosurfaces[i]->SetInput(GetInteractiveVolumePort());
+            isosurfaces[i]->SetFeatureLabels(NULL);
+        }
+
+        return;
+    }
+
+    if (type == NoSmoothing) {
+        smoother->GetOutputDataObject(0)->ReleaseData();
+    }
+    
+    if (leanMemory || type == NoSmoothing) {
+        previewSmoother->GetOutputDataObject(0)->ReleaseData();
+    }
+
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        isosurfaces[i]->SetInput(GetVolumePort());
+    }
+
+    for (int i = 0; i < 3; i++) {
+        slices[i]->SetInput(GetVolumePort());
+    }
+
+    obliqueSlice->SetInput(GetVolumePort());
+
+    projection->SetInputConnection(GetVolumePort());
+    UpdateWallProjection();
+
+    rayCastMapper->SetInputConnection(GetVolumePort());
+
+    // Label lobes of the smoothed field
+    if (featureLabels[0]) {
+        DeleteFeatureLabels();
+        CreateFeatureLabels();
+    }
+}
+
+void VTKPipeline::ConfigureSmoothing() {
+    vtkVolumeSmoothing* smoothers[2] = { smoother, previewSmoother };
+
+    for (int i = 0; i < 2; i++) {
+        smoothers[i]->SetBilateral(smoothingType == BilateralSmoothing);
+        smoothers[i]->SetRangeStandardDeviation(std::max(GetMaximumAbsoluteValue() * 0.1, 1e-30));
+    }
+
+    smoother->SetStandardDeviation(smoothingWidth);
+
+    // The downsampled volume has fewer grid points over the same width
+    double magnification = IsRectilinear() ? 1.0 / rectilinearShrinker->GetSampleRate()[0] : 
+                                             GetInteractiveDataMagnification();
+    previewSmoother->SetStandardDeviation(smoothingWidth * magnification);
+}
+
+
+bool VTKPipeline::OpenProperty(const std::string& fileName, std::string* errorMessage) {
+    if (!HasVisualization()) {
+        *errorMessage = "No volume to color";
+
+        return false;
+    }
+
+    std::string fileInfo;
+    vtkSmartPointer<vtkAlgorithm> propertyReader = ReadVolume(fileName, fileInfo, errorMessage);
+
+    if (!propertyReader) {
+        return false;
+    }
+
+    // Only uniform and rectilinear grids can be sampled directly
+    vtkDataSet* data = vtkDataSet::SafeDownCast(propertyReader->GetOutputDataObject(0));
+
+    if (!data || !(vtkImageData::SafeDownCast(data) || vtkRectilinearGrid::SafeDownCast(data))) {
+        *errorMessage = "Property must be a uniform or rectilinear grid";
+
+        return false;
+    }
+
+    vtkDataArray* scalars = data->GetPointData()->GetScalars();
+
+    if (!scalars || scalars->GetNumberOfComponents() != 1) {
+        *errorMessage = "Property contains no scalar data";
+
+        return false;
+    }
+
+    // Keep only the data, not the reader
+    property.TakeReference(data->NewInstance());
+    property->ShallowCopy(data);
+
+    propertyProducer->SetOutput(property);
+    propertyName = scalars->GetName() ? scalars->GetName() : fileInfo;
+
+    double range[2];
+    scalars->GetRange(range);
+    propertyRange = std::max(fabs(range[0]), fabs(range[1]));
+    if (propertyRange <= 0.0) {
+        propertyRange = 1.0;
+    }
+
+    SetPropertyColorMap();
+
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        isosurfaces[i]->SetProperty(property, propertyColorMap);
+    }
+
+    return true;
+}
+
+void VTKPipeline::ClearProperty() {
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        isosurfaces[i]->SetProperty(NULL, NULL);
+    }
+
+    property = NULL;
+    propertyProducer->SetOutput(NULL);
+    propertyName.clear();
+}
+
+bool VTKPipeline::HasProperty() {
+    return property != NULL;
+}
+
+std::string VTKPipeline::GetPropertyName() {
+    return propertyName;
+}
+
+double VTKPipeline::GetPropertyRange() {
+    return propertyRange;
+}
+
+void VTKPipeline::SetPropertyRange(double range) {
+    if (range <= 0.0 || range == propertyRange) {
+        return;
+    }
+
+    propertyRange = range;
+
+    // Only the colors are mapped again, as the samples are kept
+    SetPropertyColorMap();
+}
+
+void VTKPipeline::SetPropertyColorMap() {
+    propertyColorMap->RemoveAllPoints();
+    propertyColorMap->AddRGBPoint(-propertyRange, 0.0, 0.0, 1.0);
+    propertyColorMap->AddRGBPoint(0.0, 1.0, 1.0, 1.0);
+    propertyColorMap->AddRGBPoint(propertyRange, 1.0, 0.0, 0.0);
+    propertyColorMap->ClampingOn();
+}
+
+
+void VTKPipeline::GetDataRange(double range[2]) {
+    range[0] = dataRange[0];
+    range[1] = dataRange[1];
+}
+
+double VTKPipeline::GetMaximumAbsoluteValue() {
+    return std::max(fabs(dataRange[0]), dataRange[1]);
+}
+
+
+FeatureTracker* VTKPipeline::GetFeatureTracker() {
+    return featureTracker;
+}
+
+void VTKPipeline::SetFeatureTracker(FeatureTracker* tracker) {
+    if (tracker == featureTracker) {
+        return;
+    }
+
+    featureTracker = tracker;
+
+    if (HasVisualization()) {
+        DeleteFeatureLabels();
+
+        if (featureTracker) {
+            CreateFeatureLabels();
+        }
+    }
+}
+
+
+bool VTKPipeline::TrackFeatures() {
+    if (!featureTracker || !featureLabels[0]) {
+        return false;
+    }
+
+    bool changed = false;
+    for (int i = 0; i < 2; i++) {
+        changed = featureTracker->Match(i, featureLabels[i]) || changed;
+    }
+
+    if (changed) {
+        for (int i = 0; i < (int)isosurfaces.size(); i++) {
+            isosurfaces[i]->UpdateFeatureColors();
+        }
+    }
+
+    return changed;
+}
+
+
+void VTKPipeline::CreateFeatureLabels() {
+    if (!FeatureLabels::IsSupported(volume)) {
+        std::cout << "VTKPipeline::CreateFeatureLabels() : Lobe tracking requires a uniform or rectilinear grid" << std::endl;
+        return;
+    }
+
+    // Label the smoothed field if smoothing
+    vtkDataObject* data = volume;
+    if (smoothingType != NoSmoothing && !IsNested()) {
+        smoother->Update();
+        data = smoother->GetOutputDataObject(0);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        featureLabels[i] = new FeatureLabels(data, featureTracker);
+        featureLabels[i]->SetThreshold(i == 0 ? GetIsovalue1() : GetIsovalue2());
+
+        AddMemoryConsumer(i == 0 ? "Isovalue 1 lobe labels" : "Isovalue 2 lobe labels", featureLabels[i], 0);
+    }
+
+    // Isosurfaces 0 and 1 are for isovalue 1, 2 and 3 for isovalue 2
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        isosurfaces[i]->SetFeatureLabels(featureLabels[i / 2]);
+    }
+}
+
+void VTKPipeline::DeleteFeatureLabels() {
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        isosurfaces[i]->SetFeatureLabels(NULL);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        if (featureLabels[i]) {
+            RemoveMemoryConsumer(featureLabels[i]);
+            featureLabels[i] = NULL;
+        }
+    }
+}
+
+
+bool VTKPipeline::GetLeanMemory() {
+    return leanMemory;
+}
+
+void VTKPipeline::SetLeanMemory(bool lean) {
+    leanMemory = lean;
+
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        isosurfaces[i]->SetLeanMemory(lean);
+    }
+
+}
+
+
+void VTKPipeline::AddMemoryConsumer(const std::string& name, const std::vector<vtkAlgorithm*>& algorithms,
+                                    bool evictable, int priority) {
+    AddMemoryConsumer(name, new MemoryBudget::PipelineConsumer(algorithms, evictable), priority);
+
+    // Sample memory whenever one of the algorithms executes, as lean mode releases data 
+    // before the render finishes
+    vtkSmartPointer<vtkCallbackCommand> callback = vtkSmartPointer<vtkCallbackCommand>::New();
+    callback->SetCallback(MemoryCallback);
+    callback->SetClientData(this);
+
+    for (int i = 0; i < (int)algorithms.size(); i++) {
+        algorithms[i]->AddObserver(vtkCommand::EndEvent, callback);
+    }
+}
+
+void VTKPipeline::AddMemoryConsumer(const std::string& name, MemoryBudget::Consumer* consumer, int priority) {
+    MemoryConsumer entry;
+    entry.name = name;
+    entry.consumer = consumer;
+    entry.priority = priority;
+
+    memoryConsumers.push_back(entry);
+
+    if (memoryRegistered) {
+        memoryBudget->AddConsumer(entry.name, entry.consumer, entry.priority);
+    }
+}
+
+void VTKPipeline::RemoveMemoryConsumer(MemoryBudget::Consumer* consumer) {
+    for (int i = 0; i < (int)memoryConsumers.size(); i++) {
+        if (memoryConsumers[i].consumer == consumer) {
+            if (memoryRegistered) {
+                memoryBudget->RemoveConsumer(consumer);
+            }
+
+            delete consumer;
+            memoryConsumers.erase(memoryConsumers.begin() + i);
+
+            return;
+        }
+    }
+}
+
+void VTKPipeline::MemoryCallback(vtkObject* caller, unsigned long eventId, void* clientData, void* callData) {
+    VTKPipeline* pipeline = static_cast<VTKPipeline*>(clientData);
+
+    // Pipelines being loaded or computed on worker threads are not in the budget
+    if (pipeline->memoryRegistered) {
+        pipeline->memoryBudget->Update();
+    }
+}
+
+void VTKPipeline::PlaneWidgetCallback(vtkObject* caller, unsigned long eventId, void* clientData, void* callData) {
+    VTKPipeline* pipeline = static_cast<VTKPipeline*>(clientData);
+
+    double origin[3];
+    double normal[3];
+    pipeline->planeWidget->GetOrigin(origin);
+    pipeline->planeWidget->GetNormal(normal);
+
+    // Sample coarsely while dragging, and at full resolution when released.  The widget renders 
+    // after each event.
+    pipeline->obliqueSlice->SetPlane(origin, normal, eventId == vtkCommand::InteractionEvent);
+}
+
+void VTKPipeline::DepthSortCallback(vtkObject* caller, unsigned long eventId, void* clientData, void* callData) {
+    VTKPipeline* pipeline = static_cast<VTKPipeline*>(clientData);
+
+    // Before rendering, new orders are drawn in this frame.  On timer events, render to show them.
+    if (pipeline->UpdateDepthSort() && eventId == vtkCommand::TimerEvent) {
+        pipeline->Render();
+    }
+}
+
+void VTKPipeline::RenderCallback(vtkObject* caller, unsigned long eventId, void* clientData, void* callData) {
+    static_cast<VTKPipeline*>(clientData)->memoryBudget->Enforce();
+}
+
+
+bool VTKPipeline::IsRectilinear() {
+    return vtkRectilinearGrid::SafeDownCast(volume) != NULL;
+}
+
+bool VTKPipeline::IsNested() {
+    return vtkCompositeDataSet::SafeDownCast(volume) != NULL;
+}
+
+bool VTKPipeline::GetVolumeBounds(double bounds[6]) {
+    vtkDataSet* data = vtkDataSet::SafeDownCast(volume);
+    if (data) {
+        data->GetBounds(bounds);
+
+        return true;
+    }
+
+    std::vector<vtkUniformGrid*> blocks;
+    vtkNestedGridBlanking::GetBlocks(volume, blocks);
+
+    for (int i = 0; i < (int)blocks.size(); i++) {
+        double b[6];
+        blocks[i]->GetBounds(b);
+
+        for (int j = 0; j < 3; j++) {
+            bounds[2 * j] = i == 0 ? b[2 * j] : std::min(bounds[2 * j], b[2 * j]);
+            bounds[2 * j + 1] = i == 0 ? b[2 * j + 1] : std::max(bounds[2 * j + 1], b[2 * j + 1]);
+        }
+    }
+
+    return !blocks.empty();
+}
+
+void VTKPipeline::ComputeDataRange() {
+    vtkDataSet* data = vtkDataSet::SafeDownCast(volume);
+    if (data) {
+        data->GetScalarRange(dataRange);
+
+        return;
+    }
+
+    std::vector<vtkUniformGrid*> blocks;
+    vtkNestedGridBlanking::GetBlocks(volume, blocks);
+
+    for (int i = 0; i < (int)blocks.size(); i++) {
+        double r[2];
+        blocks[i]->GetScalarRange(r);
+
+        dataRange[0] = i == 0 ? r[0] : std::min(dataRange[0], r[0]);
+        dataRange[1] = i == 0 ? r[1] : std::max(dataRange[1], r[1]);
+    }
+}
+
+vtkAlgorithmOutput* VTKPipeline::GetInteractiveVolumePort() {
+    if (IsNested()) {
+        return reader->GetOutputPort();
+    }
+    else if (smoothingType != NoSmoothing) {
+        return previewSmoother->GetOutputPort();
+    }
+    else if (IsRectilinear()) {
+        return rectilinearShrinker->GetOutputPort();
+    }
+
+    return shrinker->GetOutputPort();
+}
+
+vtkAlgorithmOutput* VTKPipeline::GetVolumePort() {
+    if (smoothingType != NoSmoothing && !IsNested()) {
+        return smoother->GetOutputPort();
+    }
+
+    return reader->GetOutputPort();
+}
+
+
+void VTKPipeline::Render() {
+    interactor->Render();
+}
+
+
+bool VTKPipeline::GetDepthPeeling() {
+    return renderer->GetUseDepthPeeling() != 0;
+}
+
+int VTKPipeline::GetMaximumNumberOfPeels() {
+    return renderer->GetMaximumNumberOfPeels();
+}
+
+void VTKPipeline::SetDepthPeeling(bool use, int maxPeels) {
+    renderer->SetUseDepthPeeling(use);
+    renderer->SetMaximumNumberOfPeels(std::max(maxPeels, 1));
+
+    // Peel until no pixels are left, within the budget
+    renderer->SetOcclusionRatio(0.0);
+}
+
+bool VTKPipeline::GetLastRenderUsedDepthPeeling() {
+    return renderer->GetLastRenderingUsedDepthPeeling() != 0;
+}
+
+bool VTKPipeline::GetDepthSorting() {
+    return depthSorting;
+}
+
+void VTKPipeline::SetDepthSorting(bool sort) {
+    depthSorting = sort;
+
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        isosurfaces[i]->SetDepthSortCamera(sort ? renderer->GetActiveCamera() : NULL);
+    }
+
+    UpdateDepthSortTimer();
+}
+
+void VTKPipeline::UpdateDepthSortTimer() {
+    // Only one pipeline polls the shared interactor
+    bool poll = active && depthSorting;
+
+    if (poll && depthSortTimer < 0) {
+        depthSortTimerObserver = interactor->AddObserver(vtkCommand::TimerEvent, depthSortCallback);
+        depthSortTimer = interactor->CreateRepeatingTimer(30);
+    }
+    else if (!poll && depthSortTimer >= 0) {
+        interactor->DestroyTimer(depthSortTimer);
+        interactor->RemoveObserver(depthSortTimerObserver);
+        depthSortTimer = -1;
+    }
+}
+
+bool VTKPipeline::UpdateDepthSort() {
+    // Products being computed on worker threads may be updating the sorts
+    if (!depthSorting || productsPending > 0) {
+        return false;
+    }
+
+    bool changed = false;
+
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        if (isosurfaces[i]->GetTranslucent() && isosurfaces[i]->GetActor()->GetVisibility()) {
+            changed = isosurfaces[i]->GetDepthSort()->UpdateOrder() || changed;
+        }
+    }
+
+    return changed;
+}
+
+void VTKPipeline::BenchmarkTransparency(int numFrames, double* blendedTime, double* peeledTime) {
+    bool usePeeling = GetDepthPeeling();
+
+    // Orbiting only moves the camera position
+    vtkCamera* camera = renderer->GetActiveCamera();
+
+    double position[3];
+    camera->GetPosition(position);
+
+    vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+    double* times[2] = { blendedTime, peeledTime };
+
+    for (int i = 0; i < 2; i++) {
+        renderer->SetUseDepthPeeling(i == 1);
+
+        // Don't time building display lists and compiling shaders
+        Render();
+
+        timer->StartTimer();
+
+        for (int j = 0; j < numFrames; j++) {
+            camera->Azimuth(360.0 / numFrames);
+            Render();
+        }
+
+        timer->StopTimer();
+
+        *times[i] = timer->GetElapsedTime() * 1000.0 / std::max(numFrames, 1);
+
+        std::cout << "VTKPipeline: " << (i == 0 ? "Blended" : "Depth peeled") << " transparency " 
+                  << *times[i] << " ms per frame" 
+                  << (i == 1 && !GetLastRenderUsedDepthPeeling() ? " (depth peeling not supported)" : "") 
+                  << std::endl;
+    }
+
+    renderer->SetUseDepthPeeling(usePeeling);
+    camera->SetPosition(position);
+    renderer->ResetCameraClippingRange();
+    Render();
+}
+
+
+void VTKPipeline::SetUseStereo(bool useStereo) {
+    interactor->GetRenderWindow()->SetStereoRender(useStereo);
+}
+
+
+void VTKPipeline::SetHeadPosition(double x, double y, double z) {
+    renderer->GetActiveCamera()->GetPosition(cameraPosition);
+
+    double scale = 50;
+
+    renderer->GetActiveCamera()->SetPosition(cameraPosition[0] + x * scale,
+                                             cameraPosition[1] + y * scale,
+                                             cameraPosition[2] + z * scale);
+
+    renderer->ResetCameraClippingRange();
+    
+    Render();
+    
+    renderer->GetActiveCamera()->SetPosition(cameraPosition);
+}
+
+void VTKPipeline::FlipEyes() {
+    renderer->GetActiveCamera()->SetEyeAngle(-renderer->GetActiveCamera()->GetEyeAngle());
+}
+
+
+void VTKPipeline::SetColorMap() {
+    switch (colorMapType) {
+        case Color:
+            SetColorMapToColor(colorMap, dataRange);
+            SetIsosurfacesToColor();
+    
+            // Set logo
+            logo->VisibilityOn();
+            bwLogo->VisibilityOff();
+
+            break;
+
+        case Grayscale:
+            SetColorMapToGrayscale(colorMap, dataRange);
+            SetIsosurfacesToGrayscale();
+
+            // Set logo
+            logo->VisibilityOff();
+            bwLogo->VisibilityOn();
+
+            break;
+
+        default:
+            std::cout << "VTKPipeline::SetColorMap() : Unknown color map type, defaulting to Color" << std::endl;
+            colorMapType = Color;
+
+            SetColorMap();
+
+            return;
+    }
+
+    // The ray cast isosurfaces take the isosurface colors
+    UpdateRayCastIsosurfaces();
+
+    // The slices' lookup tables are built from the color map
+    for (int i = 0; i < 3; i++) {
+        if (slices[i]) {
+            slices[i]->UpdateColors();
+        }
+    }
+
+    if (obliqueSlice) {
+        obliqueSlice->UpdateColors();
+    }
+}
+
+void VTKPipeline::BuildColorMap(vtkColorTransferFunction* colorMap, ColorMapType type, 
+                                const double range[2]) {
+    if (type == Grayscale) {
+        SetColorMapToGrayscale(colorMap, range);
+    }
+    else {
+        SetColorMapToColor(colorMap, range);
+    }
+}
+
+void VTKPipeline::SetColorMapToColor(vtkColorTransferFunction* colorMap, const double range[2]) {
+    colorMap->RemoveAllPoints();
+
+    if (range[0] < 0.0 && range[1] > 0.0) {
+        // Positive and negative values
+        double small = std::min(fabs(range[0]), range[1]);
+        double big = std::max(fabs(range[0]), range[1]);
+
+        if (fabs(range[0]) > fabs(range[1])) {
+            // Larger negative values
+            colorMap->AddRGBPoint(-big, 1.0, 1.0, 1.0);
+            colorMap->AddRGBPoint(-small - (big - small) * 0.5, 0.0, 1.0, 1.0);
+            colorMap->AddRGBPoint(-small, 0.0, 0.0, 1.0);
+            colorMap->AddRGBPoint(0.0, 0.75, 0.75, 0.75);
+            colorMap->AddRGBPoint(small, 1.0, 0.0, 0.0);
+        }
+        else {
+            // Larger positive values
+            colorMap->AddRGBPoint(-small, 0.0, 0.0, 1.0);
+            colorMap->AddRGBPoint(0.0, 0.75, 0.75, 0.75);
+            colorMap->AddRGBPoint(small, 1.0, 0.0, 0.0);
+            colorMap->AddRGBPoint(small + (big - small) * 0.5, 1.0, 1.0, 0.0);
+            colorMap->AddRGBPoint(big, 1.0, 1.0, 1.0);
+        }
+    }
+    else {
+        if (range[1] < 0.0) {
+            // Only negative values
+            double big = range[0];
+            colorMap->AddRGBPoint(0.0, 0.75, 0.75, 0.75);
+            colorMap->AddRGBPoint(big / 3.0, 0.0, 0.0, 1.0);
+            colorMap->AddRGBPoint(big * 2.0 / 3.0, 0.0, 1.0, 1.0);
+            colorMap->AddRGBPoint(big, 1.0, 1.0, 1.0);
+        }
+        else {
+            // Only positive values
+            double big = range[1];           
+            colorMap->AddRGBPoint(0.0, 0.75, 0.75, 0.75);
+            colorMap->AddRGBPoint(big / 3.0, 1.0, 0.0, 0.0);
+            colorMap->AddRGBPoint(big * 2.0 / 3.0, 1.0, 1.0, 0.0);
+            colorMap->AddRGBPoint(big, 1.0, 1.0, 1.0);
+        }
+    }
+}
+
+void VTKPipeline::SetColorMapToGrayscale(vtkColorTransferFunction* colorMap, const double range[2]) {
+    colorMap->RemoveAllPoints();
+
+    if (range[0] < 0.0 && range[1] > 0.0) {
+        // Positive and negative values
+        double small = std::min(fabs(range[0]), range[1]);
+        double big = std::max(fabs(range[0]), range[1]);
+
+        if (fabs(range[0]) > fabs(range[1])) {
+            // Larger negative values
+            double smallValue = 0.5 + 0.5 * small / big;
+            colorMap->AddRGBPoint(-big, 0.0, 0.0, 0.0);
+            colorMap->AddRGBPoint(0.0, 0.5, 0.5, 0.5);
+            colorMap->AddRGBPoint(small, smallValue, smallValue, smallValue);
+        }
+        else {
+            // Larger positive values
+            double smallValue = 0.5 - 0.5 * small / big;
+            colorMap->AddRGBPoint(-small, smallValue, smallValue, smallValue);
+            colorMap->AddRGBPoint(0.0, 0.5, 0.5, 0.5);
+            colorMap->AddRGBPoint(big, 1.0, 1.0, 1.0);
+        }
+    }
+    else {
+        if (range[1] < 0.0) {
+            // Only negative values
+            double big = range[0];
+            colorMap->AddRGBPoint(0.0, 0.5, 0.5, 0.5);
+            colorMap->AddRGBPoint(big, 0.0, 0.0, 0.0);
+        }
+        else {
+            // Only positive values
+            double big = range[1];           
+            colorMap->AddRGBPoint(0.0, 0.5, 0.5, 0.5);
+            colorMap->AddRGBPoint(big, 1.0, 1.0, 1.0);
+        }
+    }
+}
+
+
+void VTKPipeline::SetIsosurfacesToColor() {
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        vtkProperty* p = isosurfaces[i]->GetActor()->GetProperty();
+        if (isosurfaces[i]->GetIsosurface()->GetValue(0) < 0.0) { 
+            p->SetAmbientColor(0.0, 0.0, 1.0);
+            p->SetDiffuseColor(0.0, 0.0, 1.0);
+        }
+        else {            
+            p->SetAmbientColor(1.0, 0.0, 0.0);
+            p->SetDiffuseColor(1.0, 0.0, 0.0);
+        }
+    }
+}
+
+void VTKPipeline::SetIsosurfacesToGrayscale() {
+    for (int i = 0; i < (int)isosurfaces.size(); i++) {
+        vtkProperty* p = isosurfaces[i]->GetActor()->GetProperty();
+        if (isosurfaces[i]->GetIsosurface()->GetValue(0) < 0.0) { 
+            p->SetAmbientColor(0.25, 0.25, 0.25);
+            p->SetDiffuseColor(0.25, 0.25, 0.25);
+        }
+        else {            
+            p->SetAmbientColor(0.75, 0.75, 0.75);
+            p->SetDiffuseColor(0.75, 0.75, 0.75);
+        }
+    }
 }
\ No newline at end of file
@@ -1,178 +1,575 @@
-/*=========================================================================
-
-  Name:        VTKPipeline.h
-
-  Author:      David Borland, The Renaissance Computing Institute (RENCI)
-
-  Copyright:   The Renaissance Computing Institute (RENCI)
-
-  Description: Container class for all Voluminous VTK code.
-
-=========================================================================*/
-
-
-#ifndef VTKPIPELINE_H
-#define VTKPIPELINE_H
-
-#include <string>
-#include <vector>
-
-#include <vtkSmartPointer.h>
-
-
-class vtkAlgorithm;
-class vtkColorTransferFunction;
-class vtkCubeAxesActor;
-class vtkImageActor;
-class vtkImageData;
-class vtkImageResize;
-class vtkRenderWindowInteractor;
-class vtkRenderer;
-class vtkScalarBarActor;
-class vtkTextActor;
-class vtkXMLMaterial;
-
-class Isosurface;
-class Slice;
-
-
-class vtkRenderWindow;
-
-
-class VTKPipeline {
-public:	
-    VTKPipeline(vtkRenderWindowInteractor* rwi,
-                vtkImageData* logoImage, vtkImageData* bwLogoImage,
-                const std::string& opaqueMaterial, const std::string& translucentMaterial);
-    ~VTKPipeline();
-
-    // Load data.
-    // This was split into two functions so that OpenVolume could be called via a Qt thread in order to be able
-    // to show a file progress dialog.  For OpenVolume, errorMessage must be passed as a pointer to work
-    // with QtConcurrent::run().
-    bool OpenVolume(const std::string& fileName, std::string* errorMessage);
-    bool CreateVisualization(std::string& errorMessage);
-
-    // Save a screenshot
-    void SaveScreenshot(const std::string& fileName);
-    
-    // Get/set isosurface values
-    double GetIsovalue1();
-    double GetIsovalue2();
-    void SetIsovalue1(double value, bool doFast = false);
-    void SetIsovalue2(double value, bool doFase = false);
-
-	// Get/set isosurface opacities
-/*
-	double GetIsovalue1Opacity();
-	double GetIsovalue2Opacity();
-	void SetIsovalue1Opacity(double opacity);
-	void SetIsovalue2Opacity(double opacity);
-*/
-
-	// Get/set isosurface visibility
-	bool GetIsovalue1Visible();
-	bool GetIsovalue1Translucent();
-	bool GetIsovalue2Visible();
-	bool GetIsovalue2Translucent();
-	void SetIsovalue1Visible(bool visible);
-	void SetIsovalue1Translucent(bool translucent);
-	void SetIsovalue2Visible(bool visible);
-	void SetIsovalue2Translucent(bool translucent);
-
-    // Get/set the background color
-    void GetBackgroundColor(double rgb[3]);
-    void SetBackgroundColor(double r, double g, double b);
-
-    // Get/set the color map type
-    enum ColorMapType {
-        Color,
-        Grayscale
-    };
-    ColorMapType GetColorMapType();
-    void SetColorMapType(ColorMapType);
-
-    // Get/set axes visibility
-    bool GetShowAxes();
-    void SetShowAxes(bool show);
-
-    // Get/set color legend visibility
-    bool GetShowColorLegend();
-    void SetShowColorLegend(bool show);
-
-    // Get/set data label visibility
-    bool GetShowDataLabel();
-    void SetShowDataLabel(bool show);
-
-    // Get/set interactive data magnification
-    double GetInteractiveDataMagnification();
-    void SetInteractiveDataMagnification(double magnification);
-
-    // Get data range
-    void GetDataRange(double range[2]);
-
-    // Get the maximum absolute value of data in the volume
-    double GetMaximumAbsoluteValue();
-
-    // Force a render
-    void Render();
-
-    // Stereo
-    void SetUseStereo(bool useStereo);
-    void FlipEyes();
-
-    // Head tracking
-    void SetHeadPosition(double x, double y, double z);
-
-protected:
-    // Rendering
-    vtkSmartPointer<vtkRenderWindowInteractor> interactor;
-    vtkSmartPointer<vtkRenderer> renderer;
-    vtkSmartPointer<vtkRenderer> logoRenderer;
-
-    // The volume
-    vtkSmartPointer<vtkAlgorithm> reader;
-    vtkSmartPointer<vtkImageData> volume;
-
-    // Use a downsampled volume when adjusting the isosurface value
-    vtkSmartPointer<vtkImageResize> shrinker;
-
-    // Visualization objects
-    vtkSmartPointer<vtkCubeAxesActor> axes;
-    vtkSmartPointer<vtkScalarBarActor> colorLegend;
-    vtkSmartPointer<vtkTextActor> dataLabel;
-    vtkSmartPointer<vtkImageActor> logo;
-    vtkSmartPointer<vtkImageActor> bwLogo;
-
-    std::vector<Isosurface*> isosurfaces;
-    Slice* slices[3];
-    vtkSmartPointer<vtkColorTransferFunction> colorMap;
-
-    // Shader strings
-    std::string opaqueMaterial;
-    std::string translucentMaterial;
-
-    // The range of data values in the volume
-    double dataRange[2];
-
-    // The color map type
-    ColorMapType colorMapType;
-
-    // Helper function for setting isovalues
-    void SetIsovalues(int index1, int index2, double value, bool doFast);
-
-    // Set the color map
-    void SetColorMap();
-
-    void SetColorMapToColor();
-    void SetColorMapToGrayscale();
-
-    void SetIsosurfacesToColor();
-    void SetIsosurfacesToGrayscale();
-
-    // For head tracking
-    double cameraPosition[3];
-};
-
-
+/*=========================================================================
+
+  Name:        VTKPipeline.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Container class for all Voluminous VTK code.
+
+=========================================================================*/
+
+
+#ifndef VTKPIPELINE_H
+#define VTKPIPELINE_H
+
+#include <string>
+#include <vector>
+
+#include <vtkSmartPointer.h>
+
+#include "MemoryBudget.h"
+
+
+class vtkAlgorithm;
+class vtkBrickRayCastMapper;
+class vtkCallbackCommand;
+class vtkColorTransferFunction;
+class vtkAlgorithmOutput;
+class vtkObject;
+class vtkCubeAxesActor;
+class vtkDataObject;
+class vtkDataSet;
+class vtkExtractRectilinearGrid;
+class vtkImageActor;
+class vtkImageData;
+class vtkImageResize;
+class vtkImplicitPlaneWidget;
+class vtkLookupTable;
+class vtkPiecewiseFunction;
+class vtkRenderWindowInteractor;
+class vtkRenderer;
+class vtkScalarBarActor;
+class vtkTextActor;
+class vtkTrivialProducer;
+class vtkVolume;
+class vtkVolumeProjection;
+class vtkVolumeSmoothing;
+class vtkXMLMaterial;
+
+class DerivedFields;
+class FeatureLabels;
+class FeatureTracker;
+class Isosurface;
+class ObliqueSlice;
+class Slice;
+
+
+class vtkRenderWindow;
+
+
+class VTKPipeline {
+public:	
+    VTKPipeline(vtkRenderWindowInteractor* rwi,
+                vtkImageData* logoImage, vtkImageData* bwLogoImage,
+                const std::string& opaqueMaterial, const std::string& translucentMaterial,
+                MemoryBudget* memoryBudget);
+    ~VTKPipeline();
+
+    // Load data.
+    // This was split into two functions so that OpenVolume could be called via a Qt thread in order to be able
+    // to show a file progress dialog.  For OpenVolume, errorMessage must be passed as a pointer to work
+    // with QtConcurrent::run().
+    bool OpenVolume(const std::string& fileName, std::string* errorMessage);
+    bool CreateVisualization(std::string& errorMessage);
+
+    // Open the difference of two volumes, (A - B) * scale, in place of a single volume.  Both are
+    // read at once and the difference computed in parallel.  If the grids differ, B is resampled 
+    // onto the grid of A.  Only the difference is kept.
+    bool OpenVolume(const std::string& fileNameA, const std::string& fileNameB, double scale, 
+                    std::string* errorMessage);
+
+    // Open a grid evaluated from a molden or formatted checkpoint wavefunction file: an orbital, or 
+    // the electron density if orbital is -1, with the given spacing in bohr.  If refinement is 
+    // greater than 1, the region around the atoms is evaluated on a nested grid with spacing / 
+    // refinement.
+    bool OpenWavefunction(const std::string& fileName, int orbital, double spacing, int refinement,
+                          std::string* errorMessage);
+
+    // Open the volume and create the visualization in one call, for building an inactive pipeline
+    // on a worker thread while another pipeline is shown.  Nothing is rendered.
+    bool LoadVolume(const std::string& fileName, std::string* errorMessage);
+    bool LoadDifference(const std::string& fileNameA, const std::string& fileNameB, double scale,
+                        std::string* errorMessage);
+    bool LoadWavefunction(const std::string& fileName, int orbital, double spacing, int refinement,
+                          std::string* errorMessage);
+
+    // Read a volume file, returning the updated reader, or NULL on failure.  fileInfo is set to a 
+    // description of the data for labeling.  Thread safe.
+    static vtkSmartPointer<vtkAlgorithm> ReadVolume(const std::string& fileName, std::string& fileInfo,
+                                                    std::string* errorMessage);
+
+    // Load the volume and compute all products, for prefetching into an inactive pipeline on a 
+    // worker thread
+    bool PrepareVolume(const std::string& fileName, std::string* errorMessage);
+
+    // Compute all products, e.g. after changing the isovalues of an inactive pipeline.  Can be 
+    // called from a worker thread for an inactive pipeline.
+    void UpdateProducts();
+
+    // Create a new, empty pipeline with the same rendering and memory settings
+    VTKPipeline* CreateEmptyCopy();
+
+    // Set isovalues to use instead of the defaults when creating the visualization.  Ignored if 
+    // outside of the data range.
+    void SetInitialIsovalues(double value1, double value2);
+
+    // Point data fields of the volume.  Only the field shown first is decoded when loading, and 
+    // others are decoded from the file when first selected, sharing the grid of the volume.  Fields 
+    // derived from each of these (square, gradient magnitude, Laplacian, and reduced density 
+    // gradient) follow, and are computed when first selected.
+    int GetNumberOfFields();
+    std::string GetFieldName(int index);
+    int GetField();
+
+    // Switch the field driving the isosurfaces and slices without reloading, resetting the 
+    // isovalues for its range.  Recomputed on the next render.  Products must not be pending.
+    bool SetField(int index, std::string* errorMessage);
+
+    // Set a field to show instead of the first when creating the visualization, if present
+    void SetInitialField(const std::string& name);
+
+    // Copy the camera of another pipeline
+    void CopyCamera(VTKPipeline* other);
+
+    // Has a visualization been created?
+    bool HasVisualization();
+
+    // Get/set whether this pipeline is shown in the render window and accounted in the memory budget.
+    // Pipelines start inactive.  Inactive pipelines keep all of their data, so they can be cached 
+    // and shown again later.
+    bool GetActive();
+    void SetActive(bool active);
+
+    // Get the memory held by all stages, in kilobytes
+    unsigned long GetMemorySize();
+
+    // The slices and isosurfaces are products computed after the first image of the outline and 
+    // axes is shown.  Products 0 to GetNumberOfSliceProducts() - 1 are slices, the rest isosurfaces.
+    // UpdateProduct() computes a product, and can be called for different products concurrently 
+    // from worker threads.  FinishProduct() must then be called from the GUI thread, and adds 
+    // the product to the renderer, holding back isosurfaces until all slices are shown.  
+    // Isovalues should not be changed until no products are pending.
+    int GetNumberOfProducts();
+    int GetNumberOfSliceProducts();
+    void UpdateProduct(int index);
+    void FinishProduct(int index);
+    int GetProductsPending();
+
+    // Save a screenshot
+    void SaveScreenshot(const std::string& fileName);
+    
+    // Get/set isosurface values
+    double GetIsovalue1();
+    double GetIsovalue2();
+    void SetIsovalue1(double value, bool doFast = false);
+    void SetIsovalue2(double value, bool doFase = false);
+
+	// Get/set isosurface opacities
+/*
+	double GetIsovalue1Opacity();
+	double GetIsovalue2Opacity();
+	void SetIsovalue1Opacity(double opacity);
+	void SetIsovalue2Opacity(double opacity);
+*/
+
+	// Get/set isosurface visibility
+	bool GetIsovalue1Visible();
+	bool GetIsovalue1Translucent();
+	bool GetIsovalue2Visible();
+	bool GetIsovalue2Translucent();
+	void SetIsovalue1Visible(bool visible);
+	void SetIsovalue1Translucent(bool translucent);
+	void SetIsovalue2Visible(bool visible);
+	void SetIsovalue2Translucent(bool translucent);
+
+    // Get/set the background color
+    void GetBackgroundColor(double rgb[3]);
+    void SetBackgroundColor(double r, double g, double b);
+
+    // Get/set the color map type
+    enum ColorMapType {
+        Color,
+        Grayscale
+    };
+    ColorMapType GetColorMapType();
+    void SetColorMapType(ColorMapType);
+
+    // Build the color map used for the slices, for a range of data values, e.g. to color slices 
+    // exported elsewhere the same way
+    static void BuildColorMap(vtkColorTransferFunction* colorMap, ColorMapType type, 
+                              const double range[2]);
+
+    // Get/set how the volume is displayed: as isosurfaces, or by direct volume rendering, ray cast 
+    // on the CPU so no graphics hardware is needed.  Volume rendering uses the color map, and is 
+    // transparent between the negative and positive of the smaller isovalue, like the slices, and 
+    // increasingly opaque toward both ends of the range.  The isosurfaces are hidden meanwhile.
+    // Isosurfaces can also be ray cast from the volume, with the colors, visibility, and 
+    // translucency of the isosurfaces, so no meshes are built and changing an isovalue costs a 
+    // single frame.
+    enum DisplayType {
+        SurfaceDisplay,
+        VolumeDisplay,
+        RayCastSurfaceDisplay
+    };
+    DisplayType GetDisplayType();
+    void SetDisplayType(DisplayType type);
+
+    // Get/set axes visibility
+    bool GetShowAxes();
+    void SetShowAxes(bool show);
+
+    // Get/set depth peeling of translucent isosurfaces, so nested surfaces blend in depth order 
+    // rather than in the order their triangles are drawn.  At most maxPeels layers are peeled per 
+    // frame, and the rest are blended unsorted.  The render window needs alpha bit planes and no 
+    // multisampling, and rendering falls back to blending if depth peeling is not supported.
+    bool GetDepthPeeling();
+    int GetMaximumNumberOfPeels();
+    void SetDepthPeeling(bool use, int maxPeels);
+    bool GetLastRenderUsedDepthPeeling();
+
+    // Get/set sorting of the triangles of translucent isosurfaces back to front, as an alternative 
+    // to depth peeling.  When the camera moves, the triangles are sorted for the new view on a 
+    // background thread, starting from the last order, and the order is shown when ready, at most 
+    // a frame behind.
+    bool GetDepthSorting();
+    void SetDepthSorting(bool sort);
+
+    // Time rendering with translucent isosurfaces blended and depth peeled, in milliseconds per 
+    // frame, over numFrames frames orbiting the volume.  The camera and settings are restored.
+    void BenchmarkTransparency(int numFrames, double* blendedTime, double* peeledTime);
+
+    // Get/set color legend visibility
+    bool GetShowColorLegend();
+    void SetShowColorLegend(bool show);
+
+    // Get/set data label visibility
+    bool GetShowDataLabel();
+    void SetShowDataLabel(bool show);
+
+    // Get/set the positions of the slices normal to each axis (0 for x, 1 for y, 2 for z), as 
+    // indices of grid planes.  Slices start in the middle.  Moving a slice only copies planes of 
+    // the volume, a few ahead at a time, so slices can follow a slider.
+    int GetNumberOfSlicePositions(int axis);
+    int GetSlicePosition(int axis);
+    void SetSlicePosition(int axis, int index);
+
+    // Get/set whether slices are shown at their positions inside the volume, rather than on the 
+    // walls
+    bool GetShowSlicesInside();
+    void SetShowSlicesInside(bool show);
+
+    // For coloring slices elsewhere, e.g. cine frames: get the updated grid the slices are copied 
+    // from, and build a lookup table coloring and clipping like the slices
+    vtkDataSet* GetSliceGrid();
+    void BuildSliceLookupTable(vtkLookupTable* table);
+
+    // Show a colored frame of the slice normal to an axis at a grid plane index, inside the volume 
+    // in place of the slice, or NULL to show the slice again
+    void SetSliceFrame(int axis, vtkImageData* frame, int index);
+
+    // Get/set whether the oblique slice is shown, with a plane widget to move it.  While the widget 
+    // is dragged the plane is sampled coarsely, and at full resolution when it is released.  The 
+    // slice starts through the center of the volume, normal to z.
+    bool GetShowObliqueSlice();
+    void SetShowObliqueSlice(bool show);
+
+    // Place the oblique slice through three points, e.g. the centers of three atoms.  Returns false
+    // if the points are on a line.
+    bool SetObliqueSliceThroughPoints(const double p1[3], const double p2[3], const double p3[3]);
+
+    // Get/set what the walls show: the slices, or projections of the volume along each axis.  The
+    // maximum magnitude projection shows the signed value of largest magnitude along each line, 
+    // and the integrated projection the integral of the value along each line, colored with the 
+    // color map stretched to its range.  All projections of a field are computed in one pass and 
+    // kept for the last few fields.
+    enum WallType {
+        SliceWalls,
+        MaximumProjectionWalls,
+        MinimumProjectionWalls,
+        IntegratedProjectionWalls
+    };
+    WallType GetWallType();
+    void SetWallType(WallType type);
+
+    // Get/set interactive data magnification
+    double GetInteractiveDataMagnification();
+    void SetInteractiveDataMagnification(double magnification);
+
+    // Get/set smoothing of the field before contouring and slicing, e.g. to remove speckles from 
+    // noisy difference fields.  The width is the standard deviation in grid points.  Bilateral 
+    // smoothing keeps sharp features, with a range width of a tenth of the maximum absolute value.  
+    // When doFast is true, only the downsampled volume is smoothed, to preview the isosurfaces.  
+    // The full resolution result is kept until the smoothing or field changes.  Not supported for 
+    // nested grids.
+    enum SmoothingType {
+        NoSmoothing,
+        GaussianSmoothing,
+        BilateralSmoothing
+    };
+    SmoothingType GetSmoothingType();
+    double GetSmoothingWidth();
+    void SetSmoothing(SmoothingType type, double width, bool doFast = false);
+    bool IsSmoothingSupported();
+
+    // Color the isosurfaces by a property read from a second volume file, e.g. the electrostatic 
+    // potential on density isosurfaces.  The property must be a uniform or rectilinear grid, and is
+    // sampled at the surface points, so need not share the grid of the volume.  Colors are from 
+    // blue (negative) through white to red (positive), over [-range, range], defaulting to the 
+    // maximum absolute value of the property.  Requires a visualization.
+    bool OpenProperty(const std::string& fileName, std::string* errorMessage);
+    void ClearProperty();
+    bool HasProperty();
+    std::string GetPropertyName();
+    double GetPropertyRange();
+    void SetPropertyRange(double range);
+
+    // Get data range
+    void GetDataRange(double range[2]);
+
+    // Get the maximum absolute value of data in the volume
+    double GetMaximumAbsoluteValue();
+
+    // Get/set the tracker used to color lobes by track, or NULL to use the surface colors.  Only 
+    // uniform and rectilinear grids are supported.
+    FeatureTracker* GetFeatureTracker();
+    void SetFeatureTracker(FeatureTracker* tracker);
+
+    // Match lobes to those last shown, so they keep their tracks.  Call when the pipeline is shown
+    // and after isovalue changes.  Returns true if tracks changed and a render is needed.
+    bool TrackFeatures();
+
+    // Get/set lean memory mode, which releases intermediate filter outputs that are not needed 
+    // for rendering, at the cost of recomputing them when their inputs change
+    bool GetLeanMemory();
+    void SetLeanMemory(bool lean);
+
+    // Force a render
+    void Render();
+
+    // Stereo
+    void SetUseStereo(bool useStereo);
+    void FlipEyes();
+
+    // Head tracking
+    void SetHeadPosition(double x, double y, double z);
+
+protected:
+    // Rendering
+    vtkSmartPointer<vtkRenderWindowInteractor> interactor;
+    vtkSmartPointer<vtkRenderer> renderer;
+    vtkSmartPointer<vtkRenderer> logoRenderer;
+
+    // The volume.  Either vtkImageData (uniform spacing), vtkRectilinearGrid (per-axis coordinates),
+    // or a vtkMultiBlockDataSet of nested uniform grids.
+    vtkSmartPointer<vtkAlgorithm> reader;
+    vtkSmartPointer<vtkDataObject> volume;
+
+    // Use a downsampled volume when adjusting the isosurface value
+    vtkSmartPointer<vtkImageResize> shrinker;
+    vtkSmartPointer<vtkExtractRectilinearGrid> rectilinearShrinker;
+
+    // Is the volume a rectilinear grid?
+    bool IsRectilinear();
+
+    // Is the volume a nested multi-block grid?
+    bool IsNested();
+
+    // Get the bounds and scalar range over all blocks of the volume
+    bool GetVolumeBounds(double bounds[6]);
+    void ComputeDataRange();
+
+    // Return the downsampled volume appropriate for the volume type, smoothed if smoothing
+    vtkAlgorithmOutput* GetInteractiveVolumePort();
+
+    // Smoothed full resolution and downsampled volumes
+    vtkSmartPointer<vtkVolumeSmoothing> smoother;
+    vtkSmartPointer<vtkVolumeSmoothing> previewSmoother;
+
+    SmoothingType smoothingType;
+    double smoothingWidth;
+
+    // Set the smoothers' parameters for the current settings and field
+    void ConfigureSmoothing();
+
+    // Return the full resolution volume, smoothed if smoothing
+    vtkAlgorithmOutput* GetVolumePort();
+
+    // Property colors for the isosurfaces, held by a producer for memory accounting
+    vtkSmartPointer<vtkDataSet> property;
+    vtkSmartPointer<vtkTrivialProducer> propertyProducer;
+    vtkSmartPointer<vtkColorTransferFunction> propertyColorMap;
+    std::string propertyName;
+    double propertyRange;
+
+    // Set the property color map for the property range
+    void SetPropertyColorMap();
+
+    // Products being computed
+    std::vector<bool> productFinished;
+    std::vector<bool> productShown;
+    int productsPending;
+
+    void ShowProduct(int index);
+
+    // Producers of shallow copies of the volume, one per product
+    std::vector<vtkSmartPointer<vtkAlgorithm> > volumeCopies;
+
+    vtkAlgorithmOutput* CreateVolumeCopy();
+
+    // Visualization objects
+    vtkSmartPointer<vtkCubeAxesActor> axes;
+    vtkSmartPointer<vtkScalarBarActor> colorLegend;
+    vtkSmartPointer<vtkTextActor> dataLabel;
+    vtkSmartPointer<vtkImageActor> logo;
+    vtkSmartPointer<vtkImageActor> bwLogo;
+
+    std::vector<Isosurface*> isosurfaces;
+    Slice* slices[3];
+
+    // Coordinates of the grid planes along each axis, for positioning slices
+    std::vector<double> sliceCoordinates[3];
+
+    // Get the slice normal to an axis
+    Slice* GetSlice(int axis);
+
+    // Slice at an arbitrary orientation, placed with a plane widget enabled while active and shown
+    ObliqueSlice* obliqueSlice;
+    vtkSmartPointer<vtkImplicitPlaneWidget> planeWidget;
+    vtkSmartPointer<vtkCallbackCommand> planeCallback;
+
+    void UpdatePlaneWidget();
+
+    // Projections of the volume for the walls
+    vtkSmartPointer<vtkVolumeProjection> projection;
+    WallType wallType;
+
+    // Show the projection for the wall type on the walls, computing it if needed
+    void UpdateWallProjection();
+    vtkSmartPointer<vtkColorTransferFunction> colorMap;
+
+    // Volume rendering, not a product, as it is ray cast when rendered
+    vtkSmartPointer<vtkBrickRayCastMapper> rayCastMapper;
+    vtkSmartPointer<vtkVolume> rayCastVolume;
+    vtkSmartPointer<vtkPiecewiseFunction> rayCastOpacity;
+    DisplayType displayType;
+
+    // Show the isosurfaces or the volume rendering for the display type
+    void UpdateDisplay();
+
+    // Set the volume rendering opacity for the data range and isovalues
+    void UpdateRayCastOpacity();
+
+    // Set the isosurfaces ray cast to the visible isosurfaces
+    void UpdateRayCastIsosurfaces();
+
+    // Shader strings
+    std::string opaqueMaterial;
+    std::string translucentMaterial;
+
+    // The range of data values in the volume
+    double dataRange[2];
+
+    // The color map type
+    ColorMapType colorMapType;
+
+    // Isovalues to start with, or negative for defaults
+    double initialIsovalue1;
+    double initialIsovalue2;
+
+    // Names of the fields, the field shown, and the field to show first
+    std::vector<std::string> fieldNames;
+    int field;
+    std::string initialField;
+
+    // Derived fields computed so far
+    DerivedFields* derivedFields;
+
+    // Find the fields of the volume
+    void FindFields();
+
+    // Decode a field not read yet into the volume
+    bool LoadField(const std::string& name, std::string* errorMessage);
+
+    // Make a field the active scalars of the volume and its copies
+    void ActivateField(const std::string& name);
+
+    // Helper function for setting isovalues
+    void SetIsovalues(int index1, int index2, double value, bool doFast);
+
+    // Lobe tracking, with labels for each isovalue
+    FeatureTracker* featureTracker;
+    FeatureLabels* featureLabels[2];
+
+    void CreateFeatureLabels();
+    void DeleteFeatureLabels();
+
+    // Set the color map
+    void SetColorMap();
+
+    static void SetColorMapToColor(vtkColorTransferFunction* colorMap, const double range[2]);
+    static void SetColorMapToGrayscale(vtkColorTransferFunction* colorMap, const double range[2]);
+
+    void SetIsosurfacesToColor();
+    void SetIsosurfacesToGrayscale();
+
+    // For head tracking
+    double cameraPosition[3];
+
+    // Memory accounting, shared with other subsystems
+    MemoryBudget* memoryBudget;
+
+    struct MemoryConsumer {
+        std::string name;
+        MemoryBudget::Consumer* consumer;
+        int priority;
+    };
+    std::vector<MemoryConsumer> memoryConsumers;
+
+    vtkSmartPointer<vtkCallbackCommand> renderCallback;
+    unsigned long renderObserver;
+
+    bool active;
+    bool memoryRegistered;
+
+    // Add or remove consumers from the budget depending on whether active and products are pending
+    void UpdateMemoryRegistration();
+
+    bool leanMemory;
+
+    // Register the outputs of the given algorithms with the memory budget as one consumer
+    void AddMemoryConsumer(const std::string& name, const std::vector<vtkAlgorithm*>& algorithms,
+                           bool evictable, int priority);
+
+    // Register another consumer with the memory budget.  The pipeline takes ownership.
+    void AddMemoryConsumer(const std::string& name, MemoryBudget::Consumer* consumer, int priority);
+    void RemoveMemoryConsumer(MemoryBudget::Consumer* consumer);
+
+    // Called when a tracked algorithm finishes executing, to catch peaks
+    static void MemoryCallback(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+    // Called when the plane widget moves or is released, to resample the oblique slice
+    static void PlaneWidgetCallback(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+    // Triangle sorting of translucent isosurfaces, updated before each render and polled by a 
+    // timer on the interactor while active, to show orders finished after the camera stops
+    bool depthSorting;
+    vtkSmartPointer<vtkCallbackCommand> depthSortCallback;
+    unsigned long depthSortTimerObserver;
+    int depthSortTimer;
+
+    void UpdateDepthSortTimer();
+
+    // Install finished orders and sort for the current view.  Returns true if an order changed.
+    bool UpdateDepthSort();
+
+    // Called before rendering and on timer events, to keep sorting up to date
+    static void DepthSortCallback(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+    // Called after rendering, when evicted data is no longer needed until the next update
+    static void RenderCallback(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+};
+
+
 #endif
\ No newline at end of file
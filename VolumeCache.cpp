@@ -0,0 +1,144 @@
+/*=========================================================================
+
+  Name:        VolumeCache.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Keeps recently loaded volumes, along with their isosurfaces,
+               slices, and other derived data, so that switching back to a
+               previously opened file is instant.  Entries are keyed by
+               path, file size, and modification time, so a file changed
+               on disk is loaded again.  The least recently used entries
+               are dropped when over the entry limit or the memory budget.
+
+=========================================================================*/
+
+
+#include "VolumeCache.h"
+
+#include "VTKPipeline.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <sstream>
+
+
+bool VolumeCache::Key::operator==(const Key& other) const {
+    return path == other.path && size == other.size && modifiedTime == other.modifiedTime &&
+           secondFile == other.secondFile;
+}
+
+
+VolumeCache::Key VolumeCache::GetKey(const std::string& fileName) {
+    Key key;
+    key.path = vtksys::SystemTools::CollapseFullPath(fileName.c_str());
+    key.size = vtksys::SystemTools::FileLength(key.path.c_str());
+    key.modifiedTime = vtksys::SystemTools::ModifiedTime(key.path.c_str());
+
+    return key;
+}
+
+VolumeCache::Key VolumeCache::GetKey(const std::string& fileNameA, const std::string& fileNameB, double scale) {
+    Key key = GetKey(fileNameA);
+    Key b = GetKey(fileNameB);
+
+    std::ostringstream path;
+    path << key.path << " - " << b.path << " x " << scale;
+
+    key.path = path.str();
+
+    // Changing either file changes the key
+    std::ostringstream secondFile;
+    secondFile << b.size << " " << b.modifiedTime;
+
+    key.secondFile = secondFile.str();
+
+    return key;
+}
+
+VolumeCache::Key VolumeCache::GetKey(const std::string& fileName, int orbital, double spacing, int refinement) {
+    Key key = GetKey(fileName);
+
+    // Each grid evaluated from the file is a different volume
+    std::ostringstream path;
+    path << key.path << " orbital " << orbital << " spacing " << spacing << " refinement " << refinement;
+
+    key.path = path.str();
+
+    return key;
+}
+
+
+VolumeCache::VolumeCache(MemoryBudget* memoryBudget, int maximumEntries)
+: maximumEntries(maximumEntries), memoryBudget(memoryBudget) {
+    // Cached volumes are not shown, so drop them before anything else
+    memoryBudget->AddConsumer("Volume cache", this, -1);
+}
+
+VolumeCache::~VolumeCache() {
+    memoryBudget->RemoveConsumer(this);
+
+    for (std::list<Entry>::iterator it = entries.begin(); it != entries.end(); it++) {
+        delete it->pipeline;
+    }
+}
+
+
+void VolumeCache::Add(const Key& key, VTKPipeline* pipeline) {
+    // Replace any older version of the same file
+    for (std::list<Entry>::iterator it = entries.begin(); it != entries.end(); ) {
+        if (it->key.path == key.path) {
+            delete it->pipeline;
+            it = entries.erase(it);
+        }
+        else {
+            it++;
+        }
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.pipeline = pipeline;
+
+    entries.push_front(entry);
+
+    while ((int)entries.size() > maximumEntries) {
+        Evict();
+    }
+}
+
+VTKPipeline* VolumeCache::Take(const Key& key) {
+    for (std::list<Entry>::iterator it = entries.begin(); it != entries.end(); it++) {
+        if (it->key == key) {
+            VTKPipeline* pipeline = it->pipeline;
+            entries.erase(it);
+
+            return pipeline;
+        }
+    }
+
+    return NULL;
+}
+
+
+unsigned long VolumeCache::GetMemorySize() {
+    unsigned long size = 0;
+    for (std::list<Entry>::iterator it = entries.begin(); it != entries.end(); it++) {
+        size += it->pipeline->GetMemorySize();
+    }
+
+    return size;
+}
+
+bool VolumeCache::Evict() {
+    if (entries.empty()) {
+        return false;
+    }
+
+    delete entries.back().pipeline;
+    entries.pop_back();
+
+    return true;
+}
@@ -0,0 +1,80 @@
+/*=========================================================================
+
+  Name:        VolumeCache.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Keeps recently loaded volumes, along with their isosurfaces,
+               slices, and other derived data, so that switching back to a
+               previously opened file is instant.  Entries are keyed by
+               path, file size, and modification time, so a file changed
+               on disk is loaded again.  The least recently used entries
+               are dropped when over the entry limit or the memory budget.
+
+=========================================================================*/
+
+
+#ifndef VOLUMECACHE_H
+#define VOLUMECACHE_H
+
+#include "MemoryBudget.h"
+
+#include <list>
+#include <string>
+
+class VTKPipeline;
+
+
+class VolumeCache : public MemoryBudget::Consumer {
+public:
+    struct Key {
+        std::string path;
+        unsigned long size;
+        long modifiedTime;
+
+        // Size and modification time of a second file the volume is computed from, if any
+        std::string secondFile;
+
+        bool operator==(const Key& other) const;
+    };
+
+    // Get the key for a file as it currently is on disk
+    static Key GetKey(const std::string& fileName);
+
+    // Get the key for the difference of two files, (A - B) * scale
+    static Key GetKey(const std::string& fileNameA, const std::string& fileNameB, double scale);
+
+    // Get the key for a grid evaluated from a wavefunction file
+    static Key GetKey(const std::string& fileName, int orbital, double spacing, int refinement);
+
+    VolumeCache(MemoryBudget* memoryBudget, int maximumEntries = 4);
+    virtual ~VolumeCache();
+
+    // Add an inactive pipeline.  The cache takes ownership.
+    void Add(const Key& key, VTKPipeline* pipeline);
+
+    // Remove and return the pipeline for the key, or NULL if not cached.  The caller takes ownership.
+    VTKPipeline* Take(const Key& key);
+
+    // MemoryBudget::Consumer interface.  Evicting drops the least recently used entry.
+    virtual unsigned long GetMemorySize();
+    virtual bool Evict();
+
+protected:
+    struct Entry {
+        Key key;
+        VTKPipeline* pipeline;
+    };
+
+    // Most recently used first
+    std::list<Entry> entries;
+
+    int maximumEntries;
+
+    MemoryBudget* memoryBudget;
+};
+
+
+#endif
@@ -0,0 +1,1079 @@
+/*=========================================================================
+
+  Name:        Wavefunction.cpp
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Reads a basis set and molecular orbital coefficients, and
+               evaluates orbitals or the electron density on a grid.
+
+=========================================================================*/
+
+
+#include "Wavefunction.h"
+
+#include "vtkSSE2Math.h"
+
+#include <vtkCriticalSection.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPointData.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#ifdef USE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+// Work shared by the threads evaluating planes
+struct WavefunctionWork {
+    Wavefunction* wavefunction;
+    int orbital;
+    int dimensions[3];
+    double origin[3];
+    double spacing[3];
+    float* output;
+    int next;
+    vtkSimpleCriticalSection lock;
+};
+
+
+static const double pi = 3.14159265358979323846;
+static const double bohrPerAngstrom = 1.0 / 0.52917721092;
+
+// Values of primitives below this are neglected
+static const double screeningThreshold = 1e-8;
+
+// Orbitals with occupations below this don't contribute to the density
+static const double occupationThreshold = 1e-6;
+
+// Highest angular momentum supported, f
+static const int maximumL = 3;
+
+
+// Exponents of x, y, and z of the Cartesian functions of each shell type, in the order used by
+// both molden and Gaussian
+static const int cartesianExponents[maximumL + 1][10][3] = {
+    { { 0, 0, 0 } },
+    { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } },
+    { { 2, 0, 0 }, { 0, 2, 0 }, { 0, 0, 2 }, { 1, 1, 0 }, { 1, 0, 1 }, { 0, 1, 1 } },
+    { { 3, 0, 0 }, { 0, 3, 0 }, { 0, 0, 3 }, { 1, 2, 0 }, { 2, 1, 0 },
+      { 2, 0, 1 }, { 1, 0, 2 }, { 0, 1, 2 }, { 0, 2, 1 }, { 1, 1, 1 } }
+};
+
+// Spherical functions as combinations of the Cartesian functions above, in the order d0, d+1, d-1,
+// d+2, d-2 and f0, f+1, f-1, f+2, f-2, f+3, f-3.  All Cartesian functions of a shell share the
+// normalization of x^l.
+static const double s3 = 1.7320508075688772;       // sqrt(3)
+static const double s38 = 0.6123724356957945;      // sqrt(3/8)
+static const double s58 = 0.7905694150420949;      // sqrt(5/8)
+static const double s15 = 3.872983346207417;       // sqrt(15)
+
+static const double pureD[5][6] = {
+    { -0.5, -0.5, 1.0, 0.0, 0.0, 0.0 },
+    { 0.0, 0.0, 0.0, 0.0, s3, 0.0 },
+    { 0.0, 0.0, 0.0, 0.0, 0.0, s3 },
+    { 0.5 * s3, -0.5 * s3, 0.0, 0.0, 0.0, 0.0 },
+    { 0.0, 0.0, 0.0, s3, 0.0, 0.0 }
+};
+
+static const double pureF[7][10] = {
+    { 0.0, 0.0, 1.0, 0.0, 0.0, -1.5, 0.0, 0.0, -1.5, 0.0 },
+    { -s38, 0.0, 0.0, -s38, 0.0, 0.0, 4.0 * s38, 0.0, 0.0, 0.0 },
+    { 0.0, -s38, 0.0, 0.0, -s38, 0.0, 0.0, 4.0 * s38, 0.0, 0.0 },
+    { 0.0, 0.0, 0.0, 0.0, 0.0, 0.5 * s15, 0.0, 0.0, -0.5 * s15, 0.0 },
+    { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, s15 },
+    { s58, 0.0, 0.0, -3.0 * s58, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+    { 0.0, -s58, 0.0, 0.0, 3.0 * s58, 0.0, 0.0, 0.0, 0.0, 0.0 }
+};
+
+
+static int GetNumberOfCartesianFunctions(int l) {
+    return (l + 1) * (l + 2) / 2;
+}
+
+static int GetNumberOfFunctions(int l, bool pure) {
+    return pure ? 2 * l + 1 : GetNumberOfCartesianFunctions(l);
+}
+
+
+// Row kernels over [begin, end), two points at a time with SSE2.  Each point sums in the same 
+// order as the scalar loop, so only exp differs, by a couple of units in the last place.
+
+// Contracted radial part, sum of c exp(-a (dx^2 + d2)) over the primitives
+static inline void ContractRadial(const double* exponents, const double* coefficients, int n, 
+                                  const double* dx, double d2, int begin, int end, double* radial) {
+    int x = begin;
+
+#ifdef USE_SSE2
+    __m128d d22 = _mm_set1_pd(d2);
+
+    for (; x + 2 <= end; x += 2) {
+        __m128d dx2 = _mm_loadu_pd(dx + x);
+        __m128d r2 = _mm_add_pd(_mm_mul_pd(dx2, dx2), d22);
+        __m128d sum = _mm_setzero_pd();
+
+        for (int k = 0; k < n; k++) {
+            __m128d e = vtkSSE2Exp(_mm_mul_pd(_mm_set1_pd(-exponents[k]), r2));
+            sum = _mm_add_pd(sum, _mm_mul_pd(_mm_set1_pd(coefficients[k]), e));
+        }
+
+        _mm_storeu_pd(radial + x, sum);
+    }
+#endif
+
+    for (; x < end; x++) {
+        double r2 = dx[x] * dx[x] + d2;
+        double sum = 0.0;
+
+        for (int k = 0; k < n; k++) {
+            sum += coefficients[k] * exp(-exponents[k] * r2);
+        }
+
+        radial[x] = sum;
+    }
+}
+
+// Cartesian function, radial yz dx^power
+static inline void CartesianFunction(const double* radial, const double* dx, double yz, int power, 
+                                     int begin, int end, double* out) {
+    int x = begin;
+
+#ifdef USE_SSE2
+    __m128d yz2 = _mm_set1_pd(yz);
+
+    for (; x + 2 <= end; x += 2) {
+        __m128d dx2 = _mm_loadu_pd(dx + x);
+        __m128d v = _mm_mul_pd(_mm_loadu_pd(radial + x), yz2);
+
+        for (int k = 0; k < power; k++) {
+            v = _mm_mul_pd(v, dx2);
+        }
+
+        _mm_storeu_pd(out + x, v);
+    }
+#endif
+
+    for (; x < end; x++) {
+        double v = radial[x] * yz;
+
+        for (int k = 0; k < power; k++) {
+            v *= dx[x];
+        }
+
+        out[x] = v;
+    }
+}
+
+// out += scale in, for spherical functions and orbitals
+static inline void AddScaled(const double* in, double scale, int begin, int end, double* out) {
+    int x = begin;
+
+#ifdef USE_SSE2
+    __m128d scale2 = _mm_set1_pd(scale);
+
+    for (; x + 2 <= end; x += 2) {
+        _mm_storeu_pd(out + x, _mm_add_pd(_mm_loadu_pd(out + x), _mm_mul_pd(scale2, _mm_loadu_pd(in + x))));
+    }
+#endif
+
+    for (; x < end; x++) {
+        out[x] += scale * in[x];
+    }
+}
+
+// out += weight in^2, for the density
+static inline void AddWeightedSquare(const double* in, double weight, int begin, int end, double* out) {
+    int x = begin;
+
+#ifdef USE_SSE2
+    __m128d weight2 = _mm_set1_pd(weight);
+
+    for (; x + 2 <= end; x += 2) {
+        __m128d v = _mm_loadu_pd(in + x);
+        _mm_storeu_pd(out + x, _mm_add_pd(_mm_loadu_pd(out + x), _mm_mul_pd(_mm_mul_pd(weight2, v), v)));
+    }
+#endif
+
+    for (; x < end; x++) {
+        out[x] += weight * in[x] * in[x];
+    }
+}
+
+
+static std::string ToLower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), ::tolower);
+    return s;
+}
+
+static std::string Trim(const std::string& s) {
+    size_t first = s.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        return "";
+    }
+
+    return s.substr(first, s.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+// Parse a number, allowing Fortran D exponents
+static double ToDouble(std::string s) {
+    std::replace(s.begin(), s.end(), 'D', 'E');
+    std::replace(s.begin(), s.end(), 'd', 'e');
+
+    return atof(s.c_str());
+}
+
+
+Wavefunction::Wavefunction() {
+    numberOfBasisFunctions = 0;
+}
+
+Wavefunction::~Wavefunction() {
+}
+
+
+bool Wavefunction::IsWavefunctionFile(const std::string& fileName) {
+    std::string extension = ToLower(fileName.substr(fileName.find_last_of(".") + 1));
+
+    return extension == "molden" || extension == "mold" || extension == "fchk" || extension == "fch";
+}
+
+
+bool Wavefunction::Read(const std::string& fileName, std::string* errorMessage) {
+    atoms.clear();
+    shells.clear();
+    orbitals.clear();
+
+    if (!IsWavefunctionFile(fileName)) {
+        *errorMessage = "Wavefunction must be in molden (.molden, .mold) or formatted checkpoint (.fchk, .fch) format";
+
+        return false;
+    }
+
+    std::ifstream in(fileName.c_str());
+
+    if (!in) {
+        *errorMessage = "Could not open " + fileName;
+
+        return false;
+    }
+
+    std::string extension = ToLower(fileName.substr(fileName.find_last_of(".") + 1));
+    bool success = extension[0] == 'm' ? ReadMolden(in, errorMessage) : ReadFchk(in, errorMessage);
+
+    if (!success) {
+        *errorMessage = "Could not read " + fileName + ": " + *errorMessage;
+
+        return false;
+    }
+
+    return Prepare(errorMessage);
+}
+
+
+int Wavefunction::GetNumberOfAtoms() {
+    return (int)atoms.size();
+}
+
+const Wavefunction::Atom& Wavefunction::GetAtom(int index) {
+    return atoms[index];
+}
+
+
+int Wavefunction::GetNumberOfBasisFunctions() {
+    return numberOfBasisFunctions;
+}
+
+
+int Wavefunction::GetNumberOfOrbitals() {
+    return (int)orbitals.size();
+}
+
+const Wavefunction::Orbital& Wavefunction::GetOrbital(int index) {
+    return orbitals[index];
+}
+
+
+int Wavefunction::GetHomo() {
+    int homo = -1;
+
+    for (int i = 0; i < (int)orbitals.size(); i++) {
+        if (!orbitals[i].beta && orbitals[i].occupation > occupationThreshold &&
+            (homo < 0 || orbitals[i].energy > orbitals[homo].energy)) {
+            homo = i;
+        }
+    }
+
+    return homo;
+}
+
+
+void Wavefunction::GetAtomBounds(double bounds[6]) {
+    for (int i = 0; i < 3; i++) {
+        bounds[i * 2] = atoms.empty() ? 0.0 : atoms[0].position[i];
+        bounds[i * 2 + 1] = bounds[i * 2];
+    }
+
+    for (int i = 0; i < (int)atoms.size(); i++) {
+        for (int j = 0; j < 3; j++) {
+            bounds[j * 2] = std::min(bounds[j * 2], atoms[i].position[j]);
+            bounds[j * 2 + 1] = std::max(bounds[j * 2 + 1], atoms[i].position[j]);
+        }
+    }
+}
+
+
+bool Wavefunction::ReadMolden(std::istream& in, std::string* errorMessage) {
+    // Spherical d and f flags
+    bool sphericalD = false;
+    bool sphericalF = false;
+
+    std::string section;
+    double unitScale = 1.0;
+
+    // Shells are read before knowing whether they are spherical, so keep the atom index in the
+    // center until all is read
+    std::vector<int> shellAtoms;
+    int atom = -1;
+
+    Orbital* orbital = NULL;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        std::string trimmed = Trim(line);
+
+        if (trimmed.empty()) {
+            continue;
+        }
+
+        if (trimmed[0] == '[') {
+            std::string lower = ToLower(trimmed);
+            section = lower.substr(0, lower.find(']') + 1);
+
+            if (section == "[atoms]") {
+                unitScale = lower.find("angs") != std::string::npos ? bohrPerAngstrom : 1.0;
+            }
+            else if (section == "[5d]" || section == "[5d7f]") {
+                sphericalD = sphericalF = true;
+            }
+            else if (section == "[5d10f]") {
+                sphericalD = true;
+            }
+            else if (section == "[7f]") {
+                sphericalF = true;
+            }
+            else if (section == "[9g]") {
+                *errorMessage = "g and higher shells are not supported";
+
+                return false;
+            }
+
+            continue;
+        }
+
+        std::istringstream fields(trimmed);
+
+        if (section == "[atoms]") {
+            std::string name;
+            int number;
+            Atom a;
+
+            if (!(fields >> name >> number >> a.atomicNumber >> a.position[0] >> a.position[1] >> a.position[2])) {
+                *errorMessage = "Invalid atom: " + trimmed;
+
+                return false;
+            }
+
+            for (int i = 0; i < 3; i++) {
+                a.position[i] *= unitScale;
+            }
+
+            atoms.push_back(a);
+        }
+        else if (section == "[gto]") {
+            std::string type;
+            fields >> type;
+
+            if (!type.empty() && isdigit(type[0])) {
+                // Start of the shells of an atom
+                atom = atoi(type.c_str()) - 1;
+
+                continue;
+            }
+
+            type = ToLower(type);
+
+            int numberOfPrimitives = 0;
+            fields >> numberOfPrimitives;
+
+            int l = type == "s" ? 0 : type == "p" ? 1 : type == "d" ? 2 : type == "f" ? 3 : type == "sp" ? -1 : -2;
+
+            if (l < -1) {
+                *errorMessage = "Unsupported shell type " + type + ".  Shells up to f are supported";
+
+                return false;
+            }
+
+            if (atom < 0 || numberOfPrimitives <= 0) {
+                *errorMessage = "Invalid shell: " + trimmed;
+
+                return false;
+            }
+
+            // sp shells are split into s and p shells with the same exponents
+            Shell shell;
+            shell.l = l < 0 ? 0 : l;
+            Shell pShell;
+            pShell.l = 1;
+
+            for (int i = 0; i < numberOfPrimitives; i++) {
+                std::string e, c, cp;
+
+                if (!std::getline(in, line) || !(std::istringstream(line) >> e >> c)) {
+                    *errorMessage = "Invalid primitive: " + Trim(line);
+
+                    return false;
+                }
+
+                shell.exponents.push_back(ToDouble(e));
+                shell.coefficients.push_back(ToDouble(c));
+
+                if (l < 0) {
+                    std::istringstream(line) >> e >> c >> cp;
+                    pShell.exponents.push_back(ToDouble(e));
+                    pShell.coefficients.push_back(ToDouble(cp));
+                }
+            }
+
+            shells.push_back(shell);
+            shellAtoms.push_back(atom);
+
+            if (l < 0) {
+                shells.push_back(pShell);
+                shellAtoms.push_back(atom);
+            }
+        }
+        else if (section == "[mo]") {
+            size_t equals = trimmed.find('=');
+
+            if (equals != std::string::npos) {
+                // Orbital header.  A symmetry line starts a new orbital, but not all writers
+                // include one, so an energy line following coefficients does as well.
+                std::string key = ToLower(Trim(trimmed.substr(0, equals)));
+                std::string value = Trim(trimmed.substr(equals + 1));
+
+                if (!orbital || ((key == "sym" || key == "ene") && !orbital->coefficients.empty())) {
+                    orbitals.push_back(Orbital());
+                    orbital = &orbitals.back();
+                    orbital->energy = 0.0;
+                    orbital->occupation = 0.0;
+                    orbital->beta = false;
+                }
+
+                if (key == "sym") {
+                    orbital->symmetry = value;
+                }
+                else if (key == "ene") {
+                    orbital->energy = ToDouble(value);
+                }
+                else if (key == "spin") {
+                    orbital->beta = ToLower(value) == "beta";
+                }
+                else if (key == "occup") {
+                    orbital->occupation = ToDouble(value);
+                }
+            }
+            else if (orbital) {
+                // Coefficient, which may skip zeros
+                int index;
+                std::string c;
+
+                if (!(fields >> index >> c) || index < 1) {
+                    *errorMessage = "Invalid orbital coefficient: " + trimmed;
+
+                    return false;
+                }
+
+                if ((int)orbital->coefficients.size() < index) {
+                    orbital->coefficients.resize(index, 0.0);
+                }
+
+                orbital->coefficients[index - 1] = ToDouble(c);
+            }
+        }
+    }
+
+
+    // Place the shells on their atoms
+    for (int i = 0; i < (int)shells.size(); i++) {
+        if (shellAtoms[i] >= (int)atoms.size()) {
+            *errorMessage = "Shell on a missing atom";
+
+            return false;
+        }
+
+        for (int j = 0; j < 3; j++) {
+            shells[i].center[j] = atoms[shellAtoms[i]].position[j];
+        }
+
+        shells[i].pure = (shells[i].l == 2 && sphericalD) || (shells[i].l == 3 && sphericalF);
+    }
+
+    return true;
+}
+
+
+bool Wavefunction::ReadFchk(std::istream& in, std::string* errorMessage) {
+    // Read all entries as arrays of numbers.  Scalars are arrays of one.  Character arrays aren't
+    // needed, and are skipped.
+    std::map<std::string, std::vector<double> > entries;
+
+    std::string line;
+
+    // Title and job type
+    std::getline(in, line);
+    std::getline(in, line);
+
+    while (std::getline(in, line)) {
+        if (line.length() < 44 || line[0] == ' ') {
+            continue;
+        }
+
+        std::string name = Trim(line.substr(0, 40));
+        std::istringstream fields(line.substr(40));
+
+        std::string type, value;
+        fields >> type >> value;
+
+        if (value != "N=") {
+            if (type != "C" && type != "L") {
+                entries[name].push_back(ToDouble(value));
+            }
+
+            continue;
+        }
+
+        int count = 0;
+        fields >> count;
+
+        std::vector<double>& values = entries[name];
+        values.reserve(count);
+
+        while ((int)values.size() < count && std::getline(in, line)) {
+            if (type == "C") {
+                // Five strings of 12 characters per line
+                count -= 5;
+                continue;
+            }
+
+            std::istringstream lineFields(line);
+            while (lineFields >> value) {
+                values.push_back(ToDouble(value));
+            }
+        }
+    }
+
+
+    const char* required[] = {
+        "Atomic numbers", "Current cartesian coordinates", "Number of basis functions",
+        "Shell types", "Number of primitives per shell", "Shell to atom map", "Primitive exponents",
+        "Contraction coefficients", "Coordinates of each shell", "Alpha Orbital Energies",
+        "Alpha MO coefficients", "Number of alpha electrons", "Number of beta electrons"
+    };
+
+    for (int i = 0; i < (int)(sizeof(required) / sizeof(required[0])); i++) {
+        if (entries.find(required[i]) == entries.end()) {
+            *errorMessage = std::string("Missing ") + required[i];
+
+            return false;
+        }
+    }
+
+
+    // Atoms, in bohr
+    std::vector<double>& numbers = entries["Atomic numbers"];
+    std::vector<double>& coordinates = entries["Current cartesian coordinates"];
+
+    if (coordinates.size() != numbers.size() * 3) {
+        *errorMessage = "Inconsistent atoms";
+
+        return false;
+    }
+
+    for (int i = 0; i < (int)numbers.size(); i++) {
+        Atom atom;
+        atom.atomicNumber = (int)numbers[i];
+
+        for (int j = 0; j < 3; j++) {
+            atom.position[j] = coordinates[i * 3 + j];
+        }
+
+        atoms.push_back(atom);
+    }
+
+
+    // Shells.  Types are 0 for s, 1 for p, -1 for sp, l for Cartesian and -l for spherical.
+    std::vector<double>& types = entries["Shell types"];
+    std::vector<double>& primitives = entries["Number of primitives per shell"];
+    std::vector<double>& exponents = entries["Primitive exponents"];
+    std::vector<double>& coefficients = entries["Contraction coefficients"];
+    std::vector<double>& spCoefficients = entries["P(S=P) Contraction coefficients"];
+    std::vector<double>& centers = entries["Coordinates of each shell"];
+
+    if (primitives.size() != types.size() || centers.size() != types.size() * 3) {
+        *errorMessage = "Inconsistent shells";
+
+        return false;
+    }
+
+    int primitive = 0;
+    for (int i = 0; i < (int)types.size(); i++) {
+        int type = (int)types[i];
+        int n = (int)primitives[i];
+
+        if (abs(type) > maximumL) {
+            *errorMessage = "g and higher shells are not supported";
+
+            return false;
+        }
+
+        if (primitive + n > (int)exponents.size() || primitive + n > (int)coefficients.size() ||
+            (type == -1 && primitive + n > (int)spCoefficients.size())) {
+            *errorMessage = "Inconsistent primitives";
+
+            return false;
+        }
+
+        Shell shell;
+        shell.l = type == -1 ? 0 : abs(type);
+        shell.pure = type < -1;
+
+        for (int j = 0; j < 3; j++) {
+            shell.center[j] = centers[i * 3 + j];
+        }
+
+        shell.exponents.assign(exponents.begin() + primitive, exponents.begin() + primitive + n);
+        shell.coefficients.assign(coefficients.begin() + primitive, coefficients.begin() + primitive + n);
+
+        shells.push_back(shell);
+
+        if (type == -1) {
+            shell.l = 1;
+            shell.coefficients.assign(spCoefficients.begin() + primitive, spCoefficients.begin() + primitive + n);
+
+            shells.push_back(shell);
+        }
+
+        primitive += n;
+    }
+
+
+    // Orbitals.  Occupations follow from the numbers of electrons, filling the lowest orbitals.
+    int nbf = (int)entries["Number of basis functions"][0];
+    int alpha = (int)entries["Number of alpha electrons"][0];
+    int beta = (int)entries["Number of beta electrons"][0];
+    bool unrestricted = entries.find("Beta MO coefficients") != entries.end();
+
+    for (int s = 0; s < (unrestricted ? 2 : 1); s++) {
+        std::vector<double>& energies = entries[s == 0 ? "Alpha Orbital Energies" : "Beta Orbital Energies"];
+        std::vector<double>& c = entries[s == 0 ? "Alpha MO coefficients" : "Beta MO coefficients"];
+
+        if (nbf <= 0 || c.size() != energies.size() * nbf) {
+            *errorMessage = "Inconsistent orbitals";
+
+            return false;
+        }
+
+        for (int i = 0; i < (int)energies.size(); i++) {
+            Orbital orbital;
+            orbital.energy = energies[i];
+            orbital.beta = s == 1;
+            orbital.coefficients.assign(c.begin() + i * nbf, c.begin() + (i + 1) * nbf);
+
+            if (unrestricted) {
+                orbital.occupation = i < (s == 0 ? alpha : beta) ? 1.0 : 0.0;
+            }
+            else {
+                orbital.occupation = i < beta ? 2.0 : i < alpha ? 1.0 : 0.0;
+            }
+
+            orbitals.push_back(orbital);
+        }
+    }
+
+    return true;
+}
+
+
+bool Wavefunction::Prepare(std::string* errorMessage) {
+    if (atoms.empty() || shells.empty() || orbitals.empty()) {
+        *errorMessage = "No atoms, basis set, or orbitals found";
+
+        return false;
+    }
+
+    numberOfBasisFunctions = 0;
+
+    for (int i = 0; i < (int)shells.size(); i++) {
+        Shell& shell = shells[i];
+        int l = shell.l;
+
+        shell.firstFunction = numberOfBasisFunctions;
+        numberOfBasisFunctions += GetNumberOfFunctions(l, shell.pure);
+
+
+        // Coefficients are for normalized primitives.  Fold the normalization of x^l into them,
+        // (2a/pi)^(3/4) (4a)^(l/2) / sqrt((2l-1)!!).
+        double doubleFactorial = 1.0;
+        for (int k = 2 * l - 1; k > 1; k -= 2) {
+            doubleFactorial *= k;
+        }
+
+        int n = (int)shell.exponents.size();
+
+        // Normalize the contraction as a whole
+        double overlap = 0.0;
+        for (int j = 0; j < n; j++) {
+            for (int k = 0; k < n; k++) {
+                double a = shell.exponents[j];
+                double b = shell.exponents[k];
+
+                overlap += shell.coefficients[j] * shell.coefficients[k] *
+                           pow(2.0 * sqrt(a * b) / (a + b), l + 1.5);
+            }
+        }
+
+        double scale = overlap > 0.0 ? 1.0 / sqrt(overlap) : 1.0;
+
+        for (int j = 0; j < n; j++) {
+            double a = shell.exponents[j];
+
+            shell.coefficients[j] *= scale * pow(2.0 * a / pi, 0.75) * pow(4.0 * a, 0.5 * l) / sqrt(doubleFactorial);
+        }
+
+
+        // The distance beyond which all primitives are below the threshold, solving
+        // |c| r^l exp(-a r^2) = threshold.  The r^l term is refined by iterating.
+        shell.cutoffSquared = 0.0;
+
+        for (int j = 0; j < n; j++) {
+            double c = fabs(shell.coefficients[j]);
+            double a = shell.exponents[j];
+
+            double r2 = 1.0;
+            for (int k = 0; k < 3; k++) {
+                r2 = std::max(0.0, (log(c / screeningThreshold) + 0.5 * l * log(std::max(r2, 1.0))) / a);
+            }
+
+            shell.cutoffSquared = std::max(shell.cutoffSquared, r2);
+        }
+    }
+
+
+    // Orbitals may omit trailing zero coefficients
+    for (int i = 0; i < (int)orbitals.size(); i++) {
+        if ((int)orbitals[i].coefficients.size() > numberOfBasisFunctions) {
+            std::ostringstream message;
+            message << "Orbital " << i + 1 << " has more coefficients than the "
+                    << numberOfBasisFunctions << " basis functions";
+            *errorMessage = message.str();
+
+            return false;
+        }
+
+        orbitals[i].coefficients.resize(numberOfBasisFunctions, 0.0);
+    }
+
+    return true;
+}
+
+
+vtkSmartPointer<vtkDataObject> Wavefunction::Evaluate(int orbital, double spacing, double margin,
+                                                      int refinement, const double regionOfInterest[6]) {
+    // Coarse grid covering the atoms plus the margin
+    double bounds[6];
+    GetAtomBounds(bounds);
+
+    vtkSmartPointer<vtkImageData> coarse = vtkSmartPointer<vtkImageData>::New();
+
+    int dimensions[3];
+    double origin[3];
+    for (int i = 0; i < 3; i++) {
+        dimensions[i] = (int)ceil((bounds[i * 2 + 1] - bounds[i * 2] + 2.0 * margin) / spacing) + 1;
+        origin[i] = 0.5 * (bounds[i * 2] + bounds[i * 2 + 1]) - 0.5 * (dimensions[i] - 1) * spacing;
+    }
+
+    coarse->SetDimensions(dimensions);
+    coarse->SetOrigin(origin);
+    coarse->SetSpacing(spacing, spacing, spacing);
+
+    std::cout << "Wavefunction: Evaluating " << dimensions[0] << "x" << dimensions[1] << "x" << dimensions[2]
+              << " grid with " << numberOfBasisFunctions << " basis functions" << std::endl;
+
+    EvaluateImage(coarse, orbital);
+
+    if (refinement <= 1) {
+        return coarse;
+    }
+
+
+    // Fine grid over the region of interest.  Its boundaries lie on coarse grid points, as
+    // required for nesting.
+    int extent[6];
+    for (int i = 0; i < 3; i++) {
+        extent[i * 2] = std::max((int)floor((regionOfInterest[i * 2] - origin[i]) / spacing), 0);
+        extent[i * 2 + 1] = std::min((int)ceil((regionOfInterest[i * 2 + 1] - origin[i]) / spacing), dimensions[i] - 1);
+
+        if (extent[i * 2 + 1] <= extent[i * 2]) {
+            return coarse;
+        }
+    }
+
+    vtkSmartPointer<vtkImageData> fine = vtkSmartPointer<vtkImageData>::New();
+
+    double fineSpacing = spacing / refinement;
+    for (int i = 0; i < 3; i++) {
+        dimensions[i] = (extent[i * 2 + 1] - extent[i * 2]) * refinement + 1;
+        origin[i] += extent[i * 2] * spacing;
+    }
+
+    fine->SetDimensions(dimensions);
+    fine->SetOrigin(origin);
+    fine->SetSpacing(fineSpacing, fineSpacing, fineSpacing);
+
+    std::cout << "Wavefunction: Evaluating " << dimensions[0] << "x" << dimensions[1] << "x" << dimensions[2]
+              << " refined grid" << std::endl;
+
+    EvaluateImage(fine, orbital);
+
+    vtkSmartPointer<vtkMultiBlockDataSet> blocks = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+    blocks->SetNumberOfBlocks(2);
+    blocks->SetBlock(0, coarse);
+    blocks->SetBlock(1, fine);
+
+    return blocks;
+}
+
+
+void Wavefunction::EvaluateImage(vtkImageData* image, int orbital) {
+    vtkSmartPointer<vtkFloatArray> values = vtkSmartPointer<vtkFloatArray>::New();
+    values->SetNumberOfTuples(image->GetNumberOfPoints());
+
+    if (orbital < 0) {
+        values->SetName("Density");
+    }
+    else {
+        std::ostringstream name;
+        name << "MO " << orbital + 1;
+        if (!orbitals[orbital].symmetry.empty()) {
+            name << " " << orbitals[orbital].symmetry;
+        }
+        values->SetName(name.str().c_str());
+    }
+
+    image->GetPointData()->SetScalars(values);
+
+    WavefunctionWork work;
+    work.wavefunction = this;
+    work.orbital = orbital;
+    image->GetDimensions(work.dimensions);
+    image->GetOrigin(work.origin);
+    image->GetSpacing(work.spacing);
+    work.output = values->GetPointer(0);
+    work.next = 0;
+
+    vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+    threader->SetNumberOfThreads(std::max(1, std::min(vtkMultiThreader::GetGlobalDefaultNumberOfThreads(), work.dimensions[2])));
+    threader->SetSingleMethod(EvaluatePlanes, &work);
+    threader->SingleMethodExecute();
+}
+
+VTK_THREAD_RETURN_TYPE Wavefunction::EvaluatePlanes(void* arg) {
+    vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    WavefunctionWork* work = static_cast<WavefunctionWork*>(info->UserData);
+
+    // Take planes until none are left
+    for (;;) {
+        work->lock.Lock();
+        int z = work->next++;
+        work->lock.Unlock();
+
+        if (z >= work->dimensions[2]) {
+            break;
+        }
+
+        work->wavefunction->EvaluatePlane(work, z);
+    }
+
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+
+void Wavefunction::EvaluatePlane(WavefunctionWork* work, int z) {
+    int nx = work->dimensions[0];
+    int ny = work->dimensions[1];
+
+    // Orbitals contributing to the value
+    std::vector<int> used;
+    std::vector<double> weights;
+
+    if (work->orbital >= 0) {
+        used.push_back(work->orbital);
+        weights.push_back(1.0);
+    }
+    else {
+        for (int i = 0; i < (int)orbitals.size(); i++) {
+            if (orbitals[i].occupation > occupationThreshold) {
+                used.push_back(i);
+                weights.push_back(orbitals[i].occupation);
+            }
+        }
+    }
+
+
+    // Values of basis functions along a row, stored row by row.  Only functions of shells
+    // reaching the row are set, and only over the points they reach.
+    std::vector<double> functions((size_t)numberOfBasisFunctions * nx);
+    std::vector<double> radial(nx);
+    std::vector<double> dx(nx);
+    std::vector<double> cartesian(10 * nx);
+
+    std::vector<int> active;
+    std::vector<int> starts;
+    std::vector<int> ends;
+
+    std::vector<double> psi(nx);
+    std::vector<double> sum(nx);
+
+    double pz = work->origin[2] + z * work->spacing[2];
+
+    for (int y = 0; y < ny; y++) {
+        double py = work->origin[1] + y * work->spacing[1];
+
+        active.clear();
+        starts.clear();
+        ends.clear();
+
+        for (int s = 0; s < (int)shells.size(); s++) {
+            const Shell& shell = shells[s];
+
+            // Skip shells that don't reach the row, and limit the others to the points they reach
+            double sy = py - shell.center[1];
+            double sz = pz - shell.center[2];
+            double d2 = sy * sy + sz * sz;
+
+            if (d2 >= shell.cutoffSquared) {
+                continue;
+            }
+
+            double half = sqrt(shell.cutoffSquared - d2);
+            int x0 = std::max((int)ceil((shell.center[0] - half - work->origin[0]) / work->spacing[0]), 0);
+            int x1 = std::min((int)floor((shell.center[0] + half - work->origin[0]) / work->spacing[0]) + 1, nx);
+
+            if (x0 >= x1) {
+                continue;
+            }
+
+
+            // Contracted radial part
+            int n = (int)shell.exponents.size();
+
+            for (int x = x0; x < x1; x++) {
+                dx[x] = work->origin[0] + x * work->spacing[0] - shell.center[0];
+            }
+
+            ContractRadial(&shell.exponents[0], &shell.coefficients[0], n, &dx[0], d2, x0, x1, &radial[0]);
+
+
+            // Cartesian functions
+            int l = shell.l;
+            int numberOfCartesian = GetNumberOfCartesianFunctions(l);
+
+            for (int f = 0; f < numberOfCartesian; f++) {
+                const int* e = cartesianExponents[l][f];
+
+                double yz = 1.0;
+                for (int k = 0; k < e[1]; k++) {
+                    yz *= sy;
+                }
+                for (int k = 0; k < e[2]; k++) {
+                    yz *= sz;
+                }
+
+                CartesianFunction(&radial[0], &dx[0], yz, e[0], x0, x1, &cartesian[f * nx]);
+            }
+
+
+            // Basis functions
+            int numberOfFunctions = GetNumberOfFunctions(l, shell.pure);
+
+            for (int f = 0; f < numberOfFunctions; f++) {
+                double* out = &functions[(size_t)(shell.firstFunction + f) * nx];
+
+                if (!shell.pure) {
+                    std::copy(cartesian.begin() + f * nx + x0, cartesian.begin() + f * nx + x1, out + x0);
+                }
+                else {
+                    const double* transform = l == 2 ? pureD[f] : pureF[f];
+
+                    std::fill(out + x0, out + x1, 0.0);
+
+                    for (int c = 0; c < numberOfCartesian; c++) {
+                        if (transform[c] == 0.0) {
+                            continue;
+                        }
+
+                        AddScaled(&cartesian[c * nx], transform[c], x0, x1, out);
+                    }
+                }
+
+                active.push_back(shell.firstFunction + f);
+                starts.push_back(x0);
+                ends.push_back(x1);
+            }
+        }
+
+
+        // Sum the orbitals, or the squares of occupied orbitals weighted by occupation
+        std::fill(sum.begin(), sum.end(), 0.0);
+
+        for (int i = 0; i < (int)used.size(); i++) {
+            const std::vector<double>& c = orbitals[used[i]].coefficients;
+
+            std::fill(psi.begin(), psi.end(), 0.0);
+
+            for (int j = 0; j < (int)active.size(); j++) {
+                double cj = c[active[j]];
+
+                if (cj == 0.0) {
+                    continue;
+                }
+
+                AddScaled(&functions[(size_t)active[j] * nx], cj, starts[j], ends[j], &psi[0]);
+            }
+
+            if (work->orbital >= 0) {
+                sum.swap(psi);
+            }
+            else {
+                AddWeightedSquare(&psi[0], weights[i], 0, nx, &sum[0]);
+            }
+        }
+
+        float* out = work->output + ((vtkIdType)z * ny + y) * nx;
+        for (int x = 0; x < nx; x++) {
+            out[x] = static_cast<float>(sum[x]);
+        }
+    }
+}
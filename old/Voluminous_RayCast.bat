@@ -1,2 +1,2 @@
-Release\Voluminous.exe Data/diffdensity_scaled.vti rayCast
+Release\Voluminous.exe Data/diffdensity_scaled.vti rayCast
 @PAUSE
\ No newline at end of file
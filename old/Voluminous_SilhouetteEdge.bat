@@ -1,2 +1,2 @@
-Release\Voluminous.exe Data/diffdensity_scaled.vti 0.2 0.0002 silhouetteEdge.xml 1.0
+Release\Voluminous.exe Data/diffdensity_scaled.vti 0.2 0.0002 silhouetteEdge.xml 1.0
 @PAUSE
\ No newline at end of file
@@ -1,2 +1,2 @@
-Release\Voluminous.exe Data/diffdensity_scaled.vti 0.2 0.0002 texturedTransparency_SilhouetteFalloff.xml 0.1
+Release\Voluminous.exe Data/diffdensity_scaled.vti 0.2 0.0002 texturedTransparency_SilhouetteFalloff.xml 0.1
 @PAUSE
\ No newline at end of file
@@ -0,0 +1,1266 @@
+/*=========================================================================
+
+  Name:        vtkBrickRayCastMapper.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Direct volume rendering and isosurface ray casting on the
+               CPU.
+
+=========================================================================*/
+
+
+#include "vtkBrickRayCastMapper.h"
+
+#include "vtkVolumeDifference.h"
+#include "vtkVolumeSlab.h"
+
+#include <vtkCamera.h>
+#include <vtkColorTransferFunction.h>
+#include <vtkCriticalSection.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkInformation.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkObjectFactory.h>
+#include <vtkPiecewiseFunction.h>
+#include <vtkPointData.h>
+#include <vtkRayCastImageDisplayHelper.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkVolume.h>
+#include <vtkVolumeProperty.h>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef USE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+vtkStandardNewMacro(vtkBrickRayCastMapper);
+
+
+// Cells along each side of a brick
+static const int brickShift = 3;
+static const int brickSize = 1 << brickShift;
+
+// Bins of the table locating cells, per cell of an axis
+static const int binsPerCell = 4;
+
+// Entries in the color and opacity table
+static const int tableSize = 1024;
+
+// Pixels along each side of a tile of the image
+static const int tileSize = 16;
+
+// Samples interpolated at once along a ray
+static const int batchSize = 8;
+
+// Isosurfaces rendered at once
+static const int maxIsosurfaces = 8;
+
+
+//----------------------------------------------------------------------------
+// Shared state for computing the brick ranges or casting the tiles of the image in parallel
+struct vtkBrickRayCastMapperWork
+{
+  enum
+  {
+    ComputeBricks = 0,
+    CastTiles
+  };
+
+  int Phase;
+  int NumberOfThreads;
+
+  // The grid
+  vtkDataArray* Scalars;
+  int Dimensions[3];
+  const double* Coordinates[3];
+  const double* InverseWidths[3];
+  const int* Cells[3];
+  double Scale[3];
+
+  // The bricks
+  int NumberOfBricks[3];
+  float* BrickRanges;
+  const unsigned char* BrickEmpty;
+
+  // Color and opacity table
+  const float* Table;
+  double TableShift;
+  double TableScale;
+
+  // Isosurfaces, as value, color, and whether translucent
+  int RenderMode;
+  int NumberOfIsosurfaces;
+  const double* Isosurfaces;
+
+  // View coordinates to data coordinates
+  double ViewToData[16];
+
+  // Pixels across the viewport, and the lower left and size of the pixels cast
+  int ViewportSize[2];
+  int Origin[2];
+  int Size[2];
+
+  // The image, with rows MemoryWidth pixels apart
+  unsigned char* Image;
+  int MemoryWidth;
+
+  // Depth buffer over the pixels cast, with PixelSize screen pixels across each pixel cast
+  const float* Depths;
+  int DepthSize[2];
+  int PixelSize;
+
+  double Step;
+  float OpacityThreshold;
+
+  int NumberOfTiles[2];
+  int NextTile;
+  vtkSimpleCriticalSection Lock;
+};
+
+
+//----------------------------------------------------------------------------
+// Find the cell of an axis containing a coordinate, and the fraction of the way across it
+static inline int vtkBrickRayCastMapperLocate(const vtkBrickRayCastMapperWork* work, int axis,
+                                              double x, float& fraction)
+{
+  const double* c = work->Coordinates[axis];
+  int numberOfCells = work->Dimensions[axis] - 1;
+
+  int bin = static_cast<int>((x - c[0]) * work->Scale[axis]);
+  bin = std::min(std::max(bin, 0), numberOfCells * binsPerCell - 1);
+
+  int cell = work->Cells[axis][bin];
+  while (cell < numberOfCells - 1 && x >= c[cell + 1])
+    {
+    cell++;
+    }
+
+  double f = (x - c[cell]) * work->InverseWidths[axis][cell];
+  fraction = static_cast<float>(std::min(std::max(f, 0.0), 1.0));
+
+  return cell;
+}
+
+//----------------------------------------------------------------------------
+// Transform a point in view coordinates to data coordinates
+static inline void vtkBrickRayCastMapperUnproject(const double m[16], double x, double y, double z,
+                                                  double p[3])
+{
+  double w = m[12] * x + m[13] * y + m[14] * z + m[15];
+
+  for (int i = 0; i < 3; i++)
+    {
+    p[i] = (m[4 * i] * x + m[4 * i + 1] * y + m[4 * i + 2] * z + m[4 * i + 3]) / w;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Compute the value range of the bricks in a range of brick layers along z
+template <class T>
+static void vtkBrickRayCastMapperBricks(vtkBrickRayCastMapperWork* work, const T* values,
+                                        int startLayer, int endLayer)
+{
+  const int* dims = work->Dimensions;
+  const int* nb = work->NumberOfBricks;
+  vtkIdType nx = dims[0];
+  vtkIdType nxy = nx * dims[1];
+
+  for (int bz = startLayer; bz < endLayer; bz++)
+    {
+    int z0 = bz << brickShift;
+    int z1 = std::min(z0 + brickSize, dims[2] - 1);
+
+    for (int by = 0; by < nb[1]; by++)
+      {
+      int y0 = by << brickShift;
+      int y1 = std::min(y0 + brickSize, dims[1] - 1);
+
+      for (int bx = 0; bx < nb[0]; bx++)
+        {
+        int x0 = bx << brickShift;
+        int x1 = std::min(x0 + brickSize, dims[0] - 1);
+
+        // Bricks share their boundary points, so every cell is within one brick
+        T minimum = values[z0 * nxy + y0 * nx + x0];
+        T maximum = minimum;
+
+        for (int z = z0; z <= z1; z++)
+          {
+          for (int y = y0; y <= y1; y++)
+            {
+            const T* row = values + (z * nxy + y * nx);
+
+            for (int x = x0; x <= x1; x++)
+              {
+              minimum = std::min(minimum, row[x]);
+              maximum = std::max(maximum, row[x]);
+              }
+            }
+          }
+
+        vtkIdType brick = ((vtkIdType)bz * nb[1] + by) * nb[0] + bx;
+        work->BrickRanges[2 * brick] = static_cast<float>(minimum);
+        work->BrickRanges[2 * brick + 1] = static_cast<float>(maximum);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Find the cell containing a point along a ray, returning the index of its brick
+static inline vtkIdType vtkBrickRayCastMapperFindBrick(const vtkBrickRayCastMapperWork* work,
+                                                       const double start[3], const double direction[3],
+                                                       double t, int cell[3])
+{
+  const int* nb = work->NumberOfBricks;
+  float f;
+
+  for (int i = 0; i < 3; i++)
+    {
+    cell[i] = vtkBrickRayCastMapperLocate(work, i, start[i] + t * direction[i], f);
+    }
+
+  return ((vtkIdType)(cell[2] >> brickShift) * nb[1] + (cell[1] >> brickShift)) * nb[0] +
+         (cell[0] >> brickShift);
+}
+
+//----------------------------------------------------------------------------
+// Return the first sample past the brick of a cell along a ray
+static inline double vtkBrickRayCastMapperSkipBrick(const vtkBrickRayCastMapperWork* work, const int cell[3],
+                                                    const double start[3], const double direction[3],
+                                                    double tFar, double sample)
+{
+  double tExit = tFar;
+
+  for (int i = 0; i < 3; i++)
+    {
+    int first = (cell[i] >> brickShift) << brickShift;
+
+    if (direction[i] > 0.0)
+      {
+      double plane = work->Coordinates[i][std::min(first + brickSize, work->Dimensions[i] - 1)];
+      tExit = std::min(tExit, (plane - start[i]) / direction[i]);
+      }
+    else if (direction[i] < 0.0)
+      {
+      double plane = work->Coordinates[i][first];
+      tExit = std::min(tExit, (plane - start[i]) / direction[i]);
+      }
+    }
+
+  return std::max(floor(tExit / work->Step) + 1.0, sample + 1.0);
+}
+
+//----------------------------------------------------------------------------
+// Interpolate a batch of samples along a ray
+template <class T>
+static void vtkBrickRayCastMapperInterpolate(const vtkBrickRayCastMapperWork* work, const T* values,
+                                             const vtkIdType corners[8], const double start[3],
+                                             const double direction[3], double sample, int count,
+                                             float v[batchSize])
+{
+  vtkIdType nx = work->Dimensions[0];
+  vtkIdType nxy = nx * work->Dimensions[1];
+
+  // Cells, fractions, and corner values of the samples
+  int cells[3][batchSize];
+  float fractions[3][batchSize];
+  float c[8][batchSize];
+
+  // Locating walks a table for each coordinate, so is done for each sample
+  for (int j = 0; j < count; j++)
+    {
+    double t = (sample + j) * work->Step;
+
+    for (int i = 0; i < 3; i++)
+      {
+      cells[i][j] = vtkBrickRayCastMapperLocate(work, i, start[i] + t * direction[i], fractions[i][j]);
+      }
+    }
+
+  // Gather the corners of their cells
+  for (int j = 0; j < count; j++)
+    {
+    const T* corner = values + (cells[2][j] * nxy + cells[1][j] * nx + cells[0][j]);
+
+    for (int k = 0; k < 8; k++)
+      {
+      c[k][j] = static_cast<float>(corner[corners[k]]);
+      }
+    }
+
+  int j = 0;
+
+#ifdef USE_SSE2
+  // Interpolate four samples at a time
+  for (; j + 4 <= count; j += 4)
+    {
+    __m128 fx = _mm_loadu_ps(fractions[0] + j);
+    __m128 fy = _mm_loadu_ps(fractions[1] + j);
+    __m128 fz = _mm_loadu_ps(fractions[2] + j);
+
+    __m128 ck[8];
+    for (int k = 0; k < 8; k++)
+      {
+      ck[k] = _mm_loadu_ps(c[k] + j);
+      }
+
+    __m128 c00 = _mm_add_ps(ck[0], _mm_mul_ps(fx, _mm_sub_ps(ck[1], ck[0])));
+    __m128 c10 = _mm_add_ps(ck[2], _mm_mul_ps(fx, _mm_sub_ps(ck[3], ck[2])));
+    __m128 c01 = _mm_add_ps(ck[4], _mm_mul_ps(fx, _mm_sub_ps(ck[5], ck[4])));
+    __m128 c11 = _mm_add_ps(ck[6], _mm_mul_ps(fx, _mm_sub_ps(ck[7], ck[6])));
+
+    __m128 c0 = _mm_add_ps(c00, _mm_mul_ps(fy, _mm_sub_ps(c10, c00)));
+    __m128 c1 = _mm_add_ps(c01, _mm_mul_ps(fy, _mm_sub_ps(c11, c01)));
+
+    _mm_storeu_ps(v + j, _mm_add_ps(c0, _mm_mul_ps(fz, _mm_sub_ps(c1, c0))));
+    }
+#endif
+
+  for (; j < count; j++)
+    {
+    float fx = fractions[0][j];
+    float fy = fractions[1][j];
+    float fz = fractions[2][j];
+
+    float c00 = c[0][j] + fx * (c[1][j] - c[0][j]);
+    float c10 = c[2][j] + fx * (c[3][j] - c[2][j]);
+    float c01 = c[4][j] + fx * (c[5][j] - c[4][j]);
+    float c11 = c[6][j] + fx * (c[7][j] - c[6][j]);
+
+    float c0 = c00 + fy * (c10 - c00);
+    float c1 = c01 + fy * (c11 - c01);
+
+    v[j] = c0 + fz * (c1 - c0);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Interpolate the value at a point, and its gradient if requested, from the trilinear 
+// interpolant of the cell containing the point
+template <class T>
+static double vtkBrickRayCastMapperEvaluate(const vtkBrickRayCastMapperWork* work, const T* values,
+                                            const vtkIdType corners[8], const double p[3],
+                                            double* gradient)
+{
+  vtkIdType nx = work->Dimensions[0];
+  vtkIdType nxy = nx * work->Dimensions[1];
+
+  int cell[3];
+  float f[3];
+
+  for (int i = 0; i < 3; i++)
+    {
+    cell[i] = vtkBrickRayCastMapperLocate(work, i, p[i], f[i]);
+    }
+
+  const T* corner = values + (cell[2] * nxy + cell[1] * nx + cell[0]);
+
+  double c[8];
+  for (int k = 0; k < 8; k++)
+    {
+    c[k] = static_cast<double>(corner[corners[k]]);
+    }
+
+  double fx = f[0];
+  double fy = f[1];
+  double fz = f[2];
+
+  double c00 = c[0] + fx * (c[1] - c[0]);
+  double c10 = c[2] + fx * (c[3] - c[2]);
+  double c01 = c[4] + fx * (c[5] - c[4]);
+  double c11 = c[6] + fx * (c[7] - c[6]);
+
+  double c0 = c00 + fy * (c10 - c00);
+  double c1 = c01 + fy * (c11 - c01);
+
+  if (gradient)
+    {
+    // Derivatives of the interpolant along each axis, scaled by the cell widths
+    double dx0 = (c[1] - c[0]) + fy * ((c[3] - c[2]) - (c[1] - c[0]));
+    double dx1 = (c[5] - c[4]) + fy * ((c[7] - c[6]) - (c[5] - c[4]));
+
+    gradient[0] = (dx0 + fz * (dx1 - dx0)) * work->InverseWidths[0][cell[0]];
+    gradient[1] = ((c10 - c00) + fz * ((c11 - c01) - (c10 - c00))) * work->InverseWidths[1][cell[1]];
+    gradient[2] = (c1 - c0) * work->InverseWidths[2][cell[2]];
+    }
+
+  return c0 + fz * (c1 - c0);
+}
+
+//----------------------------------------------------------------------------
+// Shade the crossings of the isosurfaces between two samples along a ray, nearest first, and 
+// composite them front to back
+template <class T>
+static void vtkBrickRayCastMapperShadeCrossings(const vtkBrickRayCastMapperWork* work, const T* values,
+                                                const vtkIdType corners[8], const double start[3],
+                                                const double direction[3], double t0, float v0,
+                                                double t1, float v1, float rgba[4])
+{
+  double hits[maxIsosurfaces];
+  int surfaces[maxIsosurfaces];
+  int numberOfHits = 0;
+
+  for (int k = 0; k < work->NumberOfIsosurfaces; k++)
+    {
+    double value = work->Isosurfaces[5 * k];
+    double f0 = v0 - value;
+    double f1 = v1 - value;
+
+    if ((f0 < 0.0) != (f1 < 0.0))
+      {
+      // Insert in order of the linear estimate of the crossing
+      double t = t0 + (t1 - t0) * f0 / (f0 - f1);
+
+      int i = numberOfHits++;
+      while (i > 0 && hits[i - 1] > t)
+        {
+        hits[i] = hits[i - 1];
+        surfaces[i] = surfaces[i - 1];
+        i--;
+        }
+
+      hits[i] = t;
+      surfaces[i] = k;
+      }
+    }
+
+  for (int h = 0; h < numberOfHits && rgba[3] < work->OpacityThreshold; h++)
+    {
+    const double* surface = work->Isosurfaces + 5 * surfaces[h];
+    double value = surface[0];
+
+    // Refine the crossing on the interpolant rather than between the samples, with regula falsi
+    // steps, halving the function at an end kept twice so both ends converge (Illinois)
+    double a = t0;
+    double b = t1;
+    double fa = v0 - value;
+    double fb = v1 - value;
+    double t = hits[h];
+    int side = 0;
+
+    for (int i = 0; i < 4 && fa != fb; i++)
+      {
+      t = (a * fb - b * fa) / (fb - fa);
+
+      double p[3] = { start[0] + t * direction[0], start[1] + t * direction[1], start[2] + t * direction[2] };
+      double f = vtkBrickRayCastMapperEvaluate(work, values, corners, p, NULL) - value;
+
+      if (f == 0.0)
+        {
+        break;
+        }
+      else if ((f < 0.0) == (fa < 0.0))
+        {
+        a = t;
+        fa = f;
+        if (side == 1) fb *= 0.5;
+        side = 1;
+        }
+      else
+        {
+        b = t;
+        fb = f;
+        if (side == -1) fa *= 0.5;
+        side = -1;
+        }
+      }
+
+    // The normal from the analytic gradient of the interpolant
+    double p[3] = { start[0] + t * direction[0], start[1] + t * direction[1], start[2] + t * direction[2] };
+    double normal[3];
+    vtkBrickRayCastMapperEvaluate(work, values, corners, p, normal);
+
+    // Cosine between the normal and the direction to the viewer, with the normal pointing out of
+    // lobes of the sign of the isovalue
+    double d = 1.0;
+    if (vtkMath::Normalize(normal) > 0.0)
+      {
+      d = value >= 0.0 ? vtkMath::Dot(normal, direction) : -vtkMath::Dot(normal, direction);
+      }
+
+    // Translucent surfaces only show their front, more opaque toward the silhouette, like the
+    // translucent shader
+    float alpha = 1.0f;
+
+    if (surface[4] != 0.0)
+      {
+      if (d < 0.0)
+        {
+        continue;
+        }
+
+      alpha = static_cast<float>(1.0 - d);
+      }
+
+    // Per-pixel lighting with a headlight, like the opaque shader
+    double lambert = fabs(d);
+    double specular = pow(std::max(2.0 * d * d - 1.0, 0.0), 50.0);
+
+    float w = (1.0f - rgba[3]) * alpha;
+
+    for (int i = 0; i < 3; i++)
+      {
+      double lit = surface[1 + i] * (0.1 + lambert) + specular;
+      rgba[i] += w * static_cast<float>(std::min(lit, 1.0));
+      }
+
+    rgba[3] += w;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Composite the samples along a ray between tNear and tFar front to back
+template <class T>
+static void vtkBrickRayCastMapperCastRay(const vtkBrickRayCastMapperWork* work, const T* values,
+                                         const vtkIdType corners[8], const double start[3],
+                                         const double direction[3], double tNear, double tFar,
+                                         float rgba[4])
+{
+  const float* table = work->Table;
+  double tableShift = work->TableShift;
+  double tableScale = work->TableScale;
+
+  // Samples are evenly spaced from the near plane, so they stay put as rays are clipped
+  double step = work->Step;
+  double sample = ceil(tNear / step);
+  double lastSample = floor(tFar / step);
+
+  float v[batchSize];
+
+  while (sample <= lastSample && rgba[3] < work->OpacityThreshold)
+    {
+    // Skip bricks whose values are all transparent, to the first sample past the brick
+    int cell[3];
+    vtkIdType brick = vtkBrickRayCastMapperFindBrick(work, start, direction, sample * step, cell);
+
+    if (work->BrickEmpty[brick])
+      {
+      sample = vtkBrickRayCastMapperSkipBrick(work, cell, start, direction, tFar, sample);
+
+      continue;
+      }
+
+    int count = static_cast<int>(std::min(static_cast<double>(batchSize), lastSample - sample + 1.0));
+    vtkBrickRayCastMapperInterpolate(work, values, corners, start, direction, sample, count, v);
+
+    // Composite front to back, stopping once nearly opaque
+    for (int j = 0; j < count && rgba[3] < work->OpacityThreshold; j++)
+      {
+      int entry = static_cast<int>((v[j] - tableShift) * tableScale + 0.5);
+      entry = std::min(std::max(entry, 0), tableSize - 1);
+
+      const float* e = table + 4 * entry;
+
+      if (e[3] > 0.0f)
+        {
+        float w = 1.0f - rgba[3];
+
+        rgba[0] += w * e[0];
+        rgba[1] += w * e[1];
+        rgba[2] += w * e[2];
+        rgba[3] += w * e[3];
+        }
+      }
+
+    sample += count;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Find and shade the isosurfaces along a ray between tNear and tFar, front to back
+template <class T>
+static void vtkBrickRayCastMapperCastIsosurfaceRay(const vtkBrickRayCastMapperWork* work, const T* values,
+                                                   const vtkIdType corners[8], const double start[3],
+                                                   const double direction[3], double tNear, double tFar,
+                                                   float rgba[4])
+{
+  double step = work->Step;
+  double sample = ceil(tNear / step);
+  double lastSample = floor(tFar / step);
+
+  float v[batchSize];
+
+  double previousT = 0.0;
+  float previous = 0.0f;
+  bool hasPrevious = false;
+
+  while (sample <= lastSample && rgba[3] < work->OpacityThreshold)
+    {
+    // No isosurface passes through a skipped brick, but one can pass between the last sample 
+    // before it and the brick, so sample once inside it
+    int cell[3];
+    vtkIdType brick = vtkBrickRayCastMapperFindBrick(work, start, direction, sample * step, cell);
+    bool empty = work->BrickEmpty[brick] != 0;
+
+    int count = empty ? 1 : static_cast<int>(std::min(static_cast<double>(batchSize), lastSample - sample + 1.0));
+    vtkBrickRayCastMapperInterpolate(work, values, corners, start, direction, sample, count, v);
+
+    for (int j = 0; j < count && rgba[3] < work->OpacityThreshold; j++)
+      {
+      double t = (sample + j) * step;
+
+      if (hasPrevious)
+        {
+        vtkBrickRayCastMapperShadeCrossings(work, values, corners, start, direction,
+                                            previousT, previous, t, v[j], rgba);
+        }
+
+      previousT = t;
+      previous = v[j];
+      hasPrevious = true;
+      }
+
+    sample = empty ? vtkBrickRayCastMapperSkipBrick(work, cell, start, direction, tFar, sample) : sample + count;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Cast the rays of a tile of the image
+template <class T>
+static void vtkBrickRayCastMapperCastTile(vtkBrickRayCastMapperWork* work, const T* values, int tile)
+{
+  int x0 = (tile % work->NumberOfTiles[0]) * tileSize;
+  int y0 = (tile / work->NumberOfTiles[0]) * tileSize;
+  int x1 = std::min(x0 + tileSize, work->Size[0]);
+  int y1 = std::min(y0 + tileSize, work->Size[1]);
+
+  // Offsets of the corners of a cell from its first point
+  vtkIdType nx = work->Dimensions[0];
+  vtkIdType nxy = nx * work->Dimensions[1];
+  vtkIdType corners[8] = { 0, 1, nx, nx + 1, nxy, nxy + 1, nxy + nx, nxy + nx + 1 };
+
+  // Bounds of the grid
+  double bounds[6];
+  for (int i = 0; i < 3; i++)
+    {
+    bounds[2 * i] = work->Coordinates[i][0];
+    bounds[2 * i + 1] = work->Coordinates[i][work->Dimensions[i] - 1];
+    }
+
+  for (int y = y0; y < y1; y++)
+    {
+    for (int x = x0; x < x1; x++)
+      {
+      double vx = 2.0 * (work->Origin[0] + x + 0.5) / work->ViewportSize[0] - 1.0;
+      double vy = 2.0 * (work->Origin[1] + y + 0.5) / work->ViewportSize[1] - 1.0;
+
+      // The ray runs from the near plane to the geometry drawn at the middle of the pixel
+      double depth = 1.0;
+
+      if (work->Depths)
+        {
+        int dx = std::min(x * work->PixelSize + work->PixelSize / 2, work->DepthSize[0] - 1);
+        int dy = std::min(y * work->PixelSize + work->PixelSize / 2, work->DepthSize[1] - 1);
+
+        depth = work->Depths[(vtkIdType)dy * work->DepthSize[0] + dx];
+        }
+
+      double start[3];
+      double end[3];
+      vtkBrickRayCastMapperUnproject(work->ViewToData, vx, vy, -1.0, start);
+      vtkBrickRayCastMapperUnproject(work->ViewToData, vx, vy, 2.0 * depth - 1.0, end);
+
+      double direction[3] = { end[0] - start[0], end[1] - start[1], end[2] - start[2] };
+      double length = vtkMath::Normalize(direction);
+
+      // Clip the ray to the grid
+      double tNear = 0.0;
+      double tFar = length;
+
+      for (int i = 0; i < 3 && tNear < tFar; i++)
+        {
+        if (direction[i] == 0.0)
+          {
+          if (start[i] < bounds[2 * i] || start[i] > bounds[2 * i + 1])
+            {
+            tFar = -1.0;
+            }
+          }
+        else
+          {
+          double t0 = (bounds[2 * i] - start[i]) / direction[i];
+          double t1 = (bounds[2 * i + 1] - start[i]) / direction[i];
+
+          tNear = std::max(tNear, std::min(t0, t1));
+          tFar = std::min(tFar, std::max(t0, t1));
+          }
+        }
+
+      float rgba[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+      if (tNear < tFar)
+        {
+        if (work->RenderMode == vtkBrickRayCastMapper::IsosurfaceMode)
+          {
+          vtkBrickRayCastMapperCastIsosurfaceRay(work, values, corners, start, direction, tNear, tFar, rgba);
+          }
+        else
+          {
+          vtkBrickRayCastMapperCastRay(work, values, corners, start, direction, tNear, tFar, rgba);
+          }
+        }
+
+      unsigned char* pixel = work->Image + 4 * ((vtkIdType)y * work->MemoryWidth + x);
+
+      for (int i = 0; i < 4; i++)
+        {
+        pixel[i] = static_cast<unsigned char>(std::min(rgba[i], 1.0f) * 255.0f + 0.5f);
+        }
+      }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+vtkBrickRayCastMapper::vtkBrickRayCastMapper()
+{
+  this->SampleDistance = 0.0;
+  this->ImageSampleDistance = 1;
+  this->InteractiveImageSampleDistance = 2;
+  this->OpacityThreshold = 0.98;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  this->RenderMode = vtkBrickRayCastMapper::CompositeMode;
+
+  this->Grid = NULL;
+  this->GridTime = 0;
+  this->Scalars = NULL;
+  this->ScalarsTime = 0;
+  this->MeanSpacing = 1.0;
+
+  for (int i = 0; i < 3; i++)
+    {
+    this->Axes[i].Scale = 1.0;
+    this->NumberOfBricks[i] = 0;
+    }
+
+  this->TableRange[0] = 0.0;
+  this->TableRange[1] = 1.0;
+
+  this->ImageDisplayHelper.TakeReference(vtkRayCastImageDisplayHelper::New());
+  this->ImageDisplayHelper->SetPreMultipliedColors(1);
+
+  this->Threader = vtkSmartPointer<vtkMultiThreader>::New();
+}
+
+//----------------------------------------------------------------------------
+vtkBrickRayCastMapper::~vtkBrickRayCastMapper()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickRayCastMapper::AddIsosurface(double value, double r, double g, double b, int translucent)
+{
+  if (this->GetNumberOfIsosurfaces() >= maxIsosurfaces)
+    {
+    vtkErrorMacro("At most " << maxIsosurfaces << " isosurfaces can be rendered");
+    return;
+    }
+
+  this->Isosurfaces.push_back(value);
+  this->Isosurfaces.push_back(r);
+  this->Isosurfaces.push_back(g);
+  this->Isosurfaces.push_back(b);
+  this->Isosurfaces.push_back(translucent ? 1.0 : 0.0);
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickRayCastMapper::RemoveAllIsosurfaces()
+{
+  if (!this->Isosurfaces.empty())
+    {
+    this->Isosurfaces.clear();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkBrickRayCastMapper::GetNumberOfIsosurfaces()
+{
+  return (int)this->Isosurfaces.size() / 5;
+}
+
+//----------------------------------------------------------------------------
+int vtkBrickRayCastMapper::FillInputPortInformation(int, vtkInformation* info)
+{
+  // Grids or multi-block grids
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataObject");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+double* vtkBrickRayCastMapper::GetBounds()
+{
+  vtkDataSet* grid = vtkVolumeSlab::GetGrid(this->GetInputDataObject(0, 0));
+
+  if (grid && grid->GetNumberOfPoints() > 0)
+    {
+    grid->GetBounds(this->Bounds);
+    }
+  else
+    {
+    vtkMath::UninitializeBounds(this->Bounds);
+    }
+
+  return this->Bounds;
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickRayCastMapper::Render(vtkRenderer* ren, vtkVolume* vol)
+{
+  vtkDataSet* grid = vtkVolumeSlab::GetGrid(this->GetInputDataObject(0, 0));
+
+  if (!grid)
+    {
+    vtkErrorMacro("Input must be a uniform, rectilinear, or nested grid");
+    return;
+    }
+
+  vtkDataArray* scalars = grid->GetPointData()->GetScalars();
+
+  if (!scalars || scalars->GetNumberOfComponents() != 1)
+    {
+    vtkErrorMacro("Input needs single component point scalars");
+    return;
+    }
+
+  if (this->RenderMode == vtkBrickRayCastMapper::IsosurfaceMode && this->Isosurfaces.empty())
+    {
+    return;
+    }
+
+  if (!this->UpdateGrid(grid, scalars))
+    {
+    return;
+    }
+
+
+  // The interactor raises the desired update rate while interacting, and lowers it when still
+  bool interactive = ren->GetRenderWindow()->GetDesiredUpdateRate() >= 1.0;
+
+  int pixelSize = interactive ? this->InteractiveImageSampleDistance : this->ImageSampleDistance;
+
+  double sampleDistance = this->SampleDistance > 0.0 ? this->SampleDistance : this->MeanSpacing * 0.5;
+  if (interactive)
+    {
+    sampleDistance *= 2.0;
+    }
+
+  this->UpdateTable(vol, sampleDistance);
+
+
+  // Transform from data coordinates to view coordinates, and back
+  double aspect = ren->GetTiledAspectRatio();
+  vtkMatrix4x4* projection = ren->GetActiveCamera()->GetCompositeProjectionTransformMatrix(aspect, -1.0, 1.0);
+
+  double dataToView[16];
+  vtkMatrix4x4::Multiply4x4(*projection->Element, *vol->GetMatrix()->Element, dataToView);
+
+  vtkBrickRayCastMapperWork work;
+  vtkMatrix4x4::Invert(dataToView, work.ViewToData);
+
+  int* size = ren->GetSize();
+  int* origin = ren->GetOrigin();
+
+  for (int i = 0; i < 2; i++)
+    {
+    work.ViewportSize[i] = std::max(size[i] / pixelSize, 1);
+    }
+
+
+  // Cast the pixels the bounds of the grid project to, or all of them if the camera is inside
+  double bounds[6];
+  this->GetBounds(bounds);
+
+  int low[2] = { 0, 0 };
+  int high[2] = { work.ViewportSize[0] - 1, work.ViewportSize[1] - 1 };
+
+  double projected[2][2] = { { VTK_DOUBLE_MAX, VTK_DOUBLE_MAX }, { -VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX } };
+  bool inside = false;
+
+  for (int corner = 0; corner < 8; corner++)
+    {
+    double p[4] = { bounds[corner & 1], bounds[2 + ((corner >> 1) & 1)], bounds[4 + ((corner >> 2) & 1)], 1.0 };
+    double q[4];
+
+    for (int i = 0; i < 4; i++)
+      {
+      q[i] = dataToView[4 * i] * p[0] + dataToView[4 * i + 1] * p[1] + dataToView[4 * i + 2] * p[2] +
+             dataToView[4 * i + 3] * p[3];
+      }
+
+    if (q[3] <= 0.0)
+      {
+      inside = true;
+      break;
+      }
+
+    for (int i = 0; i < 2; i++)
+      {
+      double pixel = (q[i] / q[3] + 1.0) * 0.5 * work.ViewportSize[i];
+
+      projected[0][i] = std::min(projected[0][i], pixel);
+      projected[1][i] = std::max(projected[1][i], pixel);
+      }
+    }
+
+  if (!inside)
+    {
+    for (int i = 0; i < 2; i++)
+      {
+      low[i] = std::max(low[i], static_cast<int>(floor(projected[0][i])) - 1);
+      high[i] = std::min(high[i], static_cast<int>(ceil(projected[1][i])) + 1);
+      }
+    }
+
+  if (low[0] > high[0] || low[1] > high[1])
+    {
+    return;
+    }
+
+  for (int i = 0; i < 2; i++)
+    {
+    work.Origin[i] = low[i];
+    work.Size[i] = high[i] - low[i] + 1;
+    }
+
+
+  // Texture sizes are powers of two
+  int memorySize[2];
+  for (int i = 0; i < 2; i++)
+    {
+    memorySize[i] = 32;
+    while (memorySize[i] < work.Size[i])
+      {
+      memorySize[i] *= 2;
+      }
+    }
+
+  this->Image.resize((size_t)memorySize[0] * memorySize[1] * 4);
+
+  work.Image = &this->Image[0];
+  work.MemoryWidth = memorySize[0];
+
+
+  // End rays at opaque geometry already drawn
+  work.PixelSize = pixelSize;
+
+  int depthLow[2];
+  int depthHigh[2];
+  for (int i = 0; i < 2; i++)
+    {
+    depthLow[i] = origin[i] + work.Origin[i] * pixelSize;
+    depthHigh[i] = origin[i] + std::min((work.Origin[i] + work.Size[i]) * pixelSize, size[i]) - 1;
+
+    work.DepthSize[i] = depthHigh[i] - depthLow[i] + 1;
+    }
+
+  float* depths = ren->GetRenderWindow()->GetZbufferData(depthLow[0], depthLow[1], depthHigh[0], depthHigh[1]);
+  work.Depths = depths;
+
+
+  // Cast the tiles in parallel
+  work.Step = sampleDistance;
+  work.OpacityThreshold = static_cast<float>(this->OpacityThreshold);
+
+  work.NumberOfTiles[0] = (work.Size[0] + tileSize - 1) / tileSize;
+  work.NumberOfTiles[1] = (work.Size[1] + tileSize - 1) / tileSize;
+  work.NextTile = 0;
+
+  this->InitializeWork(&work);
+  this->Execute(&work, vtkBrickRayCastMapperWork::CastTiles);
+
+  delete [] depths;
+
+
+  // Draw the image over the renderer.  Rays already end at the geometry, so no depth test is needed.
+  this->ImageDisplayHelper->RenderTexture(vol, ren, memorySize, work.ViewportSize, work.Size,
+                                          work.Origin, -1.0f, &this->Image[0]);
+}
+
+//----------------------------------------------------------------------------
+bool vtkBrickRayCastMapper::UpdateGrid(vtkDataSet* grid, vtkDataArray* scalars)
+{
+  if (grid == this->Grid && grid->GetMTime() == this->GridTime &&
+      scalars == this->Scalars && scalars->GetMTime() == this->ScalarsTime)
+    {
+    return true;
+    }
+
+  this->Grid = NULL;
+  this->Scalars = NULL;
+
+  vtkIdType numberOfPoints = 1;
+  double spacing = 0.0;
+
+  for (int i = 0; i < 3; i++)
+    {
+    Axis& axis = this->Axes[i];
+    std::vector<double>& c = axis.Coordinates;
+
+    if (!vtkVolumeDifference::GetCoordinates(grid, i, c) || c.size() < 2)
+      {
+      vtkErrorMacro("Input must be a uniform, rectilinear, or nested grid with cells along each axis");
+      return false;
+      }
+
+    int numberOfCells = (int)c.size() - 1;
+    numberOfPoints *= (vtkIdType)c.size();
+
+    axis.InverseWidths.resize(numberOfCells);
+    for (int j = 0; j < numberOfCells; j++)
+      {
+      double width = c[j + 1] - c[j];
+      axis.InverseWidths[j] = width > 0.0 ? 1.0 / width : 0.0;
+      }
+
+    // The cell containing the start of each bin
+    double length = c[numberOfCells] - c[0];
+    int numberOfBins = numberOfCells * binsPerCell;
+
+    axis.Scale = length > 0.0 ? numberOfBins / length : 0.0;
+    axis.Cells.resize(numberOfBins);
+
+    int cell = 0;
+    for (int j = 0; j < numberOfBins; j++)
+      {
+      double x = c[0] + length * j / numberOfBins;
+
+      while (cell < numberOfCells - 1 && x >= c[cell + 1])
+        {
+        cell++;
+        }
+
+      axis.Cells[j] = cell;
+      }
+
+    spacing += length / numberOfCells;
+
+    this->NumberOfBricks[i] = (numberOfCells + brickSize - 1) >> brickShift;
+    }
+
+  if (scalars->GetNumberOfTuples() != numberOfPoints)
+    {
+    vtkErrorMacro("Scalars do not match the grid");
+    return false;
+    }
+
+  this->MeanSpacing = spacing / 3.0;
+
+
+  // Value ranges of the bricks, in parallel slabs of bricks
+  vtkIdType numberOfBricks = (vtkIdType)this->NumberOfBricks[0] * this->NumberOfBricks[1] * this->NumberOfBricks[2];
+
+  this->BrickRanges.resize(2 * numberOfBricks);
+  this->BrickEmpty.assign(numberOfBricks, 0);
+
+  this->Grid = grid;
+  this->GridTime = grid->GetMTime();
+  this->Scalars = scalars;
+  this->ScalarsTime = scalars->GetMTime();
+
+  vtkBrickRayCastMapperWork work;
+  this->InitializeWork(&work);
+  this->Execute(&work, vtkBrickRayCastMapperWork::ComputeBricks);
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickRayCastMapper::UpdateTable(vtkVolume* vol, double sampleDistance)
+{
+  vtkVolumeProperty* property = vol->GetProperty();
+
+  double* range = this->Scalars->GetRange();
+  this->TableRange[0] = range[0];
+  this->TableRange[1] = range[1] > range[0] ? range[1] : range[0] + 1.0;
+
+  std::vector<float> colors(3 * tableSize);
+  std::vector<float> opacities(tableSize);
+
+  if (property->GetColorChannels(0) == 1)
+    {
+    std::vector<float> grays(tableSize);
+    property->GetGrayTransferFunction(0)->GetTable(this->TableRange[0], this->TableRange[1], tableSize, &grays[0]);
+
+    for (int i = 0; i < tableSize; i++)
+      {
+      colors[3 * i] = colors[3 * i + 1] = colors[3 * i + 2] = grays[i];
+      }
+    }
+  else
+    {
+    property->GetRGBTransferFunction(0)->GetTable(this->TableRange[0], this->TableRange[1], tableSize, &colors[0]);
+    }
+
+  property->GetScalarOpacity(0)->GetTable(this->TableRange[0], this->TableRange[1], tableSize, &opacities[0]);
+
+
+  // Opacities are for the unit distance, so correct them for the sample distance, and count the
+  // entries that are not transparent up to each entry, to find transparent ranges quickly
+  double exponent = sampleDistance / std::max(property->GetScalarOpacityUnitDistance(0), 1e-6);
+
+  std::vector<int> visible(tableSize + 1, 0);
+  this->Table.resize(4 * tableSize);
+
+  for (int i = 0; i < tableSize; i++)
+    {
+    double opacity = std::min(std::max(static_cast<double>(opacities[i]), 0.0), 1.0);
+    float alpha = static_cast<float>(1.0 - pow(1.0 - opacity, exponent));
+
+    this->Table[4 * i] = colors[3 * i] * alpha;
+    this->Table[4 * i + 1] = colors[3 * i + 1] * alpha;
+    this->Table[4 * i + 2] = colors[3 * i + 2] * alpha;
+    this->Table[4 * i + 3] = alpha;
+
+    visible[i + 1] = visible[i] + (alpha > 0.0f ? 1 : 0);
+    }
+
+
+  // Samples in a brick are between its minimum and maximum, so no isosurface passes through it
+  // unless an isovalue is between them
+  if (this->RenderMode == vtkBrickRayCastMapper::IsosurfaceMode)
+    {
+    for (vtkIdType i = 0; i < (vtkIdType)this->BrickEmpty.size(); i++)
+      {
+      bool empty = true;
+
+      for (int j = 0; j < this->GetNumberOfIsosurfaces() && empty; j++)
+        {
+        double value = this->Isosurfaces[5 * j];
+        empty = value < this->BrickRanges[2 * i] || value > this->BrickRanges[2 * i + 1];
+        }
+
+      this->BrickEmpty[i] = empty;
+      }
+
+    return;
+    }
+
+  // Otherwise it is transparent if all table entries between theirs are
+  double scale = (tableSize - 1) / (this->TableRange[1] - this->TableRange[0]);
+
+  for (vtkIdType i = 0; i < (vtkIdType)this->BrickEmpty.size(); i++)
+    {
+    int first = static_cast<int>((this->BrickRanges[2 * i] - this->TableRange[0]) * scale + 0.5);
+    int last = static_cast<int>((this->BrickRanges[2 * i + 1] - this->TableRange[0]) * scale + 0.5);
+
+    first = std::min(std::max(first, 0), tableSize - 1);
+    last = std::min(std::max(last, 0), tableSize - 1);
+
+    this->BrickEmpty[i] = visible[last + 1] == visible[first];
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickRayCastMapper::InitializeWork(vtkBrickRayCastMapperWork* work)
+{
+  work->Scalars = this->Scalars;
+
+  for (int i = 0; i < 3; i++)
+    {
+    work->Dimensions[i] = (int)this->Axes[i].Coordinates.size();
+    work->Coordinates[i] = &this->Axes[i].Coordinates[0];
+    work->InverseWidths[i] = &this->Axes[i].InverseWidths[0];
+    work->Cells[i] = &this->Axes[i].Cells[0];
+    work->Scale[i] = this->Axes[i].Scale;
+
+    work->NumberOfBricks[i] = this->NumberOfBricks[i];
+    }
+
+  work->BrickRanges = &this->BrickRanges[0];
+  work->BrickEmpty = &this->BrickEmpty[0];
+
+  work->Table = this->Table.empty() ? NULL : &this->Table[0];
+  work->TableShift = this->TableRange[0];
+  work->TableScale = (tableSize - 1) / (this->TableRange[1] - this->TableRange[0]);
+
+  work->RenderMode = this->RenderMode;
+  work->NumberOfIsosurfaces = this->GetNumberOfIsosurfaces();
+  work->Isosurfaces = this->Isosurfaces.empty() ? NULL : &this->Isosurfaces[0];
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickRayCastMapper::Execute(vtkBrickRayCastMapperWork* work, int phase)
+{
+  int items = phase == vtkBrickRayCastMapperWork::ComputeBricks ?
+              this->NumberOfBricks[2] : work->NumberOfTiles[0] * work->NumberOfTiles[1];
+
+  work->Phase = phase;
+  work->NumberOfThreads = std::max(1, std::min(this->NumberOfThreads, items));
+
+  this->Threader->SetNumberOfThreads(work->NumberOfThreads);
+  this->Threader->SetSingleMethod(ExecutePhase, work);
+  this->Threader->SingleMethodExecute();
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkBrickRayCastMapper::ExecutePhase(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkBrickRayCastMapperWork* work = static_cast<vtkBrickRayCastMapperWork*>(info->UserData);
+
+  void* values = work->Scalars->GetVoidPointer(0);
+
+  if (work->Phase == vtkBrickRayCastMapperWork::ComputeBricks)
+    {
+    // Each thread takes a contiguous range of brick layers
+    int t = info->ThreadID;
+    int start = work->NumberOfBricks[2] * t / work->NumberOfThreads;
+    int end = work->NumberOfBricks[2] * (t + 1) / work->NumberOfThreads;
+
+    switch (work->Scalars->GetDataType())
+      {
+      vtkTemplateMacro(vtkBrickRayCastMapperBricks(work, static_cast<const VTK_TT*>(values), start, end));
+      }
+
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  // Take tiles until none are left, as rays through the middle of the volume take longer
+  int numberOfTiles = work->NumberOfTiles[0] * work->NumberOfTiles[1];
+
+  for (;;)
+    {
+    work->Lock.Lock();
+    int tile = work->NextTile++;
+    work->Lock.Unlock();
+
+    if (tile >= numberOfTiles)
+      {
+      break;
+      }
+
+    switch (work->Scalars->GetDataType())
+      {
+      vtkTemplateMacro(vtkBrickRayCastMapperCastTile(work, static_cast<const VTK_TT*>(values), tile));
+      }
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickRayCastMapper::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "SampleDistance: " << this->SampleDistance << "\n";
+  os << indent << "ImageSampleDistance: " << this->ImageSampleDistance << "\n";
+  os << indent << "InteractiveImageSampleDistance: " << this->InteractiveImageSampleDistance << "\n";
+  os << indent << "OpacityThreshold: " << this->OpacityThreshold << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "RenderMode: " << this->RenderMode << "\n";
+  os << indent << "NumberOfIsosurfaces: " << this->GetNumberOfIsosurfaces() << "\n";
+}
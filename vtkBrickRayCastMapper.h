@@ -0,0 +1,198 @@
+/*=========================================================================
+
+  Name:        vtkBrickRayCastMapper.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Direct volume rendering by ray casting on the CPU, for
+               machines without graphics hardware to render volumes.
+
+               The image is split into tiles, which are cast in parallel.
+               Rays composite samples front to back with the color and
+               scalar opacity transfer functions of the volume property,
+               and stop once nearly opaque.  The volume is divided into
+               bricks of 8x8x8 cells, with the range of values in each,
+               and rays skip bricks whose whole range is transparent
+               without sampling them.  Samples are interpolated in small
+               batches: each is located in the grid, then all are
+               interpolated together, four at a time with USE_SSE2.
+
+               Rays end at opaque geometry already drawn, read from the
+               depth buffer, so slices and surfaces intersect the volume
+               correctly.  While interacting, rays are cast for blocks of
+               pixels and samples are spaced farther apart.
+
+               In isosurface mode, rays find where they cross a list of
+               isovalues instead, with no mesh built, so changing an
+               isovalue costs a single frame.  Bricks are skipped unless
+               an isovalue is within their range.  Each crossing found
+               between samples is refined on the trilinear interpolant
+               of its cell with a few regula falsi steps, and shaded
+               with the gradient of the interpolant as its normal.
+               Translucent isosurfaces only show their front faces, more
+               opaque toward their silhouettes, like the translucent
+               isosurface shader.
+
+               Uniform and rectilinear grids are supported, and for
+               nested multi-block grids the first (coarsest) block is
+               used, as it covers the whole volume.
+
+=========================================================================*/
+
+
+#ifndef __vtkBrickRayCastMapper_h
+#define __vtkBrickRayCastMapper_h
+
+#include <vtkAbstractVolumeMapper.h>
+#include <vtkMultiThreader.h>
+#include <vtkSmartPointer.h>
+
+#include <vector>
+
+class vtkDataArray;
+class vtkDataSet;
+class vtkRayCastImageDisplayHelper;
+
+struct vtkBrickRayCastMapperWork;
+
+
+class vtkBrickRayCastMapper : public vtkAbstractVolumeMapper
+{
+public:
+  static vtkBrickRayCastMapper *New();
+  vtkTypeMacro(vtkBrickRayCastMapper, vtkAbstractVolumeMapper);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Distance between samples along a ray, in world units, or 0 to use half
+  // the mean spacing of the grid.  Defaults to 0.
+  vtkSetClampMacro(SampleDistance, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(SampleDistance, double);
+
+  // Description:
+  // Width in screen pixels of the block of pixels each ray is cast for,
+  // when still and while interacting.  Default to 1 and 2.  Samples are
+  // also twice as far apart while interacting.
+  vtkSetClampMacro(ImageSampleDistance, int, 1, 16);
+  vtkGetMacro(ImageSampleDistance, int);
+  vtkSetClampMacro(InteractiveImageSampleDistance, int, 1, 16);
+  vtkGetMacro(InteractiveImageSampleDistance, int);
+
+  // Description:
+  // Opacity at which a ray stops.  Defaults to 0.98.
+  vtkSetClampMacro(OpacityThreshold, double, 0.0, 1.0);
+  vtkGetMacro(OpacityThreshold, double);
+
+  // Description:
+  // Composite the samples with the transfer functions of the volume
+  // property, or render the isosurfaces added.  Defaults to composite.
+  enum
+  {
+    CompositeMode = 0,
+    IsosurfaceMode
+  };
+  vtkSetClampMacro(RenderMode, int, CompositeMode, IsosurfaceMode);
+  vtkGetMacro(RenderMode, int);
+  void SetRenderModeToComposite() { this->SetRenderMode(CompositeMode); }
+  void SetRenderModeToIsosurfaces() { this->SetRenderMode(IsosurfaceMode); }
+
+  // Description:
+  // Isosurfaces rendered in isosurface mode, with their colors and whether
+  // they are translucent.  At most 8 are rendered.  Isosurfaces of positive
+  // values enclose greater values, and of negative values lesser values.
+  void AddIsosurface(double value, double r, double g, double b, int translucent);
+  void RemoveAllIsosurfaces();
+  int GetNumberOfIsosurfaces();
+
+  // Description:
+  // Number of threads used.  Defaults to the number of processors.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Bounds of the grid rendered.
+  virtual double* GetBounds();
+  virtual void GetBounds(double bounds[6]) { this->Superclass::GetBounds(bounds); }
+
+  // Description:
+  // WARNING: INTERNAL METHOD - NOT INTENDED FOR GENERAL USE
+  // Cast the image and draw it over the renderer.
+  virtual void Render(vtkRenderer* ren, vtkVolume* vol);
+  virtual void ReleaseGraphicsResources(vtkWindow*) {}
+
+protected:
+  vtkBrickRayCastMapper();
+  ~vtkBrickRayCastMapper();
+
+  virtual int FillInputPortInformation(int port, vtkInformation* info);
+
+  // Coordinates of the grid planes along an axis, with a table of the cell at evenly spaced
+  // coordinates, so the cell containing a coordinate is found in a step or two
+  struct Axis
+  {
+    std::vector<double> Coordinates;
+    std::vector<double> InverseWidths;
+    std::vector<int> Cells;
+    double Scale;
+  };
+
+  // Update the axes and the value ranges of the bricks if the grid or scalars changed.  Returns
+  // false if the grid cannot be rendered.
+  bool UpdateGrid(vtkDataSet* grid, vtkDataArray* scalars);
+
+  // Build the color and opacity table from the volume property, corrected for the sample
+  // distance, and mark the bricks whose values are all transparent, or, in isosurface mode, that
+  // no isosurface passes through
+  void UpdateTable(vtkVolume* vol, double sampleDistance);
+
+  // Parallel pass over the bricks or the tiles of the image
+  void Execute(vtkBrickRayCastMapperWork* work, int phase);
+
+  // Fill the grid, brick, and table fields of the work
+  void InitializeWork(vtkBrickRayCastMapperWork* work);
+
+  // Thread entry point
+  static VTK_THREAD_RETURN_TYPE ExecutePhase(void* arg);
+
+  double SampleDistance;
+  int ImageSampleDistance;
+  int InteractiveImageSampleDistance;
+  double OpacityThreshold;
+  int NumberOfThreads;
+  int RenderMode;
+
+  // Value, color, and translucency of each isosurface
+  std::vector<double> Isosurfaces;
+
+  // The grid and scalars the axes and bricks are for
+  vtkDataSet* Grid;
+  unsigned long GridTime;
+  vtkDataArray* Scalars;
+  unsigned long ScalarsTime;
+
+  Axis Axes[3];
+  double MeanSpacing;
+
+  // Minimum and maximum value of each brick, and whether all of its values are transparent
+  int NumberOfBricks[3];
+  std::vector<float> BrickRanges;
+  std::vector<unsigned char> BrickEmpty;
+
+  // Color, premultiplied by opacity, and opacity for evenly spaced values over the scalar range
+  std::vector<float> Table;
+  double TableRange[2];
+
+  // The image cast, and what draws it
+  std::vector<unsigned char> Image;
+  vtkSmartPointer<vtkRayCastImageDisplayHelper> ImageDisplayHelper;
+
+  vtkSmartPointer<vtkMultiThreader> Threader;
+
+private:
+  vtkBrickRayCastMapper(const vtkBrickRayCastMapper&);  // Not implemented.
+  void operator=(const vtkBrickRayCastMapper&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,144 @@
+/*=========================================================================
+
+  Name:        vtkFeatureTrackColors.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Colors the points of an isosurface by lobe track.
+
+=========================================================================*/
+
+
+#include "vtkFeatureTrackColors.h"
+
+#include "FeatureLabels.h"
+
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <cmath>
+
+
+vtkStandardNewMacro(vtkFeatureTrackColors);
+
+
+//----------------------------------------------------------------------------
+vtkFeatureTrackColors::vtkFeatureTrackColors()
+{
+  this->Labels = NULL;
+  this->Sign = 1;
+}
+
+//----------------------------------------------------------------------------
+vtkFeatureTrackColors::~vtkFeatureTrackColors()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkFeatureTrackColors::SetLabels(FeatureLabels* labels)
+{
+  if (labels != this->Labels)
+    {
+    this->Labels = labels;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+FeatureLabels* vtkFeatureTrackColors::GetLabels()
+{
+  return this->Labels;
+}
+
+//----------------------------------------------------------------------------
+void vtkFeatureTrackColors::GetTrackColor(int track, double rgb[3])
+{
+  if (track == 0)
+    {
+    rgb[0] = rgb[1] = rgb[2] = 0.5;
+    return;
+    }
+
+  // Step around the hue circle by the golden ratio, so consecutive tracks are far apart
+  double hue = fmod(track * 0.618033988749895, 1.0);
+
+  vtkMath::HSVToRGB(hue, 0.75, 1.0, &rgb[0], &rgb[1], &rgb[2]);
+}
+
+//----------------------------------------------------------------------------
+int vtkFeatureTrackColors::RequestData(vtkInformation*,
+                                       vtkInformationVector** inputVector,
+                                       vtkInformationVector* outputVector)
+{
+  vtkPolyData* input = vtkPolyData::GetData(inputVector[0], 0);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector, 0);
+
+  if (!input || !output)
+    {
+    return 0;
+    }
+
+  output->ShallowCopy(input);
+
+  if (!this->Labels)
+    {
+    return 1;
+    }
+
+  this->Labels->Update();
+
+  vtkIdType numPoints = input->GetNumberOfPoints();
+
+  vtkSmartPointer<vtkUnsignedCharArray> colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  colors->SetName("TrackColors");
+  colors->SetNumberOfComponents(3);
+  colors->SetNumberOfTuples(numPoints);
+
+  // Neighboring points are usually in the same lobe
+  int lastTrack = -1;
+  unsigned char color[3] = { 0, 0, 0 };
+
+  for (vtkIdType i = 0; i < numPoints; i++)
+    {
+    double point[3];
+    input->GetPoint(i, point);
+
+    int track = this->Labels->GetTrack(point, this->Sign);
+
+    if (track != lastTrack)
+      {
+      double rgb[3];
+      GetTrackColor(track, rgb);
+
+      for (int j = 0; j < 3; j++)
+        {
+        color[j] = (unsigned char)(rgb[j] * 255.0 + 0.5);
+        }
+
+      lastTrack = track;
+      }
+
+    colors->SetTupleValue(i, color);
+    }
+
+  output->GetPointData()->SetScalars(colors);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkFeatureTrackColors::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Labels: " << this->Labels << "\n";
+  os << indent << "Sign: " << this->Sign << "\n";
+}
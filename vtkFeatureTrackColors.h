@@ -0,0 +1,62 @@
+/*=========================================================================
+
+  Name:        vtkFeatureTrackColors.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Colors the points of an isosurface by the track of the lobe
+               they belong to, looked up in FeatureLabels.  Colors are
+               stored as unsigned char RGB point scalars, so mappers use
+               them directly.  Without labels, the input is passed
+               through unchanged.
+
+=========================================================================*/
+
+
+#ifndef __vtkFeatureTrackColors_h
+#define __vtkFeatureTrackColors_h
+
+#include <vtkPolyDataAlgorithm.h>
+
+class FeatureLabels;
+
+
+class vtkFeatureTrackColors : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkFeatureTrackColors *New();
+  vtkTypeMacro(vtkFeatureTrackColors, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Labels to look up tracks in, or NULL to pass the input through.  Not
+  // reference counted.
+  void SetLabels(FeatureLabels* labels);
+  FeatureLabels* GetLabels();
+
+  // Description:
+  // Sign of the lobes the surface bounds: 1 for positive, -1 for negative.
+  vtkSetMacro(Sign, int);
+  vtkGetMacro(Sign, int);
+
+  // Description:
+  // Color for a track.  Track 0, for points not in a lobe, is gray.
+  static void GetTrackColor(int track, double rgb[3]);
+
+protected:
+  vtkFeatureTrackColors();
+  ~vtkFeatureTrackColors();
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+  FeatureLabels* Labels;
+  int Sign;
+
+private:
+  vtkFeatureTrackColors(const vtkFeatureTrackColors&);  // Not implemented.
+  void operator=(const vtkFeatureTrackColors&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,434 @@
+/*=========================================================================
+
+  Name:        vtkNestedGridBlanking.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Prepares a nested, multi-block grid for contouring and
+               cutting.
+
+=========================================================================*/
+
+
+#include "vtkNestedGridBlanking.h"
+
+#include <vtkCellData.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkDataArray.h>
+#include <vtkFieldData.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkIntArray.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUniformGrid.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+
+vtkStandardNewMacro(vtkNestedGridBlanking);
+
+
+//----------------------------------------------------------------------------
+// Sort blocks from coarsest to finest
+static bool CoarserThan(vtkUniformGrid* a, vtkUniformGrid* b)
+{
+  return vtkNestedGridBlanking::GetNestingLevel(a) < vtkNestedGridBlanking::GetNestingLevel(b);
+}
+
+//----------------------------------------------------------------------------
+// Inclusive bounds test
+static bool BoundsContain(const double bounds[6], const double point[3], double tolerance)
+{
+  for (int i = 0; i < 3; i++)
+    {
+    if (point[i] < bounds[2 * i] - tolerance || point[i] > bounds[2 * i + 1] + tolerance)
+      {
+      return false;
+      }
+    }
+
+  return true;
+}
+
+
+//----------------------------------------------------------------------------
+vtkNestedGridBlanking::vtkNestedGridBlanking()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkNestedGridBlanking::~vtkNestedGridBlanking()
+{
+}
+
+//----------------------------------------------------------------------------
+const char* vtkNestedGridBlanking::NestingLevelArrayName()
+{
+  return "NestingLevel";
+}
+
+//----------------------------------------------------------------------------
+int vtkNestedGridBlanking::GetNestingLevel(vtkDataObject* block)
+{
+  if (!block || !block->GetFieldData())
+    {
+    return -1;
+    }
+
+  vtkIntArray* level = vtkIntArray::SafeDownCast(
+    block->GetFieldData()->GetArray(NestingLevelArrayName()));
+
+  return level ? level->GetValue(0) : -1;
+}
+
+//----------------------------------------------------------------------------
+int vtkNestedGridBlanking::FindFinestLevel(const std::vector<vtkUniformGrid*>& blocks, const double point[3])
+{
+  int finest = -1;
+
+  for (int i = 0; i < (int)blocks.size(); i++)
+    {
+    double bounds[6];
+    blocks[i]->GetBounds(bounds);
+
+    if (BoundsContain(bounds, point, 0.0))
+      {
+      finest = std::max(finest, GetNestingLevel(blocks[i]));
+      }
+    }
+
+  return finest;
+}
+
+//----------------------------------------------------------------------------
+void vtkNestedGridBlanking::GetBlocks(vtkDataObject* input, std::vector<vtkUniformGrid*>& blocks)
+{
+  blocks.clear();
+
+  vtkCompositeDataSet* composite = vtkCompositeDataSet::SafeDownCast(input);
+  if (!composite)
+    {
+    return;
+    }
+
+  vtkSmartPointer<vtkCompositeDataIterator> it;
+  it.TakeReference(composite->NewIterator());
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkUniformGrid* block = vtkUniformGrid::SafeDownCast(it->GetCurrentDataObject());
+    if (block)
+      {
+      blocks.push_back(block);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkNestedGridBlanking::InterpolateScalar(vtkImageData* image, const double point[3])
+{
+  double origin[3];
+  double spacing[3];
+  int extent[6];
+  image->GetOrigin(origin);
+  image->GetSpacing(spacing);
+  image->GetExtent(extent);
+
+  int i0[3];
+  int i1[3];
+  double t[3];
+  for (int i = 0; i < 3; i++)
+    {
+    if (extent[2 * i] == extent[2 * i + 1])
+      {
+      // Flat along this axis
+      i0[i] = i1[i] = extent[2 * i];
+      t[i] = 0.0;
+      continue;
+      }
+
+    double x = (point[i] - origin[i]) / spacing[i];
+    x = std::max((double)extent[2 * i], std::min((double)extent[2 * i + 1], x));
+
+    i0[i] = std::min((int)floor(x), extent[2 * i + 1] - 1);
+    i1[i] = i0[i] + 1;
+    t[i] = x - i0[i];
+    }
+
+  double value = 0.0;
+  for (int c = 0; c < 8; c++)
+    {
+    int ijk[3];
+    double w = 1.0;
+    for (int i = 0; i < 3; i++)
+      {
+      bool upper = (c >> i) & 1;
+      ijk[i] = upper ? i1[i] : i0[i];
+      w *= upper ? t[i] : 1.0 - t[i];
+      }
+
+    if (w > 0.0)
+      {
+      value += w * image->GetScalarComponentAsDouble(ijk[0], ijk[1], ijk[2], 0);
+      }
+    }
+
+  return value;
+}
+
+//----------------------------------------------------------------------------
+int vtkNestedGridBlanking::FillInputPortInformation(int, vtkInformation* info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkCompositeDataSet");
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkNestedGridBlanking::RequestData(vtkInformation*,
+                                       vtkInformationVector** inputVector,
+                                       vtkInformationVector* outputVector)
+{
+  vtkCompositeDataSet* input = vtkCompositeDataSet::GetData(inputVector[0], 0);
+  vtkMultiBlockDataSet* output = vtkMultiBlockDataSet::GetData(outputVector, 0);
+
+  if (!input || !output)
+    {
+    return 0;
+    }
+
+  // Convert image data leaves to uniform grids sharing the input arrays until conformed
+  std::vector<vtkUniformGrid*> blocks;
+  std::vector<double> cellSizes;
+
+  vtkSmartPointer<vtkCompositeDataIterator> it;
+  it.TakeReference(input->NewIterator());
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkImageData* image = vtkImageData::SafeDownCast(it->GetCurrentDataObject());
+    if (!image || !image->GetPointData()->GetScalars())
+      {
+      vtkWarningMacro(<< "Skipping block that is not image data with scalars");
+      continue;
+      }
+
+    vtkUniformGrid* block = vtkUniformGrid::New();
+    block->CopyStructure(image);
+    block->GetPointData()->ShallowCopy(image->GetPointData());
+    block->GetCellData()->ShallowCopy(image->GetCellData());
+    blocks.push_back(block);
+
+    cellSizes.push_back(image->GetSpacing()[0]);
+    }
+
+  if (blocks.empty())
+    {
+    vtkErrorMacro(<< "No image data blocks found");
+    return 0;
+    }
+
+  // Assign nesting levels from the distinct cell sizes, coarsest first
+  std::vector<double> levels(cellSizes);
+  std::sort(levels.begin(), levels.end(), std::greater<double>());
+  std::vector<double> distinct;
+  for (int i = 0; i < (int)levels.size(); i++)
+    {
+    if (distinct.empty() || levels[i] < distinct.back() * 0.99)
+      {
+      distinct.push_back(levels[i]);
+      }
+    }
+
+  for (int i = 0; i < (int)blocks.size(); i++)
+    {
+    int level = 0;
+    while (level + 1 < (int)distinct.size() && cellSizes[i] < distinct[level] * 0.99)
+      {
+      level++;
+      }
+
+    vtkSmartPointer<vtkIntArray> levelArray = vtkSmartPointer<vtkIntArray>::New();
+    levelArray->SetName(NestingLevelArrayName());
+    levelArray->InsertNextValue(level);
+    blocks[i]->GetFieldData()->AddArray(levelArray);
+    }
+
+  std::stable_sort(blocks.begin(), blocks.end(), CoarserThan);
+
+  // Conform from coarse to fine, so each block interpolates already-conformed parents
+  for (int i = 0; i < (int)blocks.size(); i++)
+    {
+    if (GetNestingLevel(blocks[i]) > 0)
+      {
+      ConformBoundary(blocks[i], blocks);
+      }
+
+    BlankCoveredCells(blocks[i], blocks);
+    }
+
+  output->SetNumberOfBlocks(blocks.size());
+  for (int i = 0; i < (int)blocks.size(); i++)
+    {
+    output->SetBlock(i, blocks[i]);
+    blocks[i]->Delete();
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkNestedGridBlanking::BlankCoveredCells(vtkUniformGrid* block, const std::vector<vtkUniformGrid*>& blocks)
+{
+  int level = GetNestingLevel(block);
+
+  double origin[3];
+  double spacing[3];
+  int extent[6];
+  block->GetOrigin(origin);
+  block->GetSpacing(spacing);
+  block->GetExtent(extent);
+
+  int dims[3];
+  block->GetDimensions(dims);
+
+  for (int b = 0; b < (int)blocks.size(); b++)
+    {
+    if (GetNestingLevel(blocks[b]) <= level)
+      {
+      continue;
+      }
+
+    double bounds[6];
+    blocks[b]->GetBounds(bounds);
+
+    // Range of this block's cells that lie inside the finer block
+    int cellRange[6];
+    bool empty = false;
+    for (int i = 0; i < 3; i++)
+      {
+      double lo = (bounds[2 * i] - origin[i]) / spacing[i];
+      double hi = (bounds[2 * i + 1] - origin[i]) / spacing[i];
+
+      cellRange[2 * i] = std::max(extent[2 * i], (int)ceil(lo - 1e-3));
+      cellRange[2 * i + 1] = std::min(extent[2 * i + 1], (int)floor(hi + 1e-3)) - 1;
+
+      if (cellRange[2 * i] > cellRange[2 * i + 1])
+        {
+        empty = true;
+        }
+      }
+
+    if (empty)
+      {
+      continue;
+      }
+
+    for (int k = cellRange[4]; k <= cellRange[5]; k++)
+      {
+      for (int j = cellRange[2]; j <= cellRange[3]; j++)
+        {
+        for (int i = cellRange[0]; i <= cellRange[1]; i++)
+          {
+          vtkIdType cellId = (i - extent[0]) +
+                             (dims[0] - 1) * ((j - extent[2]) + (dims[1] - 1) * (k - extent[4]));
+          block->BlankCell(cellId);
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkNestedGridBlanking::ConformBoundary(vtkUniformGrid* block, const std::vector<vtkUniformGrid*>& blocks)
+{
+  int level = GetNestingLevel(block);
+
+  int dims[3];
+  block->GetDimensions(dims);
+
+  double spacing[3];
+  block->GetSpacing(spacing);
+
+  // Conform a copy of the scalars, leaving the input's values untouched
+  vtkDataArray* inputScalars = block->GetPointData()->GetScalars();
+  vtkSmartPointer<vtkDataArray> scalars;
+  scalars.TakeReference(inputScalars->NewInstance());
+  scalars->DeepCopy(inputScalars);
+  block->GetPointData()->SetScalars(scalars);
+
+  for (int k = 0; k < dims[2]; k++)
+    {
+    for (int j = 0; j < dims[1]; j++)
+      {
+      // Only the first and last points of interior rows are on the boundary
+      bool face = k == 0 || k == dims[2] - 1 || j == 0 || j == dims[1] - 1;
+      int step = face ? 1 : std::max(dims[0] - 1, 1);
+
+      for (int i = 0; i < dims[0]; i += step)
+        {
+        int ijk[3] = { i, j, k };
+
+        vtkIdType id = i + dims[0] * (j + dims[1] * k);
+
+        double p[3];
+        block->GetPoint(id, p);
+
+        // Step half a cell outward to see what lies on the other side of the boundary
+        double outside[3];
+        for (int a = 0; a < 3; a++)
+          {
+          double n = 0.0;
+          if (dims[a] > 1 && ijk[a] == 0) n = -1.0;
+          else if (dims[a] > 1 && ijk[a] == dims[a] - 1) n = 1.0;
+
+          outside[a] = p[a] + n * spacing[a] * 0.5;
+          }
+
+        int outsideLevel = FindFinestLevel(blocks, outside);
+        if (outsideLevel < 0 || outsideLevel >= level)
+          {
+          // Domain boundary, or next to a block at least as fine
+          continue;
+          }
+
+        // Interpolate from the finest coarser block containing the point
+        vtkUniformGrid* parent = NULL;
+        for (int b = 0; b < (int)blocks.size(); b++)
+          {
+          int parentLevel = GetNestingLevel(blocks[b]);
+          if (parentLevel >= level || (parent && parentLevel <= GetNestingLevel(parent)))
+            {
+            continue;
+            }
+
+          double bounds[6];
+          blocks[b]->GetBounds(bounds);
+
+          if (BoundsContain(bounds, p, spacing[0] * 1e-3))
+            {
+            parent = blocks[b];
+            }
+          }
+
+        if (parent)
+          {
+          scalars->SetComponent(id, 0, InterpolateScalar(parent, p));
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkNestedGridBlanking::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
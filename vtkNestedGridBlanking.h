@@ -0,0 +1,90 @@
+/*=========================================================================
+
+  Name:        vtkNestedGridBlanking.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Prepares a nested, multi-block grid (a coarse box plus finer
+               sub-grids, e.g. around nuclei) for contouring and cutting.
+               Each image data block is converted to a vtkUniformGrid,
+               assigned a nesting level based on its spacing, and has the
+               cells covered by finer blocks blanked.  Points on the outer
+               faces of finer blocks are conformed to the interpolated
+               values of the enclosing coarser block, so that surface
+               crossings on shared coarse edges coincide at block
+               boundaries.
+
+               Fine block boundaries are assumed to lie on coarse grid
+               points, as is the case for typical nested grids.
+
+               The output is a flat vtkMultiBlockDataSet sorted from
+               coarsest to finest.  Coarsest blocks share their scalars
+               with the input.  Finer blocks get their own copy to
+               conform, so the input is left as it was, and memory stays
+               proportional to the original data plus one visibility byte
+               per cell of blanked blocks.
+
+=========================================================================*/
+
+
+#ifndef __vtkNestedGridBlanking_h
+#define __vtkNestedGridBlanking_h
+
+#include <vtkMultiBlockDataSetAlgorithm.h>
+
+#include <vector>
+
+class vtkImageData;
+class vtkUniformGrid;
+
+
+class vtkNestedGridBlanking : public vtkMultiBlockDataSetAlgorithm
+{
+public:
+  static vtkNestedGridBlanking *New();
+  vtkTypeMacro(vtkNestedGridBlanking, vtkMultiBlockDataSetAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Name of the integer field data array holding each block's nesting level.
+  // Level 0 is the coarsest.
+  static const char* NestingLevelArrayName();
+
+  // Description:
+  // Get the nesting level stored on a block of the output, or -1 if none.
+  static int GetNestingLevel(vtkDataObject* block);
+
+  // Description:
+  // Return the finest nesting level of the blocks strictly containing the
+  // given point, or -1 if the point is outside of all blocks.
+  static int FindFinestLevel(const std::vector<vtkUniformGrid*>& blocks, const double point[3]);
+
+  // Description:
+  // Gather the leaf blocks of the output in order.
+  static void GetBlocks(vtkDataObject* input, std::vector<vtkUniformGrid*>& blocks);
+
+  // Description:
+  // Trilinearly interpolate the active scalars of an image at the given point.
+  static double InterpolateScalar(vtkImageData* image, const double point[3]);
+
+protected:
+  vtkNestedGridBlanking();
+  ~vtkNestedGridBlanking();
+
+  virtual int FillInputPortInformation(int port, vtkInformation* info);
+  virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+  // Blank cells of a block covered by any finer block
+  void BlankCoveredCells(vtkUniformGrid* block, const std::vector<vtkUniformGrid*>& blocks);
+
+  // Set boundary values of a copy of a fine block's scalars from the enclosing coarser blocks
+  void ConformBoundary(vtkUniformGrid* block, const std::vector<vtkUniformGrid*>& blocks);
+
+private:
+  vtkNestedGridBlanking(const vtkNestedGridBlanking&);  // Not implemented.
+  void operator=(const vtkNestedGridBlanking&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,402 @@
+/*=========================================================================
+
+  Name:        vtkNestedGridContourFilter.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Contours a nested, multi-block grid.
+
+=========================================================================*/
+
+
+#include "vtkNestedGridContourFilter.h"
+
+#include "vtkNestedGridBlanking.h"
+
+#include <vtkAppendPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkCleanPolyData.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkContourTriangulator.h>
+#include <vtkDataArray.h>
+#include <vtkFeatureEdges.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMultiThreader.h>
+#include <vtkMutexLock.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUniformGrid.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+vtkStandardNewMacro(vtkNestedGridContourFilter);
+
+
+//----------------------------------------------------------------------------
+// State shared by the contouring threads
+struct vtkNestedGridContourWork
+{
+  vtkNestedGridContourFilter* Filter;
+  std::vector<vtkUniformGrid*> Blocks;
+  std::vector<vtkSmartPointer<vtkPolyData> > Surfaces;
+  std::vector<vtkSmartPointer<vtkPolyData> > Edges;
+  bool NeedEdges;
+  int NextBlock;
+  vtkSimpleMutexLock Lock;
+};
+
+//----------------------------------------------------------------------------
+// Return the axis of the face of the bounds that the point lies on, or -1
+static int FindFace(const double bounds[6], const double point[3], double tolerance, int& side)
+{
+  for (int a = 0; a < 3; a++)
+    {
+    for (int s = 0; s < 2; s++)
+      {
+      if (fabs(point[a] - bounds[2 * a + s]) > tolerance)
+        {
+        continue;
+        }
+
+      // Must also be within the face rectangle
+      bool inside = true;
+      for (int b = 0; b < 3; b++)
+        {
+        if (b != a && (point[b] < bounds[2 * b] - tolerance || point[b] > bounds[2 * b + 1] + tolerance))
+          {
+          inside = false;
+          }
+        }
+
+      if (inside)
+        {
+        side = s;
+        return a;
+        }
+      }
+    }
+
+  return -1;
+}
+
+
+//----------------------------------------------------------------------------
+vtkNestedGridContourFilter::vtkNestedGridContourFilter()
+{
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+}
+
+//----------------------------------------------------------------------------
+vtkNestedGridContourFilter::~vtkNestedGridContourFilter()
+{
+}
+
+//----------------------------------------------------------------------------
+int vtkNestedGridContourFilter::FillInputPortInformation(int, vtkInformation* info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkCompositeDataSet");
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkNestedGridContourFilter::RequestUpdateExtent(vtkInformation*,
+                                                    vtkInformationVector**,
+                                                    vtkInformationVector*)
+{
+  // Always request the whole nested grid
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkNestedGridContourFilter::RequestData(vtkInformation*,
+                                            vtkInformationVector** inputVector,
+                                            vtkInformationVector* outputVector)
+{
+  vtkCompositeDataSet* input = vtkCompositeDataSet::GetData(inputVector[0], 0);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector, 0);
+
+  if (!input || !output)
+    {
+    return 0;
+    }
+
+  vtkNestedGridContourWork work;
+  work.Filter = this;
+  vtkNestedGridBlanking::GetBlocks(input, work.Blocks);
+  work.NextBlock = 0;
+
+  int numBlocks = (int)work.Blocks.size();
+  if (numBlocks == 0)
+    {
+    return 1;
+    }
+
+  // Only multiple levels need stitching
+  int maxLevel = 0;
+  for (int i = 0; i < numBlocks; i++)
+    {
+    maxLevel = std::max(maxLevel, vtkNestedGridBlanking::GetNestingLevel(work.Blocks[i]));
+    }
+  work.NeedEdges = maxLevel > 0;
+
+  for (int i = 0; i < numBlocks; i++)
+    {
+    work.Surfaces.push_back(vtkSmartPointer<vtkPolyData>::New());
+    work.Edges.push_back(vtkSmartPointer<vtkPolyData>::New());
+    }
+
+
+  // Contour the blocks in parallel
+  vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+  threader->SetNumberOfThreads(std::min(this->NumberOfThreads, numBlocks));
+  threader->SetSingleMethod(ContourBlocks, &work);
+  threader->SingleMethodExecute();
+
+
+  // Combine the surfaces and the stitching between them
+  vtkSmartPointer<vtkAppendPolyData> append = vtkSmartPointer<vtkAppendPolyData>::New();
+
+  for (int i = 0; i < numBlocks; i++)
+    {
+    if (work.Surfaces[i]->GetNumberOfCells() > 0)
+      {
+      append->AddInput(work.Surfaces[i]);
+      }
+
+    if (vtkNestedGridBlanking::GetNestingLevel(work.Blocks[i]) > 0)
+      {
+      vtkSmartPointer<vtkPolyData> stitch = vtkSmartPointer<vtkPolyData>::New();
+      StitchBlock(i, &work, stitch);
+
+      if (stitch->GetNumberOfCells() > 0)
+        {
+        append->AddInput(stitch);
+        }
+      }
+    }
+
+  if (append->GetNumberOfInputConnections(0) > 0)
+    {
+    append->Update();
+    output->ShallowCopy(append->GetOutput());
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkNestedGridContourFilter::ContourBlocks(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkNestedGridContourWork* work = static_cast<vtkNestedGridContourWork*>(info->UserData);
+
+  // Take blocks from the shared list until none are left, so large blocks don't stall other threads
+  for (;;)
+    {
+    work->Lock.Lock();
+    int i = work->NextBlock++;
+    work->Lock.Unlock();
+
+    if (i >= (int)work->Blocks.size())
+      {
+      break;
+      }
+
+    work->Filter->ContourBlock(work->Blocks[i], work->Surfaces[i], work->Edges[i], work->NeedEdges);
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkNestedGridContourFilter::ContourBlock(vtkUniformGrid* block, vtkPolyData* surface,
+                                              vtkPolyData* edges, bool needEdges)
+{
+  // Give each thread its own copy of the block structure so pipelines don't share data objects.
+  // Blocks without blanked cells are contoured as image data to use the synchronized templates.
+  vtkSmartPointer<vtkDataSet> data;
+  if (block->GetCellBlanking())
+    {
+    vtkSmartPointer<vtkUniformGrid> grid = vtkSmartPointer<vtkUniformGrid>::New();
+    grid->ShallowCopy(block);
+    data = grid;
+    }
+  else
+    {
+    vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+    image->CopyStructure(block);
+    image->GetPointData()->PassData(block->GetPointData());
+    data = image;
+    }
+
+  vtkSmartPointer<vtkContourFilter> contour = vtkSmartPointer<vtkContourFilter>::New();
+  contour->SetInput(data);
+  contour->SetNumberOfContours(this->GetNumberOfContours());
+  for (int i = 0; i < this->GetNumberOfContours(); i++)
+    {
+    contour->SetValue(i, this->GetValue(i));
+    }
+  contour->SetComputeNormals(this->GetComputeNormals());
+  contour->SetComputeScalars(this->GetComputeScalars());
+  contour->SetComputeGradients(this->GetComputeGradients());
+  contour->Update();
+
+  surface->ShallowCopy(contour->GetOutput());
+
+  if (needEdges && surface->GetNumberOfCells() > 0)
+    {
+    vtkSmartPointer<vtkFeatureEdges> boundary = vtkSmartPointer<vtkFeatureEdges>::New();
+    boundary->SetInput(surface);
+    boundary->BoundaryEdgesOn();
+    boundary->FeatureEdgesOff();
+    boundary->NonManifoldEdgesOff();
+    boundary->ManifoldEdgesOff();
+    boundary->ColoringOff();
+    boundary->Update();
+
+    edges->ShallowCopy(boundary->GetOutput());
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkNestedGridContourFilter::StitchBlock(int index, vtkNestedGridContourWork* work, vtkPolyData* stitch)
+{
+  vtkUniformGrid* fine = work->Blocks[index];
+  int level = vtkNestedGridBlanking::GetNestingLevel(fine);
+
+  double bounds[6];
+  fine->GetBounds(bounds);
+
+  double spacing[3];
+  fine->GetSpacing(spacing);
+
+  double tolerance = std::min(spacing[0], std::min(spacing[1], spacing[2])) * 1e-3;
+
+
+  // Gather the boundary edges of this block's surface and of coarser surfaces that lie on
+  // the faces of this block shared with coarser blocks
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkFloatArray> normals = vtkSmartPointer<vtkFloatArray>::New();
+  normals->SetNumberOfComponents(3);
+  normals->SetName("Normals");
+
+  for (int b = 0; b < (int)work->Blocks.size(); b++)
+    {
+    int blockLevel = vtkNestedGridBlanking::GetNestingLevel(work->Blocks[b]);
+    if (blockLevel > level || (blockLevel == level && b != index))
+      {
+      continue;
+      }
+
+    vtkPolyData* edges = work->Edges[b];
+    vtkDataArray* edgeNormals = edges->GetPointData()->GetNormals();
+
+    vtkIdType numPts;
+    vtkIdType* pts;
+    vtkCellArray* edgeLines = edges->GetLines();
+    if (!edgeLines)
+      {
+      continue;
+      }
+
+    for (edgeLines->InitTraversal(); edgeLines->GetNextCell(numPts, pts); )
+      {
+      if (numPts != 2)
+        {
+        continue;
+        }
+
+      double p1[3];
+      double p2[3];
+      edges->GetPoint(pts[0], p1);
+      edges->GetPoint(pts[1], p2);
+
+      double mid[3];
+      for (int a = 0; a < 3; a++)
+        {
+        mid[a] = (p1[a] + p2[a]) * 0.5;
+        }
+
+      int side;
+      int axis = FindFace(bounds, mid, tolerance, side);
+      if (axis < 0)
+        {
+        continue;
+        }
+
+      if (b == index)
+        {
+        // Only faces that border a coarser block need stitching
+        double outside[3] = { mid[0], mid[1], mid[2] };
+        outside[axis] += (side ? 1.0 : -1.0) * spacing[axis] * 0.5;
+
+        int outsideLevel = vtkNestedGridBlanking::FindFinestLevel(work->Blocks, outside);
+        if (outsideLevel < 0 || outsideLevel >= level)
+          {
+          continue;
+          }
+        }
+
+      vtkIdType ids[2];
+      ids[0] = points->InsertNextPoint(p1);
+      ids[1] = points->InsertNextPoint(p2);
+      lines->InsertNextCell(2, ids);
+
+      double n[3] = { 0.0, 0.0, 0.0 };
+      for (int i = 0; i < 2; i++)
+        {
+        if (edgeNormals)
+          {
+          edgeNormals->GetTuple(pts[i], n);
+          }
+        normals->InsertNextTuple(n);
+        }
+      }
+    }
+
+  if (lines->GetNumberOfCells() == 0)
+    {
+    return;
+    }
+
+  vtkSmartPointer<vtkPolyData> loops = vtkSmartPointer<vtkPolyData>::New();
+  loops->SetPoints(points);
+  loops->SetLines(lines);
+  loops->GetPointData()->SetNormals(normals);
+
+
+  // Join coarse and fine edges at their shared crossings, then fill the closed loops
+  vtkSmartPointer<vtkCleanPolyData> clean = vtkSmartPointer<vtkCleanPolyData>::New();
+  clean->SetInput(loops);
+  clean->ToleranceIsAbsoluteOn();
+  clean->SetAbsoluteTolerance(tolerance);
+  clean->ConvertLinesToPointsOff();
+
+  vtkSmartPointer<vtkContourTriangulator> triangulator = vtkSmartPointer<vtkContourTriangulator>::New();
+  triangulator->SetInputConnection(clean->GetOutputPort());
+  triangulator->TriangulationErrorDisplayOff();
+  triangulator->Update();
+
+  stitch->ShallowCopy(triangulator->GetOutput());
+}
+
+//----------------------------------------------------------------------------
+void vtkNestedGridContourFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+}
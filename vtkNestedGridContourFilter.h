@@ -0,0 +1,71 @@
+/*=========================================================================
+
+  Name:        vtkNestedGridContourFilter.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Contours a nested, multi-block grid prepared by
+               vtkNestedGridBlanking.  Each block is contoured on its own
+               thread, skipping cells covered by finer blocks.  The gaps
+               left where a coarse surface meets a finer one are closed by
+               triangulating the loops formed by the boundary edges of
+               both surfaces on each coarse/fine interface face, giving a
+               single crack-free vtkPolyData.
+
+               Derives from vtkContourFilter so that contour values and
+               normal/scalar generation are set the same way.
+
+=========================================================================*/
+
+
+#ifndef __vtkNestedGridContourFilter_h
+#define __vtkNestedGridContourFilter_h
+
+#include <vtkContourFilter.h>
+#include <vtkMultiThreader.h>
+
+class vtkPolyData;
+class vtkUniformGrid;
+
+struct vtkNestedGridContourWork;
+
+
+class vtkNestedGridContourFilter : public vtkContourFilter
+{
+public:
+  static vtkNestedGridContourFilter *New();
+  vtkTypeMacro(vtkNestedGridContourFilter, vtkContourFilter);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Number of threads used to contour blocks.  Defaults to the number of processors.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+protected:
+  vtkNestedGridContourFilter();
+  ~vtkNestedGridContourFilter();
+
+  virtual int FillInputPortInformation(int port, vtkInformation* info);
+  virtual int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+  virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+  // Contour a single block, also extracting its boundary edges for stitching
+  void ContourBlock(vtkUniformGrid* block, vtkPolyData* surface, vtkPolyData* edges, bool needEdges);
+
+  // Close the gaps around a fine block
+  void StitchBlock(int index, vtkNestedGridContourWork* work, vtkPolyData* stitch);
+
+  // Thread entry point
+  static VTK_THREAD_RETURN_TYPE ContourBlocks(void* arg);
+
+  int NumberOfThreads;
+
+private:
+  vtkNestedGridContourFilter(const vtkNestedGridContourFilter&);  // Not implemented.
+  void operator=(const vtkNestedGridContourFilter&);  // Not implemented.
+};
+
+#endif
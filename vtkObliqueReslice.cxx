@@ -0,0 +1,609 @@
+/*=========================================================================
+
+  Name:        vtkObliqueReslice.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Samples a volume on a plane of arbitrary orientation, for
+               rendering as a texture.
+
+=========================================================================*/
+
+
+#include "vtkObliqueReslice.h"
+
+#include "vtkVolumeDifference.h"
+#include "vtkVolumeSlab.h"
+
+#include <vtkCellArray.h>
+#include <vtkCriticalSection.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+vtkStandardNewMacro(vtkObliqueReslice);
+
+
+// Samples per side of a tile.  A tile's rows stay in cache while it is located and gathered.
+static const int tileSize = 32;
+
+
+//----------------------------------------------------------------------------
+// The sampled rectangle of the plane: the world position of the first sample, the world step
+// between samples along each side, and the number of samples along each side
+struct vtkObliqueResliceFrame
+{
+  double Corner[3];
+  double Step[2][3];
+  int Size[2];
+};
+
+
+//----------------------------------------------------------------------------
+// Shared state for sampling the tiles of the image in parallel
+struct vtkObliqueResliceWork
+{
+  vtkObliqueReslice* Filter;
+
+  vtkObliqueResliceFrame Frame;
+  float* Output;
+
+  vtkDataArray* Values;
+
+  // Grid of the volume.  Uniform grids locate samples directly, rectilinear grids by search.
+  int Dimensions[3];
+  bool Uniform;
+  double Origin[3];
+  double Spacing[3];
+  std::vector<double> Coordinates[3];
+
+  int Tiles[2];
+
+  int NextTile;
+  vtkSimpleCriticalSection Lock;
+};
+
+
+//----------------------------------------------------------------------------
+// Find the cell containing each sample of a row along an axis and the weight within it, and
+// mark samples outside the volume
+static void vtkObliqueResliceLocate(vtkObliqueResliceWork* work, int axis, double start,
+                                    double step, int n, int* index, double* weight,
+                                    unsigned char* inside)
+{
+  int dimension = work->Dimensions[axis];
+
+  // Flat volumes are sampled everywhere across their single plane
+  if (dimension < 2)
+    {
+    for (int i = 0; i < n; i++)
+      {
+      index[i] = 0;
+      weight[i] = 0.0;
+      }
+
+    return;
+    }
+
+  if (work->Uniform)
+    {
+    double inverseSpacing = 1.0 / work->Spacing[axis];
+    double t0 = (start - work->Origin[axis]) * inverseSpacing;
+    double dt = step * inverseSpacing;
+    double last = dimension - 1;
+    double tolerance = 1e-6;
+
+    for (int i = 0; i < n; i++)
+      {
+      double t = t0 + i * dt;
+      inside[i] &= (unsigned char)(t >= -tolerance && t <= last + tolerance);
+
+      t = std::min(std::max(t, 0.0), last);
+
+      int j = std::min((int)t, dimension - 2);
+      index[i] = j;
+      weight[i] = t - j;
+      }
+
+    return;
+    }
+
+  const std::vector<double>& c = work->Coordinates[axis];
+  double tolerance = 1e-6 * (c.back() - c.front());
+
+  for (int i = 0; i < n; i++)
+    {
+    double p = start + i * step;
+    inside[i] &= (unsigned char)(p >= c.front() - tolerance && p <= c.back() + tolerance);
+
+    int j = (int)(std::upper_bound(c.begin(), c.end(), p) - c.begin()) - 1;
+    j = std::min(std::max(j, 0), dimension - 2);
+
+    index[i] = j;
+    weight[i] = std::min(std::max((p - c[j]) / (c[j + 1] - c[j]), 0.0), 1.0);
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+static void vtkObliqueResliceInterpolate(vtkObliqueResliceWork* work, const T* values, int n,
+                                         const int* index[3], const double* weight[3],
+                                         const unsigned char* inside, float* out)
+{
+  const int* dims = work->Dimensions;
+  vtkIdType dx = dims[0] > 1 ? 1 : 0;
+  vtkIdType dy = dims[1] > 1 ? dims[0] : 0;
+  vtkIdType dz = dims[2] > 1 ? (vtkIdType)dims[0] * dims[1] : 0;
+
+  for (int i = 0; i < n; i++)
+    {
+    // Outside the volume is 0, which the slice clipping makes transparent
+    if (!inside[i])
+      {
+      out[i] = 0.0f;
+      continue;
+      }
+
+    const T* p = values + ((vtkIdType)index[2][i] * dims[1] + index[1][i]) * dims[0] + index[0][i];
+    double wx = weight[0][i];
+    double wy = weight[1][i];
+    double wz = weight[2][i];
+
+    double v00 = p[0] + wx * ((double)p[dx] - p[0]);
+    double v10 = p[dy] + wx * ((double)p[dy + dx] - p[dy]);
+    double v01 = p[dz] + wx * ((double)p[dz + dx] - p[dz]);
+    double v11 = p[dz + dy] + wx * ((double)p[dz + dy + dx] - p[dz + dy]);
+
+    double v0 = v00 + wy * (v10 - v00);
+    double v1 = v01 + wy * (v11 - v01);
+
+    out[i] = static_cast<float>(v0 + wz * (v1 - v0));
+    }
+}
+
+
+//----------------------------------------------------------------------------
+vtkObliqueReslice::vtkObliqueReslice()
+{
+  this->Origin[0] = this->Origin[1] = this->Origin[2] = 0.0;
+  this->Normal[0] = this->Normal[1] = 0.0;
+  this->Normal[2] = 1.0;
+  this->SampleSpacing = 0.0;
+  this->Magnification = 1.0;
+  this->MaximumSize = 2048;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  this->SetNumberOfInputPorts(1);
+  this->SetNumberOfOutputPorts(2);
+}
+
+//----------------------------------------------------------------------------
+vtkObliqueReslice::~vtkObliqueReslice()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkObliqueReslice::GetSliceOutput()
+{
+  return vtkImageData::SafeDownCast(this->GetOutputDataObject(0));
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData* vtkObliqueReslice::GetSurfaceOutput()
+{
+  return vtkPolyData::SafeDownCast(this->GetOutputDataObject(1));
+}
+
+//----------------------------------------------------------------------------
+int vtkObliqueReslice::FillInputPortInformation(int, vtkInformation* info)
+{
+  // Grids or multi-block grids
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataObject");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkObliqueReslice::FillOutputPortInformation(int port, vtkInformation* info)
+{
+  info->Set(vtkDataObject::DATA_TYPE_NAME(), port == 0 ? "vtkImageData" : "vtkPolyData");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkObliqueReslice::ProcessRequest(vtkInformation* request,
+                                      vtkInformationVector** inputVector,
+                                      vtkInformationVector* outputVector)
+{
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_DATA()))
+    {
+    return this->RequestData(request, inputVector, outputVector);
+    }
+
+  if (request->Has(vtkStreamingDemandDrivenPipeline::REQUEST_UPDATE_EXTENT()))
+    {
+    return this->RequestUpdateExtent(request, inputVector, outputVector);
+    }
+
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_INFORMATION()))
+    {
+    return this->RequestInformation(request, inputVector, outputVector);
+    }
+
+  return this->Superclass::ProcessRequest(request, inputVector, outputVector);
+}
+
+//----------------------------------------------------------------------------
+bool vtkObliqueReslice::ComputeFrame(vtkDataSet* grid, vtkObliqueResliceFrame* frame)
+{
+  // Bounds of the grid, and its smallest spacing
+  double bounds[6];
+  double spacing = VTK_DOUBLE_MAX;
+
+  for (int i = 0; i < 3; i++)
+    {
+    std::vector<double> c;
+
+    if (!grid || !vtkVolumeDifference::GetCoordinates(grid, i, c) || c.empty())
+      {
+      return false;
+      }
+
+    bounds[2 * i] = c.front();
+    bounds[2 * i + 1] = c.back();
+
+    for (int j = 1; j < (int)c.size(); j++)
+      {
+      if (c[j] - c[j - 1] > 0.0)
+        {
+        spacing = std::min(spacing, c[j] - c[j - 1]);
+        }
+      }
+    }
+
+  if (this->SampleSpacing > 0.0)
+    {
+    spacing = this->SampleSpacing;
+    }
+
+  if (spacing == VTK_DOUBLE_MAX)
+    {
+    spacing = 1.0;
+    }
+
+  spacing /= this->Magnification;
+
+
+  // Orthonormal axes in the plane, the first normal to the grid axis least along the normal
+  double n[3] = { this->Normal[0], this->Normal[1], this->Normal[2] };
+
+  if (vtkMath::Normalize(n) == 0.0)
+    {
+    return false;
+    }
+
+  int least = 0;
+  for (int i = 1; i < 3; i++)
+    {
+    if (fabs(n[i]) < fabs(n[least]))
+      {
+      least = i;
+      }
+    }
+
+  double e[3] = { 0.0, 0.0, 0.0 };
+  e[least] = 1.0;
+
+  double u[3];
+  double v[3];
+  vtkMath::Cross(n, e, u);
+  vtkMath::Normalize(u);
+  vtkMath::Cross(n, u, v);
+
+
+  // The rectangle containing the bounds projected onto the plane
+  double range[2][2] = { { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX }, { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX } };
+
+  for (int i = 0; i < 8; i++)
+    {
+    double p[3] = { bounds[i & 1] - this->Origin[0],
+                    bounds[2 + ((i >> 1) & 1)] - this->Origin[1],
+                    bounds[4 + ((i >> 2) & 1)] - this->Origin[2] };
+
+    double a = vtkMath::Dot(p, u);
+    double b = vtkMath::Dot(p, v);
+
+    range[0][0] = std::min(range[0][0], a);
+    range[0][1] = std::max(range[0][1], a);
+    range[1][0] = std::min(range[1][0], b);
+    range[1][1] = std::max(range[1][1], b);
+    }
+
+  // Samples spanning the rectangle exactly, at about the spacing
+  double* axes[2] = { u, v };
+
+  for (int i = 0; i < 2; i++)
+    {
+    double length = range[i][1] - range[i][0];
+    int size = (int)std::min(floor(length / spacing) + 1.0, (double)this->MaximumSize);
+    frame->Size[i] = std::max(size, 2);
+
+    double step = length / (frame->Size[i] - 1);
+
+    for (int j = 0; j < 3; j++)
+      {
+      frame->Step[i][j] = axes[i][j] * step;
+      }
+    }
+
+  for (int j = 0; j < 3; j++)
+    {
+    frame->Corner[j] = this->Origin[j] + u[j] * range[0][0] + v[j] * range[1][0];
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkObliqueReslice::RequestInformation(vtkInformation*,
+                                          vtkInformationVector** inputVector,
+                                          vtkInformationVector* outputVector)
+{
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+
+  // The image size depends on the plane and the grid bounds.  If the input is not there yet,
+  // the image sets its own extent when sampled.
+  vtkObliqueResliceFrame frame;
+  frame.Size[0] = frame.Size[1] = 2;
+
+  if (inInfo)
+    {
+    this->ComputeFrame(vtkVolumeSlab::GetGrid(inInfo->Get(vtkDataObject::DATA_OBJECT())), &frame);
+    }
+
+  int extent[6] = { 0, frame.Size[0] - 1, 0, frame.Size[1] - 1, 0, 0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent, 6);
+  outInfo->Set(vtkDataObject::ORIGIN(), origin, 3);
+  outInfo->Set(vtkDataObject::SPACING(), spacing, 3);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkObliqueReslice::RequestUpdateExtent(vtkInformation*,
+                                           vtkInformationVector** inputVector,
+                                           vtkInformationVector*)
+{
+  // The plane can cross any part of the volume
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+
+  if (inInfo && inInfo->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()))
+    {
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+                inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkObliqueReslice::RequestData(vtkInformation*,
+                                   vtkInformationVector** inputVector,
+                                   vtkInformationVector* outputVector)
+{
+  vtkDataObject* input = vtkDataObject::GetData(inputVector[0], 0);
+  vtkImageData* slice = vtkImageData::GetData(outputVector, 0);
+  vtkPolyData* surface = vtkPolyData::GetData(outputVector, 1);
+
+  if (!slice || !surface)
+    {
+    return 0;
+    }
+
+  slice->Initialize();
+  surface->Initialize();
+
+  vtkObliqueResliceWork work;
+  work.Filter = this;
+
+  vtkDataSet* grid = vtkVolumeSlab::GetGrid(input);
+
+  if (!this->ComputeFrame(grid, &work.Frame))
+    {
+    vtkErrorMacro("Input must be a uniform, rectilinear, or nested grid, and the normal nonzero");
+    return 0;
+    }
+
+  work.Values = grid->GetPointData()->GetScalars();
+
+  if (!work.Values || work.Values->GetNumberOfComponents() != 1)
+    {
+    vtkErrorMacro("Input needs single component point scalars");
+    return 0;
+    }
+
+  vtkImageData* image = vtkImageData::SafeDownCast(grid);
+  work.Uniform = image != NULL;
+
+  for (int i = 0; i < 3; i++)
+    {
+    vtkVolumeDifference::GetCoordinates(grid, i, work.Coordinates[i]);
+    work.Dimensions[i] = (int)work.Coordinates[i].size();
+
+    if (image)
+      {
+      work.Origin[i] = work.Coordinates[i][0];
+      work.Spacing[i] = image->GetSpacing()[i];
+      }
+    }
+
+
+  // Sample the image in tiles
+  int nu = work.Frame.Size[0];
+  int nv = work.Frame.Size[1];
+
+  vtkSmartPointer<vtkFloatArray> samples = vtkSmartPointer<vtkFloatArray>::New();
+  samples->SetName(work.Values->GetName());
+  samples->SetNumberOfTuples((vtkIdType)nu * nv);
+
+  work.Output = samples->GetPointer(0);
+  work.Tiles[0] = (nu + tileSize - 1) / tileSize;
+  work.Tiles[1] = (nv + tileSize - 1) / tileSize;
+  work.NextTile = 0;
+
+  int numberOfTiles = work.Tiles[0] * work.Tiles[1];
+
+  vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+  threader->SetNumberOfThreads(std::max(1, std::min(this->NumberOfThreads, numberOfTiles)));
+  threader->SetSingleMethod(SampleTiles, &work);
+  threader->SingleMethodExecute();
+
+  slice->SetExtent(0, nu - 1, 0, nv - 1, 0, 0);
+  slice->SetOrigin(0.0, 0.0, 0.0);
+  slice->SetSpacing(1.0, 1.0, 1.0);
+  slice->GetPointData()->SetScalars(samples);
+
+
+  // The rectangle, wound counterclockwise around the normal, with texture coordinates at the
+  // texel centers of the corner samples
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetNumberOfPoints(4);
+
+  vtkSmartPointer<vtkFloatArray> tcoords = vtkSmartPointer<vtkFloatArray>::New();
+  tcoords->SetName("TextureCoordinates");
+  tcoords->SetNumberOfComponents(2);
+  tcoords->SetNumberOfTuples(4);
+
+  const vtkObliqueResliceFrame& frame = work.Frame;
+  int corners[4][2] = { { 0, 0 }, { nu - 1, 0 }, { nu - 1, nv - 1 }, { 0, nv - 1 } };
+
+  for (int i = 0; i < 4; i++)
+    {
+    int a = corners[i][0];
+    int b = corners[i][1];
+
+    double p[3];
+    for (int j = 0; j < 3; j++)
+      {
+      p[j] = frame.Corner[j] + a * frame.Step[0][j] + b * frame.Step[1][j];
+      }
+
+    float t[2] = { static_cast<float>((a + 0.5) / nu), static_cast<float>((b + 0.5) / nv) };
+
+    points->SetPoint(i, p);
+    tcoords->SetTupleValue(i, t);
+    }
+
+  vtkSmartPointer<vtkCellArray> quads = vtkSmartPointer<vtkCellArray>::New();
+  vtkIdType quad[4] = { 0, 1, 2, 3 };
+  quads->InsertNextCell(4, quad);
+
+  surface->SetPoints(points);
+  surface->SetPolys(quads);
+  surface->GetPointData()->SetTCoords(tcoords);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkObliqueReslice::SampleTiles(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkObliqueResliceWork* work = static_cast<vtkObliqueResliceWork*>(info->UserData);
+
+  // Take tiles until none are left
+  for (;;)
+    {
+    work->Lock.Lock();
+    int tile = work->NextTile++;
+    work->Lock.Unlock();
+
+    if (tile >= work->Tiles[0] * work->Tiles[1])
+      {
+      break;
+      }
+
+    work->Filter->SampleTile(work, tile);
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkObliqueReslice::SampleTile(vtkObliqueResliceWork* work, int tile)
+{
+  const vtkObliqueResliceFrame& frame = work->Frame;
+
+  int i0 = (tile % work->Tiles[0]) * tileSize;
+  int j0 = (tile / work->Tiles[0]) * tileSize;
+  int n = std::min(tileSize, frame.Size[0] - i0);
+  int j1 = std::min(j0 + tileSize, frame.Size[1]);
+
+  int indices[3][tileSize];
+  double weights[3][tileSize];
+  unsigned char inside[tileSize];
+
+  const int* index[3] = { indices[0], indices[1], indices[2] };
+  const double* weight[3] = { weights[0], weights[1], weights[2] };
+
+  void* values = work->Values->GetVoidPointer(0);
+
+  for (int j = j0; j < j1; j++)
+    {
+    // Locate the row along each axis, then interpolate
+    for (int i = 0; i < n; i++)
+      {
+      inside[i] = 1;
+      }
+
+    for (int a = 0; a < 3; a++)
+      {
+      double start = frame.Corner[a] + i0 * frame.Step[0][a] + j * frame.Step[1][a];
+
+      vtkObliqueResliceLocate(work, a, start, frame.Step[0][a], n, indices[a], weights[a], inside);
+      }
+
+    float* out = work->Output + (vtkIdType)j * frame.Size[0] + i0;
+
+    switch (work->Values->GetDataType())
+      {
+      vtkTemplateMacro(vtkObliqueResliceInterpolate(work, static_cast<const VTK_TT*>(values), n,
+                                                    index, weight, inside, out));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkObliqueReslice::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Origin: (" << this->Origin[0] << ", " << this->Origin[1] << ", "
+     << this->Origin[2] << ")\n";
+  os << indent << "Normal: (" << this->Normal[0] << ", " << this->Normal[1] << ", "
+     << this->Normal[2] << ")\n";
+  os << indent << "SampleSpacing: " << this->SampleSpacing << "\n";
+  os << indent << "Magnification: " << this->Magnification << "\n";
+  os << indent << "MaximumSize: " << this->MaximumSize << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+}
@@ -0,0 +1,443 @@
+/*=========================================================================
+
+  Name:        vtkPropertyColors.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Colors the points of an isosurface by a property sampled
+               from a second volume.
+
+=========================================================================*/
+
+
+#include "vtkPropertyColors.h"
+
+#include "vtkVolumeDifference.h"
+
+#include <vtkCriticalSection.h>
+#include <vtkDataSet.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkScalarsToColors.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifdef USE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+vtkStandardNewMacro(vtkPropertyColors);
+
+vtkCxxSetObjectMacro(vtkPropertyColors, Property, vtkDataSet);
+vtkCxxSetObjectMacro(vtkPropertyColors, LookupTable, vtkScalarsToColors);
+
+
+// Points per batch.  Large enough to amortize taking a batch, small enough to balance the threads.
+static const int batchSize = 4096;
+
+
+//----------------------------------------------------------------------------
+// Shared state for sampling batches of points in parallel
+struct vtkPropertyColorsWork
+{
+  vtkPropertyColors* Filter;
+
+  const float* Points;
+  vtkIdType NumberOfPoints;
+  float* Output;
+
+  vtkDataArray* Values;
+
+  // Grid of the property.  Uniform grids locate points directly, rectilinear grids by search.
+  int Dimensions[3];
+  bool Uniform;
+  double Origin[3];
+  double Spacing[3];
+  std::vector<double> Coordinates[3];
+
+  int NextBatch;
+  vtkSimpleCriticalSection Lock;
+};
+
+
+//----------------------------------------------------------------------------
+// Find the cell containing each coordinate along an axis and the weight within it, clamping to
+// the ends
+static void vtkPropertyColorsLocate(vtkPropertyColorsWork* work, int axis, const float* points,
+                                    int n, int* index, double* weight)
+{
+  int dimension = work->Dimensions[axis];
+
+  if (dimension < 2)
+    {
+    for (int i = 0; i < n; i++)
+      {
+      index[i] = 0;
+      weight[i] = 0.0;
+      }
+
+    return;
+    }
+
+  if (work->Uniform)
+    {
+    double origin = work->Origin[axis];
+    double inverseSpacing = 1.0 / work->Spacing[axis];
+    double last = dimension - 1;
+
+    int i = 0;
+
+#ifdef USE_SSE2
+    // Two points at a time.  Coordinates are clamped to the grid, so are not negative, and
+    // truncation finds their cells.
+    __m128d o = _mm_set1_pd(origin);
+    __m128d s = _mm_set1_pd(inverseSpacing);
+    __m128d high = _mm_set1_pd(last);
+    __m128d lastCell = _mm_set1_pd(dimension - 2);
+
+    for (; i + 2 <= n; i += 2)
+      {
+      __m128d t = _mm_set_pd(points[(i + 1) * 3 + axis], points[i * 3 + axis]);
+      t = _mm_mul_pd(_mm_sub_pd(t, o), s);
+      t = _mm_min_pd(_mm_max_pd(t, _mm_setzero_pd()), high);
+
+      __m128d j = _mm_min_pd(_mm_cvtepi32_pd(_mm_cvttpd_epi32(t)), lastCell);
+
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(index + i), _mm_cvttpd_epi32(j));
+      _mm_storeu_pd(weight + i, _mm_sub_pd(t, j));
+      }
+#endif
+
+    for (; i < n; i++)
+      {
+      double t = (points[i * 3 + axis] - origin) * inverseSpacing;
+      t = std::min(std::max(t, 0.0), last);
+
+      int j = std::min((int)t, dimension - 2);
+      index[i] = j;
+      weight[i] = t - j;
+      }
+
+    return;
+    }
+
+  const std::vector<double>& c = work->Coordinates[axis];
+
+  for (int i = 0; i < n; i++)
+    {
+    double p = points[i * 3 + axis];
+
+    int j = (int)(std::upper_bound(c.begin(), c.end(), p) - c.begin()) - 1;
+    j = std::min(std::max(j, 0), dimension - 2);
+
+    index[i] = j;
+    weight[i] = std::min(std::max((p - c[j]) / (c[j + 1] - c[j]), 0.0), 1.0);
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+static void vtkPropertyColorsInterpolate(vtkPropertyColorsWork* work, const T* values, int n,
+                                         const int* index[3], const double* weight[3], float* out)
+{
+  const int* dims = work->Dimensions;
+  vtkIdType dx = dims[0] > 1 ? 1 : 0;
+  vtkIdType dy = dims[1] > 1 ? dims[0] : 0;
+  vtkIdType dz = dims[2] > 1 ? (vtkIdType)dims[0] * dims[1] : 0;
+
+  int i = 0;
+
+#ifdef USE_SSE2
+  // Two points at a time, gathering the corners of their cells into pairs
+  vtkIdType offsets[8] = { 0, dx, dy, dy + dx, dz, dz + dx, dz + dy, dz + dy + dx };
+
+  for (; i + 2 <= n; i += 2)
+    {
+    const T* p[2];
+    for (int k = 0; k < 2; k++)
+      {
+      p[k] = values + ((vtkIdType)index[2][i + k] * dims[1] + index[1][i + k]) * dims[0] + index[0][i + k];
+      }
+
+    __m128d c[8];
+    for (int k = 0; k < 8; k++)
+      {
+      c[k] = _mm_set_pd(static_cast<double>(p[1][offsets[k]]), static_cast<double>(p[0][offsets[k]]));
+      }
+
+    __m128d wx = _mm_loadu_pd(weight[0] + i);
+    __m128d wy = _mm_loadu_pd(weight[1] + i);
+    __m128d wz = _mm_loadu_pd(weight[2] + i);
+
+    __m128d v00 = _mm_add_pd(c[0], _mm_mul_pd(wx, _mm_sub_pd(c[1], c[0])));
+    __m128d v10 = _mm_add_pd(c[2], _mm_mul_pd(wx, _mm_sub_pd(c[3], c[2])));
+    __m128d v01 = _mm_add_pd(c[4], _mm_mul_pd(wx, _mm_sub_pd(c[5], c[4])));
+    __m128d v11 = _mm_add_pd(c[6], _mm_mul_pd(wx, _mm_sub_pd(c[7], c[6])));
+
+    __m128d v0 = _mm_add_pd(v00, _mm_mul_pd(wy, _mm_sub_pd(v10, v00)));
+    __m128d v1 = _mm_add_pd(v01, _mm_mul_pd(wy, _mm_sub_pd(v11, v01)));
+
+    __m128d v = _mm_add_pd(v0, _mm_mul_pd(wz, _mm_sub_pd(v1, v0)));
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_castps_si128(_mm_cvtpd_ps(v)));
+    }
+#endif
+
+  for (; i < n; i++)
+    {
+    const T* p = values + ((vtkIdType)index[2][i] * dims[1] + index[1][i]) * dims[0] + index[0][i];
+    double wx = weight[0][i];
+    double wy = weight[1][i];
+    double wz = weight[2][i];
+
+    double v00 = p[0] + wx * ((double)p[dx] - p[0]);
+    double v10 = p[dy] + wx * ((double)p[dy + dx] - p[dy]);
+    double v01 = p[dz] + wx * ((double)p[dz + dx] - p[dz]);
+    double v11 = p[dz + dy] + wx * ((double)p[dz + dy + dx] - p[dz + dy]);
+
+    double v0 = v00 + wy * (v10 - v00);
+    double v1 = v01 + wy * (v11 - v01);
+
+    out[i] = static_cast<float>(v0 + wz * (v1 - v0));
+    }
+}
+
+
+//----------------------------------------------------------------------------
+vtkPropertyColors::vtkPropertyColors()
+{
+  this->Property = NULL;
+  this->LookupTable = NULL;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  this->SampledPoints = NULL;
+  this->SampledPointsTime = 0;
+  this->SampledPropertyTime = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkPropertyColors::~vtkPropertyColors()
+{
+  this->SetProperty(NULL);
+  this->SetLookupTable(NULL);
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkPropertyColors::GetMTime()
+{
+  unsigned long mTime = this->Superclass::GetMTime();
+
+  if (this->Property)
+    {
+    mTime = std::max(mTime, this->Property->GetMTime());
+    }
+
+  if (this->LookupTable)
+    {
+    mTime = std::max(mTime, this->LookupTable->GetMTime());
+    }
+
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkPropertyColors::RequestData(vtkInformation*,
+                                   vtkInformationVector** inputVector,
+                                   vtkInformationVector* outputVector)
+{
+  vtkPolyData* input = vtkPolyData::GetData(inputVector[0], 0);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector, 0);
+
+  if (!input || !output)
+    {
+    return 0;
+    }
+
+  output->ShallowCopy(input);
+
+  vtkPoints* points = input->GetPoints();
+
+  if (!this->Property || !this->LookupTable || !points || points->GetNumberOfPoints() == 0)
+    {
+    return 1;
+    }
+
+  vtkDataArray* values = this->Property->GetPointData()->GetScalars();
+
+  if (!values || values->GetNumberOfComponents() != 1)
+    {
+    vtkErrorMacro("Property needs single component point scalars");
+    return 1;
+    }
+
+
+  // Sample again only if the surface or the property changed
+  if (!this->Samples || points != this->SampledPoints ||
+      points->GetMTime() != this->SampledPointsTime ||
+      this->Property->GetMTime() != this->SampledPropertyTime)
+    {
+    this->Sample(points);
+
+    this->SampledPoints = points;
+    this->SampledPointsTime = points->GetMTime();
+    this->SampledPropertyTime = this->Property->GetMTime();
+    }
+
+  if (!this->Samples)
+    {
+    return 1;
+    }
+
+
+  // Map the samples to colors
+  vtkSmartPointer<vtkUnsignedCharArray> colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  colors->SetName("PropertyColors");
+  colors->SetNumberOfComponents(3);
+  colors->SetNumberOfTuples(this->Samples->GetNumberOfTuples());
+
+  this->LookupTable->MapScalarsThroughTable(this->Samples, colors->GetPointer(0), VTK_RGB);
+
+  output->GetPointData()->AddArray(this->Samples);
+  output->GetPointData()->SetScalars(colors);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPropertyColors::Sample(vtkPoints* points)
+{
+  vtkPropertyColorsWork work;
+  work.Filter = this;
+
+  vtkImageData* image = vtkImageData::SafeDownCast(this->Property);
+  work.Uniform = image != NULL;
+
+  for (int i = 0; i < 3; i++)
+    {
+    if (!vtkVolumeDifference::GetCoordinates(this->Property, i, work.Coordinates[i]) ||
+        work.Coordinates[i].empty())
+      {
+      vtkErrorMacro("Property must be a uniform or rectilinear grid");
+      this->Samples = NULL;
+      return;
+      }
+
+    work.Dimensions[i] = (int)work.Coordinates[i].size();
+    }
+
+  if (image)
+    {
+    for (int i = 0; i < 3; i++)
+      {
+      work.Origin[i] = work.Coordinates[i][0];
+      work.Spacing[i] = image->GetSpacing()[i];
+      }
+    }
+
+
+  // Surfaces from vtkContourFilter have float points.  Convert others.
+  vtkSmartPointer<vtkFloatArray> floatPoints = vtkFloatArray::SafeDownCast(points->GetData());
+  if (!floatPoints)
+    {
+    floatPoints = vtkSmartPointer<vtkFloatArray>::New();
+    floatPoints->DeepCopy(points->GetData());
+    }
+
+  this->Samples = vtkSmartPointer<vtkFloatArray>::New();
+  this->Samples->SetName("Property");
+  this->Samples->SetNumberOfTuples(points->GetNumberOfPoints());
+
+  work.Points = floatPoints->GetPointer(0);
+  work.NumberOfPoints = points->GetNumberOfPoints();
+  work.Output = this->Samples->GetPointer(0);
+  work.Values = this->Property->GetPointData()->GetScalars();
+  work.NextBatch = 0;
+
+  int numberOfBatches = (int)((work.NumberOfPoints + batchSize - 1) / batchSize);
+
+  vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+  threader->SetNumberOfThreads(std::max(1, std::min(this->NumberOfThreads, numberOfBatches)));
+  threader->SetSingleMethod(SampleBatches, &work);
+  threader->SingleMethodExecute();
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkPropertyColors::SampleBatches(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkPropertyColorsWork* work = static_cast<vtkPropertyColorsWork*>(info->UserData);
+
+  // Take batches until none are left
+  for (;;)
+    {
+    work->Lock.Lock();
+    int batch = work->NextBatch++;
+    work->Lock.Unlock();
+
+    if ((vtkIdType)batch * batchSize >= work->NumberOfPoints)
+      {
+      break;
+      }
+
+    work->Filter->SampleBatch(work, batch);
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkPropertyColors::SampleBatch(vtkPropertyColorsWork* work, int batch)
+{
+  vtkIdType begin = (vtkIdType)batch * batchSize;
+  int n = (int)std::min((vtkIdType)batchSize, work->NumberOfPoints - begin);
+
+  const float* points = work->Points + begin * 3;
+
+  // Locate the batch along each axis, then interpolate
+  std::vector<int> indices[3];
+  std::vector<double> weights[3];
+  const int* index[3];
+  const double* weight[3];
+
+  for (int i = 0; i < 3; i++)
+    {
+    indices[i].resize(n);
+    weights[i].resize(n);
+
+    vtkPropertyColorsLocate(work, i, points, n, &indices[i][0], &weights[i][0]);
+
+    index[i] = &indices[i][0];
+    weight[i] = &weights[i][0];
+    }
+
+  void* values = work->Values->GetVoidPointer(0);
+  float* out = work->Output + begin;
+
+  switch (work->Values->GetDataType())
+    {
+    vtkTemplateMacro(vtkPropertyColorsInterpolate(work, static_cast<const VTK_TT*>(values), n,
+                                                  index, weight, out));
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPropertyColors::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Property: " << this->Property << "\n";
+  os << indent << "LookupTable: " << this->LookupTable << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+}
@@ -0,0 +1,102 @@
+/*=========================================================================
+
+  Name:        vtkPropertyColors.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Colors the points of an isosurface by a property sampled
+               from a second volume, e.g. the electrostatic potential on
+               a density isosurface.  The property is trilinearly
+               interpolated at each point, clamped to the bounds of its
+               volume, and mapped through a lookup table to unsigned char
+               RGB point scalars, so mappers use them directly.  The
+               sampled values are also added as the "Property" point
+               data array.
+
+               Points are sampled in parallel batches.  With USE_SSE2,
+               points are interpolated two at a time, and located two at
+               a time on uniform grids.  The samples are kept, so only
+               the colors are mapped again if just the lookup table or
+               upstream scalars change, and sampling is done again only
+               when the surface points or the property change.
+
+               The property volume must be a uniform or rectilinear grid
+               with single component scalars.  Without a property, the
+               input is passed through unchanged.
+
+=========================================================================*/
+
+
+#ifndef __vtkPropertyColors_h
+#define __vtkPropertyColors_h
+
+#include <vtkMultiThreader.h>
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+class vtkDataSet;
+class vtkFloatArray;
+class vtkScalarsToColors;
+
+struct vtkPropertyColorsWork;
+
+
+class vtkPropertyColors : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkPropertyColors *New();
+  vtkTypeMacro(vtkPropertyColors, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Volume to sample the property from, or NULL to pass the input through.
+  virtual void SetProperty(vtkDataSet*);
+  vtkGetObjectMacro(Property, vtkDataSet);
+
+  // Description:
+  // Lookup table mapping property values to colors.
+  virtual void SetLookupTable(vtkScalarsToColors*);
+  vtkGetObjectMacro(LookupTable, vtkScalarsToColors);
+
+  // Description:
+  // Number of threads used.  Defaults to the number of processors.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Include the property and lookup table in the modification time.
+  unsigned long GetMTime();
+
+protected:
+  vtkPropertyColors();
+  ~vtkPropertyColors();
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+  // Sample the property at the points
+  void Sample(vtkPoints* points);
+
+  // Sample one batch of points
+  void SampleBatch(vtkPropertyColorsWork* work, int batch);
+
+  // Thread entry point
+  static VTK_THREAD_RETURN_TYPE SampleBatches(void* arg);
+
+  vtkDataSet* Property;
+  vtkScalarsToColors* LookupTable;
+  int NumberOfThreads;
+
+  // Samples at the points last sampled, and what they were sampled from
+  vtkSmartPointer<vtkFloatArray> Samples;
+  vtkPoints* SampledPoints;
+  unsigned long SampledPointsTime;
+  unsigned long SampledPropertyTime;
+
+private:
+  vtkPropertyColors(const vtkPropertyColors&);  // Not implemented.
+  void operator=(const vtkPropertyColors&);  // Not implemented.
+};
+
+#endif
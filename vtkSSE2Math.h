@@ -0,0 +1,61 @@
+/*=========================================================================
+
+  Name:        vtkSSE2Math.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Math functions on pairs of doubles for the SSE2 kernels,
+               where the standard library only works one value at a time.
+               Only defined when building with USE_SSE2.
+
+=========================================================================*/
+
+
+#ifndef __vtkSSE2Math_h
+#define __vtkSSE2Math_h
+
+#ifdef USE_SSE2
+#include <emmintrin.h>
+
+//----------------------------------------------------------------------------
+// exp of two values no greater than 0, from the rational approximation of the Cephes library, to
+// within a couple of units in the last place of the standard library.  Values below -708 are taken
+// as -708, where exp is already below the smallest normal double.
+static inline __m128d vtkSSE2Exp(__m128d x)
+{
+  x = _mm_max_pd(x, _mm_set1_pd(-708.0));
+
+  // x = n ln 2 + r, with |r| <= ln 2 / 2
+  __m128i n = _mm_cvtpd_epi32(_mm_mul_pd(x, _mm_set1_pd(1.4426950408889634073599)));
+  __m128d nd = _mm_cvtepi32_pd(n);
+
+  x = _mm_sub_pd(x, _mm_mul_pd(nd, _mm_set1_pd(6.93145751953125e-1)));
+  x = _mm_sub_pd(x, _mm_mul_pd(nd, _mm_set1_pd(1.42860682030941723212e-6)));
+
+  // exp(r) = 1 + 2 r P(r^2) / (Q(r^2) - r P(r^2))
+  __m128d xx = _mm_mul_pd(x, x);
+
+  __m128d p = _mm_set1_pd(1.26177193074810590878e-4);
+  p = _mm_add_pd(_mm_mul_pd(p, xx), _mm_set1_pd(3.02994407707441961300e-2));
+  p = _mm_add_pd(_mm_mul_pd(p, xx), _mm_set1_pd(9.99999999999999999910e-1));
+  p = _mm_mul_pd(p, x);
+
+  __m128d q = _mm_set1_pd(3.00198505138664455042e-6);
+  q = _mm_add_pd(_mm_mul_pd(q, xx), _mm_set1_pd(2.52448340349684104192e-3));
+  q = _mm_add_pd(_mm_mul_pd(q, xx), _mm_set1_pd(2.27265548208155028766e-1));
+  q = _mm_add_pd(_mm_mul_pd(q, xx), _mm_set1_pd(2.00000000000000000009e0));
+
+  __m128d e = _mm_div_pd(p, _mm_sub_pd(q, p));
+  e = _mm_add_pd(_mm_add_pd(e, e), _mm_set1_pd(1.0));
+
+  // Multiply by 2^n, built in the exponent bits
+  __m128i biased = _mm_add_epi32(n, _mm_set1_epi32(1023));
+  __m128i bits = _mm_slli_epi64(_mm_unpacklo_epi32(biased, _mm_setzero_si128()), 52);
+
+  return _mm_mul_pd(e, _mm_castsi128_pd(bits));
+}
+#endif
+
+#endif
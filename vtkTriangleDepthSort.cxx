@@ -0,0 +1,620 @@
+/*=========================================================================
+
+  Name:        vtkTriangleDepthSort.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Sorts the polygons of a surface back to front from a
+               camera, so translucent surfaces blend in depth order.
+
+=========================================================================*/
+
+
+#include "vtkTriangleDepthSort.h"
+
+#include <vtkCamera.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkIdTypeArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+#include <algorithm>
+#include <cstring>
+
+
+vtkStandardNewMacro(vtkTriangleDepthSort);
+
+vtkCxxSetObjectMacro(vtkTriangleDepthSort, Camera, vtkCamera);
+
+
+// Bits of the key sorted per radix pass
+static const int radixBits = 8;
+static const int radixSize = 1 << radixBits;
+
+
+//----------------------------------------------------------------------------
+// Shared state for a parallel pass over the polygons.  Each thread takes a contiguous range.
+struct vtkTriangleDepthSortWork
+{
+  enum
+  {
+    ComputeKeys = 0,
+    CountDigits,
+    Scatter
+  };
+
+  int Phase;
+  vtkIdType NumberOfCells;
+  int NumberOfThreads;
+
+  // Computing keys: the view, and the order to compute them in
+  const float* Centroids;
+  double View[7];
+  const vtkIdType* Order;
+
+  // Keys and polygons in the current order, and the buffers for the next radix pass
+  unsigned int* Keys;
+  vtkIdType* Cells;
+  unsigned int* NextKeys;
+  vtkIdType* NextCells;
+  int Shift;
+
+  // Per thread: keys out of order, and digit counts, then where each digit goes
+  std::vector<vtkIdType> Descents;
+  std::vector<vtkIdType> Digits;
+};
+
+
+//----------------------------------------------------------------------------
+// Map a float to an unsigned int with the same order
+static inline unsigned int vtkTriangleDepthSortFloatKey(float value)
+{
+  unsigned int bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+//----------------------------------------------------------------------------
+// Sort keys and polygons in place by insertion, giving up after a number of moves, for orders
+// that are nearly sorted.  Returns false if it gave up, leaving the keys partly sorted.
+static bool vtkTriangleDepthSortInsertion(unsigned int* keys, vtkIdType* cells, vtkIdType n,
+                                          vtkIdType maxMoves)
+{
+  vtkIdType moves = 0;
+
+  for (vtkIdType i = 1; i < n; i++)
+    {
+    unsigned int key = keys[i];
+    vtkIdType cell = cells[i];
+
+    vtkIdType j = i;
+    while (j > 0 && keys[j - 1] > key)
+      {
+      keys[j] = keys[j - 1];
+      cells[j] = cells[j - 1];
+      j--;
+
+      moves++;
+      }
+
+    keys[j] = key;
+    cells[j] = cell;
+
+    if (moves > maxMoves)
+      {
+      return false;
+      }
+    }
+
+  return true;
+}
+
+
+//----------------------------------------------------------------------------
+vtkTriangleDepthSort::vtkTriangleDepthSort()
+{
+  this->Camera = NULL;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  this->CentroidsInput = NULL;
+  this->CentroidsTime = 0;
+
+  this->Threader = vtkSmartPointer<vtkMultiThreader>::New();
+  this->SortThreadID = -1;
+  this->PendingReady = 0;
+  this->PendingCancelled = 0;
+
+  this->PassThreader = vtkSmartPointer<vtkMultiThreader>::New();
+
+  for (int i = 0; i < 7; i++)
+    {
+    this->OrderView[i] = this->PendingView[i] = 0.0;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkTriangleDepthSort::~vtkTriangleDepthSort()
+{
+  this->CancelSort();
+
+  this->SetCamera(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkTriangleDepthSort::GetView(double view[7])
+{
+  double* position = this->Camera->GetPosition();
+  double* direction = this->Camera->GetDirectionOfProjection();
+
+  for (int i = 0; i < 3; i++)
+    {
+    view[i] = position[i];
+    view[3 + i] = direction[i];
+    }
+
+  view[6] = this->Camera->GetParallelProjection();
+}
+
+//----------------------------------------------------------------------------
+int vtkTriangleDepthSort::UpdateOrder()
+{
+  if (!this->Camera || this->Order.empty())
+    {
+    return 0;
+    }
+
+  int installed = 0;
+
+  // Install a finished sort
+  this->PendingLock.Lock();
+  int ready = this->PendingReady;
+  this->PendingLock.Unlock();
+
+  if (ready)
+    {
+    this->WaitForSort();
+
+    this->Order.swap(this->PendingOrder);
+    std::copy(this->PendingView, this->PendingView + 7, this->OrderView);
+
+    this->Modified();
+    installed = 1;
+    }
+
+  // Sort in the background if the view changed and no sort is running
+  if (this->SortThreadID < 0)
+    {
+    double view[7];
+    this->GetView(view);
+
+    if (!std::equal(view, view + 7, this->OrderView))
+      {
+      this->PendingOrder = this->Order;
+      std::copy(view, view + 7, this->PendingView);
+      this->PendingReady = 0;
+      this->PendingCancelled = 0;
+
+      this->SortThreadID = this->Threader->SpawnThread(SortInBackground, this);
+      }
+    }
+
+  return installed;
+}
+
+//----------------------------------------------------------------------------
+void vtkTriangleDepthSort::WaitForSort()
+{
+  if (this->SortThreadID >= 0)
+    {
+    this->Threader->TerminateThread(this->SortThreadID);
+    this->SortThreadID = -1;
+    }
+
+  this->PendingReady = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkTriangleDepthSort::CancelSort()
+{
+  this->PendingLock.Lock();
+  this->PendingCancelled = 1;
+  this->PendingLock.Unlock();
+
+  // TerminateThread joins, so this returns once the sort sees the flag
+  this->WaitForSort();
+
+  this->PendingCancelled = 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTriangleDepthSort::IsSortCancelled()
+{
+  this->PendingLock.Lock();
+  bool cancelled = this->PendingCancelled != 0;
+  this->PendingLock.Unlock();
+
+  return cancelled;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkTriangleDepthSort::SortInBackground(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkTriangleDepthSort* self = static_cast<vtkTriangleDepthSort*>(info->UserData);
+
+  if (!self->Sort(self->PendingView, self->PendingOrder))
+    {
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  self->PendingLock.Lock();
+  self->PendingReady = 1;
+  self->PendingLock.Unlock();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+int vtkTriangleDepthSort::RequestData(vtkInformation*,
+                                      vtkInformationVector** inputVector,
+                                      vtkInformationVector* outputVector)
+{
+  vtkPolyData* input = vtkPolyData::GetData(inputVector[0], 0);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector, 0);
+
+  // A sort in the background reads the centroids, and may be for a surface being replaced
+  bool pending = this->SortThreadID >= 0;
+  this->CancelSort();
+
+  // Sort a new surface now, starting over
+  if (input != this->CentroidsInput || input->GetMTime() != this->CentroidsTime)
+    {
+    this->ComputeCentroids(input);
+    this->Order.clear();
+
+    if (this->Camera)
+      {
+      this->GetView(this->OrderView);
+      this->Sort(this->OrderView, this->Order);
+      }
+    }
+  else if (pending)
+    {
+    // Start the cancelled sort again on the next update
+    std::fill(this->OrderView, this->OrderView + 7, 0.0);
+    }
+
+  vtkIdType numCells = (vtkIdType)this->CellOffsets.size();
+
+  if ((vtkIdType)this->Order.size() != numCells)
+    {
+    this->Order.resize(numCells);
+
+    for (vtkIdType i = 0; i < numCells; i++)
+      {
+      this->Order[i] = i;
+      }
+    }
+
+
+  // Same points and other cells, with the polygons in order
+  output->CopyStructure(input);
+  output->GetPointData()->PassData(input->GetPointData());
+
+  vtkIdTypeArray* connectivity = input->GetPolys()->GetData();
+  const vtkIdType* in = connectivity->GetPointer(0);
+
+  vtkIdTypeArray* sortedConnectivity = vtkIdTypeArray::New();
+  sortedConnectivity->SetNumberOfTuples(connectivity->GetNumberOfTuples());
+  vtkIdType* out = sortedConnectivity->GetPointer(0);
+
+  for (vtkIdType i = 0; i < numCells; i++)
+    {
+    const vtkIdType* cell = in + this->CellOffsets[this->Order[i]];
+    vtkIdType size = cell[0] + 1;
+
+    std::copy(cell, cell + size, out);
+    out += size;
+    }
+
+  vtkCellArray* polys = vtkCellArray::New();
+  polys->SetCells(numCells, sortedConnectivity);
+  output->SetPolys(polys);
+  polys->Delete();
+  sortedConnectivity->Delete();
+
+  // Cell data follows the polygons, which come after vertices and lines
+  vtkCellData* inCD = input->GetCellData();
+
+  if (inCD->GetNumberOfArrays() > 0)
+    {
+    vtkCellData* outCD = output->GetCellData();
+    vtkIdType totalCells = input->GetNumberOfCells();
+    vtkIdType firstPoly = input->GetNumberOfVerts() + input->GetNumberOfLines();
+
+    outCD->CopyAllocate(inCD, totalCells);
+
+    for (vtkIdType i = 0; i < totalCells; i++)
+      {
+      bool isPoly = i >= firstPoly && i < firstPoly + numCells;
+      outCD->CopyData(inCD, isPoly ? firstPoly + this->Order[i - firstPoly] : i, i);
+      }
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkTriangleDepthSort::ComputeCentroids(vtkPolyData* input)
+{
+  this->CentroidsInput = input;
+  this->CentroidsTime = input->GetMTime();
+
+  vtkCellArray* polys = input->GetPolys();
+  vtkIdType numCells = polys->GetNumberOfCells();
+
+  this->Centroids.resize(numCells * 3);
+  this->CellOffsets.resize(numCells);
+
+  vtkPoints* points = input->GetPoints();
+  const vtkIdType* connectivity = polys->GetData()->GetPointer(0);
+
+  vtkIdType offset = 0;
+
+  for (vtkIdType i = 0; i < numCells; i++)
+    {
+    const vtkIdType* cell = connectivity + offset;
+    vtkIdType npts = cell[0];
+
+    double centroid[3] = { 0.0, 0.0, 0.0 };
+
+    for (vtkIdType j = 0; j < npts; j++)
+      {
+      double p[3];
+      points->GetPoint(cell[1 + j], p);
+
+      centroid[0] += p[0];
+      centroid[1] += p[1];
+      centroid[2] += p[2];
+      }
+
+    for (int j = 0; j < 3; j++)
+      {
+      this->Centroids[i * 3 + j] = static_cast<float>(centroid[j] / std::max(npts, (vtkIdType)1));
+      }
+
+    this->CellOffsets[i] = offset;
+    offset += npts + 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkTriangleDepthSort::Sort(const double view[7], std::vector<vtkIdType>& order)
+{
+  vtkIdType n = (vtkIdType)this->CellOffsets.size();
+
+  if ((vtkIdType)order.size() != n)
+    {
+    order.resize(n);
+
+    for (vtkIdType i = 0; i < n; i++)
+      {
+      order[i] = i;
+      }
+    }
+
+  if (n < 2)
+    {
+    return true;
+    }
+
+  std::vector<unsigned int> keys(n);
+  std::vector<vtkIdType> cells(n);
+
+  vtkTriangleDepthSortWork work;
+  work.NumberOfCells = n;
+  work.NumberOfThreads = (int)std::max((vtkIdType)1, std::min((vtkIdType)this->NumberOfThreads, n / 4096));
+  work.Centroids = &this->Centroids[0];
+  std::copy(view, view + 7, work.View);
+  work.Order = &order[0];
+  work.Keys = &keys[0];
+  work.Cells = &cells[0];
+  work.Descents.assign(work.NumberOfThreads, 0);
+  work.Digits.assign(work.NumberOfThreads * radixSize, 0);
+
+
+  // Keys in the previous order, counting those out of order
+  this->Execute(&work, vtkTriangleDepthSortWork::ComputeKeys);
+
+  vtkIdType descents = 0;
+  for (int t = 0; t < work.NumberOfThreads; t++)
+    {
+    descents += work.Descents[t];
+
+    vtkIdType start = n * t / work.NumberOfThreads;
+    if (t > 0 && keys[start] < keys[start - 1])
+      {
+      descents++;
+      }
+    }
+
+  if (descents == 0)
+    {
+    return true;
+    }
+
+  if (this->IsSortCancelled())
+    {
+    return false;
+    }
+
+
+  // Nearly sorted orders finish by insertion, unless too many moves are needed
+  bool sorted = false;
+
+  if (descents <= n / 32)
+    {
+    sorted = vtkTriangleDepthSortInsertion(&keys[0], &cells[0], n, n * 4);
+    }
+
+
+  // Otherwise radix sort, skipping digits all keys share
+  if (!sorted)
+    {
+    std::vector<unsigned int> nextKeys(n);
+    std::vector<vtkIdType> nextCells(n);
+
+    work.NextKeys = &nextKeys[0];
+    work.NextCells = &nextCells[0];
+
+    for (work.Shift = 0; work.Shift < 32; work.Shift += radixBits)
+      {
+      std::fill(work.Digits.begin(), work.Digits.end(), 0);
+
+      this->Execute(&work, vtkTriangleDepthSortWork::CountDigits);
+
+      // Where each thread's keys with each digit go, keeping the order stable
+      vtkIdType total = 0;
+      bool shared = false;
+
+      for (int d = 0; d < radixSize; d++)
+        {
+        vtkIdType digitTotal = 0;
+
+        for (int t = 0; t < work.NumberOfThreads; t++)
+          {
+          vtkIdType count = work.Digits[t * radixSize + d];
+          work.Digits[t * radixSize + d] = total + digitTotal;
+          digitTotal += count;
+          }
+
+        shared = shared || digitTotal == n;
+        total += digitTotal;
+        }
+
+      if (shared)
+        {
+        continue;
+        }
+
+      this->Execute(&work, vtkTriangleDepthSortWork::Scatter);
+
+      std::swap(work.Keys, work.NextKeys);
+      std::swap(work.Cells, work.NextCells);
+
+      if (this->IsSortCancelled())
+        {
+        return false;
+        }
+      }
+
+    std::copy(work.Cells, work.Cells + n, order.begin());
+
+    return true;
+    }
+
+  std::copy(cells.begin(), cells.end(), order.begin());
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkTriangleDepthSort::Execute(vtkTriangleDepthSortWork* work, int phase)
+{
+  work->Phase = phase;
+
+  this->PassThreader->SetNumberOfThreads(work->NumberOfThreads);
+  this->PassThreader->SetSingleMethod(ExecutePhase, work);
+  this->PassThreader->SingleMethodExecute();
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkTriangleDepthSort::ExecutePhase(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkTriangleDepthSortWork* work = static_cast<vtkTriangleDepthSortWork*>(info->UserData);
+
+  int t = info->ThreadID;
+  vtkIdType start = work->NumberOfCells * t / work->NumberOfThreads;
+  vtkIdType end = work->NumberOfCells * (t + 1) / work->NumberOfThreads;
+
+  switch (work->Phase)
+    {
+    case vtkTriangleDepthSortWork::ComputeKeys:
+      {
+      // Distance from the camera for perspective, along the view direction for parallel.
+      // Farther polygons come first, so keys are inverted.
+      const double* v = work->View;
+      bool parallel = v[6] != 0.0;
+      vtkIdType descents = 0;
+
+      for (vtkIdType i = start; i < end; i++)
+        {
+        vtkIdType cell = work->Order[i];
+        const float* c = work->Centroids + cell * 3;
+
+        double d[3] = { c[0] - v[0], c[1] - v[1], c[2] - v[2] };
+        double depth = parallel ? d[0] * v[3] + d[1] * v[4] + d[2] * v[5] :
+                                  d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+
+        work->Keys[i] = ~vtkTriangleDepthSortFloatKey(static_cast<float>(depth));
+        work->Cells[i] = cell;
+
+        if (i > start && work->Keys[i] < work->Keys[i - 1])
+          {
+          descents++;
+          }
+        }
+
+      work->Descents[t] = descents;
+
+      break;
+      }
+
+    case vtkTriangleDepthSortWork::CountDigits:
+      {
+      vtkIdType* digits = &work->Digits[t * radixSize];
+
+      for (vtkIdType i = start; i < end; i++)
+        {
+        digits[(work->Keys[i] >> work->Shift) & (radixSize - 1)]++;
+        }
+
+      break;
+      }
+
+    case vtkTriangleDepthSortWork::Scatter:
+      {
+      vtkIdType* offsets = &work->Digits[t * radixSize];
+
+      for (vtkIdType i = start; i < end; i++)
+        {
+        vtkIdType j = offsets[(work->Keys[i] >> work->Shift) & (radixSize - 1)]++;
+
+        work->NextKeys[j] = work->Keys[i];
+        work->NextCells[j] = work->Cells[i];
+        }
+
+      break;
+      }
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkTriangleDepthSort::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Camera: " << this->Camera << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+}
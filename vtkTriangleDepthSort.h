@@ -0,0 +1,137 @@
+/*=========================================================================
+
+  Name:        vtkTriangleDepthSort.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Sorts the polygons of a surface back to front from a
+               camera, so translucent surfaces blend in depth order.
+
+               Polygons are sorted by the depth of their centroids: the
+               distance from the camera for perspective projection, or
+               the distance along the view direction for parallel
+               projection.  Depths are sorted with a parallel radix sort.
+               Each sort starts from the previous order, so when the view
+               has moved only a little and few polygons are out of order,
+               an insertion sort with a bounded number of moves finishes
+               in near linear time instead.
+
+               A new surface is sorted when the filter executes.  When
+               only the camera moves, UpdateOrder() sorts for the new
+               view on a background thread, and installs the order the
+               next time it is called after the sort is done, so sorting
+               costs at most a frame of latency and never blocks
+               rendering.  A background sort made stale by a new surface
+               is cancelled between its passes rather than waited for.
+               Only polygons are sorted.
+
+=========================================================================*/
+
+
+#ifndef __vtkTriangleDepthSort_h
+#define __vtkTriangleDepthSort_h
+
+#include <vtkCriticalSection.h>
+#include <vtkMultiThreader.h>
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+#include <vector>
+
+class vtkCamera;
+
+struct vtkTriangleDepthSortWork;
+
+
+class vtkTriangleDepthSort : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTriangleDepthSort *New();
+  vtkTypeMacro(vtkTriangleDepthSort, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Camera to sort for.  Changes to the camera do not modify the filter;
+  // call UpdateOrder() between frames instead.
+  virtual void SetCamera(vtkCamera*);
+  vtkGetObjectMacro(Camera, vtkCamera);
+
+  // Description:
+  // Number of threads used.  Defaults to the number of processors.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Call between frames.  Installs the order from a finished background
+  // sort, modifying the filter, and starts a background sort if the view
+  // has changed since the last sort.  Returns 1 if a new order was
+  // installed, so the surface should be rendered again.
+  int UpdateOrder();
+
+  // Description:
+  // Wait for a background sort to finish.
+  void WaitForSort();
+
+  // Description:
+  // Stop a background sort at its next pass and discard it.
+  void CancelSort();
+
+protected:
+  vtkTriangleDepthSort();
+  ~vtkTriangleDepthSort();
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+  // Compute the centroids of the polygons, and where each starts in the connectivity
+  void ComputeCentroids(vtkPolyData* input);
+
+  // Get the camera position, view direction, and projection as a view to sort for
+  void GetView(double view[7]);
+
+  // Sort the polygons back to front for a view, starting from the given order.  Returns false,
+  // leaving the order as it was, if the sort was cancelled.
+  bool Sort(const double view[7], std::vector<vtkIdType>& order);
+
+  // Whether the background sort has been cancelled
+  bool IsSortCancelled();
+
+  // Parallel pass over the polygons
+  void Execute(vtkTriangleDepthSortWork* work, int phase);
+
+  // Thread entry points
+  static VTK_THREAD_RETURN_TYPE SortInBackground(void* arg);
+  static VTK_THREAD_RETURN_TYPE ExecutePhase(void* arg);
+
+  vtkCamera* Camera;
+  int NumberOfThreads;
+
+  // Centroids of the polygons sorted, the start of each in the connectivity, and their source
+  std::vector<float> Centroids;
+  std::vector<vtkIdType> CellOffsets;
+  vtkPolyData* CentroidsInput;
+  unsigned long CentroidsTime;
+
+  // Order of the polygons output, and the view it was sorted for
+  std::vector<vtkIdType> Order;
+  double OrderView[7];
+
+  // Background sort, and its result once done
+  vtkSmartPointer<vtkMultiThreader> Threader;
+  int SortThreadID;
+  std::vector<vtkIdType> PendingOrder;
+  double PendingView[7];
+  int PendingReady;
+  int PendingCancelled;
+  vtkSimpleCriticalSection PendingLock;
+
+  // Threads for the passes of a sort, kept between passes
+  vtkSmartPointer<vtkMultiThreader> PassThreader;
+
+private:
+  vtkTriangleDepthSort(const vtkTriangleDepthSort&);  // Not implemented.
+  void operator=(const vtkTriangleDepthSort&);  // Not implemented.
+};
+
+#endif
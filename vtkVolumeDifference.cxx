@@ -0,0 +1,509 @@
+/*=========================================================================
+
+  Name:        vtkVolumeDifference.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Computes the difference of two scalar volumes.
+
+=========================================================================*/
+
+
+#include "vtkVolumeDifference.h"
+
+#include <vtkCriticalSection.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkRectilinearGrid.h>
+#include <vtkSmartPointer.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef USE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+vtkStandardNewMacro(vtkVolumeDifference);
+
+
+//----------------------------------------------------------------------------
+// Shared state for computing planes in parallel
+struct vtkVolumeDifferenceWork
+{
+  vtkVolumeDifference* Filter;
+
+  vtkDataArray* A;
+  vtkDataArray* B;
+  vtkDataArray* Output;
+
+  int Dimensions[3];
+  int BDimensions[3];
+
+  // If not on the same grid, the cell of B containing each coordinate of A along each axis, or -1
+  // if outside, and the interpolation weight within the cell
+  bool SameGrid;
+  std::vector<int> Index[3];
+  std::vector<double> Weight[3];
+
+  int NextPlane;
+  vtkSimpleCriticalSection Lock;
+};
+
+
+//----------------------------------------------------------------------------
+// Tolerance for comparing coordinates along an axis
+static double CoordinateTolerance(const std::vector<double>& coordinates)
+{
+  double length = coordinates.size() > 1 ? fabs(coordinates.back() - coordinates.front()) : 0.0;
+
+  return 1e-6 * std::max(length, 1.0);
+}
+
+//----------------------------------------------------------------------------
+// Find the cells of the second set of coordinates containing each of the first
+static void FindCells(const std::vector<double>& from, const std::vector<double>& to,
+                      std::vector<int>& index, std::vector<double>& weight)
+{
+  int n = (int)to.size();
+  double tolerance = CoordinateTolerance(to);
+
+  index.resize(from.size());
+  weight.resize(from.size());
+
+  for (int i = 0; i < (int)from.size(); i++)
+    {
+    double c = from[i];
+
+    if (c < to[0] - tolerance || c > to[n - 1] + tolerance)
+      {
+      index[i] = -1;
+      weight[i] = 0.0;
+      continue;
+      }
+
+    if (n == 1)
+      {
+      index[i] = 0;
+      weight[i] = 0.0;
+      continue;
+      }
+
+    int j = (int)(std::upper_bound(to.begin(), to.end(), c) - to.begin()) - 1;
+    j = std::min(std::max(j, 0), n - 2);
+
+    index[i] = j;
+    weight[i] = std::min(std::max((c - to[j]) / (to[j + 1] - to[j]), 0.0), 1.0);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Difference of arrays on the same grid
+template <class TA, class TB, class TO>
+static void vtkVolumeDifferenceSubtract(const TA* a, const TB* b, TO* out, vtkIdType n, double scale)
+{
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    out[i] = static_cast<TO>((static_cast<double>(a[i]) - static_cast<double>(b[i])) * scale);
+    }
+}
+
+#ifdef USE_SSE2
+//----------------------------------------------------------------------------
+// Float arrays four values at a time, in double precision as for other types
+static void vtkVolumeDifferenceSubtract(const float* a, const float* b, float* out, vtkIdType n, double scale)
+{
+  __m128d s = _mm_set1_pd(scale);
+
+  vtkIdType i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+    __m128 va = _mm_loadu_ps(a + i);
+    __m128 vb = _mm_loadu_ps(b + i);
+
+    __m128d low = _mm_sub_pd(_mm_cvtps_pd(va), _mm_cvtps_pd(vb));
+    __m128d high = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(va, va)), _mm_cvtps_pd(_mm_movehl_ps(vb, vb)));
+
+    __m128 low4 = _mm_cvtpd_ps(_mm_mul_pd(low, s));
+    __m128 high4 = _mm_cvtpd_ps(_mm_mul_pd(high, s));
+
+    _mm_storeu_ps(out + i, _mm_movelh_ps(low4, high4));
+    }
+
+  for (; i < n; i++)
+    {
+    out[i] = static_cast<float>((static_cast<double>(a[i]) - static_cast<double>(b[i])) * scale);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Double arrays two values at a time
+static void vtkVolumeDifferenceSubtract(const double* a, const double* b, double* out, vtkIdType n, double scale)
+{
+  __m128d s = _mm_set1_pd(scale);
+
+  vtkIdType i = 0;
+  for (; i + 2 <= n; i += 2)
+    {
+    __m128d d = _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+    _mm_storeu_pd(out + i, _mm_mul_pd(d, s));
+    }
+
+  for (; i < n; i++)
+    {
+    out[i] = (a[i] - b[i]) * scale;
+    }
+}
+#endif
+
+//----------------------------------------------------------------------------
+template <class TA, class TB, class TO>
+static void vtkVolumeDifferencePlane(vtkVolumeDifferenceWork* work, const TA* a, const TB* b, TO* out,
+                                     int z, double scale)
+{
+  int nx = work->Dimensions[0];
+  int ny = work->Dimensions[1];
+  vtkIdType begin = (vtkIdType)z * nx * ny;
+  vtkIdType end = begin + (vtkIdType)nx * ny;
+
+  if (work->SameGrid)
+    {
+    vtkVolumeDifferenceSubtract(a + begin, b + begin, out + begin, end - begin, scale);
+
+    return;
+    }
+
+
+  // Interpolate B at the points of A.  Flat axes of B have no neighbor to interpolate with.
+  const int* bDims = work->BDimensions;
+  vtkIdType dx = bDims[0] > 1 ? 1 : 0;
+  vtkIdType dy = bDims[1] > 1 ? bDims[0] : 0;
+  vtkIdType dz = bDims[2] > 1 ? (vtkIdType)bDims[0] * bDims[1] : 0;
+
+  int k = work->Index[2][z];
+  double wz = work->Weight[2][z];
+
+  vtkIdType i = begin;
+  for (int y = 0; y < ny; y++)
+    {
+    int j = work->Index[1][y];
+    double wy = work->Weight[1][y];
+
+    for (int x = 0; x < nx; x++, i++)
+      {
+      int h = work->Index[0][x];
+
+      // B is 0 outside of its bounds
+      double value = 0.0;
+
+      if (h >= 0 && j >= 0 && k >= 0)
+        {
+        double wx = work->Weight[0][x];
+        const TB* p = b + ((vtkIdType)k * bDims[1] + j) * bDims[0] + h;
+
+        double v00 = p[0] + wx * ((double)p[dx] - p[0]);
+        double v10 = p[dy] + wx * ((double)p[dy + dx] - p[dy]);
+        double v01 = p[dz] + wx * ((double)p[dz + dx] - p[dz]);
+        double v11 = p[dz + dy] + wx * ((double)p[dz + dy + dx] - p[dz + dy]);
+
+        double v0 = v00 + wy * (v10 - v00);
+        double v1 = v01 + wy * (v11 - v01);
+
+        value = v0 + wz * (v1 - v0);
+        }
+
+      out[i] = static_cast<TO>((static_cast<double>(a[i]) - value) * scale);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TA, class TB>
+static void vtkVolumeDifferenceOutput(vtkVolumeDifferenceWork* work, const TA* a, const TB* b,
+                                      int z, double scale)
+{
+  void* out = work->Output->GetVoidPointer(0);
+
+  if (work->Output->GetDataType() == VTK_DOUBLE)
+    {
+    vtkVolumeDifferencePlane(work, a, b, static_cast<double*>(out), z, scale);
+    }
+  else
+    {
+    vtkVolumeDifferencePlane(work, a, b, static_cast<float*>(out), z, scale);
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TA>
+static void vtkVolumeDifferenceB(vtkVolumeDifferenceWork* work, const TA* a, int z, double scale)
+{
+  // B has the type of A, or was converted to double
+  void* b = work->B->GetVoidPointer(0);
+
+  if (work->B->GetDataType() == work->A->GetDataType())
+    {
+    vtkVolumeDifferenceOutput(work, a, static_cast<const TA*>(b), z, scale);
+    }
+  else
+    {
+    vtkVolumeDifferenceOutput(work, a, static_cast<const double*>(b), z, scale);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+vtkVolumeDifference::vtkVolumeDifference()
+{
+  this->SetNumberOfInputPorts(2);
+
+  this->Scale = 1.0;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+}
+
+//----------------------------------------------------------------------------
+vtkVolumeDifference::~vtkVolumeDifference()
+{
+}
+
+//----------------------------------------------------------------------------
+bool vtkVolumeDifference::GetCoordinates(vtkDataSet* data, int axis, std::vector<double>& coordinates)
+{
+  coordinates.clear();
+
+  vtkImageData* image = vtkImageData::SafeDownCast(data);
+  if (image)
+    {
+    int extent[6];
+    image->GetExtent(extent);
+    double* origin = image->GetOrigin();
+    double* spacing = image->GetSpacing();
+
+    for (int i = extent[2 * axis]; i <= extent[2 * axis + 1]; i++)
+      {
+      coordinates.push_back(origin[axis] + i * spacing[axis]);
+      }
+
+    return true;
+    }
+
+  vtkRectilinearGrid* grid = vtkRectilinearGrid::SafeDownCast(data);
+  if (grid)
+    {
+    vtkDataArray* array = axis == 0 ? grid->GetXCoordinates() :
+                          axis == 1 ? grid->GetYCoordinates() :
+                                      grid->GetZCoordinates();
+    if (!array)
+      {
+      return false;
+      }
+
+    for (vtkIdType i = 0; i < array->GetNumberOfTuples(); i++)
+      {
+      coordinates.push_back(array->GetComponent(i, 0));
+      }
+
+    return true;
+    }
+
+  return false;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeDifference::FillInputPortInformation(int, vtkInformation* info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet");
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeDifference::RequestUpdateExtent(vtkInformation*,
+                                             vtkInformationVector** inputVector,
+                                             vtkInformationVector*)
+{
+  // Always request the whole of both volumes, as their extents need not match
+  for (int port = 0; port < 2; port++)
+    {
+    vtkInformation* inInfo = inputVector[port]->GetInformationObject(0);
+
+    if (inInfo && inInfo->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()))
+      {
+      inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+                  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+      }
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeDifference::RequestData(vtkInformation*,
+                                     vtkInformationVector** inputVector,
+                                     vtkInformationVector* outputVector)
+{
+  vtkDataSet* inputA = vtkDataSet::GetData(inputVector[0], 0);
+  vtkDataSet* inputB = vtkDataSet::GetData(inputVector[1], 0);
+  vtkDataSet* output = vtkDataSet::GetData(outputVector, 0);
+
+  if (!inputA || !inputB || !output)
+    {
+    return 0;
+    }
+
+  vtkDataArray* a = inputA->GetPointData()->GetScalars();
+  vtkDataArray* b = inputB->GetPointData()->GetScalars();
+
+  if (!a || !b || a->GetNumberOfComponents() != 1 || b->GetNumberOfComponents() != 1)
+    {
+    vtkErrorMacro("Both inputs need single component point scalars");
+    return 0;
+    }
+
+
+  // Compare the grids
+  vtkVolumeDifferenceWork work;
+  work.Filter = this;
+  work.SameGrid = true;
+
+  for (int i = 0; i < 3; i++)
+    {
+    std::vector<double> coordinatesA;
+    std::vector<double> coordinatesB;
+
+    if (!GetCoordinates(inputA, i, coordinatesA) || !GetCoordinates(inputB, i, coordinatesB) ||
+        coordinatesA.empty() || coordinatesB.empty())
+      {
+      vtkErrorMacro("Inputs must be uniform or rectilinear grids");
+      return 0;
+      }
+
+    work.Dimensions[i] = (int)coordinatesA.size();
+    work.BDimensions[i] = (int)coordinatesB.size();
+
+    if (coordinatesA.size() != coordinatesB.size())
+      {
+      work.SameGrid = false;
+      }
+    else
+      {
+      double tolerance = CoordinateTolerance(coordinatesA);
+
+      for (int j = 0; j < (int)coordinatesA.size(); j++)
+        {
+        if (fabs(coordinatesA[j] - coordinatesB[j]) > tolerance)
+          {
+          work.SameGrid = false;
+          break;
+          }
+        }
+      }
+
+    FindCells(coordinatesA, coordinatesB, work.Index[i], work.Weight[i]);
+    }
+
+  if (work.SameGrid)
+    {
+    for (int i = 0; i < 3; i++)
+      {
+      std::vector<int>().swap(work.Index[i]);
+      std::vector<double>().swap(work.Weight[i]);
+      }
+    }
+
+
+  // Output precision follows the inputs
+  vtkSmartPointer<vtkDataArray> difference;
+  if (a->GetDataType() == VTK_DOUBLE || b->GetDataType() == VTK_DOUBLE)
+    {
+    difference = vtkSmartPointer<vtkDoubleArray>::New();
+    }
+  else
+    {
+    difference = vtkSmartPointer<vtkFloatArray>::New();
+    }
+
+  difference->SetName("Difference");
+  difference->SetNumberOfTuples(inputA->GetNumberOfPoints());
+
+  // Avoid instantiating every pair of types by converting B if it differs from A
+  vtkSmartPointer<vtkDataArray> converted;
+  if (b->GetDataType() != a->GetDataType())
+    {
+    converted = vtkSmartPointer<vtkDoubleArray>::New();
+    converted->DeepCopy(b);
+    b = converted;
+    }
+
+  work.A = a;
+  work.B = b;
+  work.Output = difference;
+  work.NextPlane = 0;
+
+
+  // Compute planes in parallel
+  vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+  threader->SetNumberOfThreads(std::min(this->NumberOfThreads, work.Dimensions[2]));
+  threader->SetSingleMethod(ComputePlanes, &work);
+  threader->SingleMethodExecute();
+
+
+  output->CopyStructure(inputA);
+  output->GetPointData()->SetScalars(difference);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkVolumeDifference::ComputePlanes(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkVolumeDifferenceWork* work = static_cast<vtkVolumeDifferenceWork*>(info->UserData);
+
+  // Take planes until none are left
+  for (;;)
+    {
+    work->Lock.Lock();
+    int z = work->NextPlane++;
+    work->Lock.Unlock();
+
+    if (z >= work->Dimensions[2])
+      {
+      break;
+      }
+
+    work->Filter->ComputePlane(work, z);
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkVolumeDifference::ComputePlane(vtkVolumeDifferenceWork* work, int z)
+{
+  void* a = work->A->GetVoidPointer(0);
+
+  switch (work->A->GetDataType())
+    {
+    vtkTemplateMacro(vtkVolumeDifferenceB(work, static_cast<const VTK_TT*>(a), z, this->Scale));
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkVolumeDifference::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Scale: " << this->Scale << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+}
@@ -0,0 +1,82 @@
+/*=========================================================================
+
+  Name:        vtkVolumeDifference.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Computes the difference of two scalar volumes,
+               (A - B) * Scale, where A is connected to input port 0 and
+               B to input port 1.  Both must be uniform or rectilinear
+               grids with a single scalar component.
+
+               The output has the grid of A.  If B is on the same grid,
+               the difference is computed in one pass over the arrays,
+               with SSE2 for float and double arrays.
+               Otherwise B is trilinearly interpolated at the points of A,
+               with B taken as 0 outside of its bounds.  The volume is
+               split into z planes that are computed in parallel.
+
+               The output is double if either input is double, and float
+               otherwise.
+
+=========================================================================*/
+
+
+#ifndef __vtkVolumeDifference_h
+#define __vtkVolumeDifference_h
+
+#include <vtkDataSetAlgorithm.h>
+#include <vtkMultiThreader.h>
+
+#include <vector>
+
+struct vtkVolumeDifferenceWork;
+
+
+class vtkVolumeDifference : public vtkDataSetAlgorithm
+{
+public:
+  static vtkVolumeDifference *New();
+  vtkTypeMacro(vtkVolumeDifference, vtkDataSetAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Factor to multiply the difference by.  Defaults to 1.
+  vtkSetMacro(Scale, double);
+  vtkGetMacro(Scale, double);
+
+  // Description:
+  // Number of threads used.  Defaults to the number of processors.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Get the point coordinates of a uniform or rectilinear grid along an
+  // axis.  Returns false for other data sets.
+  static bool GetCoordinates(vtkDataSet* data, int axis, std::vector<double>& coordinates);
+
+protected:
+  vtkVolumeDifference();
+  ~vtkVolumeDifference();
+
+  virtual int FillInputPortInformation(int port, vtkInformation* info);
+  virtual int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+  virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+  // Compute the difference for one z plane
+  void ComputePlane(vtkVolumeDifferenceWork* work, int z);
+
+  // Thread entry point
+  static VTK_THREAD_RETURN_TYPE ComputePlanes(void* arg);
+
+  double Scale;
+  int NumberOfThreads;
+
+private:
+  vtkVolumeDifference(const vtkVolumeDifference&);  // Not implemented.
+  void operator=(const vtkVolumeDifference&);  // Not implemented.
+};
+
+#endif
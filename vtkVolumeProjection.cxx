@@ -0,0 +1,619 @@
+/*=========================================================================
+
+  Name:        vtkVolumeProjection.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Projects a volume along each axis, for rendering on the
+               walls in place of slices.
+
+=========================================================================*/
+
+
+#include "vtkVolumeProjection.h"
+
+#include "vtkVolumeDifference.h"
+#include "vtkVolumeSlab.h"
+
+#include <vtkCompositeDataSet.h>
+#include <vtkCriticalSection.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+vtkStandardNewMacro(vtkVolumeProjection);
+
+
+//----------------------------------------------------------------------------
+// Shared state for projecting the planes of the volume in parallel
+struct vtkVolumeProjectionWork
+{
+  vtkDataArray* Scalars;
+  int Dimensions[3];
+
+  // Integration weights along each axis
+  std::vector<double> Weights[3];
+
+  // Projections along x and y, for each mode.  Each plane normal to z writes its own rows.
+  float* Images[2][3];
+
+  // Projections along z for each mode, accumulated per thread and combined at the end
+  std::vector<std::vector<double> > Partials;
+
+  // Projections of a plane along y for each mode, per thread
+  std::vector<std::vector<double> > Rows;
+
+  int NextPlane;
+  vtkSimpleCriticalSection Lock;
+};
+
+
+//----------------------------------------------------------------------------
+// Keep the signed value of largest magnitude
+static inline double vtkVolumeProjectionMaximumMagnitude(double a, double b)
+{
+  return fabs(b) > fabs(a) ? b : a;
+}
+
+//----------------------------------------------------------------------------
+// Project one plane normal to z along all three axes
+template <class T>
+static void vtkVolumeProjectionPlane(vtkVolumeProjectionWork* work, const T* values, int z,
+                                     double* partial, double* rows)
+{
+  int nx = work->Dimensions[0];
+  int ny = work->Dimensions[1];
+  vtkIdType nxy = (vtkIdType)nx * ny;
+
+  const double* wx = &work->Weights[0][0];
+  const double* wy = &work->Weights[1][0];
+  double wz = work->Weights[2][z];
+
+  // Along y, within the plane
+  double* yMax = rows;
+  double* yMin = rows + nx;
+  double* ySum = rows + 2 * nx;
+
+  for (int x = 0; x < nx; x++)
+    {
+    yMax[x] = 0.0;
+    yMin[x] = VTK_DOUBLE_MAX;
+    ySum[x] = 0.0;
+    }
+
+  // Along z, across planes
+  double* zMax = partial;
+  double* zMin = partial + nxy;
+  double* zSum = partial + 2 * nxy;
+
+  for (int y = 0; y < ny; y++)
+    {
+    const T* row = values + (z * nxy + (vtkIdType)y * nx);
+    vtkIdType offset = (vtkIdType)y * nx;
+    double w = wy[y];
+
+    // Along x, within the row
+    double xMax = 0.0;
+    double xMin = VTK_DOUBLE_MAX;
+    double xSum = 0.0;
+
+    for (int x = 0; x < nx; x++)
+      {
+      double v = row[x];
+
+      xMax = vtkVolumeProjectionMaximumMagnitude(xMax, v);
+      xMin = std::min(xMin, v);
+      xSum += v * wx[x];
+
+      yMax[x] = vtkVolumeProjectionMaximumMagnitude(yMax[x], v);
+      yMin[x] = std::min(yMin[x], v);
+      ySum[x] += v * w;
+
+      zMax[offset + x] = vtkVolumeProjectionMaximumMagnitude(zMax[offset + x], v);
+      zMin[offset + x] = std::min(zMin[offset + x], v);
+      zSum[offset + x] += v * wz;
+      }
+
+    // The projection along x is indexed by y, then z
+    vtkIdType i = (vtkIdType)z * ny + y;
+    work->Images[0][vtkVolumeProjection::MaximumMagnitude][i] = static_cast<float>(xMax);
+    work->Images[0][vtkVolumeProjection::Minimum][i] = static_cast<float>(xMin);
+    work->Images[0][vtkVolumeProjection::Integrated][i] = static_cast<float>(xSum);
+    }
+
+  // The projection along y is indexed by x, then z
+  for (int x = 0; x < nx; x++)
+    {
+    vtkIdType i = (vtkIdType)z * nx + x;
+    work->Images[1][vtkVolumeProjection::MaximumMagnitude][i] = static_cast<float>(yMax[x]);
+    work->Images[1][vtkVolumeProjection::Minimum][i] = static_cast<float>(yMin[x]);
+    work->Images[1][vtkVolumeProjection::Integrated][i] = static_cast<float>(ySum[x]);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+vtkVolumeProjection::vtkVolumeProjection()
+{
+  this->Mode = MaximumMagnitude;
+  this->NumberOfCachedFields = 4;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  this->SetNumberOfInputPorts(1);
+  this->SetNumberOfOutputPorts(3);
+}
+
+//----------------------------------------------------------------------------
+vtkVolumeProjection::~vtkVolumeProjection()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkVolumeProjection::GetProjectionOutput(int axis)
+{
+  return vtkImageData::SafeDownCast(this->GetOutputDataObject(axis));
+}
+
+//----------------------------------------------------------------------------
+bool vtkVolumeProjection::IsShown(vtkDataArray* image)
+{
+  for (int axis = 0; axis < 3; axis++)
+    {
+    vtkImageData* output = this->GetProjectionOutput(axis);
+
+    if (output && output->GetPointData()->GetScalars() == image)
+      {
+      return true;
+      }
+    }
+
+  return false;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkVolumeProjection::GetCacheSize()
+{
+  // Projections shown are counted with the outputs
+  unsigned long size = 0;
+  for (int i = 0; i < (int)this->Cache.size(); i++)
+    {
+    for (int axis = 0; axis < 3; axis++)
+      {
+      for (int mode = 0; mode < 3; mode++)
+        {
+        vtkFloatArray* image = this->Cache[i].Images[axis][mode];
+
+        if (image && !this->IsShown(image))
+          {
+          size += image->GetActualMemorySize();
+          }
+        }
+      }
+    }
+
+  return size;
+}
+
+//----------------------------------------------------------------------------
+void vtkVolumeProjection::ReleaseCache()
+{
+  // Keep only the projections shown, and the fields they belong to
+  std::vector<Projections> kept;
+
+  for (int i = 0; i < (int)this->Cache.size(); i++)
+    {
+    bool shown = false;
+
+    for (int axis = 0; axis < 3; axis++)
+      {
+      for (int mode = 0; mode < 3; mode++)
+        {
+        vtkSmartPointer<vtkFloatArray>& image = this->Cache[i].Images[axis][mode];
+
+        if (image && this->IsShown(image))
+          {
+          shown = true;
+          }
+        else
+          {
+          image = NULL;
+          }
+        }
+      }
+
+    if (shown)
+      {
+      kept.push_back(this->Cache[i]);
+      }
+    }
+
+  this->Cache = kept;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeProjection::FillInputPortInformation(int, vtkInformation* info)
+{
+  // Grids or multi-block grids
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataObject");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeProjection::FillOutputPortInformation(int, vtkInformation* info)
+{
+  info->Set(vtkDataObject::DATA_TYPE_NAME(), "vtkImageData");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeProjection::ProcessRequest(vtkInformation* request,
+                                        vtkInformationVector** inputVector,
+                                        vtkInformationVector* outputVector)
+{
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_DATA()))
+    {
+    return this->RequestData(request, inputVector, outputVector);
+    }
+
+  if (request->Has(vtkStreamingDemandDrivenPipeline::REQUEST_UPDATE_EXTENT()))
+    {
+    return this->RequestUpdateExtent(request, inputVector, outputVector);
+    }
+
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_INFORMATION()))
+    {
+    return this->RequestInformation(request, inputVector, outputVector);
+    }
+
+  return this->Superclass::ProcessRequest(request, inputVector, outputVector);
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeProjection::RequestInformation(vtkInformation*,
+                                            vtkInformationVector** inputVector,
+                                            vtkInformationVector* outputVector)
+{
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+
+  if (!inInfo)
+    {
+    return 0;
+    }
+
+  // Dimensions from the whole extent, or from the grid for multi-block grids, which have none
+  int dimensions[3];
+  vtkDataObject* input = inInfo->Get(vtkDataObject::DATA_OBJECT());
+
+  if (inInfo->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()) &&
+      !vtkCompositeDataSet::SafeDownCast(input))
+    {
+    int* extent = inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT());
+
+    for (int i = 0; i < 3; i++)
+      {
+      dimensions[i] = extent[2 * i + 1] - extent[2 * i] + 1;
+      }
+    }
+  else
+    {
+    vtkDataSet* grid = vtkVolumeSlab::GetGrid(input);
+
+    for (int i = 0; i < 3; i++)
+      {
+      std::vector<double> coordinates;
+
+      if (!grid || !vtkVolumeDifference::GetCoordinates(grid, i, coordinates))
+        {
+        vtkErrorMacro("Input must be a uniform, rectilinear, or nested grid");
+        return 0;
+        }
+
+      dimensions[i] = (int)coordinates.size();
+      }
+    }
+
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+
+  for (int axis = 0; axis < 3; axis++)
+    {
+    int u = axis == 0 ? 1 : 0;
+    int v = axis == 2 ? 1 : 2;
+
+    int extent[6] = { 0, dimensions[u] - 1, 0, dimensions[v] - 1, 0, 0 };
+
+    vtkInformation* outInfo = outputVector->GetInformationObject(axis);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent, 6);
+    outInfo->Set(vtkDataObject::ORIGIN(), origin, 3);
+    outInfo->Set(vtkDataObject::SPACING(), spacing, 3);
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeProjection::RequestUpdateExtent(vtkInformation*,
+                                             vtkInformationVector** inputVector,
+                                             vtkInformationVector*)
+{
+  // Every projection spans the whole volume
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+
+  if (inInfo && inInfo->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()))
+    {
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+                inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeProjection::RequestData(vtkInformation*,
+                                     vtkInformationVector** inputVector,
+                                     vtkInformationVector* outputVector)
+{
+  vtkDataSet* grid = vtkVolumeSlab::GetGrid(vtkDataObject::GetData(inputVector[0], 0));
+
+  if (!grid)
+    {
+    vtkErrorMacro("Input must be a uniform, rectilinear, or nested grid");
+    return 0;
+    }
+
+  vtkDataArray* scalars = grid->GetPointData()->GetScalars();
+
+  if (!scalars || scalars->GetNumberOfComponents() != 1)
+    {
+    vtkErrorMacro("Input needs single component point scalars");
+    return 0;
+    }
+
+
+  // Use the projections of this field if kept, otherwise project it
+  int index = -1;
+  for (int i = 0; i < (int)this->Cache.size(); i++)
+    {
+    if (this->Cache[i].Scalars == scalars &&
+        this->Cache[i].ScalarsTime == scalars->GetMTime())
+      {
+      index = i;
+      break;
+      }
+    }
+
+  // Projections of other modes may have been released
+  if (index >= 0 && !this->Cache[index].Images[0][this->Mode])
+    {
+    this->Cache.erase(this->Cache.begin() + index);
+    index = -1;
+    }
+
+  if (index < 0)
+    {
+    Projections projections;
+
+    if (!this->Project(grid, scalars, &projections))
+      {
+      return 0;
+      }
+
+    this->Cache.insert(this->Cache.begin(), projections);
+
+    if ((int)this->Cache.size() > this->NumberOfCachedFields)
+      {
+      this->Cache.resize(this->NumberOfCachedFields);
+      }
+    }
+  else if (index > 0)
+    {
+    // Most recent first
+    Projections projections = this->Cache[index];
+    this->Cache.erase(this->Cache.begin() + index);
+    this->Cache.insert(this->Cache.begin(), projections);
+    }
+
+  Projections& projections = this->Cache[0];
+
+
+  // Pass the projections of the mode
+  std::vector<double> coordinates[3];
+  for (int i = 0; i < 3; i++)
+    {
+    vtkVolumeDifference::GetCoordinates(grid, i, coordinates[i]);
+    }
+
+  for (int axis = 0; axis < 3; axis++)
+    {
+    int u = axis == 0 ? 1 : 0;
+    int v = axis == 2 ? 1 : 2;
+
+    vtkImageData* output = vtkImageData::GetData(outputVector, axis);
+    output->Initialize();
+    output->SetExtent(0, (int)coordinates[u].size() - 1, 0, (int)coordinates[v].size() - 1, 0, 0);
+    output->SetOrigin(0.0, 0.0, 0.0);
+    output->SetSpacing(1.0, 1.0, 1.0);
+    output->GetPointData()->SetScalars(projections.Images[axis][this->Mode]);
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkVolumeProjection::Project(vtkDataSet* grid, vtkDataArray* scalars, Projections* projections)
+{
+  vtkVolumeProjectionWork work;
+  work.Scalars = scalars;
+
+  for (int i = 0; i < 3; i++)
+    {
+    std::vector<double> c;
+
+    if (!vtkVolumeDifference::GetCoordinates(grid, i, c) || c.empty())
+      {
+      vtkErrorMacro("Input must be a uniform, rectilinear, or nested grid");
+      return false;
+      }
+
+    int n = (int)c.size();
+    work.Dimensions[i] = n;
+
+    // Trapezoid weights, so integrals follow the spacing of rectilinear grids
+    work.Weights[i].assign(n, 1.0);
+
+    if (n > 1)
+      {
+      work.Weights[i][0] = (c[1] - c[0]) * 0.5;
+      work.Weights[i][n - 1] = (c[n - 1] - c[n - 2]) * 0.5;
+
+      for (int j = 1; j < n - 1; j++)
+        {
+        work.Weights[i][j] = (c[j + 1] - c[j - 1]) * 0.5;
+        }
+      }
+    }
+
+  int nx = work.Dimensions[0];
+  int ny = work.Dimensions[1];
+  int nz = work.Dimensions[2];
+
+  if (scalars->GetNumberOfTuples() != (vtkIdType)nx * ny * nz)
+    {
+    vtkErrorMacro("Scalars do not match the grid");
+    return false;
+    }
+
+  projections->Scalars = scalars;
+  projections->ScalarsTime = scalars->GetMTime();
+
+  const char* names[3] = { "MaximumMagnitude", "Minimum", "Integrated" };
+
+  for (int axis = 0; axis < 3; axis++)
+    {
+    int u = axis == 0 ? 1 : 0;
+    int v = axis == 2 ? 1 : 2;
+
+    for (int mode = 0; mode < 3; mode++)
+      {
+      vtkFloatArray* image = vtkFloatArray::New();
+      image->SetName(names[mode]);
+      image->SetNumberOfTuples((vtkIdType)work.Dimensions[u] * work.Dimensions[v]);
+
+      projections->Images[axis][mode].TakeReference(image);
+
+      if (axis < 2)
+        {
+        work.Images[axis][mode] = image->GetPointer(0);
+        }
+      }
+    }
+
+
+  // Project the planes normal to z in parallel
+  int numberOfThreads = std::max(1, std::min(this->NumberOfThreads, nz));
+  vtkIdType nxy = (vtkIdType)nx * ny;
+
+  work.Partials.resize(numberOfThreads);
+  work.Rows.resize(numberOfThreads);
+
+  for (int i = 0; i < numberOfThreads; i++)
+    {
+    work.Partials[i].resize(3 * nxy);
+    std::fill(work.Partials[i].begin(), work.Partials[i].begin() + nxy, 0.0);
+    std::fill(work.Partials[i].begin() + nxy, work.Partials[i].begin() + 2 * nxy, VTK_DOUBLE_MAX);
+    std::fill(work.Partials[i].begin() + 2 * nxy, work.Partials[i].end(), 0.0);
+
+    work.Rows[i].resize(3 * nx);
+    }
+
+  work.NextPlane = 0;
+
+  vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+  threader->SetNumberOfThreads(numberOfThreads);
+  threader->SetSingleMethod(ProjectPlanes, &work);
+  threader->SingleMethodExecute();
+
+
+  // Combine the threads' projections along z
+  float* zImages[3];
+  for (int mode = 0; mode < 3; mode++)
+    {
+    zImages[mode] = projections->Images[2][mode]->GetPointer(0);
+    }
+
+  for (vtkIdType i = 0; i < nxy; i++)
+    {
+    double zMax = 0.0;
+    double zMin = VTK_DOUBLE_MAX;
+    double zSum = 0.0;
+
+    for (int t = 0; t < numberOfThreads; t++)
+      {
+      const double* partial = &work.Partials[t][0];
+
+      zMax = vtkVolumeProjectionMaximumMagnitude(zMax, partial[i]);
+      zMin = std::min(zMin, partial[nxy + i]);
+      zSum += partial[2 * nxy + i];
+      }
+
+    zImages[MaximumMagnitude][i] = static_cast<float>(zMax);
+    zImages[Minimum][i] = static_cast<float>(zMin);
+    zImages[Integrated][i] = static_cast<float>(zSum);
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkVolumeProjection::ProjectPlanes(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkVolumeProjectionWork* work = static_cast<vtkVolumeProjectionWork*>(info->UserData);
+
+  double* partial = &work->Partials[info->ThreadID][0];
+  double* rows = &work->Rows[info->ThreadID][0];
+  void* values = work->Scalars->GetVoidPointer(0);
+
+  // Take planes until none are left
+  for (;;)
+    {
+    work->Lock.Lock();
+    int z = work->NextPlane++;
+    work->Lock.Unlock();
+
+    if (z >= work->Dimensions[2])
+      {
+      break;
+      }
+
+    switch (work->Scalars->GetDataType())
+      {
+      vtkTemplateMacro(vtkVolumeProjectionPlane(work, static_cast<const VTK_TT*>(values), z,
+                                                partial, rows));
+      }
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkVolumeProjection::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Mode: " << this->Mode << "\n";
+  os << indent << "NumberOfCachedFields: " << this->NumberOfCachedFields << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+}
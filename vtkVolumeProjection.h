@@ -0,0 +1,137 @@
+/*=========================================================================
+
+  Name:        vtkVolumeProjection.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Projects a volume along each axis, for rendering on the
+               walls in place of slices, so features away from the middle
+               of the volume show.
+
+               Output i is the projection along axis i as a 2D float
+               image, in index space and laid out like the slices of
+               vtkVolumeSlab, so it can be textured on the same surface.
+               The projection is the signed value of largest magnitude
+               along each line, the minimum value, or the integral of the
+               value along the line, e.g. the column density of a density.
+
+               All three projections along all three axes come from one
+               pass over the volume, in parallel blocks of planes.  They
+               are kept for the last few fields, by scalar array, so
+               switching projections or going back to a field does not
+               read the volume again.
+
+               Uniform and rectilinear grids are supported, and for
+               nested multi-block grids the first (coarsest) block is
+               used, as it covers the whole volume.
+
+=========================================================================*/
+
+
+#ifndef __vtkVolumeProjection_h
+#define __vtkVolumeProjection_h
+
+#include <vtkAlgorithm.h>
+#include <vtkMultiThreader.h>
+#include <vtkSmartPointer.h>
+
+#include <vector>
+
+class vtkDataArray;
+class vtkDataSet;
+class vtkFloatArray;
+class vtkImageData;
+
+struct vtkVolumeProjectionWork;
+
+
+class vtkVolumeProjection : public vtkAlgorithm
+{
+public:
+  static vtkVolumeProjection *New();
+  vtkTypeMacro(vtkVolumeProjection, vtkAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  enum
+  {
+    MaximumMagnitude = 0,
+    Minimum,
+    Integrated
+  };
+
+  // Description:
+  // Projection output.  Defaults to MaximumMagnitude.
+  vtkSetClampMacro(Mode, int, MaximumMagnitude, Integrated);
+  vtkGetMacro(Mode, int);
+  void SetModeToMaximumMagnitude() { this->SetMode(MaximumMagnitude); }
+  void SetModeToMinimum() { this->SetMode(Minimum); }
+  void SetModeToIntegrated() { this->SetMode(Integrated); }
+
+  // Description:
+  // Number of fields whose projections are kept.  Defaults to 4.
+  vtkSetClampMacro(NumberOfCachedFields, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfCachedFields, int);
+
+  // Description:
+  // Number of threads used.  Defaults to the number of processors.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Get the projection along an axis.
+  vtkImageData* GetProjectionOutput(int axis);
+
+  // Description:
+  // Get the memory held by the projections kept besides those shown, in
+  // kilobytes, and release them.  Released projections are computed again
+  // when next needed.
+  unsigned long GetCacheSize();
+  void ReleaseCache();
+
+  // Description:
+  // See vtkAlgorithm for details.
+  virtual int ProcessRequest(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+protected:
+  vtkVolumeProjection();
+  ~vtkVolumeProjection();
+
+  virtual int FillInputPortInformation(int port, vtkInformation* info);
+  virtual int FillOutputPortInformation(int port, vtkInformation* info);
+
+  virtual int RequestInformation(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+  virtual int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+  virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+  // Projections of one field: along each axis, for each mode
+  struct Projections
+  {
+    vtkDataArray* Scalars;
+    unsigned long ScalarsTime;
+    vtkSmartPointer<vtkFloatArray> Images[3][3];
+  };
+
+  // Whether an image is shown on one of the outputs
+  bool IsShown(vtkDataArray* image);
+
+  // Compute the projections of a field in one pass
+  bool Project(vtkDataSet* grid, vtkDataArray* scalars, Projections* projections);
+
+  // Thread entry point
+  static VTK_THREAD_RETURN_TYPE ProjectPlanes(void* arg);
+
+  int Mode;
+  int NumberOfCachedFields;
+  int NumberOfThreads;
+
+  // Projections of the fields last projected, most recent first
+  std::vector<Projections> Cache;
+
+private:
+  vtkVolumeProjection(const vtkVolumeProjection&);  // Not implemented.
+  void operator=(const vtkVolumeProjection&);  // Not implemented.
+};
+
+#endif
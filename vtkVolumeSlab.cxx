@@ -0,0 +1,888 @@
+/*=========================================================================
+
+  Name:        vtkVolumeSlab.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Extracts a slice of a volume along an axis, for rendering
+               as a texture.
+
+=========================================================================*/
+
+
+#include "vtkVolumeSlab.h"
+
+#include "vtkNestedGridBlanking.h"
+#include "vtkVolumeDifference.h"
+
+#include <vtkCellArray.h>
+#include <vtkCriticalSection.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkRectilinearGrid.h>
+#include <vtkSmartPointer.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtkUniformGrid.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+
+vtkStandardNewMacro(vtkVolumeSlab);
+
+
+//----------------------------------------------------------------------------
+// Shared state for copying the rows of a block of planes in parallel
+struct vtkVolumeSlabWork
+{
+  const char* Input;
+  size_t TupleSize;
+
+  // Points per row and rows per plane, and the input strides in tuples along a row, between 
+  // rows, and between planes
+  int Size[2];
+  vtkIdType Stride[3];
+
+  int FirstPlane;
+  std::vector<char*> Planes;
+
+  int NextRow;
+  vtkSimpleCriticalSection Lock;
+};
+
+
+//----------------------------------------------------------------------------
+// Copy one row of each plane of the block
+static void vtkVolumeSlabCopyRow(vtkVolumeSlabWork* work, int row)
+{
+  size_t tupleSize = work->TupleSize;
+  int n = work->Size[0];
+  int count = (int)work->Planes.size();
+
+  const char* in = work->Input + (work->FirstPlane * work->Stride[2] + row * work->Stride[1]) * tupleSize;
+  size_t offset = (size_t)row * n * tupleSize;
+
+  if (work->Stride[0] == 1)
+    {
+    // Contiguous rows, one per plane
+    for (int p = 0; p < count; p++)
+      {
+      memcpy(work->Planes[p] + offset, in + p * work->Stride[2] * tupleSize, n * tupleSize);
+      }
+
+    return;
+    }
+
+  // Slices across x.  The planes of the block are adjacent along x, so each point of the row 
+  // reads one short contiguous run, shared by all planes, rather than a cache line per plane.
+  for (int i = 0; i < n; i++)
+    {
+    const char* run = in + i * work->Stride[0] * tupleSize;
+
+    for (int p = 0; p < count; p++)
+      {
+      memcpy(work->Planes[p] + offset + i * tupleSize, run + p * tupleSize, tupleSize);
+      }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Find the cell of a block containing each slab coordinate, and the weight within it, or -1 for
+// coordinates outside of the block
+static void vtkVolumeSlabLocate(const std::vector<double>& from, const std::vector<double>& to,
+                                std::vector<int>& index, std::vector<double>& weight)
+{
+  int n = (int)to.size();
+  double tolerance = 1e-6 * std::max(fabs(to.back() - to.front()), 1.0);
+
+  index.assign(from.size(), -1);
+  weight.assign(from.size(), 0.0);
+
+  for (int i = 0; i < (int)from.size(); i++)
+    {
+    double c = from[i];
+
+    if (c < to[0] - tolerance || c > to[n - 1] + tolerance)
+      {
+      continue;
+      }
+
+    if (n == 1)
+      {
+      index[i] = 0;
+      continue;
+      }
+
+    int j = (int)(std::upper_bound(to.begin(), to.end(), c) - to.begin()) - 1;
+    j = std::min(std::max(j, 0), n - 2);
+
+    index[i] = j;
+    weight[i] = std::min(std::max((c - to[j]) / (to[j + 1] - to[j]), 0.0), 1.0);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Interpolate the plane of a block at a coordinate along the axis, between planes k and k + dk
+// with weight w, at the slab points inside the block
+template <class T>
+static void vtkVolumeSlabSampleBlock(const T* values, const int dimensions[3], int axis, int k,
+                                     int dk, double w, const std::vector<int> index[2],
+                                     const std::vector<double> weight[2], double* plane)
+{
+  int u = axis == 0 ? 1 : 0;
+  int v = axis == 2 ? 1 : 2;
+
+  // Strides of the block along each axis, with no neighbor along flat in-plane axes
+  vtkIdType stride[3] = { 1, dimensions[0], (vtkIdType)dimensions[0] * dimensions[1] };
+  vtkIdType du = dimensions[u] > 1 ? stride[u] : 0;
+  vtkIdType dv = dimensions[v] > 1 ? stride[v] : 0;
+  vtkIdType dw = dk * stride[axis];
+
+  int nu = (int)index[0].size();
+  int nv = (int)index[1].size();
+
+  for (int j = 0; j < nv; j++)
+    {
+    int b = index[1][j];
+    if (b < 0)
+      {
+      continue;
+      }
+
+    double wv = weight[1][j];
+
+    for (int i = 0; i < nu; i++)
+      {
+      int a = index[0][i];
+      if (a < 0)
+        {
+        continue;
+        }
+
+      double wu = weight[0][i];
+      const T* p = values + k * stride[axis] + a * stride[u] + b * stride[v];
+
+      double v0 = p[0] + wu * ((double)p[du] - p[0]);
+      double v1 = p[dv] + wu * ((double)p[dv + du] - p[dv]);
+      double w0 = v0 + wv * (v1 - v0);
+
+      p += dw;
+      v0 = p[0] + wu * ((double)p[du] - p[0]);
+      v1 = p[dv] + wu * ((double)p[dv + du] - p[dv]);
+      double w1 = v0 + wv * (v1 - v0);
+
+      plane[(vtkIdType)j * nu + i] = w0 + w * (w1 - w0);
+      }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+vtkVolumeSlab::vtkVolumeSlab()
+{
+  this->Axis = 2;
+  this->Slice = -1;
+  this->NumberOfPrefetchPlanes = 8;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  this->FirstPlane = 0;
+  this->CachedScalars = NULL;
+  this->CachedGridTime = 0;
+
+  this->SetNumberOfInputPorts(1);
+  this->SetNumberOfOutputPorts(3);
+}
+
+//----------------------------------------------------------------------------
+vtkVolumeSlab::~vtkVolumeSlab()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkVolumeSlab::GetSlabOutput()
+{
+  return vtkImageData::SafeDownCast(this->GetOutputDataObject(0));
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData* vtkVolumeSlab::GetSurfaceOutput()
+{
+  return vtkPolyData::SafeDownCast(this->GetOutputDataObject(1));
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData* vtkVolumeSlab::GetGridSurfaceOutput()
+{
+  return vtkPolyData::SafeDownCast(this->GetOutputDataObject(2));
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkVolumeSlab::GetCacheSize()
+{
+  // The plane shown is counted with the output
+  vtkImageData* slab = this->GetSlabOutput();
+  vtkDataArray* shown = slab ? slab->GetPointData()->GetScalars() : NULL;
+
+  unsigned long size = 0;
+  for (int i = 0; i < (int)this->Planes.size(); i++)
+    {
+    if (this->Planes[i] != shown)
+      {
+      size += this->Planes[i]->GetActualMemorySize();
+      }
+    }
+
+  return size;
+}
+
+//----------------------------------------------------------------------------
+void vtkVolumeSlab::ReleaseCache()
+{
+  vtkImageData* slab = this->GetSlabOutput();
+  vtkDataArray* shown = slab ? slab->GetPointData()->GetScalars() : NULL;
+
+  // Keep the plane shown, so the block still starts at the slice
+  for (int i = 0; i < (int)this->Planes.size(); i++)
+    {
+    if (this->Planes[i] == shown)
+      {
+      vtkSmartPointer<vtkDataArray> plane = this->Planes[i];
+
+      this->Planes.assign(1, plane);
+      this->FirstPlane += i;
+
+      return;
+      }
+    }
+
+  this->Planes.clear();
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeSlab::FillInputPortInformation(int, vtkInformation* info)
+{
+  // Grids or multi-block grids
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataObject");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeSlab::FillOutputPortInformation(int port, vtkInformation* info)
+{
+  info->Set(vtkDataObject::DATA_TYPE_NAME(), port == 0 ? "vtkImageData" : "vtkPolyData");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeSlab::ProcessRequest(vtkInformation* request,
+                                  vtkInformationVector** inputVector,
+                                  vtkInformationVector* outputVector)
+{
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_DATA()))
+    {
+    return this->RequestData(request, inputVector, outputVector);
+    }
+
+  if (request->Has(vtkStreamingDemandDrivenPipeline::REQUEST_UPDATE_EXTENT()))
+    {
+    return this->RequestUpdateExtent(request, inputVector, outputVector);
+    }
+
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_INFORMATION()))
+    {
+    return this->RequestInformation(request, inputVector, outputVector);
+    }
+
+  return this->Superclass::ProcessRequest(request, inputVector, outputVector);
+}
+
+//----------------------------------------------------------------------------
+vtkDataSet* vtkVolumeSlab::GetGrid(vtkDataObject* input)
+{
+  vtkCompositeDataSet* composite = vtkCompositeDataSet::SafeDownCast(input);
+
+  if (!composite)
+    {
+    return vtkDataSet::SafeDownCast(input);
+    }
+
+  // Nested grids are sorted from coarsest to finest
+  vtkSmartPointer<vtkCompositeDataIterator> it;
+  it.TakeReference(composite->NewIterator());
+
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkDataSet* grid = vtkDataSet::SafeDownCast(it->GetCurrentDataObject());
+
+    if (grid)
+      {
+      return grid;
+      }
+    }
+
+  return NULL;
+}
+
+//----------------------------------------------------------------------------
+bool vtkVolumeSlab::GetSlabCoordinates(vtkDataObject* input, int axis, std::vector<double> coordinates[2])
+{
+  int u = axis == 0 ? 1 : 0;
+  int v = axis == 2 ? 1 : 2;
+
+  std::vector<vtkUniformGrid*> blocks;
+  vtkNestedGridBlanking::GetBlocks(input, blocks);
+
+  if (blocks.size() < 2)
+    {
+    vtkDataSet* grid = GetGrid(input);
+
+    return grid &&
+           vtkVolumeDifference::GetCoordinates(grid, u, coordinates[0]) &&
+           vtkVolumeDifference::GetCoordinates(grid, v, coordinates[1]);
+    }
+
+  // Merge the coordinates of all blocks, so each block's points are slab points
+  for (int i = 0; i < 2; i++)
+    {
+    std::vector<double> merged;
+
+    for (int j = 0; j < (int)blocks.size(); j++)
+      {
+      std::vector<double> c;
+      if (!vtkVolumeDifference::GetCoordinates(blocks[j], i == 0 ? u : v, c))
+        {
+        return false;
+        }
+
+      merged.insert(merged.end(), c.begin(), c.end());
+      }
+
+    if (merged.empty())
+      {
+      return false;
+      }
+
+    std::sort(merged.begin(), merged.end());
+
+    double tolerance = 1e-6 * std::max(merged.back() - merged.front(), 1.0);
+
+    coordinates[i].clear();
+    coordinates[i].push_back(merged[0]);
+
+    for (int j = 1; j < (int)merged.size(); j++)
+      {
+      if (merged[j] - coordinates[i].back() > tolerance)
+        {
+        coordinates[i].push_back(merged[j]);
+        }
+      }
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkVolumeSlab::GetSlabDimensions(vtkInformation* inInfo, int dimensions[2])
+{
+  int u = this->Axis == 0 ? 1 : 0;
+  int v = this->Axis == 2 ? 1 : 2;
+
+  vtkDataObject* input = inInfo->Get(vtkDataObject::DATA_OBJECT());
+
+  if (inInfo->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()) &&
+      !vtkCompositeDataSet::SafeDownCast(input))
+    {
+    int* extent = inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT());
+
+    dimensions[0] = extent[2 * u + 1] - extent[2 * u] + 1;
+    dimensions[1] = extent[2 * v + 1] - extent[2 * v] + 1;
+
+    return dimensions[0] > 0 && dimensions[1] > 0;
+    }
+
+  // Multi-block grids have no whole extent, so use the blocks
+  std::vector<double> coordinates[2];
+
+  if (!GetSlabCoordinates(input, this->Axis, coordinates))
+    {
+    return false;
+    }
+
+  dimensions[0] = (int)coordinates[0].size();
+  dimensions[1] = (int)coordinates[1].size();
+
+  return dimensions[0] > 0 && dimensions[1] > 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeSlab::RequestInformation(vtkInformation*,
+                                      vtkInformationVector** inputVector,
+                                      vtkInformationVector* outputVector)
+{
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+
+  int dimensions[2];
+
+  if (!inInfo || !this->GetSlabDimensions(inInfo, dimensions))
+    {
+    vtkErrorMacro("Input must be a uniform, rectilinear, or nested grid");
+    return 0;
+    }
+
+  int extent[6] = { 0, dimensions[0] - 1, 0, dimensions[1] - 1, 0, 0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent, 6);
+  outInfo->Set(vtkDataObject::ORIGIN(), origin, 3);
+  outInfo->Set(vtkDataObject::SPACING(), spacing, 3);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeSlab::RequestUpdateExtent(vtkInformation*,
+                                       vtkInformationVector** inputVector,
+                                       vtkInformationVector*)
+{
+  // The slice is copied from the whole volume, whatever part of it is requested
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+
+  if (inInfo && inInfo->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()))
+    {
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+                inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeSlab::RequestData(vtkInformation*,
+                               vtkInformationVector** inputVector,
+                               vtkInformationVector* outputVector)
+{
+  vtkDataObject* input = vtkDataObject::GetData(inputVector[0], 0);
+  vtkImageData* slab = vtkImageData::GetData(outputVector, 0);
+  vtkPolyData* surface = vtkPolyData::GetData(outputVector, 1);
+  vtkPolyData* gridSurface = vtkPolyData::GetData(outputVector, 2);
+
+  if (!slab || !surface || !gridSurface)
+    {
+    return 0;
+    }
+
+  slab->Initialize();
+  surface->Initialize();
+  gridSurface->Initialize();
+
+  vtkDataSet* grid = GetGrid(input);
+
+  if (!grid)
+    {
+    vtkErrorMacro("Input must be a uniform, rectilinear, or nested grid");
+    return 0;
+    }
+
+  std::vector<double> coordinates[3];
+  int dimensions[3];
+
+  for (int i = 0; i < 3; i++)
+    {
+    if (!vtkVolumeDifference::GetCoordinates(grid, i, coordinates[i]) || coordinates[i].empty())
+      {
+      vtkErrorMacro("Input must be a uniform, rectilinear, or nested grid");
+      return 0;
+      }
+
+    dimensions[i] = (int)coordinates[i].size();
+    }
+
+  vtkDataArray* scalars = grid->GetPointData()->GetScalars();
+
+  if (!scalars)
+    {
+    vtkErrorMacro("Input has no point scalars");
+    return 0;
+    }
+
+  // Nested grids are composed from all blocks on the merged grid of their points
+  std::vector<vtkUniformGrid*> blocks;
+  vtkNestedGridBlanking::GetBlocks(input, blocks);
+
+  bool nested = blocks.size() > 1;
+  unsigned long gridTime = grid->GetMTime();
+
+  if (nested && scalars->GetNumberOfComponents() != 1)
+    {
+    vtkErrorMacro("Nested grids must have single-component scalars");
+    return 0;
+    }
+
+  for (int i = 0; i < (int)blocks.size(); i++)
+    {
+    gridTime = std::max(gridTime, blocks[i]->GetMTime());
+    }
+
+  std::vector<double> slabCoordinates[2];
+
+  if (!GetSlabCoordinates(input, this->Axis, slabCoordinates))
+    {
+    vtkErrorMacro("Input must be a uniform, rectilinear, or nested grid");
+    return 0;
+    }
+
+
+  // The in-plane axes, and the slice requested or nearest the middle of the coarsest grid
+  int axis = this->Axis;
+  int u = axis == 0 ? 1 : 0;
+  int v = axis == 2 ? 1 : 2;
+
+  const std::vector<double>& c = coordinates[axis];
+  int slice = this->Slice;
+
+  if (slice < 0)
+    {
+    double middle = (c.front() + c.back()) * 0.5;
+
+    slice = 0;
+    for (int i = 1; i < (int)c.size(); i++)
+      {
+      if (fabs(c[i] - middle) < fabs(c[slice] - middle))
+        {
+        slice = i;
+        }
+      }
+    }
+
+  slice = std::min(slice, dimensions[axis] - 1);
+
+
+  // Copy the slice, and the planes around it, unless already copied from this grid
+  bool gridChanged = scalars != this->CachedScalars || gridTime != this->CachedGridTime;
+
+  if (gridChanged)
+    {
+    this->Planes.clear();
+    this->Surface = NULL;
+    this->GridSurface = NULL;
+
+    this->CachedScalars = scalars;
+    this->CachedGridTime = gridTime;
+    }
+
+  if (slice < this->FirstPlane || slice >= this->FirstPlane + (int)this->Planes.size())
+    {
+    if (nested)
+      {
+      this->ComposePlane(blocks, c[slice], slabCoordinates, scalars, slice);
+      }
+    else
+      {
+      this->CopyPlanes(scalars, dimensions, slice);
+      }
+    }
+
+  int nu = (int)slabCoordinates[0].size();
+  int nv = (int)slabCoordinates[1].size();
+
+  slab->SetExtent(0, nu - 1, 0, nv - 1, 0, 0);
+  slab->SetOrigin(0.0, 0.0, 0.0);
+  slab->SetSpacing(1.0, 1.0, 1.0);
+  slab->GetPointData()->SetScalars(this->Planes[slice - this->FirstPlane]);
+
+
+  // The surfaces only depend on the grid
+  if (!this->Surface)
+    {
+    // With a point per grid point for rectilinear and nested grids, so the texture follows the
+    // spacing, and otherwise just the corners
+    this->Surface = vtkSmartPointer<vtkPolyData>::New();
+    this->BuildSurface(slabCoordinates, nested || vtkRectilinearGrid::SafeDownCast(grid),
+                       this->Surface);
+
+    // Images laid out on the coarsest grid are textured on its own surface
+    this->GridSurface = this->Surface;
+
+    if (nested)
+      {
+      this->GridSurface = vtkSmartPointer<vtkPolyData>::New();
+      std::vector<double> gridCoordinates[2] = { coordinates[u], coordinates[v] };
+      this->BuildSurface(gridCoordinates, false, this->GridSurface);
+      }
+    }
+
+  surface->ShallowCopy(this->Surface);
+  gridSurface->ShallowCopy(this->GridSurface);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkVolumeSlab::BuildSurface(const std::vector<double> coordinates[2], bool pointPerGridPoint,
+                                 vtkPolyData* surface)
+{
+  int axis = this->Axis;
+  int u = axis == 0 ? 1 : 0;
+  int v = axis == 2 ? 1 : 2;
+
+  int nu = (int)coordinates[0].size();
+  int nv = (int)coordinates[1].size();
+
+  std::vector<int> indices[2];
+
+  for (int i = 0; i < 2; i++)
+    {
+    int n = i == 0 ? nu : nv;
+
+    if (pointPerGridPoint)
+      {
+      for (int j = 0; j < n; j++)
+        {
+        indices[i].push_back(j);
+        }
+      }
+    else
+      {
+      indices[i].push_back(0);
+      if (n > 1)
+        {
+        indices[i].push_back(n - 1);
+        }
+      }
+    }
+
+  int mu = (int)indices[0].size();
+  int mv = (int)indices[1].size();
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetNumberOfPoints(mu * mv);
+
+  vtkSmartPointer<vtkFloatArray> tcoords = vtkSmartPointer<vtkFloatArray>::New();
+  tcoords->SetName("TextureCoordinates");
+  tcoords->SetNumberOfComponents(2);
+  tcoords->SetNumberOfTuples(mu * mv);
+
+  for (int j = 0; j < mv; j++)
+    {
+    for (int i = 0; i < mu; i++)
+      {
+      int a = indices[0][i];
+      int b = indices[1][j];
+
+      double p[3];
+      p[axis] = 0.0;
+      p[u] = coordinates[0][a];
+      p[v] = coordinates[1][b];
+
+      // Texel centers
+      float t[2] = { static_cast<float>((a + 0.5) / nu), static_cast<float>((b + 0.5) / nv) };
+
+      points->SetPoint(j * mu + i, p);
+      tcoords->SetTupleValue(j * mu + i, t);
+      }
+    }
+
+  vtkSmartPointer<vtkCellArray> quads = vtkSmartPointer<vtkCellArray>::New();
+
+  for (int j = 0; j < mv - 1; j++)
+    {
+    for (int i = 0; i < mu - 1; i++)
+      {
+      vtkIdType p00 = j * mu + i;
+      vtkIdType p10 = p00 + 1;
+      vtkIdType p01 = p00 + mu;
+      vtkIdType p11 = p01 + 1;
+
+      // u cross v is along the positive axis, except for x cross z along y, so reverse those
+      vtkIdType quad[4] = { p00, p10, p11, p01 };
+      if (axis == 1)
+        {
+        std::swap(quad[1], quad[3]);
+        }
+
+      quads->InsertNextCell(4, quad);
+      }
+    }
+
+  surface->SetPoints(points);
+  surface->SetPolys(quads);
+  surface->GetPointData()->SetTCoords(tcoords);
+}
+
+//----------------------------------------------------------------------------
+void vtkVolumeSlab::ComposePlane(const std::vector<vtkUniformGrid*>& blocks, double position,
+                                 const std::vector<double> coordinates[2], vtkDataArray* scalars,
+                                 int slice)
+{
+  int axis = this->Axis;
+  int u = axis == 0 ? 1 : 0;
+  int v = axis == 2 ? 1 : 2;
+
+  int nu = (int)coordinates[0].size();
+  int nv = (int)coordinates[1].size();
+
+  std::vector<double> plane((vtkIdType)nu * nv, 0.0);
+
+  // Coarsest to finest, so finer blocks overwrite the coarser blocks they cover
+  for (int i = 0; i < (int)blocks.size(); i++)
+    {
+    vtkUniformGrid* block = blocks[i];
+    vtkDataArray* values = block->GetPointData()->GetScalars();
+
+    int dimensions[3];
+    block->GetDimensions(dimensions);
+
+    std::vector<double> blockCoordinates[3];
+
+    if (!values || values->GetNumberOfComponents() != 1 ||
+        !vtkVolumeDifference::GetCoordinates(block, 0, blockCoordinates[0]) ||
+        !vtkVolumeDifference::GetCoordinates(block, 1, blockCoordinates[1]) ||
+        !vtkVolumeDifference::GetCoordinates(block, 2, blockCoordinates[2]))
+      {
+      continue;
+      }
+
+    // The planes of the block around the slice, if it crosses the slice
+    std::vector<double> slicePosition(1, position);
+    std::vector<int> sliceIndex;
+    std::vector<double> sliceWeight;
+
+    vtkVolumeSlabLocate(slicePosition, blockCoordinates[axis], sliceIndex, sliceWeight);
+
+    if (sliceIndex[0] < 0)
+      {
+      continue;
+      }
+
+    int dk = dimensions[axis] > 1 ? 1 : 0;
+
+    std::vector<int> index[2];
+    std::vector<double> weight[2];
+
+    vtkVolumeSlabLocate(coordinates[0], blockCoordinates[u], index[0], weight[0]);
+    vtkVolumeSlabLocate(coordinates[1], blockCoordinates[v], index[1], weight[1]);
+
+    switch (values->GetDataType())
+      {
+      vtkTemplateMacro(vtkVolumeSlabSampleBlock(static_cast<const VTK_TT*>(values->GetVoidPointer(0)),
+                                                dimensions, axis, sliceIndex[0], dk, sliceWeight[0],
+                                                index, weight, &plane[0]));
+      }
+    }
+
+  this->Planes.resize(1);
+  this->Planes[0].TakeReference(scalars->NewInstance());
+  this->Planes[0]->SetName(scalars->GetName());
+  this->Planes[0]->SetNumberOfComponents(1);
+  this->Planes[0]->SetNumberOfTuples((vtkIdType)nu * nv);
+
+  for (vtkIdType i = 0; i < (vtkIdType)plane.size(); i++)
+    {
+    this->Planes[0]->SetTuple1(i, plane[i]);
+    }
+
+  this->FirstPlane = slice;
+}
+
+//----------------------------------------------------------------------------
+void vtkVolumeSlab::CopyPlanes(vtkDataArray* scalars, const int dimensions[3], int slice)
+{
+  int axis = this->Axis;
+  int u = axis == 0 ? 1 : 0;
+  int v = axis == 2 ? 1 : 2;
+
+  // A block of planes ahead of the slice in the direction it last moved, or around it at first,
+  // so scrubbing finds the next planes already copied
+  int count = std::min(std::max(this->NumberOfPrefetchPlanes, 1), dimensions[axis]);
+  int first = slice - count / 2;
+
+  if (!this->Planes.empty())
+    {
+    first = slice >= this->FirstPlane ? slice : slice - count + 1;
+    }
+
+  first = std::min(std::max(first, 0), dimensions[axis] - count);
+
+  vtkVolumeSlabWork work;
+  work.Input = static_cast<const char*>(scalars->GetVoidPointer(0));
+  work.TupleSize = scalars->GetNumberOfComponents() * scalars->GetDataTypeSize();
+  work.Size[0] = dimensions[u];
+  work.Size[1] = dimensions[v];
+  work.Stride[0] = axis == 0 ? dimensions[0] : 1;
+  work.Stride[1] = v == 1 ? dimensions[0] : (vtkIdType)dimensions[0] * dimensions[1];
+  work.Stride[2] = axis == 0 ? 1 : axis == 1 ? dimensions[0] : (vtkIdType)dimensions[0] * dimensions[1];
+  work.FirstPlane = first;
+  work.NextRow = 0;
+
+  this->Planes.resize(count);
+  work.Planes.resize(count);
+
+  for (int i = 0; i < count; i++)
+    {
+    this->Planes[i].TakeReference(scalars->NewInstance());
+    this->Planes[i]->SetName(scalars->GetName());
+    this->Planes[i]->SetNumberOfComponents(scalars->GetNumberOfComponents());
+    this->Planes[i]->SetNumberOfTuples((vtkIdType)work.Size[0] * work.Size[1]);
+
+    work.Planes[i] = static_cast<char*>(this->Planes[i]->GetVoidPointer(0));
+    }
+
+  this->FirstPlane = first;
+
+  vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+  threader->SetNumberOfThreads(std::max(1, std::min(this->NumberOfThreads, work.Size[1])));
+  threader->SetSingleMethod(CopyRows, &work);
+  threader->SingleMethodExecute();
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkVolumeSlab::CopyRows(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkVolumeSlabWork* work = static_cast<vtkVolumeSlabWork*>(info->UserData);
+
+  // Take rows until none are left
+  for (;;)
+    {
+    work->Lock.Lock();
+    int row = work->NextRow++;
+    work->Lock.Unlock();
+
+    if (row >= work->Size[1])
+      {
+      break;
+      }
+
+    vtkVolumeSlabCopyRow(work, row);
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkVolumeSlab::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Axis: " << this->Axis << "\n";
+  os << indent << "Slice: " << this->Slice << "\n";
+  os << indent << "NumberOfPrefetchPlanes: " << this->NumberOfPrefetchPlanes << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+}
@@ -0,0 +1,161 @@
+/*=========================================================================
+
+  Name:        vtkVolumeSlab.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Extracts a slice of a volume along an axis, for rendering
+               as a texture.
+
+               Output 0 is the slice as a 2D image, copied from the
+               volume in index space, with the input scalars' type and
+               name.  Output 1 is a surface to texture it on, lying in the
+               plane through the origin normal to the axis, so it can be
+               placed by an actor.  The surface normal points along the
+               positive axis, and its texture coordinates hit the texel
+               centers at the grid points.  For rectilinear grids the
+               surface has a point per grid point, so the texture follows
+               the spacing.  Otherwise it is a single quad.
+
+               Copying a slice only touches one plane of the volume.  To
+               keep scrubbing through the volume at display rate, a block
+               of planes ahead of the slice in the direction it moved is
+               copied at once, in parallel rows, and kept until the slice
+               leaves the block or the input changes.  Across x, where a
+               single plane reads a cache line per point, the block
+               shares those reads.  The surface is kept until the grid
+               changes.
+
+               Uniform and rectilinear grids are supported, as are
+               nested multi-block grids sorted from coarsest to finest.
+               For those the slice is composed from every block crossing
+               it, interpolated on the merged grid of the blocks' points,
+               with finer blocks over coarser ones.  Slice indices are
+               those of the coarsest block, and a single plane is kept.
+               Output 2 is the surface laid out for the coarsest block,
+               for textures sampled on it.  For other grids it is the
+               same as output 1.
+
+=========================================================================*/
+
+
+#ifndef __vtkVolumeSlab_h
+#define __vtkVolumeSlab_h
+
+#include <vtkAlgorithm.h>
+#include <vtkMultiThreader.h>
+#include <vtkSmartPointer.h>
+
+#include <vector>
+
+class vtkDataArray;
+class vtkDataSet;
+class vtkImageData;
+class vtkPolyData;
+class vtkUniformGrid;
+
+
+class vtkVolumeSlab : public vtkAlgorithm
+{
+public:
+  static vtkVolumeSlab *New();
+  vtkTypeMacro(vtkVolumeSlab, vtkAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Axis normal to the slice: 0 for x, 1 for y, 2 for z.  Defaults to z.
+  vtkSetClampMacro(Axis, int, 0, 2);
+  vtkGetMacro(Axis, int);
+
+  // Description:
+  // Index of the slice along the axis, clamped to the volume, or -1 for
+  // the slice nearest the middle.  Defaults to -1.
+  vtkSetClampMacro(Slice, int, -1, VTK_INT_MAX);
+  vtkGetMacro(Slice, int);
+
+  // Description:
+  // Number of planes copied at once when the slice moves to a plane not
+  // copied yet.  Defaults to 8.
+  vtkSetClampMacro(NumberOfPrefetchPlanes, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfPrefetchPlanes, int);
+
+  // Description:
+  // Number of threads used.  Defaults to the number of processors.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Get the slice image, the surface to texture it on, and the surface for
+  // images laid out on the coarsest grid.
+  vtkImageData* GetSlabOutput();
+  vtkPolyData* GetSurfaceOutput();
+  vtkPolyData* GetGridSurfaceOutput();
+
+  // Description:
+  // Get the memory held by the planes copied besides the one shown, in
+  // kilobytes, and release them.  Released planes are copied again when
+  // the slice moves to them.
+  unsigned long GetCacheSize();
+  void ReleaseCache();
+
+  // Description:
+  // Get the grid sliced from a volume: the volume itself, or the first
+  // block of a multi-block volume.
+  static vtkDataSet* GetGrid(vtkDataObject* input);
+
+  // Description:
+  // See vtkAlgorithm for details.
+  virtual int ProcessRequest(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+protected:
+  vtkVolumeSlab();
+  ~vtkVolumeSlab();
+
+  virtual int FillInputPortInformation(int port, vtkInformation* info);
+  virtual int FillOutputPortInformation(int port, vtkInformation* info);
+
+  virtual int RequestInformation(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+  virtual int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+  virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+  // Get the in-plane coordinates of the slice image, merged across the blocks of nested grids
+  static bool GetSlabCoordinates(vtkDataObject* input, int axis, std::vector<double> coordinates[2]);
+
+  // Get the dimensions of the slice image from the input's whole extent or grid
+  bool GetSlabDimensions(vtkInformation* inInfo, int dimensions[2]);
+
+  // Copy a block of planes including the slice
+  void CopyPlanes(vtkDataArray* scalars, const int dimensions[3], int slice);
+
+  // Compose the slice of nested grids at the given position along the axis
+  void ComposePlane(const std::vector<vtkUniformGrid*>& blocks, double position,
+                    const std::vector<double> coordinates[2], vtkDataArray* scalars, int slice);
+
+  // Build a surface with the given in-plane coordinates
+  void BuildSurface(const std::vector<double> coordinates[2], bool pointPerGridPoint,
+                    vtkPolyData* surface);
+
+  // Thread entry point
+  static VTK_THREAD_RETURN_TYPE CopyRows(void* arg);
+
+  int Axis;
+  int Slice;
+  int NumberOfPrefetchPlanes;
+  int NumberOfThreads;
+
+  // Planes copied, starting at FirstPlane, and the surfaces, with what they were copied from
+  std::vector<vtkSmartPointer<vtkDataArray> > Planes;
+  int FirstPlane;
+  vtkSmartPointer<vtkPolyData> Surface;
+  vtkSmartPointer<vtkPolyData> GridSurface;
+  vtkDataArray* CachedScalars;
+  unsigned long CachedGridTime;
+
+private:
+  vtkVolumeSlab(const vtkVolumeSlab&);  // Not implemented.
+  void operator=(const vtkVolumeSlab&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,434 @@
+/*=========================================================================
+
+  Name:        vtkVolumeSmoothing.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Smooths the scalars of a uniform or rectilinear grid.
+
+=========================================================================*/
+
+
+#include "vtkVolumeSmoothing.h"
+
+#include "vtkSSE2Math.h"
+#include "vtkVolumeDifference.h"
+
+#include <vtkCriticalSection.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifdef USE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+vtkStandardNewMacro(vtkVolumeSmoothing);
+
+
+//----------------------------------------------------------------------------
+// Shared state for smoothing the planes of one pass in parallel
+struct vtkVolumeSmoothingWork
+{
+  vtkVolumeSmoothing* Filter;
+
+  vtkDataArray* Input;
+  vtkDataArray* Output;
+
+  int Dimensions[3];
+
+  // Axis smoothed by this pass.  Passes along x and y are split into z planes, and passes along z
+  // into y planes.
+  int Axis;
+  int NumberOfPlanes;
+
+  // Spatial weights from -radius to radius, and -1 / (2 sigma^2) for differences in value
+  std::vector<double> Weights;
+  double RangeFactor;
+  bool Bilateral;
+
+  int NextPlane;
+  vtkSimpleCriticalSection Lock;
+};
+
+
+#ifdef USE_SSE2
+//----------------------------------------------------------------------------
+// Load two consecutive values as doubles
+static inline __m128d vtkVolumeSmoothingLoad(const float* p)
+{
+  return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+}
+
+static inline __m128d vtkVolumeSmoothingLoad(const double* p)
+{
+  return _mm_loadu_pd(p);
+}
+#endif
+
+//----------------------------------------------------------------------------
+// Add the weighted values of a source row, indexed by output point, to the sums over [begin, end).
+// With SSE2, two points are added at a time.
+template <class T>
+static inline void vtkVolumeSmoothingAdd(const T* source, const T* center, int begin, int end,
+                                         double weight, vtkVolumeSmoothingWork* work,
+                                         double* sum, double* norm)
+{
+  int x = begin;
+
+  if (!work->Bilateral)
+    {
+#ifdef USE_SSE2
+    __m128d w = _mm_set1_pd(weight);
+
+    for (; x + 2 <= end; x += 2)
+      {
+      __m128d s = _mm_mul_pd(w, vtkVolumeSmoothingLoad(source + x));
+      _mm_storeu_pd(sum + x, _mm_add_pd(_mm_loadu_pd(sum + x), s));
+      }
+#endif
+
+    for (; x < end; x++)
+      {
+      sum[x] += weight * source[x];
+      }
+
+    return;
+    }
+
+  double rangeFactor = work->RangeFactor;
+
+#ifdef USE_SSE2
+  __m128d spatial = _mm_set1_pd(weight);
+  __m128d range = _mm_set1_pd(rangeFactor);
+
+  for (; x + 2 <= end; x += 2)
+    {
+    __m128d s = vtkVolumeSmoothingLoad(source + x);
+    __m128d d = _mm_sub_pd(s, vtkVolumeSmoothingLoad(center + x));
+    __m128d w = _mm_mul_pd(spatial, vtkSSE2Exp(_mm_mul_pd(_mm_mul_pd(range, d), d)));
+
+    _mm_storeu_pd(sum + x, _mm_add_pd(_mm_loadu_pd(sum + x), _mm_mul_pd(w, s)));
+    _mm_storeu_pd(norm + x, _mm_add_pd(_mm_loadu_pd(norm + x), w));
+    }
+#endif
+
+  for (; x < end; x++)
+    {
+    double d = static_cast<double>(source[x]) - center[x];
+    double w = weight * exp(rangeFactor * d * d);
+
+    sum[x] += w * source[x];
+    norm[x] += w;
+    }
+}
+
+//----------------------------------------------------------------------------
+// The same, for a constant value, as for points shifted past the end of a row
+template <class T>
+static inline void vtkVolumeSmoothingAddValue(double value, const T* center, int begin, int end,
+                                              double weight, vtkVolumeSmoothingWork* work,
+                                              double* sum, double* norm)
+{
+  for (int x = begin; x < end; x++)
+    {
+    double w = weight;
+
+    if (work->Bilateral)
+      {
+      double d = value - center[x];
+      w *= exp(work->RangeFactor * d * d);
+      norm[x] += w;
+      }
+
+    sum[x] += w * value;
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+static void vtkVolumeSmoothingPlane(vtkVolumeSmoothingWork* work, const T* in, T* out, int plane)
+{
+  int nx = work->Dimensions[0];
+  int ny = work->Dimensions[1];
+  int nz = work->Dimensions[2];
+  int axis = work->Axis;
+
+  int radius = (int)work->Weights.size() / 2;
+  const double* weights = &work->Weights[radius];
+
+  std::vector<double> sum(nx);
+  std::vector<double> norm(nx);
+
+  // Rows of the plane
+  int numberOfRows = axis == 2 ? nz : ny;
+
+  for (int row = 0; row < numberOfRows; row++)
+    {
+    int y = axis == 2 ? plane : row;
+    int z = axis == 2 ? row : plane;
+
+    const T* center = in + ((vtkIdType)z * ny + y) * nx;
+
+    std::fill(sum.begin(), sum.end(), 0.0);
+    std::fill(norm.begin(), norm.end(), 0.0);
+
+    for (int k = -radius; k <= radius; k++)
+      {
+      double weight = weights[k];
+
+      if (axis == 0)
+        {
+        // Shift along the row, repeating the end values past either end
+        int begin = std::min(std::max(-k, 0), nx);
+        int end = std::max(std::min(nx - k, nx), begin);
+
+        vtkVolumeSmoothingAddValue(center[0], center, 0, begin, weight, work, &sum[0], &norm[0]);
+        vtkVolumeSmoothingAdd(center + k, center, begin, end, weight, work, &sum[0], &norm[0]);
+        vtkVolumeSmoothingAddValue(center[nx - 1], center, end, nx, weight, work, &sum[0], &norm[0]);
+        }
+      else
+        {
+        // Whole rows from neighboring rows or planes, repeating the boundary rows
+        const T* source;
+
+        if (axis == 1)
+          {
+          source = in + ((vtkIdType)z * ny + std::min(std::max(y + k, 0), ny - 1)) * nx;
+          }
+        else
+          {
+          source = in + ((vtkIdType)std::min(std::max(z + k, 0), nz - 1) * ny + y) * nx;
+          }
+
+        vtkVolumeSmoothingAdd(source, center, 0, nx, weight, work, &sum[0], &norm[0]);
+        }
+      }
+
+    T* result = out + ((vtkIdType)z * ny + y) * nx;
+
+    if (work->Bilateral)
+      {
+      for (int x = 0; x < nx; x++)
+        {
+        result[x] = static_cast<T>(norm[x] > 0.0 ? sum[x] / norm[x] : center[x]);
+        }
+      }
+    else
+      {
+      for (int x = 0; x < nx; x++)
+        {
+        result[x] = static_cast<T>(sum[x]);
+        }
+      }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+vtkVolumeSmoothing::vtkVolumeSmoothing()
+{
+  this->Bilateral = 0;
+  this->StandardDeviation = 1.0;
+  this->RangeStandardDeviation = 1.0;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+}
+
+//----------------------------------------------------------------------------
+vtkVolumeSmoothing::~vtkVolumeSmoothing()
+{
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeSmoothing::RequestUpdateExtent(vtkInformation*,
+                                            vtkInformationVector** inputVector,
+                                            vtkInformationVector*)
+{
+  // Always request the whole volume, as every point depends on its neighbors
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+
+  if (inInfo && inInfo->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()))
+    {
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+                inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkVolumeSmoothing::RequestData(vtkInformation*,
+                                    vtkInformationVector** inputVector,
+                                    vtkInformationVector* outputVector)
+{
+  vtkDataSet* input = vtkDataSet::GetData(inputVector[0], 0);
+  vtkDataSet* output = vtkDataSet::GetData(outputVector, 0);
+
+  if (!input || !output)
+    {
+    return 0;
+    }
+
+  output->ShallowCopy(input);
+
+  vtkDataArray* scalars = input->GetPointData()->GetScalars();
+
+  if (!scalars || scalars->GetNumberOfComponents() != 1)
+    {
+    vtkErrorMacro("Input needs single component point scalars");
+    return 0;
+    }
+
+  vtkVolumeSmoothingWork work;
+  work.Filter = this;
+
+  for (int i = 0; i < 3; i++)
+    {
+    std::vector<double> coordinates;
+
+    if (!vtkVolumeDifference::GetCoordinates(input, i, coordinates) || coordinates.empty())
+      {
+      vtkErrorMacro("Input must be a uniform or rectilinear grid");
+      return 0;
+      }
+
+    work.Dimensions[i] = (int)coordinates.size();
+    }
+
+
+  // Spatial weights, normalized
+  int radius = (int)ceil(3.0 * this->StandardDeviation);
+
+  work.Weights.resize(2 * radius + 1);
+
+  double total = 0.0;
+  for (int k = -radius; k <= radius; k++)
+    {
+    double w = radius > 0 ? exp(-k * k / (2.0 * this->StandardDeviation * this->StandardDeviation)) : 1.0;
+    work.Weights[k + radius] = w;
+    total += w;
+    }
+
+  for (int k = 0; k < (int)work.Weights.size(); k++)
+    {
+    work.Weights[k] /= total;
+    }
+
+  work.Bilateral = this->Bilateral && this->RangeStandardDeviation > 0.0;
+  work.RangeFactor = work.Bilateral ? -1.0 / (2.0 * this->RangeStandardDeviation * this->RangeStandardDeviation) : 0.0;
+
+
+  // Smooth a converted copy, using a second array of the same type for alternate passes
+  vtkSmartPointer<vtkDataArray> smoothed;
+  vtkSmartPointer<vtkDataArray> buffer;
+
+  if (scalars->GetDataType() == VTK_DOUBLE)
+    {
+    smoothed = vtkSmartPointer<vtkDoubleArray>::New();
+    buffer = vtkSmartPointer<vtkDoubleArray>::New();
+    }
+  else
+    {
+    smoothed = vtkSmartPointer<vtkFloatArray>::New();
+    buffer = vtkSmartPointer<vtkFloatArray>::New();
+    }
+
+  smoothed->DeepCopy(scalars);
+  smoothed->SetName(scalars->GetName());
+  buffer->SetNumberOfTuples(smoothed->GetNumberOfTuples());
+
+  if (radius > 0)
+    {
+    for (int axis = 0; axis < 3; axis++)
+      {
+      // Flat axes have nothing to smooth
+      if (work.Dimensions[axis] < 2)
+        {
+        continue;
+        }
+
+      work.Axis = axis;
+      work.NumberOfPlanes = axis == 2 ? work.Dimensions[1] : work.Dimensions[2];
+      work.Input = smoothed;
+      work.Output = buffer;
+      work.NextPlane = 0;
+
+      vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+      threader->SetNumberOfThreads(std::min(this->NumberOfThreads, work.NumberOfPlanes));
+      threader->SetSingleMethod(SmoothPlanes, &work);
+      threader->SingleMethodExecute();
+
+      std::swap(smoothed, buffer);
+      }
+    }
+
+  smoothed->SetName(scalars->GetName());
+
+  output->GetPointData()->SetScalars(smoothed);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkVolumeSmoothing::SmoothPlanes(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkVolumeSmoothingWork* work = static_cast<vtkVolumeSmoothingWork*>(info->UserData);
+
+  // Take planes until none are left
+  for (;;)
+    {
+    work->Lock.Lock();
+    int plane = work->NextPlane++;
+    work->Lock.Unlock();
+
+    if (plane >= work->NumberOfPlanes)
+      {
+      break;
+      }
+
+    work->Filter->SmoothPlane(work, plane);
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkVolumeSmoothing::SmoothPlane(vtkVolumeSmoothingWork* work, int plane)
+{
+  // Passes work on the converted copy, so are either double or float
+  if (work->Input->GetDataType() == VTK_DOUBLE)
+    {
+    vtkVolumeSmoothingPlane(work, static_cast<const double*>(work->Input->GetVoidPointer(0)),
+                            static_cast<double*>(work->Output->GetVoidPointer(0)), plane);
+    }
+  else
+    {
+    vtkVolumeSmoothingPlane(work, static_cast<const float*>(work->Input->GetVoidPointer(0)),
+                            static_cast<float*>(work->Output->GetVoidPointer(0)), plane);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkVolumeSmoothing::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Bilateral: " << this->Bilateral << "\n";
+  os << indent << "StandardDeviation: " << this->StandardDeviation << "\n";
+  os << indent << "RangeStandardDeviation: " << this->RangeStandardDeviation << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+}
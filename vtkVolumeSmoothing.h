@@ -0,0 +1,94 @@
+/*=========================================================================
+
+  Name:        vtkVolumeSmoothing.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  Description: Smooths the scalars of a uniform or rectilinear grid, to
+               remove noise (e.g. in difference fields) before contouring.
+
+               Gaussian smoothing is separable, and is done as three 1D
+               convolutions along x, y, and z.  Bilateral smoothing, which
+               keeps sharp features by weighting neighbors by how close
+               their values are, uses the same separable passes as an
+               approximation of the full 3D filter.
+
+               Widths are in grid points, so rectilinear grids are
+               smoothed in index space.  Each pass is split into planes
+               that are computed in parallel.  With USE_SSE2, rows are
+               accumulated two points at a time, with the range weights
+               of bilateral smoothing from a vector exp.  Edges repeat
+               the boundary values.
+
+               Other point data arrays are passed through.  The smoothed
+               array keeps the name of the input scalars, and is double
+               if they are double, and float otherwise.
+
+=========================================================================*/
+
+
+#ifndef __vtkVolumeSmoothing_h
+#define __vtkVolumeSmoothing_h
+
+#include <vtkDataSetAlgorithm.h>
+#include <vtkMultiThreader.h>
+
+struct vtkVolumeSmoothingWork;
+
+
+class vtkVolumeSmoothing : public vtkDataSetAlgorithm
+{
+public:
+  static vtkVolumeSmoothing *New();
+  vtkTypeMacro(vtkVolumeSmoothing, vtkDataSetAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Use bilateral rather than Gaussian smoothing.  Defaults to off.
+  vtkSetMacro(Bilateral, int);
+  vtkGetMacro(Bilateral, int);
+  vtkBooleanMacro(Bilateral, int);
+
+  // Description:
+  // Standard deviation of the spatial Gaussian, in grid points.  Defaults
+  // to 1.  The kernel extends to 3 standard deviations.
+  vtkSetClampMacro(StandardDeviation, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(StandardDeviation, double);
+
+  // Description:
+  // Standard deviation of the Gaussian applied to differences in value
+  // for bilateral smoothing, in data units.  Defaults to 1.
+  vtkSetClampMacro(RangeStandardDeviation, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(RangeStandardDeviation, double);
+
+  // Description:
+  // Number of threads used.  Defaults to the number of processors.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+protected:
+  vtkVolumeSmoothing();
+  ~vtkVolumeSmoothing();
+
+  virtual int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+  virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+  // Smooth one plane of a pass
+  void SmoothPlane(vtkVolumeSmoothingWork* work, int plane);
+
+  // Thread entry point
+  static VTK_THREAD_RETURN_TYPE SmoothPlanes(void* arg);
+
+  int Bilateral;
+  double StandardDeviation;
+  double RangeStandardDeviation;
+  int NumberOfThreads;
+
+private:
+  vtkVolumeSmoothing(const vtkVolumeSmoothing&);  // Not implemented.
+  void operator=(const vtkVolumeSmoothing&);  // Not implemented.
+};
+
+#endif